@@ -378,7 +378,9 @@ void ComputeFFTGrid::compute_per_grid()
       Compute *c = modify->compute[vidx];
 
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
 
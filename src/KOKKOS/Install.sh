@@ -149,6 +149,9 @@ action fix_grid_check_kokkos.cpp
 action fix_grid_check_kokkos.h
 action read_surf_kokkos.cpp
 action read_surf_kokkos.h
+action region_kokkos.h
+action variable_kokkos.cpp
+action variable_kokkos.h
 
 # edit 2 Makefile.package files to include/exclude package info
 # allow user to specify sed.  Useful on Mac OSX to specify SED=gsed
@@ -72,6 +72,7 @@ int CommKokkos::migrate_particles(int nmigrate, int *plist, DAT::t_int_1d &d_pli
   particle_kk_copy.copy(particle_kk);
 
   if (sparta->kokkos->comm_serial) {
+    sparta->kokkos->sync_owner = KokkosSPARTA::SYNC_COMM;
     particle_kk->sync(Host,ALL_MASK);
     //grid_kk->sync(Host,ALL_MASK);
     int prev_auto_sync = sparta->kokkos->auto_sync;
@@ -82,6 +83,7 @@ int CommKokkos::migrate_particles(int nmigrate, int *plist, DAT::t_int_1d &d_pli
     particle_kk->sync(Device,ALL_MASK);
     //grid_kk->sync(Device,ALL_MASK);
     sparta->kokkos->auto_sync = prev_auto_sync;
+    sparta->kokkos->sync_owner = KokkosSPARTA::SYNC_OTHER;
 
     return ncompress;
   }
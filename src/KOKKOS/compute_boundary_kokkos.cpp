@@ -49,6 +49,7 @@ ComputeBoundaryKokkos::ComputeBoundaryKokkos(SPARTA *sparta) :
 {
   array = NULL;
   myarray = NULL;
+  stage = NULL;
   which = NULL;
   id = NULL;
   style = NULL;
@@ -89,10 +90,10 @@ void ComputeBoundaryKokkos::compute_array()
     MPI_Allreduce(d_myarray.data(),d_array.data(),nrow*ntotal,
                   MPI_DOUBLE,MPI_SUM,world);
     k_array.modify_device();
-    k_array.sync_host();
+    sparta->kokkos->sync_counted(k_array,Host,1);
   } else {
     k_myarray.modify_device();
-    k_myarray.sync_host();
+    sparta->kokkos->sync_counted(k_myarray,Host,1);
     MPI_Allreduce(k_myarray.h_view.data(),k_array.h_view.data(),nrow*ntotal,
                   MPI_DOUBLE,MPI_SUM,world);
   }
@@ -93,7 +93,7 @@ double ComputeCountKokkos::compute_scalar()
 
   per_species_tally_kokkos();
   k_count.modify_device();
-  k_count.sync_host();
+  sparta->kokkos->sync_counted(k_count,Host,1);
   for (int m=0; m<maxspecies; ++m)
     count[m] = k_count.h_view(m);
 
@@ -123,7 +123,7 @@ void ComputeCountKokkos::compute_vector()
 
   per_species_tally_kokkos();
   k_count.modify_device();
-  k_count.sync_host();
+  sparta->kokkos->sync_counted(k_count,Host,1);
   for (int m=0; m<maxspecies; ++m)
     count[m] = k_count.h_view(m);
 
@@ -59,7 +59,7 @@ void ComputeDistSurfGridKokkos::compute_per_grid()
   } else {
     compute_per_grid_kokkos();
     k_vector_grid.modify_device();
-    k_vector_grid.sync_host();
+    sparta->kokkos->sync_counted(k_vector_grid,Host,1);
   }
 }
 
@@ -20,6 +20,7 @@
 #include "compute_lambda_grid_kokkos.h"
 #include "update.h"
 #include "grid_kokkos.h"
+#include "particle_kokkos.h"
 #include "domain.h"
 #include "collide.h"
 #include "modify.h"
@@ -35,7 +36,7 @@
 using namespace SPARTA_NS;
 using namespace MathConst;
 
-enum{NONE,COMPUTE,FIX};
+enum{NONE,COMPUTE,FIX,TALLY};
 enum{KNONE,KALL,KX,KY,KZ};
 
 #define INVOKED_PER_GRID 16
@@ -84,15 +85,32 @@ void ComputeLambdaGridKokkos::compute_per_grid_kokkos()
   if (tempwhich == FIX && update->ntimestep % ftemp->per_grid_freq)
     error->all(FLERR,"Compute lambda/grid fix not computed at compatible time");
 
-  // grab nrho and temp values from compute or fix
+  // tally nrho and optionally temp from particles in a single sweep
+  // else grab nrho and temp values from compute or fix
   // invoke nrho and temp computes as needed
 
-  if (nrhowhich == COMPUTE) {
-    if (!cnrho->kokkos_flag)
-      error->all(FLERR,"Cannot (yet) use non-Kokkos computes with compute lambda/grid/kk");
+  if (nrhowhich == TALLY) tally_particles_kokkos();
+
+  if (nrhowhich == COMPUTE && !cnrho->kokkos_flag) {
+    if (!(cnrho->invoked_flag & INVOKED_PER_GRID)) {
+      modify->invoke_begin(cnrho);
+      cnrho->compute_per_grid();
+      modify->invoke_end();
+      cnrho->invoked_flag |= INVOKED_PER_GRID;
+    }
+
+    if (cnrho->post_process_grid_flag) {
+      cnrho->post_process_grid(nrhoindex,1,NULL,NULL,NULL,1);
+      bridge_values(d_nrho_vector,cnrho->vector_grid,NULL,0,0);
+    } else
+      bridge_values(d_nrho_vector,cnrho->vector_grid,cnrho->array_grid,nrhoindex,
+                    cnrho->size_per_grid_cols);
+  } else if (nrhowhich == COMPUTE) {
     KokkosBase* computeKKBase = dynamic_cast<KokkosBase*>(cnrho);
     if (!(cnrho->invoked_flag & INVOKED_PER_GRID)) {
+      modify->invoke_begin(cnrho);
       computeKKBase->compute_per_grid_kokkos();
+      modify->invoke_end();
       cnrho->invoked_flag |= INVOKED_PER_GRID;
     }
 
@@ -107,9 +125,10 @@ void ComputeLambdaGridKokkos::compute_per_grid_kokkos()
       Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagComputeLambdaGrid_LoadNrhoVecFromArray>(0,nglocal),*this);
       copymode = 0;
     }
+  } else if (nrhowhich == FIX && !fnrho->kokkos_flag) {
+    bridge_values(d_nrho_vector,fnrho->vector_grid,fnrho->array_grid,nrhoindex,
+                  fnrho->size_per_grid_cols);
   } else if (nrhowhich == FIX) {
-    if (!fnrho->kokkos_flag)
-      error->all(FLERR,"Cannot (yet) use non-Kokkos fixes with compute lambda/grid/kk");
     KokkosBase* computeKKBase = dynamic_cast<KokkosBase*>(fnrho);
     if (nrhoindex == 0)
       d_nrho_vector = computeKKBase->d_vector;
@@ -121,12 +140,26 @@ void ComputeLambdaGridKokkos::compute_per_grid_kokkos()
     }
   }
 
-  if (tempwhich == COMPUTE) {
-    if (!ctemp->kokkos_flag)
-      error->all(FLERR,"Cannot (yet) use non-Kokkos computes with compute lambda/grid/kk");
+  if (tempwhich == COMPUTE && !ctemp->kokkos_flag) {
+    if (!(ctemp->invoked_flag & INVOKED_PER_GRID)) {
+      modify->invoke_begin(ctemp);
+      ctemp->compute_per_grid();
+      modify->invoke_end();
+      ctemp->invoked_flag |= INVOKED_PER_GRID;
+    }
+
+    if (ctemp->post_process_grid_flag) {
+      ctemp->post_process_grid(tempindex,1,NULL,NULL,NULL,1);
+      bridge_values(d_temp_vector,ctemp->vector_grid,NULL,0,0);
+    } else
+      bridge_values(d_temp_vector,ctemp->vector_grid,ctemp->array_grid,tempindex,
+                    ctemp->size_per_grid_cols);
+  } else if (tempwhich == COMPUTE) {
     KokkosBase* computeKKBase = dynamic_cast<KokkosBase*>(ctemp);
     if (!(ctemp->invoked_flag & INVOKED_PER_GRID)) {
+      modify->invoke_begin(ctemp);
       computeKKBase->compute_per_grid_kokkos();
+      modify->invoke_end();
       ctemp->invoked_flag |= INVOKED_PER_GRID;
     }
 
@@ -141,9 +174,10 @@ void ComputeLambdaGridKokkos::compute_per_grid_kokkos()
       Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagComputeLambdaGrid_LoadTempVecFromArray>(0,nglocal),*this);
       copymode = 0;
     }
+  } else if (tempwhich == FIX && !ftemp->kokkos_flag) {
+    bridge_values(d_temp_vector,ftemp->vector_grid,ftemp->array_grid,tempindex,
+                  ftemp->size_per_grid_cols);
   } else if (tempwhich == FIX) {
-    if (!ftemp->kokkos_flag)
-      error->all(FLERR,"Cannot (yet) use non-Kokkos fixes with compute lambda/grid/kk");
     KokkosBase* computeKKBase = dynamic_cast<KokkosBase*>(ftemp);
     if (tempindex == 0)
       d_temp_vector = computeKKBase->d_vector;
@@ -165,10 +199,10 @@ void ComputeLambdaGridKokkos::compute_per_grid_kokkos()
 
   if (kflag == KNONE) {
     k_vector_grid.modify_device();
-    k_vector_grid.sync_host();
+    sparta->kokkos->sync_counted(k_vector_grid,Host,1);
   } else {
     k_array_grid.modify_device();
-    k_array_grid.sync_host();
+    sparta->kokkos->sync_counted(k_array_grid,Host,1);
   }
 }
 
@@ -224,6 +258,138 @@ void ComputeLambdaGridKokkos::operator()(TagComputeLambdaGrid_ComputePerGrid, co
   }
 }
 
+/* ----------------------------------------------------------------------
+   set d_nrho_vector, and d_temp_vector if requested,
+     from one loop over particles
+   same as ComputeLambdaGrid::tally_particles()
+------------------------------------------------------------------------- */
+
+void ComputeLambdaGridKokkos::tally_particles_kokkos()
+{
+  ParticleKokkos* particle_kk = (ParticleKokkos*) particle;
+  particle_kk->sync(Device,PARTICLE_MASK|SPECIES_MASK);
+  d_particles = particle_kk->k_particles.d_view;
+  d_species = particle_kk->k_species.d_view;
+  d_s2g = particle_kk->k_species2group.d_view;
+
+  GridKokkos* grid_kk = (GridKokkos*) grid;
+  grid_kk->sync(Device,CINFO_MASK|CELL_MASK);
+  d_cinfo = grid_kk->k_cinfo.d_view;
+  d_cells = grid_kk->k_cells.d_view;
+
+  fnum = update->fnum;
+  dtlevelflag = grid->dtlevelflag;
+  int nlocal = particle->nlocal;
+
+  // zero all accumulators
+
+  Kokkos::deep_copy(d_tally,0.0);
+
+  // loop over all particles, skip species not in mixture
+
+  need_dup = sparta->kokkos->need_dup<DeviceType>();
+
+  if (need_dup)
+    dup_tally = Kokkos::Experimental::create_scatter_view<typename Kokkos::Experimental::ScatterSum, typename Kokkos::Experimental::ScatterDuplicated>(d_tally);
+  else
+    ndup_tally = Kokkos::Experimental::create_scatter_view<typename Kokkos::Experimental::ScatterSum, typename Kokkos::Experimental::ScatterNonDuplicated>(d_tally);
+
+  copymode = 1;
+  if (sparta->kokkos->need_atomics)
+    Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagComputeLambdaGrid_TallyParticles<1> >(0,nlocal),*this);
+  else
+    Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagComputeLambdaGrid_TallyParticles<0> >(0,nlocal),*this);
+
+  if (need_dup) {
+    Kokkos::Experimental::contribute(d_tally, dup_tally);
+    dup_tally = decltype(dup_tally)(); // free duplicated memory
+  }
+
+  // convert tallies to nrho and temp of each cell
+
+  Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagComputeLambdaGrid_TallyToValues>(0,nglocal),*this);
+  copymode = 0;
+
+  d_particles = t_particle_1d(); // destroy reference to reduce memory use
+}
+
+/* ---------------------------------------------------------------------- */
+
+template<int NEED_ATOMICS>
+KOKKOS_INLINE_FUNCTION
+void ComputeLambdaGridKokkos::operator()(TagComputeLambdaGrid_TallyParticles<NEED_ATOMICS>, const int &i) const {
+
+  // The tally array is duplicated for OpenMP, atomic for CUDA, and neither for Serial
+
+  auto v_tally = ScatterViewHelper<typename NeedDup<NEED_ATOMICS,DeviceType>::value,decltype(dup_tally),decltype(ndup_tally)>::get(dup_tally,ndup_tally);
+  auto a_tally = v_tally.template access<typename AtomicDup<NEED_ATOMICS,DeviceType>::value>();
+
+  const int ispecies = d_particles[i].ispecies;
+  if (d_s2g(imix,ispecies) < 0) return;
+
+  const int icell = d_particles[i].icell;
+
+  // 6 tallies per particle: N, Mass, mVx, mVy, mVz, mV^2
+  // only N if temp is not tallied
+
+  a_tally(icell,0) += 1.0;
+  if (tempwhich != TALLY) return;
+
+  const double mass = d_species[ispecies].mass;
+  const double *v = d_particles[i].v;
+
+  a_tally(icell,1) += mass;
+  a_tally(icell,2) += mass*v[0];
+  a_tally(icell,3) += mass*v[1];
+  a_tally(icell,4) += mass*v[2];
+  a_tally(icell,5) += mass * (v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+}
+
+/* ---------------------------------------------------------------------- */
+
+KOKKOS_INLINE_FUNCTION
+void ComputeLambdaGridKokkos::operator()(TagComputeLambdaGrid_TallyToValues, const int &i) const {
+  const double count = d_tally(i,0);
+
+  if (d_cinfo[i].volume == 0.0) d_nrho_vector(i) = 0.0;
+  else {
+    double wt = fnum * d_cinfo[i].weight / d_cinfo[i].volume;
+    if (dtlevelflag) wt *= (double) (1 << d_cells[i].dtlevel);
+    d_nrho_vector(i) = wt * count;
+  }
+
+  if (tempwhich != TALLY) return;
+
+  if (count <= 1.0) d_temp_vector(i) = 0.0;
+  else {
+    const double mvx = d_tally(i,2);
+    const double mvy = d_tally(i,3);
+    const double mvz = d_tally(i,4);
+    double t = d_tally(i,5) - (mvx*mvx + mvy*mvy + mvz*mvz)/d_tally(i,1);
+    d_temp_vector(i) = t * tprefactor / count;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   copy per-grid values of a non-Kokkos compute or fix into device view
+   INDEX = 0 for vector, else column of array
+------------------------------------------------------------------------- */
+
+void ComputeLambdaGridKokkos::bridge_values(DAT::t_float_1d d_values,
+                                           double *vector, double **array,
+                                           int index, int ncols)
+{
+  if (nglocal == 0) return;
+
+  if (index == 0)
+    sparta->kokkos->bridge_to_device(k_bridge,vector,nglocal,1);
+  else
+    sparta->kokkos->bridge_to_device(k_bridge,&array[0][index-1],nglocal,ncols);
+
+  Kokkos::deep_copy(Kokkos::subview(d_values,std::make_pair(0,nglocal)),
+                    Kokkos::subview(k_bridge.d_view,std::make_pair(0,nglocal)));
+}
+
 /* ----------------------------------------------------------------------
    reallocate arrays if nglocal has changed
    called by init() and load balancer
@@ -246,4 +412,6 @@ void ComputeLambdaGridKokkos::reallocate()
   d_nrho_vector = DAT::t_float_1d ("d_nrho_vector", nglocal);
   if (tempwhich != NONE)
     d_temp_vector = DAT::t_float_1d ("d_temp_vector", nglocal);
+  if (nrhowhich == TALLY)
+    d_tally = DAT::t_float_2d_lr ("d_tally", nglocal, ntally);
 }
@@ -30,6 +30,10 @@ namespace SPARTA_NS {
   struct TagComputeLambdaGrid_LoadNrhoVecFromArray{};
   struct TagComputeLambdaGrid_LoadTempVecFromArray{};
   struct TagComputeLambdaGrid_ComputePerGrid{};
+  struct TagComputeLambdaGrid_TallyToValues{};
+
+  template<int NEED_ATOMICS>
+  struct TagComputeLambdaGrid_TallyParticles{};
   struct TagComputeLambdaGrid_Junk{};
 
   class ComputeLambdaGridKokkos : public ComputeLambdaGrid, public KokkosBase {
@@ -50,6 +54,13 @@ namespace SPARTA_NS {
     KOKKOS_INLINE_FUNCTION
     void operator()(TagComputeLambdaGrid_ComputePerGrid, const int&) const;
 
+    template<int NEED_ATOMICS>
+    KOKKOS_INLINE_FUNCTION
+    void operator()(TagComputeLambdaGrid_TallyParticles<NEED_ATOMICS>, const int&) const;
+
+    KOKKOS_INLINE_FUNCTION
+    void operator()(TagComputeLambdaGrid_TallyToValues, const int&) const;
+
     DAT::tdual_float_1d k_vector_grid;
     DAT::tdual_float_2d_lr k_array_grid;
 
@@ -60,6 +71,25 @@ namespace SPARTA_NS {
     int dimension;
     t_cell_1d d_cells;
 
+    DAT::tdual_float_1d k_bridge;     // host-only compute/fix values on device
+
+    // tallies of particles in mixture, when nrho is a mixture ID
+
+    DAT::t_float_2d_lr d_tally;
+    int need_dup;
+    Kokkos::Experimental::ScatterView<F_FLOAT**, typename DAT::t_float_2d_lr::array_layout,DeviceType,typename Kokkos::Experimental::ScatterSum,typename Kokkos::Experimental::ScatterDuplicated> dup_tally;
+    Kokkos::Experimental::ScatterView<F_FLOAT**, typename DAT::t_float_2d_lr::array_layout,DeviceType,typename Kokkos::Experimental::ScatterSum,typename Kokkos::Experimental::ScatterNonDuplicated> ndup_tally;
+
+    t_particle_1d d_particles;
+    t_species_1d d_species;
+    DAT::t_int_2d d_s2g;
+    t_cinfo_1d d_cinfo;
+    double fnum;
+    int dtlevelflag;
+
+    void bridge_values(DAT::t_float_1d, double *, double **, int, int);
+    void tally_particles_kokkos();
+
 };
 
 }
@@ -78,7 +78,7 @@ void ComputePFluxGridKokkos::compute_per_grid()
   } else {
     compute_per_grid_kokkos();
     k_tally.modify_device();
-    k_tally.sync_host();
+    sparta->kokkos->sync_counted(k_tally,Host,1);
   }
 }
 
@@ -68,10 +68,10 @@ void ComputePropertyGridKokkos::compute_per_grid()
     compute_per_grid_kokkos();
     if (nvalues == 1) {
       k_vector_grid.modify_device();
-      k_vector_grid.sync_host();
+      sparta->kokkos->sync_counted(k_vector_grid,Host,1);
     } else {
       k_array_grid.modify_device();
-      k_array_grid.sync_host();
+      sparta->kokkos->sync_counted(k_array_grid,Host,1);
     }
   }
 }
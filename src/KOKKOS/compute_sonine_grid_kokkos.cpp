@@ -85,7 +85,7 @@ void ComputeSonineGridKokkos::compute_per_grid()
   } else {
     compute_per_grid_kokkos();
     k_tally.modify_device();
-    k_tally.sync_host();
+    sparta->kokkos->sync_counted(k_tally,Host,1);
   }
 }
 
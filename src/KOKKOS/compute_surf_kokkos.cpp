@@ -41,6 +41,7 @@ ComputeSurfKokkos::ComputeSurfKokkos(SPARTA *sparta) :
   ComputeSurf(sparta)
 {
   hash = NULL;
+  stage = NULL;
   which = NULL;
   array_surf_tally = NULL;
   tally2surf = NULL;
@@ -62,7 +62,7 @@ void ComputeThermalGridKokkos::compute_per_grid()
   } else {
     compute_per_grid_kokkos();
     k_tally.modify_device();
-    k_tally.sync_host();
+    sparta->kokkos->sync_counted(k_tally,Host,1);
   }
 }
 
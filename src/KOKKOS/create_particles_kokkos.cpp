@@ -28,6 +28,7 @@
 #include "variable.h"
 #include "random_mars.h"
 #include "random_knuth.h"
+#include "random_counter.h"
 #include "math_const.h"
 #include "memory_kokkos.h"
 #include "error.h"
@@ -41,10 +42,26 @@ using namespace MathConst;
 enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};   // same as Grid
 
 #define EPSZERO 1.0e-14
+#define CHUNK 256            // global particles screened per device thread
+
+// same as RanCounter
+
+#define GAMMA 0x9e3779b97f4a7c15ULL
+#define STREAMBITS 32
+#define TWOM53 (1.0/9007199254740992.0)
 
 CreateParticlesKokkos::CreateParticlesKokkos(SPARTA* spa):
-  CreateParticles(spa)
+  CreateParticles(spa),
+  grid_kk_copy(spa)
+{
+  copymode = 0;
+}
+
+CreateParticlesKokkos::~CreateParticlesKokkos()
 {
+  if (copymode) return;
+
+  grid_kk_copy.uncopy();
 }
 
 void CreateParticlesKokkos::create_local(bigint np)
@@ -318,3 +335,137 @@ void CreateParticlesKokkos::create_local(bigint np)
   delete random;
 }
 
+/* ----------------------------------------------------------------------
+   create Np particles with the same result on any number of procs
+   device threads screen chunks of the Np sequence, each jumps straight
+     to its particles' RNG streams, keeps indices of those in owned cells
+   host then generates full particles for kept indices only,
+     so particles match create_global() of the non-KOKKOS class
+------------------------------------------------------------------------- */
+
+void CreateParticlesKokkos::create_global()
+{
+  RanCounter *random = global_setup();
+
+  GridKokkos* grid_kk = (GridKokkos*) grid;
+  grid_kk->k_plevels.modify_host();
+  grid_kk->k_plevels.sync_device();
+  grid_kk->update_hash();
+  grid_kk_copy.copy(grid_kk);
+
+  seed = random->seed;
+  ndraw = np;
+  nglocal = grid->nlocal;
+  dimension = domain->dimension;
+  for (int d = 0; d < 3; d++) {
+    boxlo[d] = domain->boxlo[d];
+    boxhi[d] = domain->boxhi[d];
+    prd[d] = domain->prd[d];
+  }
+
+  // pass 1: count owned particles in each chunk
+  // pass 2: store their global indices in order
+
+  int nchunk = static_cast<int> ((np + CHUNK - 1) / CHUNK);
+  d_count = Kokkos::View<int*,DeviceType>("create_particles:count",nchunk);
+
+  copymode = 1;
+  Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType,
+                       TagCreateParticles_GlobalCount>(0,nchunk),*this);
+
+  int nkeep;
+  d_offset = offset_scan(d_count,nkeep);
+  d_keep = Kokkos::View<bigint*,DeviceType>("create_particles:keep",nkeep);
+
+  Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType,
+                       TagCreateParticles_GlobalFill>(0,nchunk),*this);
+  copymode = 0;
+
+  auto h_keep = Kokkos::create_mirror_view(d_keep);
+  Kokkos::deep_copy(h_keep,d_keep);
+  d_count = Kokkos::View<int*,DeviceType>();
+  d_offset = Kokkos::View<int*,DeviceType>();
+  d_keep = Kokkos::View<bigint*,DeviceType>();
+
+  // add kept particles on host
+  // cell is found again on host in case device coords differ by round-off
+
+  particle->error_custom();
+  modify->list_init_fixes();
+  int nfix_update_custom = modify->n_update_custom;
+
+  ParticleKokkos* particle_kk = (ParticleKokkos*) particle;
+  particle_kk->sync(Host,PARTICLE_MASK|SPECIES_MASK|CUSTOM_MASK);
+  particle_kk->grow(nkeep);
+
+  int icell;
+  double x[3];
+
+  for (int i = 0; i < nkeep; i++) {
+    global_point(h_keep(i),random,x);
+    icell = grid->id_find_child(0,0,domain->boxlo,domain->boxhi,x);
+    if (icell < 0 || icell >= nglocal) continue;
+    global_add(icell,x,random,nfix_update_custom);
+  }
+
+  particle_kk->modify(Host,PARTICLE_MASK|CUSTOM_MASK);
+
+  delete random;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if coords of global particle M are in a cell I own
+   same coords as CreateParticles::global_point()
+------------------------------------------------------------------------- */
+
+KOKKOS_INLINE_FUNCTION
+int CreateParticlesKokkos::global_owned(bigint m) const
+{
+  double x[3],lo[3],hi[3];
+
+  uint64_t state = seed + ((uint64_t) m << STREAMBITS) * GAMMA;
+
+  for (int d = 0; d < 3; d++) {
+    state += GAMMA;
+    uint64_t z = state;
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    z ^= z >> 31;
+    x[d] = boxlo[d] + ((z >> 11) + 0.5) * TWOM53 * prd[d];
+    lo[d] = boxlo[d];
+    hi[d] = boxhi[d];
+  }
+  if (dimension == 2) x[2] = 0.0;
+
+  int icell = grid_kk_copy.obj.id_find_child(0,0,lo,hi,x);
+  return (icell >= 0 && icell < nglocal);
+}
+
+/* ---------------------------------------------------------------------- */
+
+KOKKOS_INLINE_FUNCTION
+void CreateParticlesKokkos::operator()(TagCreateParticles_GlobalCount,
+                                       const int ichunk) const
+{
+  bigint mstart = (bigint) ichunk * CHUNK;
+  bigint mstop = MIN(mstart + CHUNK,ndraw);
+
+  int n = 0;
+  for (bigint m = mstart; m < mstop; m++)
+    if (global_owned(m)) n++;
+  d_count(ichunk) = n;
+}
+
+/* ---------------------------------------------------------------------- */
+
+KOKKOS_INLINE_FUNCTION
+void CreateParticlesKokkos::operator()(TagCreateParticles_GlobalFill,
+                                       const int ichunk) const
+{
+  bigint mstart = (bigint) ichunk * CHUNK;
+  bigint mstop = MIN(mstart + CHUNK,ndraw);
+
+  int n = d_offset(ichunk);
+  for (bigint m = mstart; m < mstop; m++)
+    if (global_owned(m)) d_keep(n++) = m;
+}
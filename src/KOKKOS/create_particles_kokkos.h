@@ -22,16 +22,48 @@ CommandStyle(create_particles/kk,CreateParticlesKokkos)
 #define SPARTA_CREATE_PARTICLES_KOKKOS_H
 
 #include "create_particles.h"
+#include "kokkos_type.h"
+#include "grid_kokkos.h"
+#include "kokkos_copy.h"
 
 namespace SPARTA_NS {
 
+struct TagCreateParticles_GlobalCount{};
+struct TagCreateParticles_GlobalFill{};
+
 class CreateParticlesKokkos : public CreateParticles {
 
  public:
   CreateParticlesKokkos(class SPARTA *);
+  ~CreateParticlesKokkos();
 
   void create_local(bigint);
   void create_local_twopass(bigint np) { create_local(np); };
+  void create_global();
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(TagCreateParticles_GlobalCount, const int) const;
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(TagCreateParticles_GlobalFill, const int) const;
+
+ private:
+  int copymode;
+
+  // global particles are screened on device in chunks of the Np sequence,
+  // only indices of particles in owned cells are returned to host
+
+  KKCopy<GridKokkos> grid_kk_copy;
+  uint64_t seed;
+  bigint ndraw;
+  int nglocal,dimension;
+  double boxlo[3],boxhi[3],prd[3];
+
+  Kokkos::View<int*,DeviceType> d_count,d_offset;
+  Kokkos::View<bigint*,DeviceType> d_keep;
+
+  KOKKOS_INLINE_FUNCTION
+  int global_owned(bigint) const;
 };
 
 }
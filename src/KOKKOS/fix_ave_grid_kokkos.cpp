@@ -22,12 +22,15 @@
 #include "update.h"
 #include "modify.h"
 #include "compute.h"
+#include "fix.h"
 #include "input.h"
 #include "variable.h"
 #include "memory_kokkos.h"
 #include "error.h"
 #include "sparta_masks.h"
 #include "kokkos_base.h"
+#include "kokkos.h"
+#include "variable_kokkos.h"
 
 
 using namespace SPARTA_NS;
@@ -100,6 +103,10 @@ FixAveGridKokkos::FixAveGridKokkos(SPARTA *sparta, int narg, char **arg) :
   k_uomap.modify_host();
   k_uomap.sync_device();
   d_uomap = k_uomap.d_view;
+
+  // device evaluation of grid-style variables
+
+  variable_kk = new VariableKokkos(sparta);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -112,6 +119,7 @@ FixAveGridKokkos::~FixAveGridKokkos()
   else memoryKK->destroy_kokkos(k_array_grid,array_grid);
   memoryKK->destroy_kokkos(k_tally,tally);
   vector_grid = NULL;
+  delete variable_kk;
   array_grid = tally = NULL;
 }
 
@@ -126,6 +134,9 @@ void FixAveGridKokkos::init()
       int icompute = modify->find_compute(ids[m]);
       if (icompute < 0)
     error->all(FLERR,"Compute ID for fix ave/grid does not exist");
+      if (post_process[m] && !modify->compute[icompute]->kokkos_flag)
+        error->all(FLERR,"Cannot (yet) use non-Kokkos computes that "
+                   "post-process with fix ave/grid/kk");
       value2index[m] = icompute;
 
     } else if (which[m] == FIX) {
@@ -165,16 +176,20 @@ void FixAveGridKokkos::end_of_step()
   bigint ntimestep = update->ntimestep;
   if (ntimestep != nvalid) return;
 
-  // zero tally if ave = ONE and first sample
+  // zero tally if ave = ONE or reset requested and first sample
   // could do this with memset()
 
   copymode = 1;
-  if (ave == ONE && irepeat == 0)
+  if ((ave == ONE || resetflag) && irepeat == 0)
     Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagFixAveGrid_Zero_tally>(0,nglocal),*this);
 
+  if (resetflag && irepeat == 0) {
+    nsample = 0;
+    resetflag = 0;
+  }
+
   // accumulate results of computes,fixes,variables
   // compute/fix/variable may invoke computes so wrap with clear/add
-  // NOTE: add more logic for fixes and variables if enable them
 
   modify->clearstep_compute();
 
@@ -182,19 +197,32 @@ void FixAveGridKokkos::end_of_step()
     n = value2index[m];
     j = argindex[m];
 
-    if (which[m] == COMPUTE) {
+    // non-Kokkos compute is invoked on host, its values bridged to device
+
+    if (which[m] == COMPUTE && !modify->compute[n]->kokkos_flag) {
       Compute *compute = modify->compute[n];
-      if (!compute->kokkos_flag)
-        error->all(FLERR,"Cannot (yet) use non-Kokkos computes with fix ave/grid/kk");
-    }
+      if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(compute);
+        compute->compute_per_grid();
+        modify->invoke_end();
+        compute->invoked_flag |= INVOKED_PER_GRID;
+      }
+
+      k = umap[m][0];
+      if (j == 0) add_host_values(compute->vector_grid,1);
+      else if (nglocal)
+        add_host_values(&compute->array_grid[0][j-1],
+                        compute->size_per_grid_cols);
 
     // invoke compute if not previously invoked
 
-    if (which[m] == COMPUTE) {
+    } else if (which[m] == COMPUTE) {
       Compute *compute = modify->compute[n];
       KokkosBase* computeKKBase = dynamic_cast<KokkosBase*>(compute);
       if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(compute);
         computeKKBase->compute_per_grid_kokkos();
+        modify->invoke_end();
         compute->invoked_flag |= INVOKED_PER_GRID;
       }
 
@@ -219,25 +247,30 @@ void FixAveGridKokkos::end_of_step()
       }
 
     // access fix fields, guaranteed to be ready
+    // fields of non-Kokkos fix are bridged to device
 
     } else if (which[m] == FIX) {
-      error->all(FLERR,"Cannot (yet) use fixes with fix ave/grid/kk");
-      //k = umap[m][0];
-      //if (j == 0) {
-      //  double *d_fix_vector = modify->fix[n]->vector_grid; // need Kokkos version
-      //  Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagFixAveGrid_Add_fix_vector>(0,nglocal),*this);
-      //} else {
-      //  int jm1 = j - 1;
-      //  double **fix_array = modify->fix[n]->array_grid; // need Kokkos version
-      //  Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagFixAveGrid_Add_fix_array>(0,nglocal),*this);
-      //}
-
-    // evaluate grid-style variable, sum values to Kth column of tally array
+      Fix *fix = modify->fix[n];
+      KokkosBase* fixKKBase = dynamic_cast<KokkosBase*>(fix);
+      k = umap[m][0];
+      if (fix->kokkos_flag && fixKKBase) {
+        if (j == 0) {
+          d_fix_vector = fixKKBase->d_vector;
+          Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagFixAveGrid_Add_fix_vector>(0,nglocal),*this);
+        } else {
+          jm1 = j - 1;
+          d_fix_array = fixKKBase->d_array_grid;
+          Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagFixAveGrid_Add_fix_array>(0,nglocal),*this);
+        }
+      } else if (j == 0) add_host_values(fix->vector_grid,1);
+      else if (nglocal)
+        add_host_values(&fix->array_grid[0][j-1],fix->size_per_grid_cols);
+
+    // evaluate grid-style variable on device, sum to Kth column of tally
 
     } else if (which[m] == VARIABLE) {
-      error->all(FLERR,"Cannot (yet) use variables with fix ave/grid/kk");
-      //k = umap[m][0];
-      //input->variable->compute_grid(n,&tally[0][k],ntotal,1); // need Kokkos version
+      k = umap[m][0];
+      variable_kk->compute_grid(n,Kokkos::subview(d_tally,Kokkos::ALL(),k),1);
     }
 
   }
@@ -390,6 +423,20 @@ void FixAveGridKokkos::operator()(TagFixAveGrid_Norm_array_grid, const int &i) c
   d_array_grid(i,m) = d_tally(i,k) / nsample;
 }
 
+/* ----------------------------------------------------------------------
+   add per-grid values of a host-only compute or fix to Kth column of tally
+   values are bridged to device with stride between successive cells
+------------------------------------------------------------------------- */
+
+void FixAveGridKokkos::add_host_values(double *values, int stride)
+{
+  if (nglocal == 0) return;
+
+  sparta->kokkos->bridge_to_device(k_bridge,values,nglocal,stride);
+  d_compute_vector = k_bridge.d_view;
+  Kokkos::parallel_for(Kokkos::RangePolicy<DeviceType, TagFixAveGrid_Add_compute_vector>(0,nglocal),*this);
+}
+
 /* ----------------------------------------------------------------------
    insure per-cell arrays are allocated long enough for N new cells
 ------------------------------------------------------------------------- */
@@ -397,7 +444,7 @@ void FixAveGridKokkos::operator()(TagFixAveGrid_Norm_array_grid, const int &i) c
 void FixAveGridKokkos::grow_percell(int nnew)
 {
   if (nglocal+nnew < maxgrid) return;
-  maxgrid += DELTAGRID;
+  while (maxgrid < nglocal+nnew) maxgrid += DELTAGRID;
   int n = maxgrid;
 
   if (nvalues == 1) {
@@ -100,9 +100,13 @@ class FixAveGridKokkos : public FixAveGrid, public KokkosBase {
   DAT::tdual_float_2d k_umap,k_uomap;
   DAT::t_float_2d d_umap,d_uomap;
 
+  DAT::tdual_float_1d k_bridge;     // host-only compute/fix values on device
+  class VariableKokkos *variable_kk;
+
   int j,k,kk,jm1,m,ntally;
 
   void grow_percell(int);
+  void add_host_values(double *, int);
 };
 
 }
@@ -171,4 +175,10 @@ E: Fix ave/grid variable is not grid-style variable
 
 Self-explanatory.
 
+E: Cannot (yet) use non-Kokkos computes that post-process with fix ave/grid/kk
+
+Values of computes without a Kokkos version are copied from host to
+device each sample, but normalization of post-processed tallies
+must be done by the Kokkos version of the compute.
+
 */
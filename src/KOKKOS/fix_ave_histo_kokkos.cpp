@@ -37,6 +37,8 @@
 #include "memory.h"
 #include "memory_kokkos.h"
 #include "error.h"
+#include "kokkos.h"
+#include "variable_kokkos.h"
 
 using namespace SPARTA_NS;
 
@@ -68,6 +70,11 @@ FixAveHistoKokkos::FixAveHistoKokkos(SPARTA *spa, int narg, char **arg) :
   memoryKK->grow_kokkos(k_bin, bin, nbins, "ave/histo:bin");
   d_bin = k_bin.d_view;
 
+  region_device = 0;
+  rmask = NULL;
+  maxrmask = 0;
+
+  variable_kk = new VariableKokkos(sparta);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -78,6 +85,8 @@ FixAveHistoKokkos::~FixAveHistoKokkos()
 
   k_stats = DAT::tdual_float_1d();
   memoryKK->destroy_kokkos(k_bin, bin);
+  memory->destroy(rmask);
+  delete variable_kk;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -152,8 +161,15 @@ void FixAveHistoKokkos::end_of_step()
     k_bin.sync_device();
   }
 
+  s_bin = Kokkos::Experimental::create_scatter_view(d_bin);
+  s_stats = Kokkos::Experimental::create_scatter_view(d_stats);
+
+  if (regionflag && kind == PERPARTICLE) setup_region();
+
+  // each value is reduced separately, then merged into minmax
+
   minmax_type::value_type minmax;
-  minmax_type reducer(minmax);
+  minmax_type(minmax).init(minmax);
 
   // accumulate results of computes,fixes,variables to local copy
   // compute/fix/variable may invoke computes so wrap with clear/add
@@ -173,6 +189,10 @@ void FixAveHistoKokkos::end_of_step()
     m = value2index[i];
     j = argindex[i];
 
+    minmax_type::value_type vminmax;
+    minmax_type reducer(vminmax);
+    reducer.init(vminmax);
+
     // invoke compute if not previously invoked
 
     if (which[i] == COMPUTE) {
@@ -184,30 +204,38 @@ void FixAveHistoKokkos::end_of_step()
       if (kind == GLOBAL && mode == SCALAR) {
         if (j == 0) {
           if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+            modify->invoke_begin(compute);
             compute->compute_scalar();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_SCALAR;
           }
-          bin_scalar(minmax, compute->scalar);
+          bin_scalar(vminmax, compute->scalar);
         }
         else {
           error->all(FLERR,"Compute kind not compatible with fix ave/histo/kk");
           if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+            modify->invoke_begin(compute);
             compute->compute_vector();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_VECTOR;
           }
-          bin_scalar(minmax, compute->vector[j-1]);
+          bin_scalar(vminmax, compute->vector[j-1]);
         }
       } else if (kind == GLOBAL && mode == VECTOR) {
           error->all(FLERR,"Compute kind not compatible with fix ave/histo/kk");
         if (j == 0) {
           if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+            modify->invoke_begin(compute);
             compute->compute_vector();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_VECTOR;
           }
           bin_vector(reducer, compute->size_vector,compute->vector,1);
         } else {
           if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+            modify->invoke_begin(compute);
             compute->compute_array();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_ARRAY;
           }
           if (compute->array)
@@ -215,9 +243,11 @@ void FixAveHistoKokkos::end_of_step()
                        compute->size_array_cols);
         }
       } else if (kind == PERPARTICLE) {
-          error->all(FLERR,"Compute kind not compatible with fix ave/histo/kk");
         if (!(compute->invoked_flag & INVOKED_PER_PARTICLE)) {
+          modify->invoke_begin(compute);
+          particle_kk->sync(Host, PARTICLE_MASK|SPECIES_MASK);
           compute->compute_per_particle();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_PER_PARTICLE;
         }
         if (j == 0)
@@ -227,7 +257,9 @@ void FixAveHistoKokkos::end_of_step()
                         compute->size_per_particle_cols);
       } else if (kind == PERGRID) {
         if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+          modify->invoke_begin(compute);
           computeKKBase->compute_per_grid_kokkos();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_PER_GRID;
         }
 
@@ -259,27 +291,27 @@ void FixAveHistoKokkos::end_of_step()
 
       if (kind == GLOBAL && mode == SCALAR) {
         if (j == 0) {
-          bin_scalar(minmax, fix->compute_scalar());
+          bin_scalar(vminmax, fix->compute_scalar());
         }
         else {
           error->all(FLERR,"Fix not compatible with fix ave/histo/kk");
-          bin_scalar(minmax, fix->compute_vector(j-1));
+          bin_scalar(vminmax, fix->compute_vector(j-1));
         }
       } else if (kind == GLOBAL && mode == VECTOR) {
         error->all(FLERR,"Fix not compatible with fix ave/histo/kk");
         if (j == 0) {
           int n = fix->size_vector;
-          for (i = 0; i < n; i++) bin_scalar(minmax, fix->compute_vector(i));
+          for (int k = 0; k < n; k++) bin_scalar(vminmax, fix->compute_vector(k));
         } else {
           int n = fix->size_vector;
-          for (i = 0; i < n; i++) bin_scalar(minmax, fix->compute_array(i,j-1));
+          for (int k = 0; k < n; k++) bin_scalar(vminmax, fix->compute_array(k,j-1));
         }
 
       } else if (kind == PERPARTICLE) {
-        error->all(FLERR,"Fix not compatible with fix ave/histo/kk");
         if (j == 0) bin_particles(reducer, fix->vector_particle,1);
         else if (fix->array_particle)
-          bin_particles(reducer, fix->array_particle[j-1],fix->size_per_particle_cols);
+          bin_particles(reducer, &fix->array_particle[0][j-1],
+                        fix->size_per_particle_cols);
       } else if (kind == PERGRID) {
         if (j == 0) {
           bin_grid_cells(reducer, fixKKBase->d_vector);
@@ -294,10 +326,12 @@ void FixAveHistoKokkos::end_of_step()
       }
 
     // evaluate equal-style or particle-style or grid-style variable
+    // particle-style variables are evaluated on host
+    // grid-style variables are evaluated on device when possible
+
     } else if (which[i] == VARIABLE) {
-      error->all(FLERR,"Cannot (yet) use variables with fix ave/histo/kk");
       if (kind == GLOBAL && mode == SCALAR) {
-        bin_scalar(minmax, input->variable->compute_equal(m));
+        bin_scalar(vminmax, input->variable->compute_equal(m));
 
       } else if (which[i] == VARIABLE && kind == PERPARTICLE) {
         if (particle->maxlocal > maxvector) {
@@ -305,24 +339,30 @@ void FixAveHistoKokkos::end_of_step()
           maxvector = particle->maxlocal;
           memory->create(vector,maxvector,"ave/histo:vector");
         }
+        particle_kk->sync(Host, PARTICLE_MASK|SPECIES_MASK);
         input->variable->compute_particle(m,vector,1,0);
         bin_particles(reducer, vector,1);
 
       } else if (which[i] == VARIABLE && kind == PERGRID) {
-        if (grid->maxlocal > maxvector) {
-          memory->destroy(vector);
-          maxvector = grid->maxlocal;
-          memory->create(vector,maxvector,"ave/histo:vector");
-        }
-        input->variable->compute_grid(m,vector,1,0);
-        //bin_grid_cells(reducer, vector);
+        if ((int) d_vargrid.extent(0) < grid->nlocal)
+          d_vargrid = DAT::t_float_1d("ave/histo:vargrid",grid->maxlocal);
+        variable_kk->compute_grid(m,d_vargrid,0);
+        bin_grid_cells(reducer, d_vargrid);
       }
     } else {
       // explicit per-particle attributes
       bin_particles(reducer, which[i], j);
     }
+
+    minmax.min_val = MIN(minmax.min_val,vminmax.min_val);
+    minmax.max_val = MAX(minmax.max_val,vminmax.max_val);
   }
 
+  Kokkos::Experimental::contribute(d_bin, s_bin);
+  Kokkos::Experimental::contribute(d_stats, s_stats);
+  s_bin = decltype(s_bin)();     // free duplicated memory
+  s_stats = decltype(s_stats)();
+
   k_stats.modify_device();
   k_stats.sync_host();
 
@@ -471,7 +511,26 @@ double FixAveHistoKokkos::compute_array(int i, int j)
 ------------------------------------------------------------------------- */
 void FixAveHistoKokkos::bin_scalar(minmax_type::value_type& minmax, double val)
 {
-  bin_one(minmax, val);
+  bin_one_device(minmax, val, 1.0);
+}
+
+/* ----------------------------------------------------------------------
+   bin a single host value with weight, bins live on device
+------------------------------------------------------------------------- */
+void FixAveHistoKokkos::bin_one_device(minmax_type::value_type& minmax,
+                                       double val, double wt)
+{
+  scalar_value = val;
+  scalar_weight = wt;
+
+  minmax_type::value_type lminmax;
+  minmax_type lreducer(lminmax);
+  lreducer.init(lminmax);
+  auto policy = Kokkos::RangePolicy<TagFixAveHisto_BinScalar,DeviceType>(0, 1);
+  Kokkos::parallel_reduce(policy, *this, lreducer);
+
+  minmax.min_val = MIN(minmax.min_val,lminmax.min_val);
+  minmax.max_val = MAX(minmax.max_val,lminmax.max_val);
 }
 
 /* ----------------------------------------------------------------------
@@ -503,21 +562,14 @@ void FixAveHistoKokkos::bin_particles(
   this->index = index;
   int n = particle->nlocal;
 
-  // FIXME: Kokkos version of region
-  //Region *region;
-  //if (regionflag) region = domain->regions[iregion];
-
-  if (regionflag)
-    error->all(FLERR,"Cannot (yet) use regionflag with fix ave/histo/kk");
-
   if (attribute == X) {
 
     if (regionflag && mixflag) {
-      //auto policy = RangePolicy<TagFixAveHisto_BinParticlesX1,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHisto_BinParticlesX1,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (regionflag) {
-      //auto policy = RangePolicy<TagFixAveHisto_BinParticlesX2,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHisto_BinParticlesX2,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (mixflag) {
       auto policy = RangePolicy<TagFixAveHisto_BinParticlesX3,DeviceType>(0, n);
       Kokkos::parallel_reduce(policy, *this, reducer);
@@ -529,11 +581,11 @@ void FixAveHistoKokkos::bin_particles(
   } else if (attribute == V) {
 
     if (regionflag && mixflag) {
-      //auto policy = RangePolicy<TagFixAveHisto_BinParticlesV1,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHisto_BinParticlesV1,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (regionflag) {
-      //auto policy = RangePolicy<TagFixAveHisto_BinParticlesV2,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHisto_BinParticlesV2,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (mixflag) {
       auto policy = RangePolicy<TagFixAveHisto_BinParticlesV3,DeviceType>(0, n);
       Kokkos::parallel_reduce(policy, *this, reducer);
@@ -551,28 +603,33 @@ void FixAveHistoKokkos::bin_particles(
     minmax_type& reducer,
     double *values, int stride)
 {
-  using Kokkos::RangePolicy;
   using FixKokkosDetails::mirror_view_from_raw_host_array;
 
   this->stride = stride;
   int n = particle->nlocal;
 
-  d_values = mirror_view_from_raw_host_array<double,DeviceType>(values, n, stride);
+  bin_particles(reducer,
+                mirror_view_from_raw_host_array<double,DeviceType>(values, n, stride));
+}
 
-  // FIXME: Kokkos version of region
-  // FIXME: Does values need to be made a view that lives on Device?
-  //Region *region;
-  //if (regionflag) region = domain->regions[iregion];
+/* ----------------------------------------------------------------------
+   bin a per-particle vector of values already on device
+------------------------------------------------------------------------- */
+void FixAveHistoKokkos::bin_particles(
+    minmax_type& reducer,
+    DAT::t_float_1d_strided d_vec)
+{
+  using Kokkos::RangePolicy;
 
-  if (regionflag)
-    error->all(FLERR,"Cannot (yet) use regionflag with fix ave/histo/kk");
+  int n = particle->nlocal;
+  d_values = d_vec;
 
   if (regionflag && mixflag) {
-    //auto policy = RangePolicy<TagFixAveHisto_BinParticles1,DeviceType>(0, n);
-    //Kokkos::parallel_reduce(policy, *this, reducer);
+    auto policy = RangePolicy<TagFixAveHisto_BinParticles1,DeviceType>(0, n);
+    Kokkos::parallel_reduce(policy, *this, reducer);
   } else if (regionflag) {
-    //auto policy = RangePolicy<TagFixAveHisto_BinParticles2,DeviceType>(0, n);
-    //Kokkos::parallel_reduce(policy, *this, reducer);
+    auto policy = RangePolicy<TagFixAveHisto_BinParticles2,DeviceType>(0, n);
+    Kokkos::parallel_reduce(policy, *this, reducer);
   } else if (mixflag) {
     auto policy = RangePolicy<TagFixAveHisto_BinParticles3,DeviceType>(0, n);
     Kokkos::parallel_reduce(policy, *this, reducer);
@@ -607,6 +664,37 @@ void FixAveHistoKokkos::bin_grid_cells(
 }
 
 
+/* ----------------------------------------------------------------------
+   prepare region test for per-particle binning
+   region styles without a Kokkos version are matched on host,
+     the resulting mask is bridged to device
+------------------------------------------------------------------------- */
+
+void FixAveHistoKokkos::setup_region()
+{
+  Region *region = domain->regions[iregion];
+  region_device = region_kk.init(region);
+  if (region_device) return;
+
+  ParticleKokkos* particle_kk = (ParticleKokkos*) particle;
+  particle_kk->sync(Host, PARTICLE_MASK);
+
+  Particle::OnePart *particles = particle->particles;
+  int nlocal = particle->nlocal;
+
+  if (nlocal > maxrmask) {
+    memory->destroy(rmask);
+    maxrmask = particle->maxlocal;
+    memory->create(rmask,maxrmask,"ave/histo:rmask");
+  }
+
+  for (int i = 0; i < nlocal; i++)
+    rmask[i] = region->match(particles[i].x);
+
+  sparta->kokkos->bridge_to_device(k_rmask,rmask,nlocal,1);
+  d_rmask = k_rmask.d_view;
+}
+
 /* ----------------------------------------------------------------------
    calculate nvalid = next step on which end_of_step does something
    can be this timestep if multiple of nfreq and nrepeat = 1
@@ -626,6 +714,15 @@ bigint FixAveHistoKokkos::nextvalid()
   return nvalid;
 }
 
+/* ------------------------------------------------------------------------- */
+KOKKOS_INLINE_FUNCTION
+void
+FixAveHistoKokkos::operator()(TagFixAveHisto_BinScalar, const int,
+                              minmax_type::value_type& lminmax) const
+{
+  bin_one(lminmax, scalar_value, scalar_weight);
+}
+
 /* ------------------------------------------------------------------------- */
 KOKKOS_INLINE_FUNCTION
 void
@@ -641,17 +738,11 @@ void
 FixAveHistoKokkos::operator()(TagFixAveHisto_BinParticles1, const int i,
                               minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
   const int ispecies = d_particles(i).ispecies;
-  if (region_kk->match(d_particles(i).x) && d_s2g(imix, ispecies) >= 0)
+  if (region_match(i) && d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_values(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -660,16 +751,10 @@ void
 FixAveHistoKokkos::operator()(TagFixAveHisto_BinParticles2, const int i,
                               minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible.
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
-  if (region_kk->match(d_particles(i).x))
+  if (region_match(i))
   {
     bin_one(lminmax, d_values(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -679,7 +764,7 @@ FixAveHistoKokkos::operator()(TagFixAveHisto_BinParticles3, const int i,
                               minmax_type::value_type& lminmax) const
 {
   const int ispecies = d_particles(i).ispecies;
-  if (d_s2g(imix, ispecies) < 0)
+  if (d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_values(i));
   }
@@ -721,17 +806,11 @@ void
 FixAveHistoKokkos::operator()(TagFixAveHisto_BinParticlesX1, const int i,
                               minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
   const int ispecies = d_particles(i).ispecies;
-  if (region_kk->match(d_particles(i).x) && d_s2g(imix, ispecies) < 0)
+  if (region_match(i) && d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_particles(i).x[index]);
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -740,16 +819,10 @@ void
 FixAveHistoKokkos::operator()(TagFixAveHisto_BinParticlesX2, const int i,
                               minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
-  if (region_kk->match(d_particles(i).x))
+  if (region_match(i))
   {
     bin_one(lminmax, d_particles(i).x[index]);
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -780,17 +853,11 @@ void
 FixAveHistoKokkos::operator()(TagFixAveHisto_BinParticlesV1, const int i,
                               minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
   const int ispecies = d_particles(i).ispecies;
-  if (region_kk->match(d_particles(i).x) && d_s2g(imix, ispecies) < 0)
+  if (region_match(i) && d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_particles(i).v[index]);
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -799,16 +866,10 @@ void
 FixAveHistoKokkos::operator()(TagFixAveHisto_BinParticlesV2, const int i,
                               minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
-  if (region_kk->match(d_particles(i).x))
+  if (region_match(i))
   {
     bin_one(lminmax, d_particles(i).v[index]);
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -24,10 +24,12 @@ FixStyle(ave/histo/kk, FixAveHistoKokkos)
 #include "fix_ave_histo.h"
 #include "kokkos_type.h"
 #include "grid_kokkos.h"
+#include "region_kokkos.h"
 
 namespace SPARTA_NS
 {
 
+struct TagFixAveHisto_BinScalar {};
 struct TagFixAveHisto_BinVector {};
 struct TagFixAveHisto_BinParticles1 {};
 struct TagFixAveHisto_BinParticles2 {};
@@ -79,6 +81,9 @@ public:
   double compute_vector(int);
   double compute_array(int, int);
 
+  KOKKOS_INLINE_FUNCTION void
+  operator()(TagFixAveHisto_BinScalar, const int, minmax_type::value_type&) const;
+
   KOKKOS_INLINE_FUNCTION void
   operator()(TagFixAveHisto_BinVector, const int, minmax_type::value_type&) const;
 
@@ -132,6 +137,14 @@ protected:
   DAT::tdual_float_1d k_bin;
   DAT::t_float_1d d_bin;
 
+  // bins and stats are accumulated via scatter views,
+  // thread-private copies on host threads, atomics on GPUs
+
+  Kokkos::Experimental::ScatterView<double*, DAT::t_float_1d::array_layout,
+                                    DeviceType> s_bin,s_stats;
+
+  double scalar_value,scalar_weight;  // single value binned by BinScalar
+
   t_particle_1d d_particles;
   DAT::t_int_2d d_s2g;
 
@@ -143,6 +156,18 @@ protected:
   // data used by ave/histo/weight/kk
   DAT::t_float_1d_strided d_weights;
 
+  // region matched on device, else per-particle mask computed on host
+
+  RegionKokkos region_kk;
+  int region_device;
+  DAT::tdual_float_1d k_rmask;
+  DAT::t_float_1d d_rmask;
+  double *rmask;
+  int maxrmask;
+
+  class VariableKokkos *variable_kk;
+  DAT::t_float_1d d_vargrid;         // grid-style variable values
+
   // methods
   using FixAveHisto::bin_one;
   using FixAveHisto::bin_vector;
@@ -153,13 +178,28 @@ protected:
   virtual void bin_vector(minmax_type&, int, double *, int);
   virtual void bin_particles(minmax_type&, int, int);
   virtual void bin_particles(minmax_type&, double *, int);
+  virtual void bin_particles(minmax_type&, DAT::t_float_1d_strided);
   virtual void bin_grid_cells(minmax_type&, DAT::t_float_1d_strided);
 
+  void bin_one_device(mm_value_type&, double, double);
+  void setup_region();
+
   virtual void calculate_weights() {}
 
   void options(int, int, char **);
   bigint nextvalid();
 
+  /* ----------------------------------------------------------------------
+     1 if particle I is in region, only called when regionflag is set
+     ----------------------------------------------------------------------- */
+  KOKKOS_INLINE_FUNCTION
+  int
+  region_match(const int i) const
+  {
+    if (region_device) return region_kk.match(d_particles(i).x);
+    return (d_rmask(i) != 0.0);
+  }
+
   /* ----------------------------------------------------------------------
      bin a single value with weight
      ----------------------------------------------------------------------- */
@@ -167,30 +207,33 @@ protected:
   void
   bin_one(mm_value_type& mm_v, double value, double weight) const
   {
-    auto nbins = d_bin.extent(0);
+    auto a_bin = s_bin.access();
+    auto a_stats = s_stats.access();
+
+    const int nbins = d_bin.extent(0);
     if (value < mm_v.min_val) mm_v.min_val = value;
     if (value > mm_v.max_val) mm_v.max_val = value;
     if (value < lo) {
       if (beyond == 0 /*IGNORE*/) {
-        Kokkos::atomic_add(&d_stats(1), weight);
+        a_stats(1) += weight;
         return;
       } else {
-        Kokkos::atomic_add(&d_bin(0), weight);
+        a_bin(0) += weight;
       }
     } else if (value > hi) {
       if (beyond == 0 /*IGNORE*/) {
-        Kokkos::atomic_add(&d_stats(1), weight);
+        a_stats(1) += weight;
         return;
       } else {
-        Kokkos::atomic_add(&d_bin(nbins-1), weight);
+        a_bin(nbins-1) += weight;
       }
     } else {
       int ibin = static_cast<int>((value - lo) * bininv);
       ibin = MIN(ibin, nbins-1);
       if (beyond == 2 /*EXTRA*/) ibin++;
-      Kokkos::atomic_add(&d_bin(ibin), weight);
+      a_bin(ibin) += weight;
     }
-    Kokkos::atomic_add(&d_stats(0), weight);
+    a_stats(0) += weight;
   }
 
   KOKKOS_INLINE_FUNCTION
@@ -36,6 +36,7 @@
 #include "variable.h"
 #include "memory.h"
 #include "error.h"
+#include "variable_kokkos.h"
 
 using namespace SPARTA_NS;
 
@@ -137,14 +138,18 @@ void FixAveHistoWeightKokkos::calculate_weights()
     if (kind == GLOBAL && mode == SCALAR) {
       if (j == 0) {
         if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+          modify->invoke_begin(compute);
           compute->compute_scalar();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_SCALAR;
         }
         weight = compute->scalar;
       } else {
         error->all(FLERR,"Compute not compatible with fix ave/histo/kk");
         if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+          modify->invoke_begin(compute);
           compute->compute_vector();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_VECTOR;
         }
         weight = compute->vector[j-1];
@@ -153,14 +158,18 @@ void FixAveHistoWeightKokkos::calculate_weights()
       error->all(FLERR,"Compute not compatible with fix ave/histo/kk");
       if (j == 0) {
         if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+          modify->invoke_begin(compute);
           compute->compute_vector();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_VECTOR;
         }
         weights = compute->vector;
         stridewt = 1;
       } else {
         if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+          modify->invoke_begin(compute);
           compute->compute_array();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_ARRAY;
         }
         if (compute->array) weights = &compute->array[0][j-1];
@@ -168,9 +177,11 @@ void FixAveHistoWeightKokkos::calculate_weights()
       }
 
     } else if (kind == PERPARTICLE) {
-      error->all(FLERR,"Compute not compatible with fix ave/histo/kk");
       if (!(compute->invoked_flag & INVOKED_PER_PARTICLE)) {
+        modify->invoke_begin(compute);
+        ((ParticleKokkos*) particle)->sync(Host, PARTICLE_MASK|SPECIES_MASK);
         compute->compute_per_particle();
+        modify->invoke_end();
         compute->invoked_flag |= INVOKED_PER_PARTICLE;
       }
       if (j == 0) {
@@ -183,7 +194,9 @@ void FixAveHistoWeightKokkos::calculate_weights()
 
     } else if (kind == PERGRID) {
       if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(compute);
         computeKKBase->compute_per_grid_kokkos();
+        modify->invoke_end();
         compute->invoked_flag |= INVOKED_PER_GRID;
       }
       if (j == 0) {
@@ -220,12 +233,11 @@ void FixAveHistoWeightKokkos::calculate_weights()
       }
 
     } else if (kind == PERPARTICLE) {
-      error->all(FLERR,"Fix not compatible with fix ave/histo/weight/kk");
       if (j == 0) {
         weights = fix->vector_particle;
         stridewt = 1;
       } else if (fix->array_particle) {
-        weights = fix->array_particle[j-1];
+        weights = &fix->array_particle[0][j-1];
         stridewt = fix->size_per_particle_cols;
       }
 
@@ -240,7 +252,6 @@ void FixAveHistoWeightKokkos::calculate_weights()
   // evaluate equal-style or particle-style or grid-style variable
 
   } else if (which[i] == VARIABLE) {
-    error->all(FLERR,"Cannot (yet) use variables with fix ave/histo/weight/kk");
     if (kind == GLOBAL && mode == SCALAR) {
       weight = input->variable->compute_equal(m);
 
@@ -250,27 +261,29 @@ void FixAveHistoWeightKokkos::calculate_weights()
         maxvectorwt = particle->maxlocal;
         memory->create(vectorwt,maxvectorwt,"ave/histo/weight:vectorwt");
       }
+      ((ParticleKokkos*) particle)->sync(Host, PARTICLE_MASK|SPECIES_MASK);
       input->variable->compute_particle(m,vectorwt,1,0);
       weights = vectorwt;
       stridewt = 1;
 
     } else if (which[i] == VARIABLE && kind == PERGRID) {
-      if (grid->maxlocal > maxvectorwt) {
-        memory->destroy(vectorwt);
-        maxvectorwt = grid->maxlocal;
-        memory->create(vectorwt,maxvectorwt,"ave/histo/weight:vectorwt");
-      }
-      input->variable->compute_grid(m,vectorwt,1,0);
-      weights = vectorwt;
-      stridewt = 1;
+      if ((int) d_vargridwt.extent(0) < grid->nlocal)
+        d_vargridwt = DAT::t_float_1d("ave/histo/weight:vargrid",grid->maxlocal);
+      variable_kk->compute_grid(m,d_vargridwt,0);
+      d_weights = d_vargridwt;
     }
 
   // explicit per-particle attributes
   // NOTE: need to allocate local storage
   } else {
-    printf("%d, %d\n", which[i] == VARIABLE, kind == PERGRID);
     error->all(FLERR,"Fix ave/histo/weight/kokkos option not yet supported");
   }
+
+  // per-particle weights computed on host are mirrored to device
+
+  if (kind == PERPARTICLE && weights)
+    d_weights = FixKokkosDetails::mirror_view_from_raw_host_array<double,DeviceType>
+      (weights, particle->nlocal, stridewt);
 }
 
 /* ----------------------------------------------------------------------
@@ -280,7 +293,7 @@ void FixAveHistoWeightKokkos::bin_scalar(
     typename minmax_type::value_type& minmax,
     double value)
 {
-  bin_one(minmax, value, weight);
+  bin_one_device(minmax, value, weight);
 }
 
 /* ----------------------------------------------------------------------
@@ -313,21 +326,14 @@ void FixAveHistoWeightKokkos::bin_particles(
   this->index = index;
   int n = particle->nlocal;
 
-  // FIXME: Kokkos version of region
-  //Region *region;
-  //if (regionflag) region = domain->regions[iregion];
-
-  if (regionflag)
-    error->all(FLERR,"Cannot (yet) use regionflag with fix ave/histo/kk");
-
   if (attribute == X) {
 
     if (regionflag && mixflag) {
-      //auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesX1,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesX1,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (regionflag) {
-      //auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesX2,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesX2,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (mixflag) {
       auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesX3,DeviceType>(0, n);
       Kokkos::parallel_reduce(policy, *this, reducer);
@@ -339,11 +345,11 @@ void FixAveHistoWeightKokkos::bin_particles(
   } else if (attribute == V) {
 
     if (regionflag && mixflag) {
-      //auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesV1,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesV1,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (regionflag) {
-      //auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesV2,DeviceType>(0, n);
-      //Kokkos::parallel_reduce(policy, *this, reducer);
+      auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesV2,DeviceType>(0, n);
+      Kokkos::parallel_reduce(policy, *this, reducer);
     } else if (mixflag) {
       auto policy = RangePolicy<TagFixAveHistoWeight_BinParticlesV3,DeviceType>(0, n);
       Kokkos::parallel_reduce(policy, *this, reducer);
@@ -361,28 +367,33 @@ void FixAveHistoWeightKokkos::bin_particles(
     minmax_type& reducer,
     double *values, int stride)
 {
-  using Kokkos::RangePolicy;
   using FixKokkosDetails::mirror_view_from_raw_host_array;
 
   this->stride = stride;
   int n = particle->nlocal;
 
-  d_values = mirror_view_from_raw_host_array<double,DeviceType>(values, n, stride);
+  bin_particles(reducer,
+                mirror_view_from_raw_host_array<double,DeviceType>(values, n, stride));
+}
 
-  // FIXME: Kokkos version of region
-  // FIXME: Does values need to be made a view that lives on Device?
-  //Region *region;
-  //if (regionflag) region = domain->regions[iregion];
+/* ----------------------------------------------------------------------
+   bin a per-particle vector of values already on device
+------------------------------------------------------------------------- */
+void FixAveHistoWeightKokkos::bin_particles(
+    minmax_type& reducer,
+    DAT::t_float_1d_strided d_vec)
+{
+  using Kokkos::RangePolicy;
 
-  if (regionflag)
-    error->all(FLERR,"Cannot (yet) use regionflag with fix ave/histo/kk");
+  int n = particle->nlocal;
+  d_values = d_vec;
 
   if (regionflag && mixflag) {
-    //auto policy = RangePolicy<TagFixAveHistoWeight_BinParticles1,DeviceType>(0, n);
-    //Kokkos::parallel_reduce(policy, *this, reducer);
+    auto policy = RangePolicy<TagFixAveHistoWeight_BinParticles1,DeviceType>(0, n);
+    Kokkos::parallel_reduce(policy, *this, reducer);
   } else if (regionflag) {
-    //auto policy = RangePolicy<TagFixAveHistoWeight_BinParticles2,DeviceType>(0, n);
-    //Kokkos::parallel_reduce(policy, *this, reducer);
+    auto policy = RangePolicy<TagFixAveHistoWeight_BinParticles2,DeviceType>(0, n);
+    Kokkos::parallel_reduce(policy, *this, reducer);
   } else if (mixflag) {
     auto policy = RangePolicy<TagFixAveHistoWeight_BinParticles3,DeviceType>(0, n);
     Kokkos::parallel_reduce(policy, *this, reducer);
@@ -432,17 +443,11 @@ void
 FixAveHistoWeightKokkos::operator()(TagFixAveHistoWeight_BinParticles1, const int i,
                                     minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
   const int ispecies = d_particles(i).ispecies;
-  if (region_kk->match(d_particles(i).x) && d_s2g(imix, ispecies) >= 0)
+  if (region_match(i) && d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_values(i), d_weights(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -451,16 +456,10 @@ void
 FixAveHistoWeightKokkos::operator()(TagFixAveHistoWeight_BinParticles2, const int i,
                                     minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible.
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
-  if (region_kk->match(d_particles(i).x))
+  if (region_match(i))
   {
     bin_one(lminmax, d_values(i), d_weights(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -470,7 +469,7 @@ FixAveHistoWeightKokkos::operator()(TagFixAveHistoWeight_BinParticles3, const in
                                     minmax_type::value_type& lminmax) const
 {
   const int ispecies = d_particles(i).ispecies;
-  if (d_s2g(imix, ispecies) < 0)
+  if (d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_values(i), d_weights(i));
   }
@@ -512,17 +511,11 @@ void
 FixAveHistoWeightKokkos::operator()(TagFixAveHistoWeight_BinParticlesX1, const int i,
                                     minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
   const int ispecies = d_particles(i).ispecies;
-  if (region_kk->match(d_particles(i).x) && d_s2g(imix, ispecies) < 0)
+  if (region_match(i) && d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_particles(i).x[index], d_weights(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -531,16 +524,10 @@ void
 FixAveHistoWeightKokkos::operator()(TagFixAveHistoWeight_BinParticlesX2, const int i,
                                     minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
-  if (region_kk->match(d_particles(i).x))
+  if (region_match(i))
   {
     bin_one(lminmax, d_particles(i).x[index], d_weights(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -571,17 +558,11 @@ void
 FixAveHistoWeightKokkos::operator()(TagFixAveHistoWeight_BinParticlesV1, const int i,
                                     minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
   const int ispecies = d_particles(i).ispecies;
-  if (region_kk->match(d_particles(i).x) && d_s2g(imix, ispecies) < 0)
+  if (region_match(i) && d_s2g(imix, ispecies) >= 0)
   {
     bin_one(lminmax, d_particles(i).v[index], d_weights(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -590,16 +571,10 @@ void
 FixAveHistoWeightKokkos::operator()(TagFixAveHistoWeight_BinParticlesV2, const int i,
                                     minmax_type::value_type& lminmax) const
 {
-  /*
-   * region is not Kokkos compatible
-   * If a Kokkos compatible region becomes available,
-   * this code can be recommissioned.
-   *
-  if (region_kk->match(d_particles(i).x))
+  if (region_match(i))
   {
     bin_one(lminmax, d_particles(i).v[index], d_weights(i));
   }
-  */
 }
 
 /* ------------------------------------------------------------------------- */
@@ -94,6 +94,7 @@ class FixAveHistoWeightKokkos : public FixAveHistoKokkos {
 
  private:
   int stridewt;
+  DAT::t_float_1d d_vargridwt;       // grid-style variable weights
 
   using FixAveHisto::bin_one;
   using FixAveHisto::bin_vector;
@@ -108,6 +109,7 @@ class FixAveHistoWeightKokkos : public FixAveHistoKokkos {
   void bin_vector(minmax_type&, int, double *, int);
   void bin_particles(minmax_type&, int, int);
   void bin_particles(minmax_type&, double *, int);
+  void bin_particles(minmax_type&, DAT::t_float_1d_strided);
   void bin_grid_cells(minmax_type&, DAT::t_float_1d_strided);
 
   void calculate_weights();
@@ -51,6 +51,18 @@ void FixSurfTempKokkos::init()
   surf_kk->modify(Host,SURF_CUSTOM_MASK);
 }
 
+/* ---------------------------------------------------------------------- */
+
+void FixSurfTempKokkos::setup()
+{
+  SurfKokkos* surf_kk = (SurfKokkos*) surf;
+  surf_kk->sync(Host,LINE_MASK|TRI_MASK|SURF_CUSTOM_MASK);
+
+  FixSurfTemp::setup();
+
+  surf_kk->modify(Host,SURF_CUSTOM_MASK);
+}
+
 /* ----------------------------------------------------------------------
    compute new surface element temperatures based on heat flux
    only invoked once every Nevery steps
@@ -65,3 +77,15 @@ void FixSurfTempKokkos::end_of_step()
 
   surf_kk->modify(Host,SURF_CUSTOM_MASK);
 }
+
+/* ---------------------------------------------------------------------- */
+
+void FixSurfTempKokkos::grid_changed()
+{
+  SurfKokkos* surf_kk = (SurfKokkos*) surf;
+  surf_kk->sync(Host,LINE_MASK|TRI_MASK|SURF_CUSTOM_MASK);
+
+  FixSurfTemp::grid_changed();
+
+  surf_kk->modify(Host,SURF_CUSTOM_MASK);
+}
@@ -31,7 +31,9 @@ class FixSurfTempKokkos : public FixSurfTemp {
   FixSurfTempKokkos(class SPARTA *, int, char **);
   virtual ~FixSurfTempKokkos();
   void init();
+  void setup();
   void end_of_step();
+  void grid_changed();
 };
 
 }
@@ -42,6 +42,7 @@ void FixTempRescaleKokkos::end_of_step_no_average(double t_target_in)
   // loop over grid cells and twice over particles in each cell
   // 1st pass: calc thermal temp via same logic as in ComputeThermalGrid
   // 2nd pass: rescale thermal velocity components
+  // both passes stream over the cell's contiguous row of d_plist
 
   ParticleKokkos* particle_kk = (ParticleKokkos*) particle;
   particle_kk->sync(Device,PARTICLE_MASK|SPECIES_MASK);
@@ -71,6 +72,7 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_no_average,
   // loop over grid cells with more than 1 particle
 
   double totmass,mvx,mvy,mvz,mvsq;
+  double erot,rotdof,evib,vibdof;
   double *v;
 
   const int count = d_cellcount[icell];
@@ -79,9 +81,11 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_no_average,
   totmass = 0.0;
   mvx = mvy = mvz = 0.0;
   mvsq = 0.0;
+  erot = rotdof = evib = vibdof = 0.0;
 
   // 1st pass: loop over particles in cell
   // 5 tallies per particle: Mass, mVx, mVy, mVz, mV^2
+  // plus Erot, rot DOF, Evib, vib DOF if requested
 
   for (int n = 0; n < count; n++) {
     const int ip = d_plist(icell,n);
@@ -95,6 +99,15 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_no_average,
     mvy += mass*v[1];
     mvz += mass*v[2];
     mvsq += mass * (v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+
+    if (rotflag) {
+      erot += d_particles[ip].erot;
+      rotdof += d_species[ispecies].rotdof;
+    }
+    if (vibflag) {
+      evib += d_particles[ip].evib;
+      vibdof += d_species[ispecies].vibdof;
+    }
   }
 
   // COM velocity of particles in grid cell
@@ -111,20 +124,25 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_no_average,
 
   // vscale = scale factor for thermal velocity components
 
+  // rscale,bscale = scale factors for rotational,vibrational energies
+
   const double vscale = sqrt(t_target/t_current);
+  const double rscale = rotflag ? t_target/t_internal_kk(erot,rotdof) : 1.0;
+  const double bscale = vibflag ? t_target/t_internal_kk(evib,vibdof) : 1.0;
 
   // 2nd pass: loop over particles in cell
   // rescale thermal velocity components
 
   for (int n = 0; n < count; n++) {
     const int ip = d_plist(icell,n);
-    const int ispecies = d_particles[ip].ispecies;
-    const double mass = d_species[ispecies].mass;
     v = d_particles[ip].v;
 
     v[0] = vscale*(v[0]-vxcom) + vxcom;
     v[1] = vscale*(v[1]-vycom) + vycom;
     v[2] = vscale*(v[2]-vzcom) + vzcom;
+
+    if (rotflag) d_particles[ip].erot *= rscale;
+    if (vibflag) d_particles[ip].evib *= bscale;
   }
 }
 
@@ -188,6 +206,14 @@ void FixTempRescaleKokkos::end_of_step_average(double t_target_in)
   t_current /= n_current;
   vscale = sqrt(t_target/t_current);
 
+  // rscale,bscale = likewise for rotational,vibrational energies
+
+  double trot_current,tvib_current;
+  MPI_Allreduce(&current_mine.trot,&trot_current,1,MPI_DOUBLE,MPI_SUM,world);
+  MPI_Allreduce(&current_mine.tvib,&tvib_current,1,MPI_DOUBLE,MPI_SUM,world);
+  rscale = rotflag ? t_target / (trot_current/n_current) : 1.0;
+  bscale = vibflag ? t_target / (tvib_current/n_current) : 1.0;
+
   // loop over grid cells to rescale velocity of particles in each
   // single-particle cells are also rescaled, their d_vcom = 0.0
 
@@ -203,6 +229,7 @@ KOKKOS_INLINE_FUNCTION
 void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_average1, const int &icell, REDUCE &current_mine) const {
 
   double totmass,mvx,mvy,mvz,mvsq;
+  double erot,rotdof,evib,vibdof;
   double t_one;
   double *v;
 
@@ -212,9 +239,11 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_average1, co
   totmass = 0.0;
   mvx = mvy = mvz = 0.0;
   mvsq = 0.0;
+  erot = rotdof = evib = vibdof = 0.0;
 
   // loop over particles in cell
   // 5 tallies per particle: Mass, mVx, mVy, mVz, mV^2
+  // plus Erot, rot DOF, Evib, vib DOF if requested
 
   for (int n = 0; n < count; n++) {
     const int ip = d_plist(icell,n);
@@ -227,6 +256,15 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_average1, co
     mvy += mass*v[1];
     mvz += mass*v[2];
     mvsq += mass * (v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+
+    if (rotflag) {
+      erot += d_particles[ip].erot;
+      rotdof += d_species[ispecies].rotdof;
+    }
+    if (vibflag) {
+      evib += d_particles[ip].evib;
+      vibdof += d_species[ispecies].vibdof;
+    }
   }
 
   // t_one = thermal T of particles in the cell
@@ -256,6 +294,8 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_average1, co
   // accumulate thermal T over my cells
 
   current_mine.t += t_one;
+  if (rotflag) current_mine.trot += t_internal_kk(erot,rotdof);
+  if (vibflag) current_mine.tvib += t_internal_kk(evib,vibdof);
   current_mine.n++;
 }
 
@@ -272,12 +312,24 @@ void FixTempRescaleKokkos::operator()(TagFixTempRescale_end_of_step_average2, co
 
   for (int n = 0; n < count; n++) {
     const int ip = d_plist(icell,n);
-    const int ispecies = d_particles[ip].ispecies;
-    const double mass = d_species[ispecies].mass;
     double* v = d_particles[ip].v;
 
     v[0] = vscale*(v[0]-d_vcom(icell,0)) + d_vcom(icell,0);
     v[1] = vscale*(v[1]-d_vcom(icell,1)) + d_vcom(icell,1);
     v[2] = vscale*(v[2]-d_vcom(icell,2)) + d_vcom(icell,2);
+
+    if (rotflag) d_particles[ip].erot *= rscale;
+    if (vibflag) d_particles[ip].evib *= bscale;
   }
 }
+
+/* ----------------------------------------------------------------------
+   same as FixTempRescale::t_internal(), with t_target stored in class
+------------------------------------------------------------------------- */
+
+KOKKOS_INLINE_FUNCTION
+double FixTempRescaleKokkos::t_internal_kk(double esum, double dofsum) const
+{
+  if (dofsum == 0.0 || esum == 0.0) return t_target;
+  return rvprefactor * esum/dofsum;
+}
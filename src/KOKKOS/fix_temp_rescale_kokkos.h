@@ -35,16 +35,18 @@ class FixTempRescaleKokkos : public FixTempRescale {
 
   struct REDUCE {
     bigint n;
-    double t;
+    double t,trot,tvib;
     KOKKOS_INLINE_FUNCTION
     REDUCE() {
       n = 0;
-      t = 0.0;
+      t = trot = tvib = 0.0;
     }
     KOKKOS_INLINE_FUNCTION
     REDUCE& operator+=(const REDUCE &rhs) {
       n += rhs.n;
       t += rhs.t;
+      trot += rhs.trot;
+      tvib += rhs.tvib;
       return *this;
     }
 
@@ -52,6 +54,8 @@ class FixTempRescaleKokkos : public FixTempRescale {
     void operator+=(const volatile REDUCE &rhs) volatile {
       n += rhs.n;
       t += rhs.t;
+      trot += rhs.trot;
+      tvib += rhs.tvib;
     }
   };
 
@@ -68,7 +72,7 @@ class FixTempRescaleKokkos : public FixTempRescale {
   void operator()(TagFixTempRescale_end_of_step_average2, const int&) const;
 
  private:
-  double t_target,vscale;
+  double t_target,vscale,rscale,bscale;
 
   DAT::t_float_1d_3 d_vcom;
 
@@ -81,6 +85,9 @@ class FixTempRescaleKokkos : public FixTempRescale {
 
   void end_of_step_no_average(double);
   void end_of_step_average(double);
+
+  KOKKOS_INLINE_FUNCTION
+  double t_internal_kk(double, double) const;
 };
 
 }
@@ -62,6 +62,8 @@ enum{NOWEIGHT,VOLWEIGHT,RADWEIGHT,RADUNWEIGHT};
 
 GridKokkos::GridKokkos(SPARTA *sparta) : Grid(sparta)
 {
+  stale_host = stale_device = 0;
+
   delete [] plevels;
   memoryKK->create_kokkos(k_plevels,plevels,MAXLEVEL,"grid:plevels");
 }
@@ -292,6 +294,9 @@ void GridKokkos::wrap_kokkos()
 
 void GridKokkos::sync(ExecutionSpace space, unsigned int mask)
 {
+  KokkosSPARTA *kk = sparta->kokkos;
+  unsigned int stale;
+
   if (sparta->kokkos->prewrap) {
     if (space == Device)
       error->one(FLERR,"Sync Device before wrap");
@@ -302,17 +307,23 @@ void GridKokkos::sync(ExecutionSpace space, unsigned int mask)
   if (space == Device) {
     if (sparta->kokkos->auto_sync)
       modify(Host,mask);
-    if (mask & CELL_MASK) k_cells.sync_device();
-    if (mask & CINFO_MASK) k_cinfo.sync_device();
-    if (mask & PCELL_MASK) k_pcells.sync_device();
-    if (mask & SINFO_MASK) k_sinfo.sync_device();
-    if (mask & PLEVEL_MASK) k_plevels.sync_device();
+    stale = mask & stale_device;
+    stale_device &= ~mask;
+    if (mask & CELL_MASK) kk->sync_counted(k_cells,Device,stale & CELL_MASK);
+    if (mask & CINFO_MASK) kk->sync_counted(k_cinfo,Device,stale & CINFO_MASK);
+    if (mask & PCELL_MASK) kk->sync_counted(k_pcells,Device,stale & PCELL_MASK);
+    if (mask & SINFO_MASK) kk->sync_counted(k_sinfo,Device,stale & SINFO_MASK);
+    if (mask & PLEVEL_MASK)
+      kk->sync_counted(k_plevels,Device,stale & PLEVEL_MASK);
   } else {
-    if (mask & CELL_MASK) k_cells.sync_host();
-    if (mask & CINFO_MASK) k_cinfo.sync_host();
-    if (mask & PCELL_MASK) k_pcells.sync_host();
-    if (mask & SINFO_MASK) k_sinfo.sync_host();
-    if (mask & PLEVEL_MASK) k_plevels.sync_host();
+    stale = mask & stale_host;
+    stale_host &= ~mask;
+    if (mask & CELL_MASK) kk->sync_counted(k_cells,Host,stale & CELL_MASK);
+    if (mask & CINFO_MASK) kk->sync_counted(k_cinfo,Host,stale & CINFO_MASK);
+    if (mask & PCELL_MASK) kk->sync_counted(k_pcells,Host,stale & PCELL_MASK);
+    if (mask & SINFO_MASK) kk->sync_counted(k_sinfo,Host,stale & SINFO_MASK);
+    if (mask & PLEVEL_MASK)
+      kk->sync_counted(k_plevels,Host,stale & PLEVEL_MASK);
   }
 }
 
@@ -328,6 +339,8 @@ void GridKokkos::modify(ExecutionSpace space, unsigned int mask)
   }
 
   if (space == Device) {
+    stale_host |= mask;
+    stale_device &= ~mask;
     if (mask & CELL_MASK) k_cells.modify_device();
     if (mask & CINFO_MASK) k_cinfo.modify_device();
     if (mask & PCELL_MASK) k_pcells.modify_device();
@@ -336,6 +349,8 @@ void GridKokkos::modify(ExecutionSpace space, unsigned int mask)
     if (sparta->kokkos->auto_sync)
       sync(Host,mask);
   } else {
+    stale_device |= mask;
+    stale_host &= ~mask;
     if (mask & CELL_MASK) k_cells.modify_host();
     if (mask & CINFO_MASK) k_cinfo.modify_host();
     if (mask & PCELL_MASK) k_pcells.modify_host();
@@ -168,6 +168,9 @@ class GridKokkos : public Grid {
   hash_type hash_kk;
 
  private:
+  unsigned int stale_host;      // masks of data modified in other space
+  unsigned int stale_device;    //   since last sync, for sync accounting
+
   void grow_cells(int, int);
   void grow_sinfo(int);
   void grow_pcells();
@@ -21,6 +21,10 @@
 #include "sparta.h"
 #include "error.h"
 #include "memory_kokkos.h"
+#include "modify.h"
+#include "fix.h"
+#include "compute.h"
+#include "comm.h"
 
 using namespace SPARTA_NS;
 
@@ -168,6 +172,14 @@ KokkosSPARTA::KokkosSPARTA(SPARTA *sparta, int narg, char **arg) : Pointers(spar
   react_retry_flag = 0;
   react_extra = 1.1;
 
+  nbridge = bridge_bytes = 0;
+
+  sync_audit = 0;
+  sync_owner = SYNC_OTHER;
+  nsync_owner = nsync_fix = 0;
+  sync_count = sync_bytes = sync_invoke = NULL;
+  sync_depth = 0;
+
   // finalize Kokkos on abort
 
   signal(SIGABRT, my_signal_handler);
@@ -177,6 +189,10 @@ KokkosSPARTA::KokkosSPARTA(SPARTA *sparta, int narg, char **arg) : Pointers(spar
 
 KokkosSPARTA::~KokkosSPARTA()
 {
+  delete [] sync_count;
+  delete [] sync_bytes;
+  delete [] sync_invoke;
+
   // finalize Kokkos
 
   Kokkos::finalize();
@@ -229,10 +245,196 @@ void KokkosSPARTA::accelerator(int narg, char **arg)
         gpu_aware_flag = 0;
       } else error->all(FLERR,"Illegal package kokkos command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"sync/audit") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal package kokkos command");
+      if (strcmp(arg[iarg+1],"yes") == 0) {
+        sync_audit = 1;
+      } else if (strcmp(arg[iarg+1],"no") == 0) {
+        sync_audit = 0;
+      } else error->all(FLERR,"Illegal package kokkos command");
+      iarg += 2;
     } else error->all(FLERR,"Illegal package kokkos command");
   }
 }
 
+/* ----------------------------------------------------------------------
+   copy N values of host-only data with stride into device view of k_data
+   used when a Kokkos style consumes a compute/fix/variable with no
+     Kokkos version, counted so the extra data motion can be reported
+------------------------------------------------------------------------- */
+
+void KokkosSPARTA::bridge_to_device(DAT::tdual_float_1d &k_data,
+                                    double *data, int n, int stride)
+{
+  if ((int) k_data.extent(0) < n) k_data.resize(n);
+
+  k_data.sync_host();
+  for (int i = 0; i < n; i++)
+    k_data.h_view(i) = data[i*stride];
+  k_data.modify_host();
+  k_data.sync_device();
+
+  nbridge++;
+  bridge_bytes += (bigint) n * sizeof(double);
+}
+
+/* ----------------------------------------------------------------------
+   zero sync accounting at start of a run
+   one counter per fix and compute plus output, comm, and other
+------------------------------------------------------------------------- */
+
+void KokkosSPARTA::sync_setup()
+{
+  delete [] sync_count;
+  delete [] sync_bytes;
+  delete [] sync_invoke;
+
+  nsync_fix = modify->nfix;
+  nsync_owner = modify->nfix + modify->ncompute + NSYNC_EXTRA;
+  sync_count = new bigint[nsync_owner];
+  sync_bytes = new bigint[nsync_owner];
+  sync_invoke = new bigint[nsync_owner];
+  for (int i = 0; i < nsync_owner; i++)
+    sync_count[i] = sync_bytes[i] = sync_invoke[i] = 0;
+
+  nbridge = bridge_bytes = 0;
+  sync_owner = SYNC_OTHER;
+  sync_depth = 0;
+}
+
+/* ----------------------------------------------------------------------
+   make owner the current owner while a fix or compute is invoked
+   previous owner is restored by sync_end(), calls can nest
+------------------------------------------------------------------------- */
+
+void KokkosSPARTA::sync_begin(int owner)
+{
+  if (sync_depth < SYNC_MAXNEST) sync_stack[sync_depth] = sync_owner;
+  sync_depth++;
+  sync_owner = owner;
+
+  if (owner >= 0 && owner < nsync_owner-NSYNC_EXTRA) sync_invoke[owner]++;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void KokkosSPARTA::sync_end()
+{
+  sync_depth--;
+  if (sync_depth < SYNC_MAXNEST) sync_owner = sync_stack[sync_depth];
+}
+
+/* ----------------------------------------------------------------------
+   charge bytes moved by one DualView sync to current owner
+------------------------------------------------------------------------- */
+
+void KokkosSPARTA::sync_tally(bigint nbytes)
+{
+  if (nsync_owner == 0) return;
+
+  // extra owners are stored after fixes and computes, SYNC_OTHER last
+
+  int m;
+  if (sync_owner >= 0 && sync_owner < nsync_owner-NSYNC_EXTRA) m = sync_owner;
+  else if (sync_owner < 0 && sync_owner >= -NSYNC_EXTRA)
+    m = nsync_owner + sync_owner;
+  else m = nsync_owner-1;
+
+  sync_count[m]++;
+  sync_bytes[m] += nbytes;
+}
+
+/* ----------------------------------------------------------------------
+   print data moved between host and device during a run of nsteps
+   invoked by Finish, summed across procs
+   if sync/audit is set, warn about host-only fixes and computes
+     invoked at least once every SYNC_AUDIT_EVERY steps
+------------------------------------------------------------------------- */
+
+void KokkosSPARTA::sync_summary(int nsteps)
+{
+  if (nsync_owner == 0) return;
+
+  bigint *count = new bigint[nsync_owner];
+  bigint *bytes = new bigint[nsync_owner];
+  bigint *invoke = new bigint[nsync_owner];
+  MPI_Allreduce(sync_count,count,nsync_owner,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  MPI_Allreduce(sync_bytes,bytes,nsync_owner,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  MPI_Allreduce(sync_invoke,invoke,nsync_owner,MPI_SPARTA_BIGINT,MPI_MAX,world);
+
+  bigint bridge[2],bridge_all[2];
+  bridge[0] = nbridge;
+  bridge[1] = bridge_bytes;
+  MPI_Allreduce(bridge,bridge_all,2,MPI_SPARTA_BIGINT,MPI_SUM,world);
+
+  if (comm->me == 0) {
+    double steps = MAX(nsteps,1);
+    const char *hdr = "\nKokkos host/device syncs:\n"
+      "Owner                    |   syncs    |   Mbytes   | Mbytes/step\n"
+      "-----------------------------------------------------------------\n";
+    const char *fmt = "%-24s |%- 12.10g|%- 12.4g|%- 12.4g\n";
+    char name[64];
+
+    FILE *fp[2] = {screen,logfile};
+    for (int k = 0; k < 2; k++) {
+      if (!fp[k]) continue;
+      fputs(hdr,fp[k]);
+      for (int m = 0; m < nsync_owner; m++) {
+        if (count[m] == 0) continue;
+        sync_name(m,name);
+        fprintf(fp[k],fmt,name,(double) count[m],bytes[m]/1.0e6,
+                bytes[m]/1.0e6/steps);
+      }
+      if (bridge_all[0])
+        fprintf(fp[k],fmt,"bridge to device",
+                (double) bridge_all[0],
+                bridge_all[1]/1.0e6,bridge_all[1]/1.0e6/steps);
+    }
+
+    // hot path = invoked on average at least once every SYNC_AUDIT_EVERY steps
+    // styles invoked less often, e.g. only on output steps, are not reported
+
+    if (sync_audit) {
+      char str[256];
+      for (int m = 0; m < nsync_owner-NSYNC_EXTRA; m++) {
+        if (invoke[m] == 0 || steps/invoke[m] > SYNC_AUDIT_EVERY) continue;
+        int kokkos_flag;
+        if (m < nsync_fix) kokkos_flag = modify->fix[m]->kokkos_flag;
+        else kokkos_flag = modify->compute[m-nsync_fix]->kokkos_flag;
+        if (kokkos_flag) continue;
+        sync_name(m,name);
+        snprintf(str,256,"%s has no Kokkos version and was invoked "
+                 "every %g steps, moving %g Mbytes",
+                 name,steps/invoke[m],bytes[m]/1.0e6);
+        error->warning(FLERR,str);
+      }
+    }
+  }
+
+  delete [] count;
+  delete [] bytes;
+  delete [] invoke;
+}
+
+/* ----------------------------------------------------------------------
+   name of sync owner M for summary output
+------------------------------------------------------------------------- */
+
+void KokkosSPARTA::sync_name(int m, char *name)
+{
+  if (m < nsync_fix) {
+    Fix *fix = modify->fix[m];
+    snprintf(name,64,"fix %s %s",fix->id,fix->style);
+  } else if (m < nsync_owner-NSYNC_EXTRA) {
+    Compute *compute = modify->compute[m-nsync_fix];
+    snprintf(name,64,"compute %s %s",compute->id,compute->style);
+  } else if (m == nsync_owner+SYNC_OUTPUT) strcpy(name,"output");
+  else if (m == nsync_owner+SYNC_COMM) strcpy(name,"particle comm");
+  else strcpy(name,"other");
+}
+
+/* ---------------------------------------------------------------------- */
+
 void KokkosSPARTA::my_signal_handler(int sig)
 {
   if (sig == SIGABRT) Kokkos::finalize();
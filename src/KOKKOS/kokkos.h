@@ -34,9 +34,47 @@ class KokkosSPARTA : protected Pointers {
   int react_retry_flag;
   double react_extra;
 
+  bigint nbridge;           // # of host-to-device copies of host-only data
+  bigint bridge_bytes;      // bytes moved by those copies
+
+  // accounting of DualView syncs that move data during a run
+  // each sync is charged to the fix, compute, output, or particle comm
+  //   currently being invoked
+  // owners are fixes, then computes, then the SYNC enums
+
+  enum{SYNC_OTHER=-1,SYNC_OUTPUT=-2,SYNC_COMM=-3};
+  enum{NSYNC_EXTRA=3,SYNC_MAXNEST=16,SYNC_AUDIT_EVERY=10};
+
+  int sync_audit;           // 1 to warn about host-only styles in hot path
+  int sync_owner;           // owner index or one of SYNC enums
+
   KokkosSPARTA(class SPARTA *, int, char **);
   ~KokkosSPARTA();
   void accelerator(int, char **);
+  void bridge_to_device(DAT::tdual_float_1d &, double *, int, int);
+  void sync_setup();
+  void sync_begin(int);
+  void sync_end();
+  void sync_summary(int);
+
+  // sync one DualView to space, tally its bytes if it was out of date
+  // stale = set by caller from its own modify() calls, since DualView
+  //   flags are not kept when host and device share memory
+
+  template<class DualView>
+  void sync_counted(DualView &k_data, ExecutionSpace space, int stale)
+  {
+    bigint nbytes = k_data.d_view.span() *
+      sizeof(typename DualView::t_dev::value_type);
+
+    if (space == Device) {
+      if (stale || k_data.need_sync_device()) sync_tally(nbytes);
+      k_data.sync_device();
+    } else {
+      if (stale || k_data.need_sync_host()) sync_tally(nbytes);
+      k_data.sync_host();
+    }
+  }
 
   template<class DeviceType>
   int need_dup()
@@ -50,6 +88,17 @@ class KokkosSPARTA : protected Pointers {
   }
 
  private:
+  int nsync_owner;          // # of fixes + computes + NSYNC_EXTRA
+  int nsync_fix;            // # of fixes when accounting was set up
+  bigint *sync_count;       // # of data-moving syncs per owner
+  bigint *sync_bytes;       // bytes moved per owner
+  bigint *sync_invoke;      // # of times each owner was invoked
+
+  int sync_depth;           // nesting depth of sync_begin() calls
+  int sync_stack[SYNC_MAXNEST];  // owners saved by sync_begin()
+
+  void sync_tally(bigint);
+  void sync_name(int, char *);
   static void my_signal_handler(int);
 };
 
@@ -59,6 +108,13 @@ class KokkosSPARTA : protected Pointers {
 
 /* ERROR/WARNING messages:
 
+W: %s has no Kokkos version and was invoked every %g steps, moving %g Mbytes
+
+The fix or compute was invoked on average at least once every 10
+steps during the run, and the data it caused to be copied between
+host and device is listed.  This warning is printed when the
+sync/audit option of the package kokkos command is enabled.
+
 E: Invalid Kokkos command-line args
 
 Self-explanatory.  See Section ? of the manual for details.
@@ -25,6 +25,7 @@
 #include "error.h"
 #include "particle_kokkos.h"
 #include "grid_kokkos.h"
+#include "comm.h"
 #include "kokkos.h"
 
 using namespace SPARTA_NS;
@@ -53,33 +54,51 @@ ModifyKokkos::~ModifyKokkos()
 
 /* ----------------------------------------------------------------------
    start-of-timestep call, only for relevant fixes
+   only call fix->start_of_step() on the next step it was scheduled for
+   then reschedule the invoked fixes and reset next_start_of_step
 ------------------------------------------------------------------------- */
 
 void ModifyKokkos::start_of_step()
 {
+  bigint ntimestep = update->ntimestep;
+  if (ntimestep < next_start_of_step) return;
+
+  next_start_of_step = MAXBIGINT;
   for (int i = 0; i < n_start_of_step; i++) {
-    int j = list_start_of_step[i];
-    particle_kk->sync(fix[j]->execution_space,fix[j]->datamask_read);
-    int prev_auto_sync = sparta->kokkos->auto_sync;
-    if (!fix[j]->kokkos_flag) sparta->kokkos->auto_sync = 1;
+    if (start_of_step_next[i] == ntimestep) {
+      int j = list_start_of_step[i];
+      sparta->kokkos->sync_begin(j);
+      particle_kk->sync(fix[j]->execution_space,fix[j]->datamask_read);
+      int prev_auto_sync = sparta->kokkos->auto_sync;
+      if (!fix[j]->kokkos_flag) sparta->kokkos->auto_sync = 1;
 
-    fix[list_start_of_step[i]]->start_of_step();
+      fix[list_start_of_step[i]]->start_of_step();
 
-    sparta->kokkos->auto_sync = prev_auto_sync;
-    particle_kk->modify(fix[j]->execution_space,fix[j]->datamask_modify);
+      sparta->kokkos->auto_sync = prev_auto_sync;
+      particle_kk->modify(fix[j]->execution_space,fix[j]->datamask_modify);
+      sparta->kokkos->sync_end();
+      start_of_step_next[i] = next_step_fix(0,start_of_step_every[i]);
+    }
+    next_start_of_step = MIN(next_start_of_step,start_of_step_next[i]);
   }
 }
 
 /* ----------------------------------------------------------------------
    end-of-timestep call, only for relevant fixes
-   only call fix->end_of_step() on timesteps that are multiples of nevery
+   only call fix->end_of_step() on the next step it was scheduled for
+   then reschedule the invoked fixes and reset next_end_of_step
 ------------------------------------------------------------------------- */
 
 void ModifyKokkos::end_of_step()
 {
-  for (int i = 0; i < n_end_of_step; i++)
-    if (update->ntimestep % end_of_step_every[i] == 0) {
+  bigint ntimestep = update->ntimestep;
+  if (ntimestep < next_end_of_step) return;
+
+  next_end_of_step = MAXBIGINT;
+  for (int i = 0; i < n_end_of_step; i++) {
+    if (end_of_step_next[i] == ntimestep) {
       int j = list_end_of_step[i];
+      sparta->kokkos->sync_begin(j);
       particle_kk->sync(fix[j]->execution_space,fix[j]->datamask_read);
       int prev_auto_sync = sparta->kokkos->auto_sync;
       if (!fix[j]->kokkos_flag) sparta->kokkos->auto_sync = 1;
@@ -88,7 +107,12 @@ void ModifyKokkos::end_of_step()
 
       sparta->kokkos->auto_sync = prev_auto_sync;
       particle_kk->modify(fix[j]->execution_space,fix[j]->datamask_modify);
+      sparta->kokkos->sync_end();
+      end_of_step_next[i] =
+        next_step_fix(fix[j]->next_end_of_step(),end_of_step_every[i]);
     }
+    next_end_of_step = MIN(next_end_of_step,end_of_step_next[i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -175,6 +199,26 @@ void ModifyKokkos::add_grid_one()
   }
 }
 
+/* ----------------------------------------------------------------------
+   add_grid_many call, only for relevant fixes
+   invoked by adapt_grid and fix adapt after N new child cells are created
+------------------------------------------------------------------------- */
+
+void ModifyKokkos::add_grid_many(int n)
+{
+  for (int i = 0; i < n_pergrid; i++) {
+    int j = list_pergrid[i];
+    particle_kk->sync(fix[j]->execution_space,fix[j]->datamask_read);
+    int prev_auto_sync = sparta->kokkos->auto_sync;
+    if (!fix[j]->kokkos_flag) sparta->kokkos->auto_sync = 1;
+
+    fix[j]->add_grid_many(n);
+
+    sparta->kokkos->auto_sync = prev_auto_sync;
+    particle_kk->modify(fix[j]->execution_space,fix[j]->datamask_modify);
+  }
+}
+
 /* ----------------------------------------------------------------------
    reset_grid call, only for relevant fixes
    invoked after all grid cell removals
@@ -273,3 +317,23 @@ void ModifyKokkos::surf_react(Particle::OnePart *iorig, int &i, int &)
     particle_kk->modify(fix[j]->execution_space,fix[j]->datamask_modify);
   }
 }
+
+/* ----------------------------------------------------------------------
+   charge host/device syncs during a compute invocation to the compute
+   owner index of compute I is nfix + I, see KokkosSPARTA::sync_setup()
+------------------------------------------------------------------------- */
+
+void ModifyKokkos::invoke_begin(Compute *c)
+{
+  int owner = KokkosSPARTA::SYNC_OTHER;
+  for (int i = 0; i < ncompute; i++)
+    if (compute[i] == c) owner = nfix + i;
+  sparta->kokkos->sync_begin(owner);
+}
+
+/* ---------------------------------------------------------------------- */
+
+void ModifyKokkos::invoke_end()
+{
+  sparta->kokkos->sync_end();
+}
@@ -30,6 +30,7 @@ class ModifyKokkos : public Modify {
   int unpack_grid_one(int, char *);
   void copy_grid_one(int, int);
   void add_grid_one();
+  void add_grid_many(int);
   void reset_grid_count(int);
   void grid_changed();
 
@@ -37,6 +38,9 @@ class ModifyKokkos : public Modify {
   void gas_react(int);
   void surf_react(Particle::OnePart *, int &, int &);
 
+  void invoke_begin(class Compute *);
+  void invoke_end();
+
  private:
   class ParticleKokkos* particle_kk;
   class GridKokkos* grid_kk;
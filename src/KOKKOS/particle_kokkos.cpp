@@ -45,6 +45,8 @@ enum{COPYPARTICLELIST,FIXEDMEMORY};
 
 ParticleKokkos::ParticleKokkos(SPARTA *sparta) : Particle(sparta)
 {
+  stale_host = stale_device = 0;
+
   d_resize = DAT::t_int_scalar("particle:resize");
   h_resize = HAT::t_int_scalar("particle:resize_mirror");
 
@@ -578,6 +580,24 @@ void ParticleKokkos::update_class_variables() {
   }
 }
 
+/* ----------------------------------------------------------------------
+   create energy tables on host, copy them to device
+------------------------------------------------------------------------- */
+
+void ParticleKokkos::energy_table(int dof)
+{
+  if (dof <= maxetable || dof <= 2) return;
+
+  Particle::energy_table(dof);
+
+  d_etable = DAT::t_float_2d("particle:etable",maxetable+1,netable+1);
+  auto h_etable = Kokkos::create_mirror_view(d_etable);
+  for (int idof = 3; idof <= maxetable; idof++)
+    for (int k = 0; k <= netable; k++)
+      h_etable(idof,k) = etable[idof][k];
+  Kokkos::deep_copy(d_etable,h_etable);
+}
+
 /* ----------------------------------------------------------------------
    insure particle list can hold nextra new particles
    if defined, also grow custom particle arrays and initialize with zeroes
@@ -951,6 +971,23 @@ void ParticleKokkos::copy_custom(int i, int j)
   this->modify(Host,CUSTOM_MASK);
 }
 
+/* ----------------------------------------------------------------------
+   perform particle copies planned by a host-side compression
+   custom vectors/arrays are copied on host
+------------------------------------------------------------------------- */
+
+void ParticleKokkos::compress_copy(int ncopy)
+{
+  if (!ncustom || !ncopy) {
+    Particle::compress_copy(ncopy);
+    return;
+  }
+
+  this->sync(Host,CUSTOM_MASK);
+  Particle::compress_copy(ncopy);
+  this->modify(Host,CUSTOM_MASK);
+}
+
 /* ----------------------------------------------------------------------
    copy info for one particle in custom attribute vectors/arrays
    into location I from location J
@@ -1015,49 +1052,68 @@ void ParticleKokkos::unpack_custom(char *buf, int n)
 
 void ParticleKokkos::sync(ExecutionSpace space, unsigned int mask)
 {
+  KokkosSPARTA *kk = sparta->kokkos;
+  unsigned int stale;
+
   if (space == Device) {
     if (sparta->kokkos->auto_sync)
       modify(Host,mask);
-    if (mask & PARTICLE_MASK) k_particles.sync_device();
-    if (mask & SPECIES_MASK) k_species.sync_device();
+    stale = mask & stale_device;
+    stale_device &= ~mask;
+    if (mask & PARTICLE_MASK)
+      kk->sync_counted(k_particles,Device,stale & PARTICLE_MASK);
+    if (mask & SPECIES_MASK)
+      kk->sync_counted(k_species,Device,stale & SPECIES_MASK);
     if (mask & CUSTOM_MASK) {
       if (ncustom) {
         if (ncustom_ivec)
           for (int i = 0; i < ncustom_ivec; i++)
-            k_eivec.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_eivec.h_view[i].k_view,Device,
+                             stale & CUSTOM_MASK);
 
         if (ncustom_iarray)
           for (int i = 0; i < ncustom_iarray; i++)
-            k_eiarray.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_eiarray.h_view[i].k_view,Device,
+                             stale & CUSTOM_MASK);
 
         if (ncustom_dvec)
           for (int i = 0; i < ncustom_dvec; i++)
-            k_edvec.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_edvec.h_view[i].k_view,Device,
+                             stale & CUSTOM_MASK);
 
         if (ncustom_darray)
           for (int i = 0; i < ncustom_darray; i++)
-            k_edarray.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_edarray.h_view[i].k_view,Device,
+                             stale & CUSTOM_MASK);
       }
     }
   } else {
-    if (mask & PARTICLE_MASK) k_particles.sync_host();
-    if (mask & SPECIES_MASK) k_species.sync_host();
+    stale = mask & stale_host;
+    stale_host &= ~mask;
+    if (mask & PARTICLE_MASK)
+      kk->sync_counted(k_particles,Host,stale & PARTICLE_MASK);
+    if (mask & SPECIES_MASK)
+      kk->sync_counted(k_species,Host,stale & SPECIES_MASK);
     if (mask & CUSTOM_MASK) {
       if (ncustom_ivec)
         for (int i = 0; i < ncustom_ivec; i++)
-          k_eivec.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_eivec.h_view[i].k_view,Host,
+                           stale & CUSTOM_MASK);
 
       if (ncustom_iarray)
         for (int i = 0; i < ncustom_iarray; i++)
-          k_eiarray.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_eiarray.h_view[i].k_view,Host,
+                           stale & CUSTOM_MASK);
 
       if (ncustom_dvec)
         for (int i = 0; i < ncustom_dvec; i++)
-          k_edvec.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_edvec.h_view[i].k_view,Host,
+                           stale & CUSTOM_MASK);
 
       if (ncustom_darray)
         for (int i = 0; i < ncustom_darray; i++)
-          k_edarray.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_edarray.h_view[i].k_view,Host,
+                           stale & CUSTOM_MASK);
     }
   }
 }
@@ -1067,6 +1123,8 @@ void ParticleKokkos::sync(ExecutionSpace space, unsigned int mask)
 void ParticleKokkos::modify(ExecutionSpace space, unsigned int mask)
 {
   if (space == Device) {
+    stale_host |= mask;
+    stale_device &= ~mask;
     if (mask & PARTICLE_MASK) k_particles.modify_device();
     if (mask & SPECIES_MASK) k_species.modify_device();
     if (mask & CUSTOM_MASK) {
@@ -1091,6 +1149,8 @@ void ParticleKokkos::modify(ExecutionSpace space, unsigned int mask)
     if (sparta->kokkos->auto_sync)
       sync(Host,mask);
   } else {
+    stale_device |= mask;
+    stale_host &= ~mask;
     if (mask & PARTICLE_MASK) k_particles.modify_host();
     if (mask & SPECIES_MASK) k_species.modify_host();
     if (mask & CUSTOM_MASK) {
@@ -56,10 +56,12 @@ class ParticleKokkos : public Particle {
   void pre_weight() override;
   void post_weight() override;
   void update_class_variables();
+  void energy_table(int) override;
   int add_custom(char *, int, int) override;
   void grow_custom(int, int, int) override;
   void remove_custom(int) override;
   void copy_custom(int, int) override;
+  void compress_copy(int) override;
   void pack_custom(int, char *) override;
   void unpack_custom(char *, int) override;
 
@@ -119,6 +121,7 @@ class ParticleKokkos : public Particle {
   tdual_particle_1d k_particles;
   tdual_species_1d k_species;
   DAT::tdual_int_2d k_species2group;
+  DAT::t_float_2d d_etable;       // device copy of energy tables
 
   DAT::tdual_int_1d k_ewhich,k_eicol,k_edcol;
 
@@ -141,6 +144,9 @@ class ParticleKokkos : public Particle {
   }
 
  private:
+  unsigned int stale_host;      // masks of data modified in other space
+  unsigned int stale_device;    //   since last sync, for sync accounting
+
   t_particle_1d d_particles;
   t_species_1d d_species;
 
@@ -215,7 +221,7 @@ int ParticleKokkos::add_particle_kokkos(t_particle_1d particles, int index, int
 KOKKOS_INLINE_FUNCTION
 double ParticleKokkos::erot(int isp, double temp_thermal, rand_type &erandom) const
 {
- double eng,a,erm,b;
+ double eng;
 
  if (!collide_rot) return 0.0;
  if (d_species[isp].rotdof < 2) return 0.0;
@@ -223,14 +229,11 @@ double ParticleKokkos::erot(int isp, double temp_thermal, rand_type &erandom) co
  if (d_species[isp].rotdof == 2)
    eng = -log(erandom.drand()) * boltz * temp_thermal;
  else {
-   a = 0.5*d_species[isp].rotdof-1.0;
-   while (1) {
-     // energy cut-off at 10 kT
-     erm = 10.0*erandom.drand();
-     b = pow(erm/a,a) * exp(a-erm);
-     if (b > erandom.drand()) break;
-   }
-   eng = erm * boltz * temp_thermal;
+   const int dof = d_species[isp].rotdof;
+   const double x = erandom.drand() * netable;
+   const int k = static_cast<int> (x);
+   eng = (d_etable(dof,k) + (x-k)*(d_etable(dof,k+1)-d_etable(dof,k))) *
+     boltz * temp_thermal;
  }
 
  return eng;
@@ -244,7 +247,7 @@ double ParticleKokkos::erot(int isp, double temp_thermal, rand_type &erandom) co
 KOKKOS_INLINE_FUNCTION
 double ParticleKokkos::evib(int isp, double temp_thermal, rand_type &erandom) const
 {
-  double eng,a,erm,b;
+  double eng;
 
   enum{NONE,DISCRETE,SMOOTH};            // several files
   if (vibstyle == NONE || d_species[isp].vibdof < 2) return 0.0;
@@ -258,14 +261,11 @@ double ParticleKokkos::evib(int isp, double temp_thermal, rand_type &erandom) co
     if (d_species[isp].vibdof == 2)
       eng = -log(erandom.drand()) * boltz * temp_thermal;
     else if (d_species[isp].vibdof > 2) {
-      a = 0.5*d_species[isp].vibdof-1.;
-      while (1) {
-        // energy cut-off at 10 kT
-        erm = 10.0*erandom.drand();
-        b = pow(erm/a,a) * exp(a-erm);
-        if (b > erandom.drand()) break;
-      }
-      eng = erm * boltz * temp_thermal;
+      const int dof = d_species[isp].vibdof;
+      const double x = erandom.drand() * netable;
+      const int k = static_cast<int> (x);
+      eng = (d_etable(dof,k) + (x-k)*(d_etable(dof,k+1)-d_etable(dof,k))) *
+        boltz * temp_thermal;
     }
   }
 
@@ -88,6 +88,7 @@ ReactBirdKokkos::~ReactBirdKokkos()
       if (d_reactions.data()) {
         k_reactions.h_view(i,j).d_list = DAT::t_int_1d();
         k_reactions.h_view(i,j).d_sp2recomb = DAT::t_int_1d();
+        k_reactions.h_view(i,j).d_emin = DAT::t_float_1d();
       }
     }
   }
@@ -134,6 +135,13 @@ void ReactBirdKokkos::init()
         h_list(k) = reactions[i][j].list[k];
       Kokkos::deep_copy(k_reactions.h_view(i,j).d_list,h_list);
 
+      k_reactions.h_view(i,j).zmax = reactions[i][j].zmax;
+      k_reactions.h_view(i,j).d_emin = DAT::t_float_1d("react/bird:emin",n);
+      auto h_emin = Kokkos::create_mirror_view(k_reactions.h_view(i,j).d_emin);
+      for (int k = 0; k < n; k++)
+        h_emin(k) = reactions[i][j].emin[k];
+      Kokkos::deep_copy(k_reactions.h_view(i,j).d_emin,h_emin);
+
       if (!recombflag || !reactions[i][j].sp2recomb) continue;
 
       k_reactions.h_view(i,j).d_sp2recomb = DAT::t_int_1d("react/bird:sp2recomb",nspecies);
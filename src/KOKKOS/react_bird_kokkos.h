@@ -73,6 +73,8 @@ class ReactBirdKokkos : public ReactBird {
                      //   one index for all 3rd particle species,
                      //   just a ptr into sub-section of long sp2recomb_ij
                      //   vector for all pairs which have recomb reactions
+    DAT::t_float_1d d_emin;  // min threshold energy of remaining reactions
+    double zmax;     // max rotational DOF factor of reactions in list
     int n;           // # of reactions in list
   };
 
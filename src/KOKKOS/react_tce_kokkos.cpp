@@ -41,4 +41,29 @@ void ReactTCEKokkos::init()
     error->all(FLERR,"React tce can only be used with collide vss");
 
   ReactBirdKokkos::init();
+  create_tables();
+
+  // copy probability tables into device views
+
+  if (!tableflag) return;
+
+  d_tnbin = DAT::t_int_1d("react/tce:tnbin",nlist);
+  d_tlo = DAT::t_int_1d("react/tce:tlo",nlist);
+  d_thi = DAT::t_int_1d("react/tce:thi",nlist);
+  d_ptable = DAT::t_float_2d("react/tce:ptable",nlist,maxbin+1);
+  auto h_tnbin = Kokkos::create_mirror_view(d_tnbin);
+  auto h_tlo = Kokkos::create_mirror_view(d_tlo);
+  auto h_thi = Kokkos::create_mirror_view(d_thi);
+  auto h_ptable = Kokkos::create_mirror_view(d_ptable);
+  for (int m = 0; m < nlist; m++) {
+    h_tnbin(m) = tnbin[m];
+    h_tlo(m) = tlo[m];
+    h_thi(m) = thi[m];
+    for (int k = 0; k <= maxbin; k++)
+      h_ptable(m,k) = ptable[m][k];
+  }
+  Kokkos::deep_copy(d_tnbin,h_tnbin);
+  Kokkos::deep_copy(d_tlo,h_tlo);
+  Kokkos::deep_copy(d_thi,h_thi);
+  Kokkos::deep_copy(d_ptable,h_ptable);
 }
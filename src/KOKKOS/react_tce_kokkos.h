@@ -54,6 +54,15 @@ int attempt_kk(Particle::OnePart *ip, Particle::OnePart *jp,
   const int n = d_reactions(isp,jsp).n;
   if (n == 0) return 0;
   auto& d_list = d_reactions(isp,jsp).d_list;
+  auto& d_emin = d_reactions(isp,jsp).d_emin;
+
+  // ecc_max = upper bound on collision energy of any reaction in list
+  // no reaction is possible once it is below threshold of all remaining ones
+
+  double ecc_max = pre_etrans;
+  if (pre_ave_rotdof > 0.1)
+    ecc_max += pre_erot*d_reactions(isp,jsp).zmax/pre_ave_rotdof;
+  if (ecc_max <= d_emin[0]) return 0;
 
   // probablity to compare to reaction probability
 
@@ -65,6 +74,7 @@ int attempt_kk(Particle::OnePart *ip, Particle::OnePart *jp,
   // loop over possible reactions for these 2 species
 
   for (int i = 0; i < n; i++) {
+    if (ecc_max <= d_emin[i]) break;
     r = &d_rlist[d_list[i]];
 
     // ignore energetically impossible reactions
@@ -84,6 +94,18 @@ int attempt_kk(Particle::OnePart *ip, Particle::OnePart *jp,
     case IONIZATION:
     case EXCHANGE:
       {
+        // interpolate in table of probability vs Ea/Ecc if it exists
+
+        if (tableflag && d_tnbin[d_list[i]]) {
+          const int m = d_list[i];
+          const double x = r->d_coeff[1]/ecc * d_tnbin[m];
+          const int k = static_cast<int> (x);
+          if (k >= d_tlo[m] && k < d_thi[m]) {
+            react_prob += d_ptable(m,k) + (x-k)*(d_ptable(m,k+1)-d_ptable(m,k));
+            break;
+          }
+        }
+
         react_prob += r->d_coeff[2] *
           pow(ecc-r->d_coeff[1],r->d_coeff[3]) *
           pow(1.0-r->d_coeff[1]/ecc,r->d_coeff[5]);
@@ -174,6 +196,9 @@ int attempt_kk(Particle::OnePart *ip, Particle::OnePart *jp,
 /* ---------------------------------------------------------------------- */
 
  protected:
+  DAT::t_int_1d d_tnbin,d_tlo,d_thi;
+  DAT::t_float_2d d_ptable;
+
   DAT::tdual_int_scalar k_error_flag;
   DAT::t_int_scalar d_error_flag;
   HAT::t_int_scalar h_error_flag;
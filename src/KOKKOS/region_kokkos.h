@@ -0,0 +1,101 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifndef SPARTA_REGION_KOKKOS_H
+#define SPARTA_REGION_KOKKOS_H
+
+#include "string.h"
+#include "math.h"
+#include "region.h"
+#include "kokkos_type.h"
+
+namespace SPARTA_NS {
+
+// copy of a region that Kokkos kernels can match points against
+// block, sphere, cylinder, plane regions are supported,
+//   init() returns 0 for other styles so caller can match on host
+
+class RegionKokkos {
+ public:
+  enum{NONE,BLOCK,SPHERE,CYLINDER,PLANE};
+
+  int style;
+  int interior;
+  double params[Region::MAXGEOMETRY];
+
+  RegionKokkos() : style(NONE), interior(1) {}
+
+  int init(Region *region)
+  {
+    style = NONE;
+    interior = region->interior;
+    if (region->geometry(params) == 0) return 0;
+
+    if (strcmp(region->style,"block") == 0) style = BLOCK;
+    else if (strcmp(region->style,"sphere") == 0) style = SPHERE;
+    else if (strcmp(region->style,"cylinder") == 0) style = CYLINDER;
+    else if (strcmp(region->style,"plane") == 0) style = PLANE;
+    return (style != NONE);
+  }
+
+  // same logic as Region::match() and inside() of each region style
+
+  KOKKOS_INLINE_FUNCTION
+  int match(const double *x) const
+  {
+    return !(inside(x) ^ interior);
+  }
+
+  KOKKOS_INLINE_FUNCTION
+  int inside(const double *x) const
+  {
+    if (style == BLOCK) {
+      if (x[0] >= params[0] && x[0] <= params[1] &&
+          x[1] >= params[2] && x[1] <= params[3] &&
+          x[2] >= params[4] && x[2] <= params[5]) return 1;
+      return 0;
+
+    } else if (style == SPHERE) {
+      double delx = x[0] - params[0];
+      double dely = x[1] - params[1];
+      double delz = x[2] - params[2];
+      double r = sqrt(delx*delx + dely*dely + delz*delz);
+      if (r <= params[3]) return 1;
+      return 0;
+
+    } else if (style == CYLINDER) {
+      int axis = static_cast<int> (params[0]);
+      int dim1 = (axis == 0) ? 1 : 0;
+      int dim2 = (axis == 2) ? 1 : 2;
+      double del1 = x[dim1] - params[1];
+      double del2 = x[dim2] - params[2];
+      double dist = sqrt(del1*del1 + del2*del2);
+      if (dist <= params[3] && x[axis] >= params[4] && x[axis] <= params[5])
+        return 1;
+      return 0;
+
+    } else if (style == PLANE) {
+      double dot = (x[0]-params[0])*params[3] + (x[1]-params[1])*params[4] +
+        (x[2]-params[2])*params[5];
+      if (dot >= 0.0) return 1;
+      return 0;
+    }
+
+    return 0;
+  }
+};
+
+}
+
+#endif
@@ -198,6 +198,8 @@ void SurfCollideDiffuseKokkos::pre_collide()
   particle_kk->sync(Device,PARTICLE_MASK|SPECIES_MASK);
   d_particles = particle_kk->k_particles.d_view;
   d_species = particle_kk->k_species.d_view;
+  d_etable = particle_kk->d_etable;
+  netable = particle_kk->netable;
   boltz = update->boltz;
 
   SurfKokkos* surf_kk = (SurfKokkos*) surf;
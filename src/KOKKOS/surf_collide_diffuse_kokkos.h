@@ -85,6 +85,8 @@ class SurfCollideDiffuseKokkos : public SurfCollideDiffuse {
 
   t_particle_1d d_particles;
   t_species_1d d_species; 
+  DAT::t_float_2d d_etable;
+  int netable;
 
   int ambi_flag,vibmode_flag;
   FixAmbipolarKokkos* afix_kk;
@@ -305,7 +307,7 @@ class SurfCollideDiffuseKokkos : public SurfCollideDiffuse {
   KOKKOS_INLINE_FUNCTION
   double erot(int isp, double temp_thermal, rand_type &rand_gen, double boltz) const
   {
-    double eng,a,erm,b;
+    double eng;
 
     if (rotstyle == NONE) return 0.0;
     if (d_species[isp].rotdof < 2) return 0.0;
@@ -317,14 +319,11 @@ class SurfCollideDiffuseKokkos : public SurfCollideDiffuse {
     } else if (rotstyle == SMOOTH && d_species[isp].rotdof == 2) {
       eng = -log(rand_gen.drand()) * boltz * temp_thermal;
     } else {
-      a = 0.5*d_species[isp].rotdof-1.0;
-      while (1) {
-        // energy cut-off at 10 kT
-        erm = 10.0*rand_gen.drand();
-        b = pow(erm/a,a) * exp(a-erm);
-        if (b > rand_gen.drand()) break;
-      }
-      eng = erm * boltz * temp_thermal;
+      const int dof = d_species[isp].rotdof;
+      const double x = rand_gen.drand() * netable;
+      const int k = static_cast<int> (x);
+      eng = (d_etable(dof,k) + (x-k)*(d_etable(dof,k+1)-d_etable(dof,k))) *
+        boltz * temp_thermal;
     }
 
    return eng;
@@ -340,7 +339,7 @@ class SurfCollideDiffuseKokkos : public SurfCollideDiffuse {
   KOKKOS_INLINE_FUNCTION
   double evib(int isp, double temp_thermal, rand_type &rand_gen, double boltz) const
   {
-    double eng,a,erm,b;
+    double eng;
 
     if (vibstyle == NONE || d_species[isp].vibdof < 2) return 0.0;
 
@@ -357,14 +356,11 @@ class SurfCollideDiffuseKokkos : public SurfCollideDiffuse {
       if (d_species[isp].vibdof == 2)
         eng = -log(rand_gen.drand()) * boltz * temp_thermal;
       else if (d_species[isp].vibdof > 2) {
-        a = 0.5*d_species[isp].vibdof-1.;
-        while (1) {
-          // energy cut-off at 10 kT
-          erm = 10.0*rand_gen.drand();
-          b = pow(erm/a,a) * exp(a-erm);
-          if (b > rand_gen.drand()) break;
-        }
-        eng = erm * boltz * temp_thermal;
+        const int dof = d_species[isp].vibdof;
+        const double x = rand_gen.drand() * netable;
+        const int k = static_cast<int> (x);
+        eng = (d_etable(dof,k) + (x-k)*(d_etable(dof,k+1)-d_etable(dof,k))) *
+          boltz * temp_thermal;
       }
     }
 
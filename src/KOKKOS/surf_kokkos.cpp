@@ -48,8 +48,7 @@ enum{INT,DOUBLE};                      // several files
 
 SurfKokkos::SurfKokkos(SPARTA *sparta) : Surf(sparta)
 {
-
-
+  stale_host = stale_device = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -445,6 +444,9 @@ void SurfKokkos::grow_own(int old)
 
 void SurfKokkos::sync(ExecutionSpace space, unsigned int mask)
 {
+  KokkosSPARTA *kk = sparta->kokkos;
+  unsigned int stale;
+
   if (sparta->kokkos->prewrap)
     if (space == Device)
       error->one(FLERR,"Sync Device before wrap");
@@ -452,46 +454,58 @@ void SurfKokkos::sync(ExecutionSpace space, unsigned int mask)
   if (space == Device) {
     if (sparta->kokkos->auto_sync)
       modify(Host,mask);
-    if (mask & LINE_MASK) k_lines.sync_device();
-    if (mask & TRI_MASK) k_tris.sync_device();
+    stale = mask & stale_device;
+    stale_device &= ~mask;
+    if (mask & LINE_MASK) kk->sync_counted(k_lines,Device,stale & LINE_MASK);
+    if (mask & TRI_MASK) kk->sync_counted(k_tris,Device,stale & TRI_MASK);
     if (mask & SURF_CUSTOM_MASK) {
       if (ncustom) {
         if (ncustom_ivec)
           for (int i = 0; i < ncustom_ivec; i++)
-            k_eivec.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_eivec.h_view[i].k_view,Device,
+                             stale & SURF_CUSTOM_MASK);
 
         if (ncustom_iarray)
           for (int i = 0; i < ncustom_iarray; i++)
-            k_eiarray.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_eiarray.h_view[i].k_view,Device,
+                             stale & SURF_CUSTOM_MASK);
 
         if (ncustom_dvec)
           for (int i = 0; i < ncustom_dvec; i++)
-            k_edvec.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_edvec.h_view[i].k_view,Device,
+                             stale & SURF_CUSTOM_MASK);
 
         if (ncustom_darray)
           for (int i = 0; i < ncustom_darray; i++)
-            k_edarray.h_view[i].k_view.sync_device();
+            kk->sync_counted(k_edarray.h_view[i].k_view,Device,
+                             stale & SURF_CUSTOM_MASK);
       }
     }
   } else {
-    if (mask & LINE_MASK) k_lines.sync_host();
-    if (mask & TRI_MASK) k_tris.sync_host();
+    stale = mask & stale_host;
+    stale_host &= ~mask;
+    if (mask & LINE_MASK) kk->sync_counted(k_lines,Host,stale & LINE_MASK);
+    if (mask & TRI_MASK) kk->sync_counted(k_tris,Host,stale & TRI_MASK);
     if (mask & SURF_CUSTOM_MASK) {
       if (ncustom_ivec)
         for (int i = 0; i < ncustom_ivec; i++)
-          k_eivec.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_eivec.h_view[i].k_view,Host,
+                           stale & SURF_CUSTOM_MASK);
 
       if (ncustom_iarray)
         for (int i = 0; i < ncustom_iarray; i++)
-          k_eiarray.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_eiarray.h_view[i].k_view,Host,
+                           stale & SURF_CUSTOM_MASK);
 
       if (ncustom_dvec)
         for (int i = 0; i < ncustom_dvec; i++)
-          k_edvec.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_edvec.h_view[i].k_view,Host,
+                           stale & SURF_CUSTOM_MASK);
 
       if (ncustom_darray)
         for (int i = 0; i < ncustom_darray; i++)
-          k_edarray.h_view[i].k_view.sync_host();
+          kk->sync_counted(k_edarray.h_view[i].k_view,Host,
+                           stale & SURF_CUSTOM_MASK);
     }
   }
 }
@@ -505,6 +519,8 @@ void SurfKokkos::modify(ExecutionSpace space, unsigned int mask)
       error->one(FLERR,"Modify Device before wrap");
 
   if (space == Device) {
+    stale_host |= mask;
+    stale_device &= ~mask;
     if (mask & LINE_MASK) k_lines.modify_device();
     if (mask & TRI_MASK) k_tris.modify_device();
     if (mask & SURF_CUSTOM_MASK) {
@@ -530,6 +546,8 @@ void SurfKokkos::modify(ExecutionSpace space, unsigned int mask)
     if (sparta->kokkos->auto_sync)
       sync(Host,mask);
   } else {
+    stale_device |= mask;
+    stale_host &= ~mask;
     if (mask & LINE_MASK) k_lines.modify_host();
     if (mask & TRI_MASK) k_tris.modify_host();
     if (mask & SURF_CUSTOM_MASK) {
@@ -53,7 +53,8 @@ class SurfKokkos : public Surf {
   tdual_struct_tdual_float_2d_1d k_edarray;
 
  private:
-
+  unsigned int stale_host;      // masks of data modified in other space
+  unsigned int stale_device;    //   since last sync, for sync accounting
 };
 
 }
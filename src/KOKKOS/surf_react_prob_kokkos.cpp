@@ -72,6 +72,7 @@ SurfReactProbKokkos::SurfReactProbKokkos(SPARTA *sparta) :
   rlist = NULL;
   reactions = NULL;
   indices = NULL;
+  cumprobs = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -140,9 +141,14 @@ void SurfReactProbKokkos::init_reactions()
   d_list = DAT::t_int_2d("surf_react_prob:list",nspecies,nmax);
   auto h_list = Kokkos::create_mirror_view(d_list);
 
+  d_cumprob = DAT::t_float_2d("surf_react_prob:cumprob",nspecies,nmax);
+  auto h_cumprob = Kokkos::create_mirror_view(d_cumprob);
+
   for (int i = 0; i < nspecies; i++)
-    for (int j = 0; j < reactions[i].n; j++)
+    for (int j = 0; j < reactions[i].n; j++) {
       h_list(i,j) = reactions[i].list[j];
+      h_cumprob(i,j) = reactions[i].cumprob[j];
+    }
 
   d_type = DAT::t_int_1d("surf_react_prob:type",maxlist_prob);
   d_reactants = DAT::t_int_2d("surf_react_prob:reactants",maxlist_prob,MAXREACTANT);
@@ -171,6 +177,7 @@ void SurfReactProbKokkos::init_reactions()
 
   Kokkos::deep_copy(d_reactions_n,h_reactions_n);
   Kokkos::deep_copy(d_list,h_list);
+  Kokkos::deep_copy(d_cumprob,h_cumprob);
   Kokkos::deep_copy(d_type,h_type);
   Kokkos::deep_copy(d_reactants,h_reactants);
   Kokkos::deep_copy(d_products,h_products);
@@ -47,6 +47,7 @@ class SurfReactProbKokkos : public SurfReactProb {
  private:
   DAT::t_int_1d d_reactions_n;       // # of reactions in list
   DAT::t_int_2d d_list;
+  DAT::t_float_2d d_cumprob;          // cumulative reaction probs
 
   DAT::t_int_1d d_type;
   DAT::t_int_2d d_reactants;
@@ -92,59 +93,65 @@ class SurfReactProbKokkos : public SurfReactProb {
                    Particle::OnePart *&jp, int &,
                    const DAT::t_int_scalar &d_retry, const DAT::t_int_scalar &d_nlocal) const
   {
-    int n = d_reactions_n[ip->ispecies];
+    const int isp = ip->ispecies;
+    int n = d_reactions_n[isp];
     if (n == 0) return 0;
 
-    // probablity to compare to reaction probability
+    // probablity to compare to cumulative reaction probabilities
+    // no reaction if it exceeds summed probability of all reactions
 
-    double react_prob = 0.0;
     rand_type rand_gen = rand_pool.get_state();
     double random_prob = rand_gen.drand();
 
-    // loop over possible reactions for this species
-    // if dissociation performs a realloc:
-    //   make copy of x,v with new species
-    //   rot/vib energies will be reset by SurfCollide
-    //   repoint ip to new particles data struct if reallocated
-
-    for (int i = 0; i < n; i++) {
-      int j = d_list(ip->ispecies,i);
-      react_prob += d_coeffs(j,0);
-
-      if (react_prob > random_prob) {
-        Kokkos::atomic_increment(&d_nsingle());
-        Kokkos::atomic_increment(&d_tally_single(j));
-        switch (d_type(j)) {
-        case DISSOCIATION:
-          {
-            double x[3],v[3];
-            ip->ispecies = d_products(j,0);
-            int id = MAXSMALLINT*rand_gen.drand();
-            memcpy(x,ip->x,3*sizeof(double));
-            memcpy(v,ip->v,3*sizeof(double));
-            int index = Kokkos::atomic_fetch_add(&d_nlocal(),1);
-            int reallocflag = ParticleKokkos::add_particle_kokkos(d_particles,index,id,d_products(j,1),ip->icell,x,v,0.0,0.0);
-            if (reallocflag) {
-              d_retry() = 1;
-              rand_pool.free_state(rand_gen);
-              return 0;
-            }
-            jp = &d_particles[index];
-            rand_pool.free_state(rand_gen);
-            return (j + 1);
-          }
-        case EXCHANGE:
-          {
-            ip->ispecies = d_products(j,0);
-            rand_pool.free_state(rand_gen);
-            return (j + 1);
-          }
-        case RECOMBINATION:
-          {
-            ip = NULL;
+    if (d_cumprob(isp,n-1) > random_prob) {
+
+      // binary search for 1st reaction whose cumulative prob > random_prob
+      // if dissociation performs a realloc:
+      //   make copy of x,v with new species
+      //   rot/vib energies will be reset by SurfCollide
+      //   repoint ip to new particles data struct if reallocated
+
+      int lo = 0;
+      int hi = n-1;
+      while (lo < hi) {
+        int mid = (lo+hi) / 2;
+        if (d_cumprob(isp,mid) > random_prob) hi = mid;
+        else lo = mid+1;
+      }
+
+      int j = d_list(isp,lo);
+      Kokkos::atomic_increment(&d_nsingle());
+      Kokkos::atomic_increment(&d_tally_single(j));
+      switch (d_type(j)) {
+      case DISSOCIATION:
+        {
+          double x[3],v[3];
+          ip->ispecies = d_products(j,0);
+          int id = MAXSMALLINT*rand_gen.drand();
+          memcpy(x,ip->x,3*sizeof(double));
+          memcpy(v,ip->v,3*sizeof(double));
+          int index = Kokkos::atomic_fetch_add(&d_nlocal(),1);
+          int reallocflag = ParticleKokkos::add_particle_kokkos(d_particles,index,id,d_products(j,1),ip->icell,x,v,0.0,0.0);
+          if (reallocflag) {
+            d_retry() = 1;
             rand_pool.free_state(rand_gen);
-            return (j + 1);
+            return 0;
           }
+          jp = &d_particles[index];
+          rand_pool.free_state(rand_gen);
+          return (j + 1);
+        }
+      case EXCHANGE:
+        {
+          ip->ispecies = d_products(j,0);
+          rand_pool.free_state(rand_gen);
+          return (j + 1);
+        }
+      case RECOMBINATION:
+        {
+          ip = NULL;
+          rand_pool.free_state(rand_gen);
+          return (j + 1);
         }
       }
     }
@@ -37,6 +37,7 @@
 #include "timer.h"
 #include "math_extra.h"
 #include "memory_kokkos.h"
+#include "modify_kokkos.h"
 #include "error.h"
 #include <unistd.h>
 #include "kokkos.h"
@@ -295,6 +296,10 @@ void UpdateKokkos::setup()
 
   Update::setup(); // must come after prewrap since computes are called by setup()
 
+  // count host/device syncs from here to end of run
+
+  sparta->kokkos->sync_setup();
+
   // For MPI debugging
   //
   //  volatile int i = 0;
@@ -331,6 +336,8 @@ void UpdateKokkos::run(int nsteps)
   int cellweightflag = 0;
   if (grid->cellweightflag) cellweightflag = 1;
 
+  haltflag = 0;
+
   // loop over timesteps
 
   for (int i = 0; i < nsteps; i++) {
@@ -347,8 +354,9 @@ void UpdateKokkos::run(int nsteps)
     if (dynamic) dynamic_update();
 
     // start of step fixes
+    // skip steps before the next step any fix is scheduled on
 
-    if (n_start_of_step) {
+    if (n_start_of_step && ntimestep >= modify->next_start_of_step) {
       modify->start_of_step();
       timer->stamp(TIME_MODIFY);
     }
@@ -387,19 +395,29 @@ void UpdateKokkos::run(int nsteps)
     if (collide_react) collide_react_update();
 
     // diagnostic fixes
+    // skip steps before the next step any fix is scheduled on
 
-    if (n_end_of_step) {
+    if (n_end_of_step && ntimestep >= modify->next_end_of_step) {
       modify->end_of_step();
       timer->stamp(TIME_MODIFY);
+      if (haltflag) output->next_stats = output->next = ntimestep;
     }
 
     // all output
 
     if (ntimestep == output->next) {
+      sparta->kokkos->sync_owner = KokkosSPARTA::SYNC_OUTPUT;
       particle_kk->sync(Host,ALL_MASK);
       output->write(ntimestep);
+      sparta->kokkos->sync_owner = KokkosSPARTA::SYNC_OTHER;
       timer->stamp(TIME_OUTPUT);
     }
+
+    if (haltflag) {
+      this->nsteps = i+1;
+      laststep = ntimestep;
+      break;
+    }
   }
   sparta->kokkos->auto_sync = 1;
 
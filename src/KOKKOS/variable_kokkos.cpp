@@ -0,0 +1,426 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#include "math.h"
+#include "variable_kokkos.h"
+#include "variable.h"
+#include "input.h"
+#include "update.h"
+#include "grid_kokkos.h"
+#include "modify.h"
+#include "compute.h"
+#include "fix.h"
+#include "kokkos.h"
+#include "kokkos_base.h"
+#include "memory_kokkos.h"
+#include "error.h"
+#include "sparta_masks.h"
+
+using namespace SPARTA_NS;
+
+// bits set by device evaluation for invalid math, reported on host
+
+enum{DIVIDE_ZERO=1,MODULO_ZERO=2,POWER_ZERO=4,SQRT_NEGATIVE=8,
+     LOG_NONPOSITIVE=16,ASIN_INVALID=32,ACOS_INVALID=64};
+
+#define INVOKED_PER_GRID 16
+
+/* ---------------------------------------------------------------------- */
+
+VariableKokkos::VariableKokkos(SPARTA *sparta) : Pointers(sparta)
+{
+  copymode = 0;
+  nglocal = nops = nleaf = maxleaf = 0;
+  sumflag = 0;
+  vbuf = NULL;
+  maxbuf = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+VariableKokkos::~VariableKokkos()
+{
+  if (copymode) return;
+
+  memory->destroy(vbuf);
+}
+
+/* ----------------------------------------------------------------------
+   evaluate grid-style variable IVAR for all owned grid cells on device
+   answers are placed in result, if sumflag add them to existing values
+   formulas Variable cannot compile to postfix, or that reference other
+     grid-style variables, are evaluated on host and copied to device
+------------------------------------------------------------------------- */
+
+void VariableKokkos::compute_grid(int ivar, DAT::t_float_1d_strided result,
+                                  int sumflag_caller)
+{
+  nglocal = grid->nlocal;
+  d_result = result;
+  sumflag = sumflag_caller;
+
+  if (!compile(ivar)) {
+    host_grid(ivar);
+    return;
+  }
+
+  GridKokkos* grid_kk = (GridKokkos*) grid;
+  grid_kk->sync(Device,CELL_MASK);
+  d_cells = grid_kk->k_cells.d_view;
+
+  int errflag = 0;
+  copymode = 1;
+  Kokkos::parallel_reduce(Kokkos::RangePolicy<DeviceType, TagVariableKokkos_Eval>(0,nglocal),*this,Kokkos::BOr<int>(errflag));
+  copymode = 0;
+
+  if (errflag & DIVIDE_ZERO)
+    error->one(FLERR,"Divide by 0 in variable formula");
+  if (errflag & MODULO_ZERO)
+    error->one(FLERR,"Modulo 0 in variable formula");
+  if (errflag & POWER_ZERO)
+    error->one(FLERR,"Power by 0 in variable formula");
+  if (errflag & SQRT_NEGATIVE)
+    error->one(FLERR,"Sqrt of negative value in variable formula");
+  if (errflag & LOG_NONPOSITIVE)
+    error->one(FLERR,"Log of zero/negative value in variable formula");
+  if (errflag & ASIN_INVALID)
+    error->one(FLERR,"Arcsin of invalid value in variable formula");
+  if (errflag & ACOS_INVALID)
+    error->one(FLERR,"Arccos of invalid value in variable formula");
+}
+
+/* ----------------------------------------------------------------------
+   compile variable IVAR into device ops and gather its operands
+   scalar sub-expressions are folded to constants by Variable,
+     so formula is recompiled each time it is evaluated
+   return 1 if successful, 0 if formula must be evaluated on host
+------------------------------------------------------------------------- */
+
+int VariableKokkos::compile(int ivar)
+{
+  Variable::PostfixOp *ops;
+  nops = input->variable->compile_grid(ivar,ops);
+  if (nops <= 0) return 0;
+
+  // check stack depth the ops need and count per-grid operands
+
+  int depth = 0;
+  int maxdepth = 0;
+  nleaf = 0;
+
+  for (int iop = 0; iop < nops; iop++) {
+    int type = ops[iop].type;
+    if (type == Variable::PF_VALUE || type == Variable::PF_CELL) depth++;
+    else if (type == Variable::PF_COMPUTE || type == Variable::PF_FIX) {
+      depth++;
+      nleaf++;
+    } else if (type <= Variable::PF_OR || type == Variable::PF_ATAN2) {
+      if (type != Variable::PF_UNARY && type != Variable::PF_NOT) depth--;
+    }
+    maxdepth = MAX(maxdepth,depth);
+  }
+
+  if (maxdepth > MAXSTACK) return 0;
+
+  if ((int) k_optype.extent(0) < nops) {
+    k_optype = DAT::tdual_int_1d("variable/kk:optype",nops);
+    k_opint = DAT::tdual_int_1d("variable/kk:opint",nops);
+    k_opvalue = DAT::tdual_float_1d("variable/kk:opvalue",nops);
+  }
+
+  if (nleaf && ((int) d_leaves.extent(0) < nglocal || nleaf > maxleaf)) {
+    maxleaf = MAX(maxleaf,nleaf);
+    d_leaves = DAT::t_float_2d_lr("variable/kk:leaves",nglocal,maxleaf);
+  }
+
+  // gather each compute/fix operand into its own column of leaves
+  // invoking computes in same order the host evaluation would
+
+  int ileaf = 0;
+
+  for (int iop = 0; iop < nops; iop++) {
+    int type = ops[iop].type;
+    k_optype.h_view(iop) = type;
+    k_opvalue.h_view(iop) = ops[iop].value;
+    k_opint.h_view(iop) = ops[iop].index;
+
+    if (type == Variable::PF_COMPUTE) {
+      gather_compute(ops[iop].index,ops[iop].column,ileaf);
+      k_opint.h_view(iop) = ileaf++;
+    } else if (type == Variable::PF_FIX) {
+      gather_fix(ops[iop].index,ops[iop].column,ileaf);
+      k_opint.h_view(iop) = ileaf++;
+    }
+  }
+
+  k_optype.modify_host();
+  k_optype.sync_device();
+  d_optype = k_optype.d_view;
+
+  k_opint.modify_host();
+  k_opint.sync_device();
+  d_opint = k_opint.d_view;
+
+  k_opvalue.modify_host();
+  k_opvalue.sync_device();
+  d_opvalue = k_opvalue.d_view;
+
+  return 1;
+}
+
+/* ----------------------------------------------------------------------
+   copy per-grid vector or array column of compute into leaf column ILEAF
+   Kokkos computes are invoked and read on device,
+     others are invoked on host and bridged to device
+------------------------------------------------------------------------- */
+
+void VariableKokkos::gather_compute(int icompute, int column, int ileaf)
+{
+  Compute *compute = modify->compute[icompute];
+  KokkosBase* computeKKBase = dynamic_cast<KokkosBase*>(compute);
+  int kkflag = compute->kokkos_flag && computeKKBase &&
+    !compute->post_process_isurf_grid_flag;
+
+  if (update->runflag == 0) {
+    if (compute->invoked_per_grid != update->ntimestep)
+      error->all(FLERR,"Compute used in variable between runs is not current");
+  } else if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+    modify->invoke_begin(compute);
+    if (kkflag) computeKKBase->compute_per_grid_kokkos();
+    else compute->compute_per_grid();
+    modify->invoke_end();
+    compute->invoked_flag |= INVOKED_PER_GRID;
+  }
+
+  auto d_leaf = Kokkos::subview(d_leaves,std::make_pair(0,nglocal),ileaf);
+
+  if (kkflag) {
+    if (compute->post_process_grid_flag)
+      computeKKBase->post_process_grid_kokkos(column,1,DAT::t_float_2d_lr(),
+                                              NULL,DAT::t_float_1d_strided());
+    if (column == 0 || compute->post_process_grid_flag)
+      Kokkos::deep_copy(d_leaf,Kokkos::subview(computeKKBase->d_vector,
+                                               std::make_pair(0,nglocal)));
+    else
+      Kokkos::deep_copy(d_leaf,Kokkos::subview(computeKKBase->d_array_grid,
+                                               std::make_pair(0,nglocal),
+                                               column-1));
+    return;
+  }
+
+  if (compute->post_process_grid_flag)
+    compute->post_process_grid(column,1,NULL,NULL,NULL,1);
+  else if (compute->post_process_isurf_grid_flag)
+    compute->post_process_isurf_grid();
+
+  if (nglocal == 0) return;
+
+  if (column == 0 || compute->post_process_grid_flag)
+    sparta->kokkos->bridge_to_device(k_bridge,compute->vector_grid,nglocal,1);
+  else
+    sparta->kokkos->bridge_to_device(k_bridge,&compute->array_grid[0][column-1],
+                                     nglocal,compute->size_per_grid_cols);
+  Kokkos::deep_copy(d_leaf,Kokkos::subview(k_bridge.d_view,
+                                           std::make_pair(0,nglocal)));
+}
+
+/* ----------------------------------------------------------------------
+   copy per-grid vector or array column of fix into leaf column ILEAF
+   Variable has already checked fix is current on this timestep
+------------------------------------------------------------------------- */
+
+void VariableKokkos::gather_fix(int ifix, int column, int ileaf)
+{
+  Fix *fix = modify->fix[ifix];
+  KokkosBase* fixKKBase = dynamic_cast<KokkosBase*>(fix);
+
+  if (nglocal == 0) return;
+
+  auto d_leaf = Kokkos::subview(d_leaves,std::make_pair(0,nglocal),ileaf);
+
+  if (fix->kokkos_flag && fixKKBase) {
+    if (column == 0)
+      Kokkos::deep_copy(d_leaf,Kokkos::subview(fixKKBase->d_vector,
+                                               std::make_pair(0,nglocal)));
+    else
+      Kokkos::deep_copy(d_leaf,Kokkos::subview(fixKKBase->d_array_grid,
+                                               std::make_pair(0,nglocal),
+                                               column-1));
+    return;
+  }
+
+  if (column == 0)
+    sparta->kokkos->bridge_to_device(k_bridge,fix->vector_grid,nglocal,1);
+  else
+    sparta->kokkos->bridge_to_device(k_bridge,&fix->array_grid[0][column-1],
+                                     nglocal,fix->size_per_grid_cols);
+  Kokkos::deep_copy(d_leaf,Kokkos::subview(k_bridge.d_view,
+                                           std::make_pair(0,nglocal)));
+}
+
+/* ----------------------------------------------------------------------
+   evaluate variable IVAR on host and bridge values into result
+------------------------------------------------------------------------- */
+
+void VariableKokkos::host_grid(int ivar)
+{
+  if (nglocal > maxbuf) {
+    memory->destroy(vbuf);
+    maxbuf = nglocal;
+    memory->create(vbuf,maxbuf,"variable/kk:vbuf");
+  }
+
+  input->variable->compute_grid(ivar,vbuf,1,0);
+
+  if (nglocal == 0) return;
+
+  sparta->kokkos->bridge_to_device(k_bridge,vbuf,nglocal,1);
+
+  auto d_values = Kokkos::subview(k_bridge.d_view,std::make_pair(0,nglocal));
+  auto d_target = Kokkos::subview(d_result,std::make_pair(0,nglocal));
+  if (sumflag) {
+    Kokkos::parallel_for(nglocal,KOKKOS_LAMBDA(const int i) {
+      d_target(i) += d_values(i);
+    });
+  } else Kokkos::deep_copy(d_target,d_values);
+}
+
+/* ----------------------------------------------------------------------
+   run postfix ops for grid cell I on a local stack
+   invalid math sets a bit in errflag and leaves result unchanged
+------------------------------------------------------------------------- */
+
+KOKKOS_INLINE_FUNCTION
+void VariableKokkos::operator()(TagVariableKokkos_Eval, const int &i,
+                                int &errflag) const
+{
+  double stack[MAXSTACK];
+  double arg1,arg2;
+  int n = 0;
+
+  for (int iop = 0; iop < nops; iop++) {
+    const int type = d_optype(iop);
+
+    // operands push a value
+
+    if (type == Variable::PF_VALUE) {
+      stack[n++] = d_opvalue(iop);
+      continue;
+    } else if (type == Variable::PF_COMPUTE || type == Variable::PF_FIX) {
+      stack[n++] = d_leaves(i,d_opint(iop));
+      continue;
+    } else if (type == Variable::PF_CELL) {
+      stack[n++] = *((double *) ((char *) &d_cells(i) + d_opint(iop)));
+      continue;
+    }
+
+    // functions of one argument replace top of stack
+
+    arg1 = stack[n-1];
+
+    switch (type) {
+    case Variable::PF_UNARY: stack[n-1] = -arg1; continue;
+    case Variable::PF_NOT: stack[n-1] = (arg1 == 0.0) ? 1.0 : 0.0; continue;
+    case Variable::PF_SQRT:
+      if (arg1 < 0.0) {
+        errflag |= SQRT_NEGATIVE;
+        return;
+      }
+      stack[n-1] = sqrt(arg1);
+      continue;
+    case Variable::PF_EXP: stack[n-1] = exp(arg1); continue;
+    case Variable::PF_LN:
+    case Variable::PF_LOG:
+      if (arg1 <= 0.0) {
+        errflag |= LOG_NONPOSITIVE;
+        return;
+      }
+      stack[n-1] = (type == Variable::PF_LN) ? log(arg1) : log10(arg1);
+      continue;
+    case Variable::PF_ABS: stack[n-1] = fabs(arg1); continue;
+    case Variable::PF_SIN: stack[n-1] = sin(arg1); continue;
+    case Variable::PF_COS: stack[n-1] = cos(arg1); continue;
+    case Variable::PF_TAN: stack[n-1] = tan(arg1); continue;
+    case Variable::PF_ASIN:
+      if (arg1 < -1.0 || arg1 > 1.0) {
+        errflag |= ASIN_INVALID;
+        return;
+      }
+      stack[n-1] = asin(arg1);
+      continue;
+    case Variable::PF_ACOS:
+      if (arg1 < -1.0 || arg1 > 1.0) {
+        errflag |= ACOS_INVALID;
+        return;
+      }
+      stack[n-1] = acos(arg1);
+      continue;
+    case Variable::PF_ATAN: stack[n-1] = atan(arg1); continue;
+    case Variable::PF_ERF: stack[n-1] = erf(arg1); continue;
+    case Variable::PF_CEIL: stack[n-1] = ceil(arg1); continue;
+    case Variable::PF_FLOOR: stack[n-1] = floor(arg1); continue;
+    case Variable::PF_ROUND:
+      stack[n-1] = ((arg1-floor(arg1)) >= 0.5) ? ceil(arg1) : floor(arg1);
+      continue;
+    }
+
+    // operators of two arguments pop right operand, replace left one
+
+    arg2 = stack[--n];
+    arg1 = stack[n-1];
+
+    switch (type) {
+    case Variable::PF_ADD: stack[n-1] = arg1 + arg2; break;
+    case Variable::PF_SUBTRACT: stack[n-1] = arg1 - arg2; break;
+    case Variable::PF_MULTIPLY: stack[n-1] = arg1 * arg2; break;
+    case Variable::PF_DIVIDE:
+      if (arg2 == 0.0) {
+        errflag |= DIVIDE_ZERO;
+        return;
+      }
+      stack[n-1] = arg1 / arg2;
+      break;
+    case Variable::PF_MODULO:
+      if (arg2 == 0.0) {
+        errflag |= MODULO_ZERO;
+        return;
+      }
+      stack[n-1] = fmod(arg1,arg2);
+      break;
+    case Variable::PF_CARAT:
+      if (arg2 == 0.0) {
+        errflag |= POWER_ZERO;
+        return;
+      }
+      stack[n-1] = pow(arg1,arg2);
+      break;
+    case Variable::PF_EQ: stack[n-1] = (arg1 == arg2) ? 1.0 : 0.0; break;
+    case Variable::PF_NE: stack[n-1] = (arg1 != arg2) ? 1.0 : 0.0; break;
+    case Variable::PF_LT: stack[n-1] = (arg1 < arg2) ? 1.0 : 0.0; break;
+    case Variable::PF_LE: stack[n-1] = (arg1 <= arg2) ? 1.0 : 0.0; break;
+    case Variable::PF_GT: stack[n-1] = (arg1 > arg2) ? 1.0 : 0.0; break;
+    case Variable::PF_GE: stack[n-1] = (arg1 >= arg2) ? 1.0 : 0.0; break;
+    case Variable::PF_AND:
+      stack[n-1] = (arg1 != 0.0 && arg2 != 0.0) ? 1.0 : 0.0;
+      break;
+    case Variable::PF_OR:
+      stack[n-1] = (arg1 != 0.0 || arg2 != 0.0) ? 1.0 : 0.0;
+      break;
+    case Variable::PF_ATAN2: stack[n-1] = atan2(arg1,arg2); break;
+    }
+  }
+
+  if (sumflag) d_result(i) += stack[0];
+  else d_result(i) = stack[0];
+}
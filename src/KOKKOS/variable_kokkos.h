@@ -0,0 +1,98 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifndef SPARTA_VARIABLE_KOKKOS_H
+#define SPARTA_VARIABLE_KOKKOS_H
+
+#include "pointers.h"
+#include "kokkos_type.h"
+
+namespace SPARTA_NS {
+
+struct TagVariableKokkos_Eval{};
+
+// evaluates grid-style variables on the device for Kokkos styles
+// formula is compiled by Variable into postfix ops, per-grid compute
+//   and fix operands are gathered into columns of a device leaf array,
+//   then each grid cell runs the ops on a small stack
+
+class VariableKokkos : protected Pointers {
+ public:
+  VariableKokkos(class SPARTA *);
+  ~VariableKokkos();
+  void compute_grid(int, DAT::t_float_1d_strided, int);
+
+  KOKKOS_INLINE_FUNCTION
+  void operator()(TagVariableKokkos_Eval, const int&, int&) const;
+
+ private:
+  int copymode;
+  int nglocal,nops,nleaf,maxleaf,sumflag;
+
+  enum{MAXSTACK=32};
+
+  DAT::tdual_int_1d k_optype,k_opint;
+  DAT::tdual_float_1d k_opvalue;
+  DAT::t_int_1d d_optype,d_opint;
+  DAT::t_float_1d d_opvalue;
+
+  DAT::t_float_2d_lr d_leaves;
+  DAT::t_float_1d_strided d_result;
+  t_cell_1d d_cells;
+
+  DAT::tdual_float_1d k_bridge;
+  double *vbuf;
+  int maxbuf;
+
+  int compile(int);
+  void gather_compute(int, int, int);
+  void gather_fix(int, int, int);
+  void host_grid(int);
+};
+
+}
+
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Divide by 0 in variable formula
+
+Self-explanatory.
+
+E: Modulo 0 in variable formula
+
+Self-explanatory.
+
+E: Power by 0 in variable formula
+
+Self-explanatory.
+
+E: Sqrt of negative value in variable formula
+
+Self-explanatory.
+
+E: Log of zero/negative value in variable formula
+
+Self-explanatory.
+
+E: Arcsin of invalid value in variable formula
+
+Argument of arcsin() must be between -1 and 1.
+
+E: Arccos of invalid value in variable formula
+
+Argument of arccos() must be between -1 and 1.
+
+*/
@@ -104,7 +104,7 @@ void AdaptGrid::command(int narg, char **arg)
   // so all grid cell info including collide & fixes is ready to migrate
 
   sparta->init();
-  grid->remove_ghosts();
+  grid->hold_ghosts();
 
   // iterate over refinement and coarsening actions
 
@@ -135,11 +135,10 @@ void AdaptGrid::command(int narg, char **arg)
     if (nrefine == 0 && ncoarsen == 0) break;
   }
 
-  // if no refine or coarsen, just reghost/reneighbor and return
+  // if no refine or coarsen, restore held ghosts and return
 
   if (nrefine_total == 0 && ncoarsen_total == 0) {
-    grid->acquire_ghosts();
-    grid->find_neighbors();
+    grid->restore_ghosts();
 
     if (me == 0) {
       if (screen) fprintf(screen,"  no grid adaptation performed\n");
@@ -153,10 +152,13 @@ void AdaptGrid::command(int narg, char **arg)
 
   // reset all attributes of adapted grid
   // same steps as in create_grid
+  // update ghosts and neighbors only of changed cells if possible
 
   grid->setup_owned();
-  grid->acquire_ghosts();
-  grid->find_neighbors();
+  if (!grid->update_ghosts()) {
+    grid->acquire_ghosts();
+    grid->find_neighbors();
+  }
   grid->check_uniform();
   comm->reset_neighbors();
 
@@ -555,9 +557,11 @@ bigint AdaptGrid::refine()
   MPI_Allreduce(&nme,&nrefine,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
 
   // if any refinement
+  // procs which refined nothing stash their held ghosts before compress()
   // compress() removes child cells that became parents
 
   if (nrefine) {
+    grid->stash_ghosts();
     if (collide) collide->adapt_grid();
     grid->compress();
 
@@ -601,12 +605,14 @@ bigint AdaptGrid::coarsen()
   MPI_Allreduce(&nme,&ncoarsen,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
 
   // if any coarsening
+  // procs which coarsened nothing stash their held ghosts before compress()
   // compress() removes child cells that vanished
   // surf->compress() removes surfs no longer referenced by owned cells
   //   can be needed when owned cells are removed by coarsening
   //   no need to call in refine() since new child cells own same surfs
 
   if (ncoarsen) {
+    grid->stash_ghosts();
     if (collide) collide->adapt_grid();
     grid->compress();
     if (particle->exist) particle->compress_rebalance();
@@ -751,7 +757,9 @@ void AdaptGrid::refine_value()
 
   if (valuewhich == COMPUTE) {
     compute = modify->compute[icompute];
+    modify->invoke_begin(compute);
     compute->compute_per_grid();
+    modify->invoke_end();
     if (compute->post_process_grid_flag)
       compute->post_process_grid(valindex,1,NULL,NULL,NULL,1);
   } else if (valuewhich == FIX) fix = modify->fix[ifix];
@@ -829,9 +837,26 @@ int AdaptGrid::perform_refine()
   int icell,jcell;
   int nglocal,nglocalprev;
 
+  Grid::ParentLevel *plevels = grid->plevels;
   Grid::ChildCell *cells = grid->cells;
   Grid::ChildInfo *cinfo = grid->cinfo;
 
+  // stash held ghosts before new cells overwrite them
+
+  if (rnum) grid->stash_ghosts();
+
+  // allocate all new unsplit child cells up front
+  // only sub cells of new split cells can reallocate cells after this
+
+  bigint nnew = 0;
+  for (int ilist = 0; ilist < rnum; ilist++)
+    nnew += plevels[cells[rlist[ilist]].level].nxyz;
+  grid->reserve_cells((int) nnew);
+
+  cells = grid->cells;
+  cinfo = grid->cinfo;
+  int nglocalorig = grid->nlocal;
+
   for (int ilist = 0; ilist < rnum; ilist++) {
     icell = rlist[ilist];
 
@@ -845,7 +870,7 @@ int AdaptGrid::perform_refine()
     cells[icell].proc = -1;
 
     // add Nx by Ny by Nz child cells to replace icell
-    // refine_cell() adds all new unsplit/split cells to grid hash
+    // caller rehashes all cells after grid is compressed
 
     nglocalprev = grid->nlocal;
     grid->refine_cell(icell,childlist,cut2d,cut3d);
@@ -860,6 +885,12 @@ int AdaptGrid::perform_refine()
       cinfo[jcell].mask = cinfo[icell].mask;
   }
 
+  // add per grid fix data for all new unsplit/split/sub cells at once
+  // collide->adapt_grid() in refine() does the same for collide data
+
+  if (modify->n_pergrid && grid->nlocal > nglocalorig)
+    modify->add_grid_many(grid->nlocal - nglocalorig);
+
   return rnum;
 }
 
@@ -888,7 +919,9 @@ void AdaptGrid::candidates_coarsen()
   if (style == VALUE) {
     if (valuewhich == COMPUTE) {
       compute = modify->compute[icompute];
+      modify->invoke_begin(compute);
       compute->compute_per_grid();
+      modify->invoke_end();
       if (compute->post_process_grid_flag)
         compute->post_process_grid(valindex,1,NULL,NULL,NULL,1);
     } else if (valuewhich == FIX) fix = modify->fix[ifix];
@@ -1371,6 +1404,7 @@ void AdaptGrid::particle_surf_comm()
     sadapt[i].type = cinfo[icell].type;
     sadapt[i].ichild = outbuf[i].ichild;
     sadapt[i].nsurf = cells[icell].nsurf;
+    sadapt[i].wfactor = grid->weight_factor(icell);
 
     nsplit = cells[icell].nsplit;
     if (nsplit == 1) sadapt[i].np = cinfo[icell].count;
@@ -1429,6 +1463,8 @@ void AdaptGrid::particle_surf_comm()
       alist[m].anyinside = 0;
       nchild = plevels[s->plevel].nxyz;
       alist[m].nchild = nchild;
+      alist[m].npsum = 0;
+      alist[m].wsum = alist[m].wchild = 0.0;
       alist[m].index = new int[nchild];
       alist[m].nsurf = new int[nchild];
       alist[m].np = new int[nchild];
@@ -1438,6 +1474,10 @@ void AdaptGrid::particle_surf_comm()
 
     if (s->type == INSIDE) alist[m].anyinside = 1;
 
+    alist[m].npsum += s->np;
+    alist[m].wsum += s->np * s->wfactor;
+    alist[m].wchild += s->wfactor;
+
     ichild = s->ichild;
     if (s->proc == me) alist[m].index[ichild] = s->icell;
     else alist[m].index[ichild] = -1;
@@ -1481,6 +1521,7 @@ int AdaptGrid::perform_coarsen()
   int i,m,icell,nchild,newcell,mask;
   int plevel,nsplit,jcell,ip;
   cellint parentID;
+  double wfactor;
   double plo[3],phi[3];
   int *csubs;
 
@@ -1496,6 +1537,10 @@ int AdaptGrid::perform_coarsen()
 
   if (surf->distributed) surf->rehash();
 
+  // stash held ghosts before new cells overwrite them
+
+  if (anum) grid->stash_ghosts();
+
   // loop over coarsening action list
 
   for (i = 0; i < anum; i++) {
@@ -1528,6 +1573,14 @@ int AdaptGrid::perform_coarsen()
     mask = groupbit | 1;
     cinfo[newcell].mask = mask;
 
+    // scale static weight of new child and its sub-cells
+    //   by particle-weighted average of child weight factors
+    // factors differ from 1 only for cells whose weight fix merge changed
+
+    if (alist[i].npsum) wfactor = alist[i].wsum / alist[i].npsum;
+    else wfactor = alist[i].wchild / nchild;
+    cinfo[newcell].weight *= wfactor;
+
     if (cells[newcell].nsplit > 1) {
       sinfo = grid->sinfo;
       nsplit = cells[newcell].nsplit;
@@ -1535,6 +1588,7 @@ int AdaptGrid::perform_coarsen()
       for (int j = 0; j < nsplit; j++) {
         jcell = csubs[j];
         cinfo[jcell].mask = mask;
+        cinfo[jcell].weight = cinfo[newcell].weight;
       }
     }
 
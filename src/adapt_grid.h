@@ -42,6 +42,7 @@ class AdaptGrid : protected Pointers {
     int ichild;             // which child within parent cell (0 to Nxyz-1)
     int nsurf;              // # of surfs in child cell
     int np;                 // # of particles in child cell or all its sub cells
+    double wfactor;         // ratio of child cell weight to its static weight
   };
 
   AdaptGrid(class SPARTA *);
@@ -98,6 +99,9 @@ class AdaptGrid : protected Pointers {
     int plevel;             // level of parent cell
     int anyinside;          // 1 if any children are an INSIDE cell
     int nchild;             // # of children of parent cell
+    int npsum;              // # of particles in all children
+    double wsum;            // sum of child weight factors, particle weighted
+    double wchild;          // sum of child weight factors
     int *index;             // local icell if I own each child cell, else -1
     int *nsurf;             // # of surfs in each child cell
     int *np;                // # of particles in each child cell
@@ -478,6 +478,7 @@ template < int NEARCP > void Collide::collisions_one()
 
     ip = cinfo[icell].first;
     volume = cinfo[icell].volume / cinfo[icell].weight;
+    if (grid->dtlevelflag) volume /= grid->dtscale(icell);
     if (volume == 0.0) error->one(FLERR,"Collision cell volume is zero");
 
     // setup particle list for this cell
@@ -615,6 +616,7 @@ template < int NEARCP > void Collide::collisions_group()
     if (np <= 1) continue;
     ip = cinfo[icell].first;
     volume = cinfo[icell].volume / cinfo[icell].weight;
+    if (grid->dtlevelflag) volume /= grid->dtscale(icell);
     if (volume == 0.0) error->one(FLERR,"Collision cell volume is zero");
 
     // reallocate plist and p2g if necessary
@@ -889,6 +891,7 @@ void Collide::collisions_one_ambipolar()
     if (np <= 1) continue;
     ip = cinfo[icell].first;
     volume = cinfo[icell].volume / cinfo[icell].weight;
+    if (grid->dtlevelflag) volume /= grid->dtscale(icell);
     if (volume == 0.0) error->one(FLERR,"Collision cell volume is zero");
 
     // setup particle list for this cell
@@ -1185,6 +1188,7 @@ void Collide::collisions_group_ambipolar()
     if (np <= 1) continue;
     ip = cinfo[icell].first;
     volume = cinfo[icell].volume / cinfo[icell].weight;
+    if (grid->dtlevelflag) volume /= grid->dtscale(icell);
     if (volume == 0.0) error->one(FLERR,"Collision cell volume is zero");
 
     // reallocate plist and p2g if necessary
@@ -1860,8 +1864,10 @@ int Collide::find_nn(int i, int np)
   double dt = update->dt;
 
   // thresh = distance particle I moves in this timestep
+  // use local timestep of cell if defined
 
   ipart = &particles[plist[i]];
+  if (grid->dtlevelflag) dt *= grid->dtscale(ipart->icell);
   double *vi = ipart->v;
   double *xi = ipart->x;
   double threshsq =  dt*dt * (vi[0]*vi[0]+vi[1]*vi[1]+vi[2]*vi[2]);
@@ -1949,8 +1955,10 @@ int Collide::find_nn_group(int i, int *ilist, int np, int *jlist, int *plist,
   double dt = update->dt;
 
   // thresh = distance particle I moves in this timestep
+  // use local timestep of cell if defined
 
   ipart = &particles[plist[ilist[i]]];
+  if (grid->dtlevelflag) dt *= grid->dtscale(ipart->icell);
   double *vi = ipart->v;
   double *xi = ipart->x;
   double threshsq =  dt*dt * (vi[0]*vi[0]+vi[1]*vi[1]+vi[2]*vi[2]);
@@ -137,6 +137,7 @@ double CollideVSS::attempt_collision(int icell, int np, double volume)
 {
   double fnum = update->fnum;
   double dt = update->dt;
+  if (grid->dtlevelflag) dt *= grid->dtscale(icell);
 
   double nattempt;
 
@@ -159,6 +160,7 @@ double CollideVSS::attempt_collision(int icell, int igroup, int jgroup,
 {
  double fnum = update->fnum;
  double dt = update->dt;
+ if (grid->dtlevelflag) dt *= grid->dtscale(icell);
 
  double nattempt;
 
@@ -85,33 +85,52 @@ Comm::~Comm()
 /* ----------------------------------------------------------------------
    reset neighbor list used in particle comm and setup irregular for them
    invoked after grid decomposition changes
+   irregular setup is skipped if no proc's neighbor list changed,
+     e.g. when grid adaptation only changed cells interior to procs
    no-op if commpartstyle not set or grid decomposition not clumped
      since different mode of irregular comm will be done
 ------------------------------------------------------------------------- */
 
 void Comm::reset_neighbors()
 {
+  int neighflag_prev = neighflag;
   neighflag = 0;
   if (!commpartstyle || !grid->clumped) return;
   neighflag = 1;
 
-  if (neighlist == NULL)
-    memory->create(neighlist,nprocs,"comm:neighlist");
-  for (int i = 0; i < nprocs; i++) neighlist[i] = 0;
+  int *newlist;
+  memory->create(newlist,nprocs,"comm:newlist");
+  for (int i = 0; i < nprocs; i++) newlist[i] = 0;
 
   Grid::ChildCell *cells = grid->cells;
   int nglocal = grid->nlocal;
   int ntotal = nglocal + grid->nghost;
 
   for (int icell = nglocal; icell < ntotal; icell++)
-    neighlist[cells[icell].proc] = 1;
-  neighlist[me] = 0;
+    newlist[cells[icell].proc] = 1;
+  newlist[me] = 0;
 
-  nneigh = 0;
+  int nneigh_new = 0;
   for (int i = 0; i < nprocs; i++)
-    if (neighlist[i]) neighlist[nneigh++] = i;
+    if (newlist[i]) newlist[nneigh_new++] = i;
 
-  iparticle->create_procs(nneigh,neighlist,commsortflag);
+  // change = 1 if my list differs from the one iparticle was setup with
+
+  int change = 0;
+  if (!neighflag_prev || nneigh_new != nneigh) change = 1;
+  else {
+    for (int i = 0; i < nneigh; i++)
+      if (newlist[i] != neighlist[i]) change = 1;
+  }
+
+  int anychange;
+  MPI_Allreduce(&change,&anychange,1,MPI_INT,MPI_MAX,world);
+
+  memory->destroy(neighlist);
+  neighlist = newlist;
+  nneigh = nneigh_new;
+
+  if (anychange) iparticle->create_procs(nneigh,neighlist,commsortflag);
 }
 
 /* ----------------------------------------------------------------------
@@ -201,8 +220,9 @@ int Comm::migrate_particles(int nmigrate, int *plist)
     nrecv = iparticle->create_data_uniform(nsend,pproc,commsortflag);
 
   // extend particle list if necessary
+  // pnew = where received particles are appended
 
-  particle->grow(nrecv);
+  Particle::OnePart *pnew = particle->reserve(nrecv);
 
   // perform irregular communication
   // if no custom attributes, append recv particles directly to particle list
@@ -210,8 +230,7 @@ int Comm::migrate_particles(int nmigrate, int *plist)
 
   if (!ncustom)
     iparticle->
-      exchange_uniform(sbuf,nbytes,
-                       (char *) &particle->particles[particle->nlocal]);
+      exchange_uniform(sbuf,nbytes,(char *) pnew);
 
   else {
     if (nrecv*nbytes > maxrecvbuf) {
@@ -225,15 +244,14 @@ int Comm::migrate_particles(int nmigrate, int *plist)
     offset = 0;
     int nlocal = particle->nlocal;
     for (i = 0; i < nrecv; i++) {
-      memcpy(&particle->particles[nlocal],&rbuf[offset],nbytes_particle);
+      memcpy(&pnew[i],&rbuf[offset],nbytes_particle);
       offset += nbytes_particle;
-      particle->unpack_custom(&rbuf[offset],nlocal);
+      particle->unpack_custom(&rbuf[offset],nlocal+i);
       offset += nbytes_custom;
-      nlocal++;
     }
   }
 
-  particle->nlocal += nrecv;
+  particle->commit(nrecv);
   ncomm += nsend;
   return ncompress;
 }
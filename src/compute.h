@@ -90,6 +90,8 @@ class Compute : protected Pointers {
                           Particle::OnePart *, Particle::OnePart *) {}
   virtual void boundary_tally(int, int, int, Particle::OnePart *,
                               Particle::OnePart *, Particle::OnePart *) {}
+  virtual void post_surf_tally() {}
+  virtual void post_boundary_tally() {}
 
   virtual void post_process_grid(int, int, double **, int *, double *, int) {}
   // NOTE: get rid of this method at some point
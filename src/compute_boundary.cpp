@@ -22,6 +22,7 @@
 #include "domain.h"
 #include "modify.h"
 #include "math_extra.h"
+#include "tally_stage.h"
 #include "memory.h"
 #include "error.h"
 #include "math_const.h"
@@ -76,6 +77,7 @@ ComputeBoundary::ComputeBoundary(SPARTA *sparta, int narg, char **arg) :
 
   memory->create(array,size_array_rows,size_array_cols,"boundary:array");
   memory->create(myarray,size_array_rows,size_array_cols,"boundary:array");
+  stage = new TallyStage(sparta,ntotal);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -87,6 +89,7 @@ ComputeBoundary::~ComputeBoundary()
   delete [] which;
   memory->destroy(array);
   memory->destroy(myarray);
+  delete stage;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -160,6 +163,7 @@ void ComputeBoundary::clear()
   for (int i = 0; i < size_array_rows; i++)
     for (int j = 0; j < ntotal; j++)
       myarray[i][j] = 0.0;
+  stage->reset();
 }
 
 /* ----------------------------------------------------------------------
@@ -203,15 +207,18 @@ void ComputeBoundary::boundary_tally(int iface, int istyle, int reaction,
   double *vorig = iorig->v;
   double mvv2e = update->mvv2e;
 
-  double *vec = myarray[iface];
+  // values for this hit accumulate in staged slot for iface,
+  //   merged into myarray by post_boundary_tally() after the move
+
+  double *vec = stage->slot(iface);
   int k = igroup*nvalue;
   int nflag = 0;
   int tflag = 0;
 
   if (istyle == PERIODIC) {
     for (int m = 0; m < nvalue; m++) {
-      if (which[m] == NUM) myarray[iface][k++] += 1.0;
-      else if (which[m] == NUMWT) myarray[iface][k++] += weight;
+      if (which[m] == NUM) vec[k++] += 1.0;
+      else if (which[m] == NUMWT) vec[k++] += weight;
       else k++;
     }
 
@@ -379,3 +386,13 @@ void ComputeBoundary::boundary_tally(int iface, int istyle, int reaction,
     }
   }
 }
+
+/* ----------------------------------------------------------------------
+   merge values staged during the move into myarray
+   one slot per box face
+------------------------------------------------------------------------- */
+
+void ComputeBoundary::post_boundary_tally()
+{
+  stage->merge(myarray);
+}
@@ -36,6 +36,7 @@ class ComputeBoundary : public Compute {
   virtual void clear();
   virtual void boundary_tally(int, int, int, Particle::OnePart *,
                               Particle::OnePart *, Particle::OnePart *);
+  virtual void post_boundary_tally();
 
  protected:
   int imix,nvalue,ngroup,ntotal,nrow;
@@ -46,6 +47,7 @@ class ComputeBoundary : public Compute {
 
   double normflux[6];            // per face normalization factors
   double **myarray;              // local accumulator array
+  class TallyStage *stage;       // tallies staged during move, merged after
 };
 
 }
@@ -394,6 +394,7 @@ void ComputeGrid::post_process_grid(int index, int nsample,
         if (norm == 0.0) vec[k] = 0.0;
         else {
           wt = fnum * cinfo[icell].weight / norm;
+          if (grid->dtlevelflag) wt *= grid->dtscale(icell);
           vec[k] = wt * etally[icell][count] / nsample;
         }
         k += nstride;
@@ -414,6 +415,7 @@ void ComputeGrid::post_process_grid(int index, int nsample,
         if (norm == 0.0) vec[k] = 0.0;
         else {
           wt = fnum * cinfo[icell].weight / norm;
+          if (grid->dtlevelflag) wt *= grid->dtscale(icell);
           vec[k] = wt * etally[icell][mass] / nsample;
         }
         k += nstride;
@@ -528,6 +530,7 @@ void ComputeGrid::post_process_grid(int index, int nsample,
         if (norm == 0.0) vec[k] = 0.0;
         else {
           wt = fnum * cinfo[icell].weight / norm;
+          if (grid->dtlevelflag) wt *= grid->dtscale(icell);
           vec[k] = wt * etally[icell][mom] / nsample;
         }
         k += nstride;
@@ -548,6 +551,7 @@ void ComputeGrid::post_process_grid(int index, int nsample,
         if (norm == 0.0) vec[k] = 0.0;
         else {
           wt = fnum * cinfo[icell].weight / norm;
+          if (grid->dtlevelflag) wt *= grid->dtscale(icell);
           vec[k] = eprefactor * wt * etally[icell][ke] / nsample;
         }
         k += nstride;
@@ -22,6 +22,7 @@
 #include "domain.h"
 #include "comm.h"
 #include "math_extra.h"
+#include "tally_stage.h"
 #include "memory.h"
 #include "error.h"
 
@@ -93,6 +94,7 @@ ComputeISurfGrid::ComputeISurfGrid(SPARTA *sparta, int narg, char **arg) :
   combined = 0;
 
   hash = new MyHash;
+  stage = new TallyStage(sparta,ntotal);
 
   dim = domain->dimension;
 }
@@ -107,6 +109,7 @@ ComputeISurfGrid::~ComputeISurfGrid()
   memory->destroy(array_grid);
   memory->destroy(normflux);
   delete hash;
+  delete stage;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -200,6 +203,7 @@ void ComputeISurfGrid::clear()
 
   hash->clear();
   ntally = 0;
+  stage->reset();
   combined = 0;
 }
 
@@ -229,6 +233,8 @@ void ComputeISurfGrid::surf_tally(int isurf, int icell, int reaction,
   // if 1st particle hitting isurf, add surf ID to hash
   // grow tally list if needed
   // for implicit surfs, surfID is really a cellID
+  // values for this hit accumulate in staged slot itally,
+  //   merged into tally array by post_surf_tally() after the move
 
   int itally;
   double *vec;
@@ -248,6 +254,8 @@ void ComputeISurfGrid::surf_tally(int isurf, int icell, int reaction,
     ntally++;
   }
 
+  vec = stage->slot(itally);
+
   double fluxscale = normflux[isurf];
 
   // tally all values associated with group into array
@@ -273,7 +281,6 @@ void ComputeISurfGrid::surf_tally(int isurf, int icell, int reaction,
   double *vorig = iorig->v;
   double mvv2e = update->mvv2e;
 
-  vec = array_surf_tally[itally];
   int k = igroup*nvalue;
   int fflag = 0;
   int nflag = 0;
@@ -430,6 +437,16 @@ void ComputeISurfGrid::surf_tally(int isurf, int icell, int reaction,
   }
 }
 
+/* ----------------------------------------------------------------------
+   merge values staged since last merge into tally array
+   one slot per tally index, so cost scales with # of tallied surfs
+------------------------------------------------------------------------- */
+
+void ComputeISurfGrid::post_surf_tally()
+{
+  stage->merge(array_surf_tally);
+}
+
 /* ----------------------------------------------------------------------
    return # of tallies and their indices into my local surf list
 ------------------------------------------------------------------------- */
@@ -534,5 +551,6 @@ bigint ComputeISurfGrid::memory_usage()
   bytes += ntotal*maxgrid * sizeof(double);     // array_grid
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += stage->memory_usage();               // staged hits
   return bytes;
 }
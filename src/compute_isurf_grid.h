@@ -37,6 +37,7 @@ class ComputeISurfGrid : public Compute {
   virtual void clear();
   virtual void surf_tally(int, int, int, Particle::OnePart *,
                           Particle::OnePart *, Particle::OnePart *);
+  virtual void post_surf_tally();
   virtual int tallyinfo(surfint *&);
   void post_process_isurf_grid();
   void reallocate();
@@ -64,6 +65,8 @@ class ComputeISurfGrid : public Compute {
 
   MyHash *hash;
 
+  class TallyStage *stage;  // tallies staged during move, merged after
+
   int dim;                 // local copies
   Grid::ChildInfo *cinfo;
   Surf::Line *lines;
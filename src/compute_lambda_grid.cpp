@@ -16,6 +16,8 @@
 #include "compute_lambda_grid.h"
 #include "update.h"
 #include "grid.h"
+#include "particle.h"
+#include "mixture.h"
 #include "domain.h"
 #include "collide.h"
 #include "modify.h"
@@ -28,7 +30,7 @@
 using namespace SPARTA_NS;
 using namespace MathConst;
 
-enum{NONE,COMPUTE,FIX};
+enum{NONE,COMPUTE,FIX,TALLY};
 enum{KNONE,KALL,KX,KY,KZ};
 
 #define INVOKED_PER_GRID 16
@@ -44,8 +46,10 @@ ComputeLambdaGrid::ComputeLambdaGrid(SPARTA *sparta, int narg, char **arg) :
 
   // parse three required input fields
   // customize a new keyword by adding to if statement
+  // nrho = mixture ID tallies number density from particles directly
 
   id_nrho = id_temp = NULL;
+  imix = -1;
 
   if (strncmp(arg[2],"c_",2) == 0 || strncmp(arg[2],"f_",2) == 0) {
     int n = strlen(arg[2]);
@@ -97,7 +101,12 @@ ComputeLambdaGrid::ComputeLambdaGrid(SPARTA *sparta, int narg, char **arg) :
         error->all(FLERR,"Compute lambda/grid fix array is "
                    "accessed out-of-range");
     }
-  } else error->all(FLERR,"Illegal compute lambda/grid command");
+  } else {
+    imix = particle->find_mixture(arg[2]);
+    if (imix < 0)
+      error->all(FLERR,"Compute lambda/grid mixture ID does not exist");
+    nrhowhich = TALLY;
+  }
 
   if (strncmp(arg[3],"c_",2) == 0 || strncmp(arg[3],"f_",2) == 0) {
     int n = strlen(arg[3]);
@@ -150,7 +159,11 @@ ComputeLambdaGrid::ComputeLambdaGrid(SPARTA *sparta, int narg, char **arg) :
                    "accessed out-of-range");
     }
   } else if (strcmp(arg[3],"NULL") == 0) tempwhich = NONE;
-  else error->all(FLERR,"Illegal compute lambda/grid command");
+  else if (strcmp(arg[3],"thermal") == 0) {
+    if (nrhowhich != TALLY)
+      error->all(FLERR,"Compute lambda/grid thermal requires a mixture ID");
+    tempwhich = TALLY;
+  } else error->all(FLERR,"Illegal compute lambda/grid command");
 
   int n = strlen(arg[4]) + 1;
   species = new char[n];
@@ -180,6 +193,10 @@ ComputeLambdaGrid::ComputeLambdaGrid(SPARTA *sparta, int narg, char **arg) :
   vector_grid = NULL;
   array_grid = NULL;
   nrho = temp = NULL;
+
+  if (tempwhich == TALLY) ntally = 6;
+  else ntally = 1;
+  tally = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -195,6 +212,7 @@ ComputeLambdaGrid::~ComputeLambdaGrid()
   memory->destroy(array_grid);
   memory->destroy(nrho);
   memory->destroy(temp);
+  memory->destroy(tally);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -243,6 +261,7 @@ void ComputeLambdaGrid::init()
   tref = collide->extract(ispecies,ispecies,"tref");
   omega = collide->extract(ispecies,ispecies,"omega");
   prefactor = sqrt(2.0) * MY_PI * dref*dref;
+  tprefactor = update->mvv2e / (3.0*update->boltz);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -256,12 +275,17 @@ void ComputeLambdaGrid::compute_per_grid()
   if (tempwhich == FIX && update->ntimestep % ftemp->per_grid_freq)
     error->all(FLERR,"Compute lambda/grid fix not computed at compatible time");
 
-  // grab nrho and temp values from compute or fix
+  // tally nrho and optionally temp from particles in a single sweep
+  // else grab nrho and temp values from compute or fix
   // invoke nrho and temp computes as needed
 
+  if (nrhowhich == TALLY) tally_particles();
+
   if (nrhowhich == COMPUTE) {
     if (!(cnrho->invoked_flag & INVOKED_PER_GRID)) {
+      modify->invoke_begin(cnrho);
       cnrho->compute_per_grid();
+      modify->invoke_end();
       cnrho->invoked_flag |= INVOKED_PER_GRID;
     }
 
@@ -290,7 +314,9 @@ void ComputeLambdaGrid::compute_per_grid()
 
   if (tempwhich == COMPUTE) {
     if (!(ctemp->invoked_flag & INVOKED_PER_GRID)) {
+      modify->invoke_begin(ctemp);
       ctemp->compute_per_grid();
+      modify->invoke_end();
       ctemp->invoked_flag |= INVOKED_PER_GRID;
     }
 
@@ -364,6 +390,76 @@ void ComputeLambdaGrid::compute_per_grid()
   }
 }
 
+/* ----------------------------------------------------------------------
+   set nrho, and temp if requested, from one loop over particles
+   same values as compute grid nrho and compute thermal/grid temp
+     for all species in the mixture as a single group
+------------------------------------------------------------------------- */
+
+void ComputeLambdaGrid::tally_particles()
+{
+  Grid::ChildInfo *cinfo = grid->cinfo;
+  Particle::Species *species = particle->species;
+  Particle::OnePart *particles = particle->particles;
+  int *s2g = particle->mixture[imix]->species2group;
+  int nlocal = particle->nlocal;
+
+  int i,j,ispecies;
+  double mass;
+  double *v,*vec;
+
+  for (i = 0; i < nglocal; i++)
+    for (j = 0; j < ntally; j++)
+      tally[i][j] = 0.0;
+
+  // 6 tallies per particle: N, Mass, mVx, mVy, mVz, mV^2
+  // only N if temp is not tallied
+
+  for (i = 0; i < nlocal; i++) {
+    ispecies = particles[i].ispecies;
+    if (s2g[ispecies] < 0) continue;
+
+    vec = tally[particles[i].icell];
+    vec[0] += 1.0;
+    if (tempwhich != TALLY) continue;
+
+    mass = species[ispecies].mass;
+    v = particles[i].v;
+    vec[1] += mass;
+    vec[2] += mass*v[0];
+    vec[3] += mass*v[1];
+    vec[4] += mass*v[2];
+    vec[5] += mass * (v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
+  }
+
+  // nrho = N * fnum * weight / volume
+  // thermal temp = (Sum mv^2 - |Sum mv|^2 / Sum m) * tprefactor / N
+
+  double fnum = update->fnum;
+  double wt,mvx,mvy,mvz;
+
+  for (i = 0; i < nglocal; i++) {
+    vec = tally[i];
+    if (cinfo[i].volume == 0.0) nrho[i] = 0.0;
+    else {
+      wt = fnum * cinfo[i].weight / cinfo[i].volume;
+      if (grid->dtlevelflag) wt *= grid->dtscale(i);
+      nrho[i] = wt * vec[0];
+    }
+
+    if (tempwhich != TALLY) continue;
+
+    if (vec[0] <= 1.0) temp[i] = 0.0;
+    else {
+      mvx = vec[2];
+      mvy = vec[3];
+      mvz = vec[4];
+      temp[i] = vec[5] - (mvx*mvx + mvy*mvy + mvz*mvz)/vec[1];
+      temp[i] *= tprefactor / vec[0];
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    reallocate arrays if nglocal has changed
    called by init() and load balancer
@@ -388,6 +484,10 @@ void ComputeLambdaGrid::reallocate()
     memory->destroy(temp);
     memory->create(temp,nglocal,"lambda/grid:temp");
   }
+  if (nrhowhich == TALLY) {
+    memory->destroy(tally);
+    memory->create(tally,nglocal,ntally,"lambda/grid:tally");
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -401,5 +501,6 @@ bigint ComputeLambdaGrid::memory_usage()
   if (kflag != KNONE) bytes += nglocal * sizeof(double);
   bytes += nglocal * sizeof(double);                            // nrho
   if (tempwhich != KNONE) bytes += nglocal * sizeof(double);    // temp
+  if (nrhowhich == TALLY) bytes += nglocal*ntally * sizeof(double); // tally
   return bytes;
 }
@@ -44,8 +44,15 @@ class ComputeLambdaGrid : public Compute {
   class Fix *fnrho,*ftemp;
   double *nrho,*temp;
 
+  int imix;                 // mixture whose particles are tallied directly
+  int ntally;               // # of per-cell tallies, 1 or 6
+  double **tally;           // per-cell N, Mass, mVx, mVy, mVz, mV^2
+  double tprefactor;
+
   char *species;
   double dref,tref,omega,prefactor;
+
+  void tally_particles();
 };
 
 }
@@ -61,4 +68,13 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running SPARTA to see the offending line.
 
+E: Compute lambda/grid mixture ID does not exist
+
+Self-explanatory.
+
+E: Compute lambda/grid thermal requires a mixture ID
+
+The thermal temperature can only be tallied directly from particles
+when the number density is also tallied from a mixture.
+
 */
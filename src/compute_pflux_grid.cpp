@@ -306,6 +306,7 @@ void ComputePFluxGrid::post_process_grid(int index, int nsample,
         if (summass == 0.0) vec[k] = 0.0;
         else {
           wt = fnum * cinfo[icell].weight / cinfo[icell].volume;
+          if (grid->dtlevelflag) wt *= grid->dtscale(icell);
           summv = etally[icell][mv];
           vec[k] = wt/nsample * (etally[icell][mvv] - summv*summv/summass);
         }
@@ -331,6 +332,7 @@ void ComputePFluxGrid::post_process_grid(int index, int nsample,
         if (summass == 0.0) vec[k] = 0.0;
         else {
           wt = fnum * cinfo[icell].weight / cinfo[icell].volume;
+          if (grid->dtlevelflag) wt *= grid->dtscale(icell);
           vec[k] = wt/nsample * (etally[icell][mvv] -
                                  etally[icell][mv1]*etally[icell][mv2]/summass);
         }
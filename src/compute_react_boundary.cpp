@@ -19,6 +19,7 @@
 #include "comm.h"
 #include "surf.h"
 #include "surf_react.h"
+#include "tally_stage.h"
 #include "memory.h"
 #include "error.h"
 
@@ -93,6 +94,7 @@ ComputeReactBoundary(SPARTA *sparta, int narg, char **arg) :
 
   memory->create(array,size_array_rows,size_array_cols,"react/boundary:array");
   memory->create(myarray,size_array_rows,size_array_cols,"react/boundary:array");
+  stage = new TallyStage(sparta,ntotal);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -102,6 +104,7 @@ ComputeReactBoundary::~ComputeReactBoundary()
   memory->destroy(reaction2col);
   memory->destroy(array);
   memory->destroy(myarray);
+  delete stage;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -141,6 +144,7 @@ void ComputeReactBoundary::clear()
   for (int i = 0; i < size_array_rows; i++)
     for (int j = 0; j < ntotal; j++)
       myarray[i][j] = 0.0;
+  stage->reset();
 }
 
 /* ----------------------------------------------------------------------
@@ -167,11 +171,12 @@ void ComputeReactBoundary::boundary_tally(int iface, int istyle, int reaction,
 
   if (surf_react[iface] != isr) return;
 
-  // tally the reaction
+  // reaction accumulates in staged slot for iface,
+  //   merged into myarray by post_boundary_tally() after the move
   // for rpflag, tally each column if r2c is 1 for this reaction
   // for rpflag = 0, tally the reaction directly
 
-  double *vec = myarray[iface];
+  double *vec = stage->slot(iface);
 
   if (rpflag) {
     int *r2c = reaction2col[reaction];
@@ -179,3 +184,13 @@ void ComputeReactBoundary::boundary_tally(int iface, int istyle, int reaction,
       if (r2c[i]) vec[i] += 1.0;
   } else vec[reaction] += 1.0;
 }
+
+/* ----------------------------------------------------------------------
+   merge reactions staged during the move into myarray
+   one slot per box face
+------------------------------------------------------------------------- */
+
+void ComputeReactBoundary::post_boundary_tally()
+{
+  stage->merge(myarray);
+}
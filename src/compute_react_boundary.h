@@ -35,6 +35,7 @@ class ComputeReactBoundary : public Compute {
   virtual void clear();
   virtual void boundary_tally(int, int, int, Particle::OnePart *,
                               Particle::OnePart *, Particle::OnePart *);
+  virtual void post_boundary_tally();
 
  protected:
   int isr,ntotal,nrow,rpflag;
@@ -43,6 +44,7 @@ class ComputeReactBoundary : public Compute {
   int **reaction2col;      // 1 if ireaction triggers tally for icol
 
   double **myarray;        // local accumulator array
+  class TallyStage *stage; // tallies staged during move, merged after
 };
 
 }
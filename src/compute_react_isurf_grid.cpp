@@ -23,6 +23,7 @@
 #include "domain.h"
 #include "comm.h"
 #include "math_extra.h"
+#include "tally_stage.h"
 #include "memory.h"
 #include "error.h"
 
@@ -109,6 +110,7 @@ ComputeReactISurfGrid(SPARTA *sparta, int narg, char **arg) :
   combined = 0;
 
   hash = new MyHash;
+  stage = new TallyStage(sparta,ntotal);
 
   dim = domain->dimension;
 }
@@ -122,6 +124,7 @@ ComputeReactISurfGrid::~ComputeReactISurfGrid()
   memory->destroy(tally2surf);
   memory->destroy(array_grid);
   delete hash;
+  delete stage;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -195,6 +198,7 @@ void ComputeReactISurfGrid::clear()
 
   hash->clear();
   ntally = 0;
+  stage->reset();
   combined = 0;
 }
 
@@ -234,6 +238,8 @@ void ComputeReactISurfGrid::surf_tally(int isurf, int icell, int reaction,
   // if 1st reaction on this isurf, add surf ID to hash
   // grow tally list if needed
   // for implicit surfs, surfID is really a cellID
+  // reaction accumulates in staged slot itally,
+  //   merged into tally array by post_surf_tally()
 
   int itally;
   double *vec;
@@ -253,12 +259,12 @@ void ComputeReactISurfGrid::surf_tally(int isurf, int icell, int reaction,
     ntally++;
   }
 
+  vec = stage->slot(itally);
+
   // tally the reaction
   // for rpflag, tally each column if r2c is 1 for this reaction
   // for rpflag = 0, tally the reaction directly
 
-  vec = array_surf_tally[itally];
-
   if (rpflag) {
     int *r2c = reaction2col[reaction];
     for (int i = 0; i < ntotal; i++)
@@ -266,6 +272,16 @@ void ComputeReactISurfGrid::surf_tally(int isurf, int icell, int reaction,
   } else vec[reaction] += 1.0;
 }
 
+/* ----------------------------------------------------------------------
+   merge reactions staged since last merge into tally array
+   one slot per tally index, so cost scales with # of tallied surfs
+------------------------------------------------------------------------- */
+
+void ComputeReactISurfGrid::post_surf_tally()
+{
+  stage->merge(array_surf_tally);
+}
+
 /* ----------------------------------------------------------------------
    return # of tallies and their indices into my local surf list
 ------------------------------------------------------------------------- */
@@ -360,5 +376,6 @@ bigint ComputeReactISurfGrid::memory_usage()
   bytes += ntotal*maxgrid * sizeof(double);     // array_grid
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += stage->memory_usage();               // staged hits
   return bytes;
 }
@@ -18,6 +18,7 @@
 #include "domain.h"
 #include "comm.h"
 #include "surf_react.h"
+#include "tally_stage.h"
 #include "memory.h"
 #include "error.h"
 
@@ -100,6 +101,7 @@ ComputeReactSurf::ComputeReactSurf(SPARTA *sparta, int narg, char **arg) :
   combined = 0;
 
   hash = new MyHash;
+  stage = new TallyStage(sparta,ntotal);
 
   dim = domain->dimension;
 }
@@ -113,6 +115,7 @@ ComputeReactSurf::~ComputeReactSurf()
   memory->destroy(tally2surf);
   memory->destroy(array_surf);
   delete hash;
+  delete stage;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -186,6 +189,7 @@ void ComputeReactSurf::clear()
 
   hash->clear();
   ntally = 0;
+  stage->reset();
   combined = 0;
 }
 
@@ -222,6 +226,8 @@ void ComputeReactSurf::surf_tally(int isurf, int icell, int reaction,
   // itally = tally index of isurf
   // if 1st reaction on this isurf, add surf ID to hash
   // grow tally list if needed
+  // reaction accumulates in staged slot itally,
+  //   merged into tally array by post_surf_tally()
 
   int itally;
   double *vec;
@@ -241,12 +247,12 @@ void ComputeReactSurf::surf_tally(int isurf, int icell, int reaction,
     ntally++;
   }
 
+  vec = stage->slot(itally);
+
   // tally the reaction
   // for rpflag, tally each column if r2c is 1 for this reaction
   // for rpflag = 0, tally the reaction directly
 
-  vec = array_surf_tally[itally];
-
   if (rpflag) {
     int *r2c = reaction2col[reaction];
     for (int i = 0; i < ntotal; i++)
@@ -254,6 +260,16 @@ void ComputeReactSurf::surf_tally(int isurf, int icell, int reaction,
   } else vec[reaction] += 1.0;
 }
 
+/* ----------------------------------------------------------------------
+   merge reactions staged since last merge into tally array
+   one slot per tally index, so cost scales with # of tallied surfs
+------------------------------------------------------------------------- */
+
+void ComputeReactSurf::post_surf_tally()
+{
+  stage->merge(array_surf_tally);
+}
+
 /* ----------------------------------------------------------------------
    return # of tallies and their indices into my local surf list
 ------------------------------------------------------------------------- */
@@ -314,5 +330,6 @@ bigint ComputeReactSurf::memory_usage()
   bigint bytes = 0;
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += stage->memory_usage();               // staged hits
   return bytes;
 }
@@ -36,6 +36,7 @@ class ComputeReactSurf : public Compute {
   virtual void clear();
   virtual void surf_tally(int, int, int, Particle::OnePart *,
                           Particle::OnePart *, Particle::OnePart *);
+  virtual void post_surf_tally();
   virtual int tallyinfo(surfint *&);
   virtual void post_process_surf();
   bigint memory_usage();
@@ -64,6 +65,8 @@ class ComputeReactSurf : public Compute {
 
   MyHash *hash;
 
+  class TallyStage *stage;  // tallies staged during move, merged after
+
   int dim;                 // local copies
   Surf::Line *lines;
   Surf::Tri *tris;
@@ -276,9 +276,10 @@ ComputeReduce::ComputeReduce(SPARTA *spa, int narg, char **arg) :
         error->all(FLERR,"Variable name for compute reduce does not exist");
       if (input->variable->particle_style(ivariable)) flavor[i] = PARTICLE;
       else if (input->variable->grid_style(ivariable)) flavor[i] = GRID;
+      else if (input->variable->surf_style(ivariable)) flavor[i] = SURF;
       else
         error->all(FLERR,"Compute reduce variable is not "
-                   "particle-style or grid-style variable");
+                   "particle-style or grid-style or surf-style variable");
     }
 
     // require all values have same flavor
@@ -308,8 +309,8 @@ ComputeReduce::ComputeReduce(SPARTA *spa, int narg, char **arg) :
     owner = new int[size_vector];
   }
 
-  maxparticle = maxgrid = 0;
-  varparticle = vargrid = NULL;
+  maxparticle = maxgrid = maxsurf = 0;
+  varparticle = vargrid = varsurf = NULL;
   areasurf = NULL;
 }
 
@@ -334,6 +335,7 @@ ComputeReduce::~ComputeReduce()
 
   memory->destroy(varparticle);
   memory->destroy(vargrid);
+  memory->destroy(varsurf);
   memory->destroy(areasurf);
 }
 
@@ -590,7 +592,9 @@ double ComputeReduce::compute_one(int m, int flag)
 
     if (flavor[m] == PARTICLE) {
       if (!(c->invoked_flag & INVOKED_PER_PARTICLE)) {
+        modify->invoke_begin(c);
         c->compute_per_particle();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_PARTICLE;
       }
 
@@ -619,7 +623,9 @@ double ComputeReduce::compute_one(int m, int flag)
 
     } else if (flavor[m] == GRID) {
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
 
@@ -790,7 +796,7 @@ double ComputeReduce::compute_one(int m, int flag)
       }
     }
 
-  // evaluate particle-style or grid-style variable
+  // evaluate particle-style or grid-style or surf-style variable
 
   } else if (which[m] == VARIABLE) {
     if (flavor[m] == PARTICLE) {
@@ -826,6 +832,48 @@ double ComputeReduce::compute_one(int m, int flag)
           combine(one,vargrid[i],i);
         }
       } else one = vargrid[flag];
+
+    } else if (flavor[m] == SURF) {
+      int n = surf->nown;
+      if (n > maxsurf) {
+        maxsurf = n;
+        memory->destroy(varsurf);
+        memory->create(varsurf,maxsurf,"reduce:varsurf");
+      }
+
+      input->variable->compute_surf(vidx,varsurf,1,0);
+
+      int dimension = domain->dimension;
+      Surf::Line *lines = surf->lines;
+      Surf::Line *mylines = surf->mylines;
+      Surf::Tri *tris = surf->tris;
+      Surf::Tri *mytris = surf->mytris;
+      int distributed = surf->distributed;
+
+      if (flag < 0) {
+
+        // mask/group logic for selecting surfs matches DumpSurf
+
+        for (i = 0; i < n; i++) {
+          if (subsetID) {
+            if (dimension == 2) {
+              if (!distributed) {
+                if (!(lines[me+i*nprocs].mask & surfgroupbit)) continue;
+              } else {
+                if (!(mylines[i].mask & surfgroupbit)) continue;
+              }
+            } else {
+              if (!distributed) {
+                if (!(tris[me+i*nprocs].mask & surfgroupbit)) continue;
+              } else {
+                if (!(mytris[i].mask & surfgroupbit)) continue;
+              }
+            }
+          }
+
+          combine(one,areasurf[i]*varsurf[i],i);
+        }
+      } else one = varsurf[flag];
     }
   }
 
@@ -975,5 +1023,6 @@ bigint ComputeReduce::memory_usage()
 {
   bigint bytes = maxparticle * sizeof(double);
   bytes += maxgrid * sizeof(double);
+  bytes += maxsurf * sizeof(double);
   return bytes;
 }
@@ -49,8 +49,8 @@ class ComputeReduce : public Compute {
   int *s2g;
   int gridgroupbit,surfgroupbit;
 
-  int maxparticle,maxgrid;
-  double *varparticle,*vargrid;
+  int maxparticle,maxgrid,maxsurf;
+  double *varparticle,*vargrid,*varsurf;
   double *areasurf;
 
   struct Pair {
@@ -156,9 +156,9 @@ E: Variable name for compute reduce does not exist
 
 Self-explanatory.
 
-E: Compute reduce variable is not particle-style variable
+E: Compute reduce variable is not particle-style or grid-style or surf-style variable
 
-This is the only style of variable that can be reduced.
+These are the only styles of variable that can be reduced.
 
 E: Fix used in compute reduce not computed at compatible time
 
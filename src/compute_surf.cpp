@@ -22,6 +22,7 @@
 #include "modify.h"
 #include "domain.h"
 #include "math_extra.h"
+#include "tally_stage.h"
 #include "memory.h"
 #include "error.h"
 
@@ -114,6 +115,7 @@ ComputeSurf::ComputeSurf(SPARTA *sparta, int narg, char **arg) :
   combined = 0;
 
   hash = new MyHash;
+  stage = new TallyStage(sparta,ntotal);
 
   dim = domain->dimension;
 }
@@ -130,6 +132,7 @@ ComputeSurf::~ComputeSurf()
   memory->destroy(array_surf);
   memory->destroy(normflux);
   delete hash;
+  delete stage;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -225,6 +228,7 @@ void ComputeSurf::clear()
   hash->clear();
   ntally = 0;
   combined = 0;
+  stage->reset();
 }
 
 /* ----------------------------------------------------------------------
@@ -258,6 +262,8 @@ void ComputeSurf::surf_tally(int isurf, int icell, int reaction,
   // itally = tally index of isurf
   // if 1st particle hitting isurf, add surf ID to hash
   // grow tally list if needed
+  // values for this hit accumulate in staged slot itally,
+  //   merged into tally array by post_surf_tally() after the move
 
   int itally,transparent;
   double *vec;
@@ -282,6 +288,8 @@ void ComputeSurf::surf_tally(int isurf, int icell, int reaction,
     ntally++;
   }
 
+  vec = stage->slot(itally);
+
   double fluxscale = normflux[isurf];
 
   // tally all values associated with group into array
@@ -308,7 +316,6 @@ void ComputeSurf::surf_tally(int isurf, int icell, int reaction,
   double *vorig = iorig->v;
   double mvv2e = update->mvv2e;
 
-  vec = array_surf_tally[itally];
   int k = igroup*nvalue;
   int fflag = 0;
   int nflag = 0;
@@ -495,6 +502,16 @@ void ComputeSurf::surf_tally(int isurf, int icell, int reaction,
   }
 }
 
+/* ----------------------------------------------------------------------
+   merge values staged during the move into tally array
+   one slot per tally index, so cost scales with # of tallied surfs
+------------------------------------------------------------------------- */
+
+void ComputeSurf::post_surf_tally()
+{
+  stage->merge(array_surf_tally);
+}
+
 /* ----------------------------------------------------------------------
    return # of tallies and their indices into my local surf list
 ------------------------------------------------------------------------- */
@@ -574,5 +591,6 @@ bigint ComputeSurf::memory_usage()
   bigint bytes = 0;
   bytes += ntotal*maxtally * sizeof(double);    // array_surf_tally
   bytes += maxtally * sizeof(surfint);          // tally2surf
+  bytes += stage->memory_usage();               // staged hits
   return bytes;
 }
@@ -37,6 +37,7 @@ class ComputeSurf : public Compute {
   virtual void clear();
   virtual void surf_tally(int, int, int, Particle::OnePart *,
                           Particle::OnePart *, Particle::OnePart *);
+  virtual void post_surf_tally();
   virtual int tallyinfo(surfint *&);
   virtual void post_process_surf();
   void reallocate();
@@ -65,6 +66,8 @@ class ComputeSurf : public Compute {
 
   MyHash *hash;
 
+  class TallyStage *stage;  // tallies staged during move, merged after
+
   int dim;                 // local copies
   Surf::Line *lines;
   Surf::Tri *tris;
@@ -20,6 +20,7 @@
 #include "particle.h"
 #include "mixture.h"
 #include "grid.h"
+#include "surf.h"
 #include "modify.h"
 #include "comm.h"
 #include "domain.h"
@@ -28,6 +29,7 @@
 #include "variable.h"
 #include "random_mars.h"
 #include "random_knuth.h"
+#include "random_counter.h"
 #include "math_const.h"
 #include "memory.h"
 #include "error.h"
@@ -173,8 +175,17 @@ void CreateParticles::command(int narg, char **arg)
     } else error->all(FLERR,"Illegal create_particles command");
   }
 
-  if (globalflag)
-    error->all(FLERR,"Create_particles global option not yet implemented");
+  if (globalflag && !single) {
+    if (densflag)
+      error->all(FLERR,"Cannot use create_particles global yes "
+                 "with density variable");
+    if (grid->cellweightflag || grid->dtlevelflag)
+      error->all(FLERR,"Cannot use create_particles global yes "
+                 "with cell weighting");
+    if (domain->axisymmetric)
+      error->all(FLERR,"Cannot use create_particles global yes "
+                 "with axisymmetric domain");
+  }
 
   // error checks and further setup for variables
 
@@ -324,21 +335,20 @@ void CreateParticles::command(int narg, char **arg)
   else if (!globalflag) {
     if (twopass) create_local_twopass();
     else create_local();
-  } else {
-    error->all(FLERR,"Create_particles global option not yet implemented");
-    // create_global();
-  }
+  } else create_global();
 
   MPI_Barrier(world);
   double time2 = MPI_Wtime();
 
   // issue warning if created particle count is unexpected
   // only if no region and no variable density specified
+  // global option drops particles created inside surfs, so skip it then
 
   bigint nglobal;
   bigint nme = particle->nlocal;
   MPI_Allreduce(&nme,&nglobal,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
-  if (!region && !densflag && nglobal-nprevious != np) {
+  if (!region && !densflag && !(globalflag && surf->exist) &&
+      nglobal-nprevious != np) {
     char str[128];
     sprintf(str,"Created unexpected # of particles: "
 	    BIGINT_FORMAT " versus " BIGINT_FORMAT,
@@ -470,9 +480,11 @@ void CreateParticles::create_local()
         outside_region(dimension,cells[icell].lo,cells[icell].hi))
       continue;
 
-    flowvolme += cinfo[icell].volume / cinfo[icell].weight;
+    flowvolme += cinfo[icell].volume / cinfo[icell].weight /
+      grid->dtscale(icell);
     if (!cutflag && cells[icell].nsurf) continue;
-    insertvolme += cinfo[icell].volume / cinfo[icell].weight;
+    insertvolme += cinfo[icell].volume / cinfo[icell].weight /
+      grid->dtscale(icell);
   }
 
   // calculate total Np if not set explicitly
@@ -558,7 +570,8 @@ void CreateParticles::create_local()
       continue;
     if (!cutflag && cells[icell].nsurf) continue;
 
-    volsum += cinfo[icell].volume / cinfo[icell].weight;
+    volsum += cinfo[icell].volume / cinfo[icell].weight /
+      grid->dtscale(icell);
 
     ntarget = nme * volsum/insertvolme - nprev;
     npercell = static_cast<int> (ntarget);
@@ -581,6 +594,8 @@ void CreateParticles::create_local()
     if (cells[icell].nsurf)
       pflag = grid->point_outside_surfs(icell,xcell);
 
+    particle->reserve(ncreate);
+
     for (int m = 0; m < ncreate; m++) {
 
       // generate random position X for new particle
@@ -719,9 +734,11 @@ void CreateParticles::create_local_twopass()
         outside_region(dimension,cells[icell].lo,cells[icell].hi))
       continue;
 
-    flowvolme += cinfo[icell].volume / cinfo[icell].weight;
+    flowvolme += cinfo[icell].volume / cinfo[icell].weight /
+      grid->dtscale(icell);
     if (!cutflag && cells[icell].nsurf) continue;
-    insertvolme += cinfo[icell].volume / cinfo[icell].weight;
+    insertvolme += cinfo[icell].volume / cinfo[icell].weight /
+      grid->dtscale(icell);
   }
 
   // calculate total Np if not set explicitly
@@ -802,6 +819,7 @@ void CreateParticles::create_local_twopass()
 
   int *ncreate_values;
   memory->create(ncreate_values, nglocal, "create_particles:ncreate");
+  bigint nreserve = 0;
 
   for (int icell = 0; icell < nglocal; icell++) {
     if (cinfo[icell].type == INSIDE) continue;
@@ -812,7 +830,8 @@ void CreateParticles::create_local_twopass()
       continue;
     if (!cutflag && cells[icell].nsurf) continue;
 
-    volsum += cinfo[icell].volume / cinfo[icell].weight;
+    volsum += cinfo[icell].volume / cinfo[icell].weight /
+      grid->dtscale(icell);
 
     ntarget = nme * volsum/insertvolme - nprev;
     npercell = static_cast<int> (ntarget);
@@ -831,6 +850,7 @@ void CreateParticles::create_local_twopass()
     }
 
     ncreate_values[icell] = ncreate;
+    nreserve += ncreate;
 
     // increment count without effect of density variation
     // so that target insertion count is undisturbed
@@ -839,6 +859,11 @@ void CreateParticles::create_local_twopass()
   }
 
   // second pass, create particles using ncreate_values
+  // reserve room for all of them up front
+
+  if (nreserve > MAXSMALLINT)
+    error->one(FLERR,"Per-processor particle count is too big");
+  particle->reserve(nreserve);
 
   for (int icell = 0; icell < nglocal; icell++) {
     if (cinfo[icell].type == INSIDE) continue;
@@ -956,6 +981,174 @@ void CreateParticles::create_local_twopass()
   delete random;
 }
 
+/* ----------------------------------------------------------------------
+   create Np particles with the same result on any number of procs
+   every proc loops over all Np particles and generates their coords,
+     only keeps those in cells it owns
+   particle M draws all its random numbers from stream M of a
+     counter-based RNG, so particles do not depend on how the
+     Np coords are partitioned across procs or threads
+------------------------------------------------------------------------- */
+
+void CreateParticles::create_global()
+{
+  RanCounter *random = global_setup();
+
+  particle->error_custom();
+  modify->list_init_fixes();
+  int nfix_update_custom = modify->n_update_custom;
+
+  double *boxlo = domain->boxlo;
+  double *boxhi = domain->boxhi;
+  int nglocal = grid->nlocal;
+
+  int icell;
+  double x[3];
+
+  for (bigint m = 0; m < np; m++) {
+    global_point(m,random,x);
+
+    // id_find_child() recurses from root cell to find owning child cell
+    // returned icell can be owned or ghost cell, or -1 if not stored
+
+    icell = grid->id_find_child(0,0,boxlo,boxhi,x);
+    if (icell < 0 || icell >= nglocal) continue;
+
+    global_add(icell,x,random,nfix_update_custom);
+  }
+
+  delete random;
+}
+
+/* ----------------------------------------------------------------------
+   setup for create_global() of this class and KOKKOS package
+   if Np not set, set it so particles created in flow volume have
+     mixture density, since coords are uniform in entire box
+   RNG seed is the same on all procs
+   return RNG for caller to delete
+------------------------------------------------------------------------- */
+
+RanCounter *CreateParticles::global_setup()
+{
+  if (np == 0) {
+    double boxvol = domain->xprd * domain->yprd;
+    if (domain->dimension == 3) boxvol *= domain->zprd;
+    np = static_cast<bigint>
+      (particle->mixture[imix]->nrho * boxvol / update->fnum);
+  }
+
+  if (!grid->hashfilled) grid->rehash();
+
+  double seed1 = update->ranmaster->uniform();
+  double seed2 = update->ranmaster->uniform();
+  return new RanCounter(seed1,seed2);
+}
+
+/* ----------------------------------------------------------------------
+   generate coords X of global particle M
+   leaves RNG positioned for remaining attributes of particle M
+------------------------------------------------------------------------- */
+
+void CreateParticles::global_point(bigint m, RanCounter *random, double *x)
+{
+  double *boxlo = domain->boxlo;
+
+  random->reset(m);
+  x[0] = boxlo[0] + random->uniform() * domain->xprd;
+  x[1] = boxlo[1] + random->uniform() * domain->yprd;
+  x[2] = boxlo[2] + random->uniform() * domain->zprd;
+  if (domain->dimension == 2) x[2] = 0.0;
+}
+
+/* ----------------------------------------------------------------------
+   add particle at X in owned cell icell if eligible for insertion
+   same eligibility as create_local(), except a particle that is
+     inside surfs or outside region is dropped, not re-attempted
+   icell can be a split cell, particle goes in the sub cell containing X
+   other attributes come from RNG as positioned by global_point()
+------------------------------------------------------------------------- */
+
+void CreateParticles::global_add(int icell, double *x, RanCounter *random,
+                                 int nfix_update_custom)
+{
+  Grid::ChildCell *cells = grid->cells;
+  Grid::ChildInfo *cinfo = grid->cinfo;
+
+  if (cells[icell].nsplit > 1) {
+    if (domain->dimension == 3) icell = update->split3d(icell,x);
+    else icell = update->split2d(icell,x);
+  }
+
+  if (cinfo[icell].type == INSIDE) return;
+  if (cinfo[icell].volume == 0.0) return;
+  if (!cutflag && cells[icell].nsurf) return;
+
+  if (cells[icell].nsurf) {
+    double xcell[3];
+    if (grid->point_outside_surfs(icell,xcell) &&
+        !grid->outside_surfs(icell,x,xcell)) return;
+  }
+
+  if (region && !region->match(x)) return;
+
+  int *species = particle->mixture[imix]->species;
+  double *cummulative = particle->mixture[imix]->cummulative;
+  double *vstream = particle->mixture[imix]->vstream;
+  double *vscale = particle->mixture[imix]->vscale;
+  int nspecies = particle->mixture[imix]->nspecies;
+  double temp_thermal = particle->mixture[imix]->temp_thermal;
+  double temp_rot = particle->mixture[imix]->temp_rot;
+  double temp_vib = particle->mixture[imix]->temp_vib;
+
+  double v[3],vstream_variable[3];
+  double tempscale = 1.0;
+  double sqrttempscale = 1.0;
+
+  double rn = random->uniform();
+
+  int isp = 0;
+  while (cummulative[isp] < rn) isp++;
+  int ispecies = species[isp];
+
+  if (speciesflag) {
+    isp = species_variable(x) - 1;
+    if (isp < 0 || isp >= nspecies) return;
+    ispecies = species[isp];
+  }
+
+  if (tempflag) {
+    tempscale = temperature_variable(x);
+    sqrttempscale = sqrt(tempscale);
+  }
+
+  double vn = vscale[isp] * sqrttempscale * sqrt(-log(random->uniform()));
+  double vr = vscale[isp] * sqrttempscale * sqrt(-log(random->uniform()));
+  double theta1 = MY_2PI * random->uniform();
+  double theta2 = MY_2PI * random->uniform();
+
+  if (velflag) {
+    velocity_variable(x,vstream,vstream_variable);
+    v[0] = vstream_variable[0] + vn*cos(theta1);
+    v[1] = vstream_variable[1] + vr*cos(theta2);
+    v[2] = vstream_variable[2] + vr*sin(theta2);
+  } else {
+    v[0] = vstream[0] + vn*cos(theta1);
+    v[1] = vstream[1] + vr*cos(theta2);
+    v[2] = vstream[2] + vr*sin(theta2);
+  }
+
+  double erot = particle->erot(ispecies,temp_rot*tempscale,random);
+  double evib = particle->evib(ispecies,temp_vib*tempscale,random);
+
+  int id = MAXSMALLINT*random->uniform();
+
+  particle->add_particle(id,ispecies,icell,x,v,erot,evib);
+
+  if (nfix_update_custom)
+    modify->update_custom(particle->nlocal-1,temp_thermal,
+                          temp_rot,temp_vib,vstream);
+}
+
 /* ----------------------------------------------------------------------
    return 1 if grid cell with lo/hi is entirely outside region bounding box
    else return 0
@@ -1045,49 +1238,3 @@ void CreateParticles::velocity_variable(double *x, double *vstream,
   if (vzstr) vstream_variable[2] = input->variable->compute_equal(vzvar);
   else vstream_variable[2] = vstream[2];
 }
-
-/* ----------------------------------------------------------------------
-   create Np particles in serial
-   every proc generates all Np coords, only keeps those in cells it owns
-   created particle attributes should be independent of number of procs
-------------------------------------------------------------------------- */
-
-/*
-void CreateParticles::create_all(bigint n)
-{
-  int dimension = domain->dimension;
-  double xlo = domain->boxlo[0];
-  double ylo = domain->boxlo[1];
-  double zlo = domain->boxlo[2];
-  double xprd = domain->xprd;
-  double yprd = domain->yprd;
-  double zprd = domain->zprd;
-
-  int me = comm->me;
-  RanKnuth *random = new RandomPark(update->ranmaster->uniform());
-
-  int icell,id;
-  double x,y,z;
-
-  // loop over all N particles
-
-  for (bigint m = 0; m < n; m++) {
-    x = xlo + random->uniform()*xprd;
-    y = ylo + random->uniform()*yprd;
-    z = zlo + random->uniform()*zprd;
-    if (dimension == 2) z = 0.0;
-
-    // which_cell() returns global grid cell index the particle is in
-    // if I own that grid cell, add particle
-
-    icell = grid->which_cell(x,y,z);
-    id = MAXSMALLINT*random->uniform();
-
-    if (grid->cells[icell].proc == me) {
-      particle->add_particle(id,1,icell,x,y,z);
-    }
-  }
-
-  delete random;
-}
-*/
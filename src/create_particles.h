@@ -56,6 +56,10 @@ class CreateParticles : protected Pointers {
   virtual void create_single();
   virtual void create_local();
   virtual void create_local_twopass();
+  virtual void create_global();
+  class RanCounter *global_setup();
+  void global_point(bigint, class RanCounter *, double *);
+  void global_add(int, double *, class RanCounter *, int);
   int species_variable(double *);
   double density_variable(double *, double *);
   double temperature_variable(double *);
@@ -92,9 +96,20 @@ E: Create_particles species ID does not exist
 
 Self-explanatory.
 
-E: Create_particles global option not yet implemented
+E: Cannot use create_particles global yes with density variable
 
-Self-explanatory.
+Particle counts with the global option do not depend on a density
+variable, so the two cannot be combined.
+
+E: Cannot use create_particles global yes with cell weighting
+
+Particles are created uniformly in the simulation box, so cell
+weights or local timesteps cannot be honored.
+
+E: Cannot use create_particles global yes with axisymmetric domain
+
+Particles are created uniformly in the simulation box, which is not
+uniform in volume for an axisymmetric domain.
 
 E: Created incorrect # of particles: %ld versus %ld
 
@@ -111,4 +126,9 @@ The specified position was either not inside the simulation domain or
 not inside a grid cell with no intersections with any defined surface
 elements.
 
+E: Per-processor particle count is too big
+
+The number of particles a processor would own exceeds the size of a
+32-bit integer.
+
 */
@@ -294,7 +294,9 @@ int DumpGrid::count()
   if (ncompute) {
     for (int i = 0; i < ncompute; i++)
       if (!(compute[i]->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(compute[i]);
         compute[i]->compute_per_grid();
+        modify->invoke_end();
         compute[i]->invoked_flag |= INVOKED_PER_GRID;
       }
   }
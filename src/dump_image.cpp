@@ -838,7 +838,9 @@ void DumpImage::write()
     if (gridwhich == COMPUTE) {
       c = modify->compute[gridindex];
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
       ppgflag = 0;
@@ -880,7 +882,9 @@ void DumpImage::write()
     if (gridxwhich == COMPUTE) {
       c = modify->compute[gridxindex];
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
       ppgflag = 0;
@@ -922,7 +926,9 @@ void DumpImage::write()
     if (gridywhich == COMPUTE) {
       c = modify->compute[gridyindex];
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
       ppgflag = 0;
@@ -964,7 +970,9 @@ void DumpImage::write()
     if (gridzwhich == COMPUTE) {
       c = modify->compute[gridzindex];
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
       ppgflag = 0;
@@ -1006,7 +1014,9 @@ void DumpImage::write()
     if (surfwhich == COMPUTE) {
       c = modify->compute[surfindex];
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
       c->post_process_surf();
@@ -1196,7 +1206,9 @@ void DumpImage::create_image()
     if (gcolor == ATTRIBUTE && gridwhich == COMPUTE) {
       c = modify->compute[gridindex];
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
       ppgflag = 0;
@@ -1265,7 +1277,9 @@ void DumpImage::create_image()
       if (gridxwhich == COMPUTE) {
         cx = modify->compute[gridxindex];
         if (!(cx->invoked_flag & INVOKED_PER_GRID)) {
+          modify->invoke_begin(cx);
           cx->compute_per_grid();
+          modify->invoke_end();
           cx->invoked_flag |= INVOKED_PER_GRID;
         }
         ppgflagx = 0;
@@ -1283,7 +1297,9 @@ void DumpImage::create_image()
       if (gridywhich == COMPUTE) {
         cy = modify->compute[gridyindex];
         if (!(cy->invoked_flag & INVOKED_PER_GRID)) {
+          modify->invoke_begin(cy);
           cy->compute_per_grid();
+          modify->invoke_end();
           cy->invoked_flag |= INVOKED_PER_GRID;
         }
         ppgflagy = 0;
@@ -1301,7 +1317,9 @@ void DumpImage::create_image()
       if (gridzwhich == COMPUTE) {
         cz = modify->compute[gridzindex];
         if (!(cz->invoked_flag & INVOKED_PER_GRID)) {
+          modify->invoke_begin(cz);
           cz->compute_per_grid();
+          modify->invoke_end();
           cz->invoked_flag |= INVOKED_PER_GRID;
         }
         ppgflagz = 0;
@@ -1526,7 +1544,9 @@ void DumpImage::create_image()
     if (scolor == ATTRIBUTE && surfwhich == COMPUTE) {
       c = modify->compute[surfindex];
       if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(c);
         c->compute_per_grid();
+        modify->invoke_end();
         c->invoked_flag |= INVOKED_PER_GRID;
       }
       c->post_process_surf();
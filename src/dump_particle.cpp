@@ -347,7 +347,9 @@ int DumpParticle::count()
   if (ncompute) {
     for (i = 0; i < ncompute; i++)
       if (!(compute[i]->invoked_flag & INVOKED_PER_PARTICLE)) {
+        modify->invoke_begin(compute[i]);
         compute[i]->compute_per_particle();
+        modify->invoke_end();
         compute[i]->invoked_flag |= INVOKED_PER_PARTICLE;
       }
   }
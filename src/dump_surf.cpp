@@ -288,6 +288,8 @@ void DumpSurf::init_style()
   memory->create(cglobal,nchoose,"dump/surf:cglobal");
   memory->create(clocal,nchoose,"dump/surf:clocal");
   memory->create(buflocal,nown,"dump/surf:buflocal");
+  for (int i = 0; i < nvariable; i++)
+    memory->create(vbuf[i],nown,"dump/surf:vbuf");
 
   nchoose = 0;
   for (int i = 0; i < nown; i++)
@@ -358,12 +360,15 @@ int DumpSurf::count()
   if (ncompute) {
     for (int i = 0; i < ncompute; i++)
       if (!(compute[i]->invoked_flag & INVOKED_PER_SURF)) {
-        compute[i]->compute_per_grid();
+        modify->invoke_begin(compute[i]);
+        compute[i]->compute_per_surf();
+        modify->invoke_end();
         compute[i]->invoked_flag |= INVOKED_PER_SURF;
       }
   }
 
   // evaluate surf-style Variables for per-surf quantities
+  // vbuf arrays are length nown, allocated once in init_style()
 
   if (nvariable)
     for (int i = 0; i < nvariable; i++)
@@ -773,8 +778,6 @@ void DumpSurf::pack_variable(int n)
 {
   double *vector = vbuf[field2index[n]];
 
-  // NOTE: when add surf variables, check this logic
-
   for (int i = 0; i < nchoose; i++) {
     buf[n] = vector[clocal[i]];
     n += size_one;
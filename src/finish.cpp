@@ -29,6 +29,7 @@
 #include "math_extra.h"
 #include "timer.h"
 #include "memory.h"
+#include "accelerator_kokkos.h"
 
 using namespace SPARTA_NS;
 
@@ -291,6 +292,10 @@ void Finish::end(int flag, double time_multiple_runs)
     }
   }
 
+  // host/device data motion of KOKKOS package
+
+  if (statsflag && sparta->kokkos) sparta->kokkos->sync_summary(update->nsteps);
+
   // gas per-reaction stats
 
   if (react) {
@@ -30,6 +30,7 @@ class Fix : protected Pointers {
   int flag_update_custom;         // 0/1 if has update_custom() method
   int flag_gas_react;            // 0/1 if has gas_react() method
   int flag_surf_react;           // 0/1 if has surf_react() method
+  int flag_reset_sampling;       // 0/1 if has reset_sampling() method
 
   int scalar_flag;               // 0/1 if compute_scalar() function exists
   int vector_flag;               // 0/1 if compute_vector() function exists
@@ -81,15 +82,18 @@ class Fix : protected Pointers {
 
   virtual void start_of_step() {}
   virtual void end_of_step() {}
+  virtual bigint next_end_of_step() {return 0;}
   virtual void update_custom(int, double, double, double, double *) {}
   virtual void gas_react(int) {}
   virtual void surf_react(Particle::OnePart *, int &, int &) {}
   virtual void compute_field() {}
+  virtual void reset_sampling() {}
 
   virtual int pack_grid_one(int, char *, int) {return 0;}
   virtual int unpack_grid_one(int, char *) {return 0;}
   virtual void copy_grid_one(int, int) {}
   virtual void add_grid_one() {}
+  virtual void add_grid_many(int n) {for (int i = 0; i < n; i++) add_grid_one();}
   virtual void reset_grid_count(int) {}
   virtual void grid_changed() {}
 
@@ -345,9 +345,16 @@ void FixAblate::store_corners(int nx_caller, int ny_caller, int nz_caller,
   epsilon_adjust();
 
   // create marching squares/cubes classes, now that have group & threshold
+  // restricted mode: each ablation only regenerates surfs in cells
+  //   whose corner point values were decremented
 
-  if (dim == 2) ms = new MarchingSquares(sparta,igroup,thresh);
-  else mc = new MarchingCubes(sparta,igroup,thresh);
+  if (dim == 2) {
+    ms = new MarchingSquares(sparta,igroup,thresh);
+    ms->restricted = 1;
+  } else {
+    mc = new MarchingCubes(sparta,igroup,thresh);
+    mc->restricted = 1;
+  }
 
   // create implicit surfaces
 
@@ -743,7 +750,9 @@ void FixAblate::set_delta()
     Compute *c = modify->compute[icompute];
 
     if (!(c->invoked_flag & INVOKED_PER_GRID)) {
+      modify->invoke_begin(c);
       c->compute_per_grid();
+      modify->invoke_end();
       c->invoked_flag |= INVOKED_PER_GRID;
     }
     c->post_process_isurf_grid();
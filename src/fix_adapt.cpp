@@ -122,8 +122,9 @@ void FixAdapt::end_of_step()
   modify->clearstep_compute();
 
   // same operations as in AdaptGrid single invocation
+  // hold ghosts so they can be reinstated as-is if no cells change
 
-  grid->remove_ghosts();
+  grid->hold_ghosts();
 
   // memory allocation in AdaptGrid class
 
@@ -140,18 +141,19 @@ void FixAdapt::end_of_step()
   else if (action2 == COARSEN) ncoarsen = adapt->coarsen();
 
   grid->set_maxlevel();
-  grid->rehash();
 
-  // if no refinement or coarsening, just reghost/reneighbor and return
+  // if no refinement or coarsening, owned cells are unchanged
+  // restore held ghosts and their neighbor indices, no comm needed
 
   if (nrefine == 0 && ncoarsen == 0) {
     last_adapt = 0;
     adapt->cleanup();
-    grid->acquire_ghosts();
-    grid->find_neighbors();
+    grid->restore_ghosts();
     return;
   }
 
+  grid->rehash();
+
   // memory deallocation in AdaptGrid class
 
   adapt->cleanup();
@@ -160,8 +162,10 @@ void FixAdapt::end_of_step()
   // same steps as in adapt_grid
 
   grid->setup_owned();
-  grid->acquire_ghosts();
-  grid->find_neighbors();
+  if (!grid->update_ghosts()) {
+    grid->acquire_ghosts();
+    grid->find_neighbors();
+  }
   grid->check_uniform();
   comm->reset_neighbors();
 
@@ -54,6 +54,7 @@ FixAveGrid::FixAveGrid(SPARTA *sparta, int narg, char **arg) :
 
   time_depend = 1;
   gridmigrate = 1;
+  flag_reset_sampling = 1;
 
   // scan values, then read options
 
@@ -237,6 +238,7 @@ FixAveGrid::FixAveGrid(SPARTA *sparta, int narg, char **arg) :
 
   nsample = 0;
   irepeat = 0;
+  resetflag = 0;
   nvalid = nextvalid();
   modify->addstep_compute_all(nvalid);
 
@@ -448,10 +450,10 @@ void FixAveGrid::end_of_step()
   bigint ntimestep = update->ntimestep;
   if (ntimestep != nvalid) return;
 
-  // zero grid tallies if ave = ONE and first sample
+  // zero grid tallies if ave = ONE or reset requested and first sample
   // could do this with memset()
 
-  if (flavor == PERGRID && ave == ONE && irepeat == 0) {
+  if (flavor == PERGRID && (ave == ONE || resetflag) && irepeat == 0) {
     for (i = 0; i < nglocal; i++)
       for (j = 0; j < ntotal; j++)
         tally[i][j] = 0.0;
@@ -459,11 +461,16 @@ void FixAveGrid::end_of_step()
 
   // clear hash of cellID tallies if ave = ONE and first sample
 
-  if (flavor == PERGRIDSURF && ave == ONE && irepeat == 0) {
+  if (flavor == PERGRIDSURF && (ave == ONE || resetflag) && irepeat == 0) {
     hash->clear();
     ntallyID = 0;
   }
 
+  if (resetflag && irepeat == 0) {
+    nsample = 0;
+    resetflag = 0;
+  }
+
   // accumulate results of computes,fixes,variables
   // compute/fix/variable may invoke computes so wrap with clear/add
 
@@ -483,7 +490,9 @@ void FixAveGrid::end_of_step()
       if (which[m] == COMPUTE) {
         Compute *compute = modify->compute[n];
         if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+          modify->invoke_begin(compute);
           compute->compute_per_grid();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_PER_GRID;
         }
 
@@ -550,7 +559,9 @@ void FixAveGrid::end_of_step()
 
       Compute *compute = modify->compute[n];
       if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(compute);
         compute->compute_per_grid();
+        modify->invoke_end();
         compute->invoked_flag |= INVOKED_PER_GRID;
       }
 
@@ -742,6 +753,16 @@ void FixAveGrid::end_of_step()
   if (ave == ONE) nsample = 0;
 }
 
+/* ----------------------------------------------------------------------
+   discard accumulated tallies at start of next Nfreq window
+   used by fix steady to begin sampling once flow is steady
+------------------------------------------------------------------------- */
+
+void FixAveGrid::reset_sampling()
+{
+  resetflag = 1;
+}
+
 /* ----------------------------------------------------------------------
    pack icell values for per-cell arrays into buf
    if icell is a split cell, also pack all sub cell values
@@ -874,6 +895,28 @@ void FixAveGrid::add_grid_one()
   nglocal++;
 }
 
+/* ----------------------------------------------------------------------
+   add N grid cells at once
+   called after N grid cells are added to this processor's list
+   initialize values to 0.0
+------------------------------------------------------------------------- */
+
+void FixAveGrid::add_grid_many(int n)
+{
+  grow_percell(n);
+
+  for (int icell = nglocal; icell < nglocal+n; icell++) {
+    if (nvalues == 1) vector_grid[icell] = 0.0;
+    else
+      for (int i = 0; i < nvalues; i++) array_grid[icell][i] = 0.0;
+
+    if (flavor == PERGRID)
+      for (int i = 0; i < ntotal; i++) tally[icell][i] = 0.0;
+  }
+
+  nglocal += n;
+}
+
 /* ----------------------------------------------------------------------
    reset final grid cell count after grid cell removals
 ------------------------------------------------------------------------- */
@@ -36,18 +36,22 @@ class FixAveGrid : public Fix {
   void init();
   void setup();
   void end_of_step();
+  bigint next_end_of_step() {return nvalid;}
+  void reset_sampling();
 
   int pack_grid_one(int, char *, int);
   int unpack_grid_one(int, char *);
   void copy_grid_one(int, int);
   void reset_grid_count(int);
   void add_grid_one();
+  void add_grid_many(int);
   double memory_usage();
 
  protected:
   int tmax,flavor;
   int groupbit,nvalues,maxvalues;
   int nrepeat,irepeat,nsample;
+  int resetflag;             // 1 if tallies restart on next Nfreq window
   bigint nvalid;
 
   char **ids;                // ID/name of compute,fix,variable to access
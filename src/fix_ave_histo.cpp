@@ -578,13 +578,17 @@ void FixAveHisto::end_of_step()
       if (kind == GLOBAL && mode == SCALAR) {
         if (j == 0) {
           if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+            modify->invoke_begin(compute);
             compute->compute_scalar();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_SCALAR;
           }
           bin_one(compute->scalar);
         } else {
           if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+            modify->invoke_begin(compute);
             compute->compute_vector();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_VECTOR;
           }
           bin_one(compute->vector[j-1]);
@@ -592,13 +596,17 @@ void FixAveHisto::end_of_step()
       } else if (kind == GLOBAL && mode == VECTOR) {
         if (j == 0) {
           if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+            modify->invoke_begin(compute);
             compute->compute_vector();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_VECTOR;
           }
           bin_vector(compute->size_vector,compute->vector,1);
         } else {
           if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+            modify->invoke_begin(compute);
             compute->compute_array();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_ARRAY;
           }
           if (compute->array)
@@ -608,7 +616,9 @@ void FixAveHisto::end_of_step()
 
       } else if (kind == PERPARTICLE) {
         if (!(compute->invoked_flag & INVOKED_PER_PARTICLE)) {
+          modify->invoke_begin(compute);
           compute->compute_per_particle();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_PER_PARTICLE;
         }
         if (j == 0)
@@ -619,7 +629,9 @@ void FixAveHisto::end_of_step()
 
       } else if (kind == PERGRID) {
         if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+          modify->invoke_begin(compute);
           compute->compute_per_grid();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_PER_GRID;
         }
 
@@ -903,7 +915,7 @@ void FixAveHisto::bin_particles(int attribute, int index)
       int *s2g = particle->mixture[imix]->species2group;
       for (int i = 0; i < nlocal; i++) {
         if (region->match(particles[i].x) &&
-            s2g[particles[i].ispecies] < 0) bin_one(particles[i].v[index]);
+            s2g[particles[i].ispecies] >= 0) bin_one(particles[i].v[index]);
       }
     } else if (regionflag) {
       for (int i = 0; i < nlocal; i++) {
@@ -950,7 +962,7 @@ void FixAveHisto::bin_particles(double *values, int stride)
   } else if (mixflag) {
     int *s2g = particle->mixture[imix]->species2group;
     for (int i = 0; i < nlocal; i++) {
-      if (s2g[particles[i].ispecies] < 0) bin_one(values[m]);
+      if (s2g[particles[i].ispecies] >= 0) bin_one(values[m]);
       m += stride;
     }
   } else {
@@ -34,6 +34,7 @@ class FixAveHisto : public Fix {
   void init();
   void setup();
   virtual void end_of_step();
+  bigint next_end_of_step() {return nvalid;}
   double compute_vector(int);
   double compute_array(int,int);
 
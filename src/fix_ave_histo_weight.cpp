@@ -126,13 +126,17 @@ void FixAveHistoWeight::calculate_weights()
     if (kind == GLOBAL && mode == SCALAR) {
       if (j == 0) {
         if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+          modify->invoke_begin(compute);
           compute->compute_scalar();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_SCALAR;
         }
         weight = compute->scalar;
       } else {
         if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+          modify->invoke_begin(compute);
           compute->compute_vector();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_VECTOR;
         }
         weight = compute->vector[j-1];
@@ -141,14 +145,18 @@ void FixAveHistoWeight::calculate_weights()
     } else if (kind == GLOBAL && mode == VECTOR) {
       if (j == 0) {
         if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+          modify->invoke_begin(compute);
           compute->compute_vector();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_VECTOR;
         }
         weights = compute->vector;
         stridewt = 1;
       } else {
         if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+          modify->invoke_begin(compute);
           compute->compute_array();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_ARRAY;
         }
         if (compute->array) weights = &compute->array[0][j-1];
@@ -157,7 +165,9 @@ void FixAveHistoWeight::calculate_weights()
 
     } else if (kind == PERPARTICLE) {
       if (!(compute->invoked_flag & INVOKED_PER_PARTICLE)) {
+        modify->invoke_begin(compute);
         compute->compute_per_particle();
+        modify->invoke_end();
         compute->invoked_flag |= INVOKED_PER_PARTICLE;
       }
       if (j == 0) {
@@ -170,7 +180,9 @@ void FixAveHistoWeight::calculate_weights()
 
     } else if (kind == PERGRID) {
       if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+        modify->invoke_begin(compute);
         compute->compute_per_grid();
+        modify->invoke_end();
         compute->invoked_flag |= INVOKED_PER_GRID;
       }
       if (j == 0) {
@@ -320,7 +332,8 @@ void FixAveHistoWeight::bin_vector(int n, double *values, int stride)
 void FixAveHistoWeight::bin_particles(int attribute, int index)
 {
   Particle::OnePart *particles = particle->particles;
-  int *s2g = particle->mixture[imix]->species2group;
+  int *s2g = NULL;
+  if (mixflag) s2g = particle->mixture[imix]->species2group;
   int nlocal = particle->nlocal;
 
   Region *region;
@@ -332,7 +345,7 @@ void FixAveHistoWeight::bin_particles(int attribute, int index)
     if (regionflag && mixflag) {
       for (int i = 0; i < nlocal; i++) {
         if (region->match(particles[i].x) &&
-            s2g[particles[i].ispecies] < 0)
+            s2g[particles[i].ispecies] >= 0)
           bin_one_weight(particles[i].x[index],weights[mwt]);
         mwt += stridewt;
       }
@@ -359,7 +372,7 @@ void FixAveHistoWeight::bin_particles(int attribute, int index)
     if (regionflag && mixflag) {
       for (int i = 0; i < nlocal; i++) {
         if (region->match(particles[i].x) &&
-            s2g[particles[i].ispecies] < 0)
+            s2g[particles[i].ispecies] >= 0)
           bin_one_weight(particles[i].v[index],weights[mwt]);
         mwt += stridewt;
       }
@@ -392,7 +405,8 @@ void FixAveHistoWeight::bin_particles(int attribute, int index)
 void FixAveHistoWeight::bin_particles(double *values, int stride)
 {
   Particle::OnePart *particles = particle->particles;
-  int *s2g = particle->mixture[imix]->species2group;
+  int *s2g = NULL;
+  if (mixflag) s2g = particle->mixture[imix]->species2group;
   int nlocal = particle->nlocal;
 
   Region *region;
@@ -418,7 +432,7 @@ void FixAveHistoWeight::bin_particles(double *values, int stride)
     }
   } else if (mixflag) {
     for (int i = 0; i < nlocal; i++) {
-      if (s2g[particles[i].ispecies] < 0)
+      if (s2g[particles[i].ispecies] >= 0)
         bin_one_weight(values[m],weights[mwt]);
       m += stride;
       mwt += stridewt;
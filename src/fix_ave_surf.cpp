@@ -57,6 +57,7 @@ FixAveSurf::FixAveSurf(SPARTA *sparta, int narg, char **arg) :
   per_surf_freq = atoi(arg[5]);
 
   time_depend = 1;
+  flag_reset_sampling = 1;
 
   // scan values, then read options
 
@@ -180,7 +181,7 @@ FixAveSurf::FixAveSurf(SPARTA *sparta, int narg, char **arg) :
 
   // if any input is a compute, all must be
 
-  int cflag = 0;
+  cflag = 0;
   for (int i = 0; i < nvalues; i++)
     if (which[i] == COMPUTE) cflag++;
 
@@ -199,9 +200,10 @@ FixAveSurf::FixAveSurf(SPARTA *sparta, int narg, char **arg) :
   nown = surf->nown;
   memory->create(masks,nown,"ave/surf:masks");
 
+  bufvec = NULL;
+  bufarray = NULL;
+
   if (cflag) {
-    bufvec = NULL;
-    bufarray = NULL;
     if (nvalues == 1) memory->create(bufvec,nown,"ave/surf:bufvec");
     else memory->create(bufarray,nown,nvalues,"ave/surf:bufarray");
   }
@@ -287,6 +289,7 @@ FixAveSurf::FixAveSurf(SPARTA *sparta, int narg, char **arg) :
 
   nsample = 0;
   irepeat = 0;
+  resetflag = 0;
   nvalid = nextvalid();
   modify->addstep_compute_all(nvalid);
 
@@ -386,9 +389,9 @@ void FixAveSurf::end_of_step()
   bigint ntimestep = update->ntimestep;
   if (ntimestep != nvalid) return;
 
-  // zero accumulators if ave = ONE and first sample
+  // zero accumulators if ave = ONE or reset requested and first sample
 
-  if (ave == ONE && irepeat == 0) {
+  if ((ave == ONE || resetflag) && irepeat == 0) {
     if (nvalues == 1)
       for (i = 0; i < nown; i++)
         accvec[i] = 0.0;
@@ -398,6 +401,11 @@ void FixAveSurf::end_of_step()
           accarray[i][m] = 0.0;
   }
 
+  if (resetflag && irepeat == 0) {
+    nsample = 0;
+    resetflag = 0;
+  }
+
   // clear hash of tallied surf IDs if first sample
 
   if (irepeat == 0) {
@@ -419,7 +427,9 @@ void FixAveSurf::end_of_step()
     if (which[m] == COMPUTE) {
       Compute *compute = modify->compute[n];
       if (!(compute->invoked_flag & INVOKED_PER_SURF)) {
+        modify->invoke_begin(compute);
         compute->compute_per_surf();
+        modify->invoke_end();
         compute->invoked_flag |= INVOKED_PER_SURF;
       }
       surfint *tally2surf_compute;
@@ -510,9 +520,11 @@ void FixAveSurf::end_of_step()
           for (i = 0; i < nown; i++) accarray[i][m] += fix_array[i][jm1];
       }
 
-    // evaluate surf-style variable
+    // evaluate surf-style variable, sum into accumulators for owned surfs
 
     } else if (which[m] == VARIABLE) {
+      if (nvalues == 1) input->variable->compute_surf(n,accvec,1,1);
+      else if (nown) input->variable->compute_surf(n,&accarray[0][m],nvalues,1);
     }
   }
 
@@ -533,12 +545,13 @@ void FixAveSurf::end_of_step()
 
   // invoke surf->collate() on tallies this fix stores for multiple steps
   // this merges tallies to owned surfs
-  // NOTE: this should only be done if source is a COMPUTE ?
+  // only needed for compute inputs,
+  //   fixes and variables accumulate directly into owned surfs
 
-  if (nvalues == 1) {
+  if (cflag && nvalues == 1) {
     surf->collate_vector(ntally,tally2surf,vec_tally,1,bufvec);
     for (i = 0; i < nown; i++) accvec[i] += bufvec[i];
-  } else {
+  } else if (cflag) {
     surf->collate_array(ntally,nvalues,tally2surf,array_tally,bufarray);
     for (i = 0; i < nown; i++)
       for (m = 0; m < nvalues; m++)
@@ -583,6 +596,16 @@ void FixAveSurf::end_of_step()
   if (ave == ONE) nsample = 0;
 }
 
+/* ----------------------------------------------------------------------
+   discard accumulated values at start of next Nfreq window
+   used by fix steady to begin sampling once flow is steady
+------------------------------------------------------------------------- */
+
+void FixAveSurf::reset_sampling()
+{
+  resetflag = 1;
+}
+
 /* ----------------------------------------------------------------------
    parse optional args
 ------------------------------------------------------------------------- */
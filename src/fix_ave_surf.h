@@ -34,12 +34,15 @@ class FixAveSurf : public Fix {
   void init();
   void setup();
   void end_of_step();
+  bigint next_end_of_step() {return nvalid;}
+  void reset_sampling();
   double memory_usage();
 
  private:
   int groupbit;
   int nvalues,maxvalues;
   int nrepeat,irepeat,nsample,ave;
+  int resetflag;
   bigint nvalid;
   int *which,*argindex,*value2index;
   char **ids;
@@ -48,6 +51,7 @@ class FixAveSurf : public Fix {
   int nown;                // # of explicit surfs I own = surf->nown
   double *accvec;          // accumulation vector
   double **accarray;       // accumulation array
+  int cflag;               // 1 if inputs are computes, 0 if fixes/variables
   double *bufvec;          // surf collate vector for surfs I own
   double **bufarray;       // surf collate array for surfs I own
   int *masks;              // surface element group masks for surfs I own
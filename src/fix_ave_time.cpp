@@ -419,13 +419,17 @@ void FixAveTime::invoke_scalar(bigint ntimestep)
 
       if (argindex[i] == 0) {
         if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+          modify->invoke_begin(compute);
           compute->compute_scalar();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_SCALAR;
         }
         scalar = compute->scalar;
       } else {
         if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+          modify->invoke_begin(compute);
           compute->compute_vector();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_VECTOR;
         }
         scalar = compute->vector[argindex[i]-1];
@@ -541,7 +545,9 @@ void FixAveTime::invoke_vector(bigint ntimestep)
 
       if (argindex[j] == 0) {
         if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+          modify->invoke_begin(compute);
           compute->compute_vector();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_VECTOR;
         }
         double *cvector = compute->vector;
@@ -550,7 +556,9 @@ void FixAveTime::invoke_vector(bigint ntimestep)
 
       } else {
         if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+          modify->invoke_begin(compute);
           compute->compute_array();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_ARRAY;
         }
         double **carray = compute->array;
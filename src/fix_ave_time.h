@@ -34,6 +34,7 @@ class FixAveTime : public Fix {
   void init();
   void setup();
   void end_of_step();
+  bigint next_end_of_step() {return nvalid;}
   double compute_scalar();
   double compute_vector(int);
   double compute_array(int,int);
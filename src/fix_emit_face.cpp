@@ -479,6 +479,7 @@ void FixEmitFace::perform_task_onepass()
 
   // insert particles for each task = cell/face pair
   // ntarget/ninsert is either perspecies or for all species
+  // reserve room for ninsert particles up front, so no realloc per particle
   // for one particle:
   //   x = random position on face
   //   v = randomized thermal velocity + vstream
@@ -522,6 +523,7 @@ void FixEmitFace::perform_task_onepass()
         scosine = indot / vscale[isp];
 
         nactual = 0;
+        particle->reserve(ninsert);
         for (int m = 0; m < ninsert; m++) {
           x[0] = lo[0] + random->uniform() * (hi[0]-lo[0]);
           x[1] = lo[1] + random->uniform() * (hi[1]-lo[1]);
@@ -574,6 +576,7 @@ void FixEmitFace::perform_task_onepass()
       }
 
       nactual = 0;
+      particle->reserve(ninsert);
       for (int m = 0; m < ninsert; m++) {
         rn = random->uniform();
         isp = 0;
@@ -650,6 +653,7 @@ void FixEmitFace::perform_task_twopass()
 
   // insert particles for each task = cell/face pair
   // ntarget/ninsert is either perspecies or for all species
+  // reserve room for ninsert particles up front, so no realloc per particle
   // for one particle:
   //   x = random position on face
   //   v = randomized thermal velocity + vstream
@@ -715,6 +719,7 @@ void FixEmitFace::perform_task_twopass()
         scosine = indot / vscale[isp];
 
         nactual = 0;
+        particle->reserve(ninsert);
         for (int m = 0; m < ninsert; m++) {
           x[0] = lo[0] + random->uniform() * (hi[0]-lo[0]);
           x[1] = lo[1] + random->uniform() * (hi[1]-lo[1]);
@@ -761,6 +766,7 @@ void FixEmitFace::perform_task_twopass()
       ninsert = ninsert_values[i][0];
 
       nactual = 0;
+      particle->reserve(ninsert);
       for (int m = 0; m < ninsert; m++) {
         rn = random->uniform();
         isp = 0;
@@ -363,6 +363,7 @@ void FixEmitFaceFile::perform_task()
 
   // insert particles for each task = cell
   // ntarget/ninsert is either perspecies or for all species
+  // reserve room for ninsert particles up front, so no realloc per particle
   // for one particle:
   //   x = random position on subset of face that overlaps with file grid
   //   v = randomized thermal velocity + vstream
@@ -400,6 +401,7 @@ void FixEmitFaceFile::perform_task()
         scosine = indot / vscale[isp];
 
         nactual = 0;
+        particle->reserve(ninsert);
         for (int m = 0; m < ninsert; m++) {
           x[0] = lo[0] + random->uniform() * (hi[0]-lo[0]);
           x[1] = lo[1] + random->uniform() * (hi[1]-lo[1]);
@@ -448,6 +450,7 @@ void FixEmitFaceFile::perform_task()
       ninsert = static_cast<int> (ntarget);
 
       nactual = 0;
+      particle->reserve(ninsert);
       for (int m = 0; m < ninsert; m++) {
         rn = random->uniform();
         isp = 0;
@@ -454,6 +454,7 @@ void FixEmitSurf::perform_task()
 
   // insert particles for each task = cell/surf pair
   // ntarget/ninsert is either perspecies or for all species
+  // reserve room for ninsert particles up front, so no realloc per particle
   // for one particle:
   //   x = random position with overlap of surf with cell
   //   v = randomized thermal velocity + vstream
@@ -505,6 +506,7 @@ void FixEmitSurf::perform_task()
         scosine = indot / vscale[isp];
 
         nactual = 0;
+        particle->reserve(ninsert);
         for (m = 0; m < ninsert; m++) {
           if (dimension == 2) {
             rn = random->uniform();
@@ -597,6 +599,7 @@ void FixEmitSurf::perform_task()
       ninsert = static_cast<int> (ntarget + random->uniform());
 
       nactual = 0;
+      particle->reserve(ninsert);
       for (int m = 0; m < ninsert; m++) {
         rn = random->uniform();
         isp = 0;
@@ -0,0 +1,594 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#include "math.h"
+#include "stdlib.h"
+#include "string.h"
+#include "fix_merge.h"
+#include "update.h"
+#include "grid.h"
+#include "particle.h"
+#include "collide.h"
+#include "comm.h"
+#include "modify.h"
+#include "fix_ave_grid.h"
+#include "random_mars.h"
+#include "random_knuth.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace SPARTA_NS;
+
+enum{NONE,DISCRETE,SMOOTH};            // several files
+enum{ONE,RUNNING};                      // also in FixAveGrid
+
+// per-species sums of a cell
+
+enum{COUNT,VX,VY,VZ,VSQ,EROT,EVIB};
+#define NSUM 7
+
+#define DELTA 1024
+
+/* ---------------------------------------------------------------------- */
+
+FixMerge::FixMerge(SPARTA *sparta, int narg, char **arg) :
+  Fix(sparta, narg, arg)
+{
+  if (narg < 4) error->all(FLERR,"Illegal fix merge command");
+
+  if (sparta->kokkos) error->all(FLERR,"Cannot use fix merge with Kokkos");
+
+  vector_flag = 1;
+  size_vector = 3;
+  global_freq = 1;
+
+  nevery = atoi(arg[2]);
+  nmax = atoi(arg[3]);
+
+  if (nevery <= 0) error->all(FLERR,"Illegal fix merge command");
+  if (nmax < 2) error->all(FLERR,"Illegal fix merge command");
+
+  // optional keywords
+
+  ntarget = nmax/2;
+  nmin = 0;
+  maxfactor = 0.0;
+
+  int iarg = 4;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"target") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix merge command");
+      ntarget = atoi(arg[iarg+1]);
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"split") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix merge command");
+      nmin = atoi(arg[iarg+1]);
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"max") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix merge command");
+      maxfactor = atof(arg[iarg+1]);
+      if (maxfactor < 1.0) error->all(FLERR,"Illegal fix merge command");
+      iarg += 2;
+    } else error->all(FLERR,"Illegal fix merge command");
+  }
+
+  if (ntarget < 1 || ntarget >= nmax)
+    error->all(FLERR,"Illegal fix merge command");
+  if (nmin < 0 || nmin > ntarget)
+    error->all(FLERR,"Illegal fix merge command");
+
+  // RNG
+
+  me = comm->me;
+  random = new RanKnuth(update->ranmaster->uniform());
+  double seed = update->ranmaster->uniform();
+  random->reset(seed,me,100);
+
+  nmerge_running = nsplit_running = ncell_running = 0;
+
+  nspecies = 0;
+  scount = sfirst = kcount = kfirst = NULL;
+  before = ucom = NULL;
+
+  nemit = 0;
+  emitlist = NULL;
+
+  maxplist = maxslist = maxdelete = 0;
+  plist = slist = dellist = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixMerge::~FixMerge()
+{
+  delete random;
+  delete [] emitlist;
+
+  memory->destroy(scount);
+  memory->destroy(sfirst);
+  memory->destroy(kcount);
+  memory->destroy(kfirst);
+  memory->destroy(before);
+  memory->destroy(ucom);
+  memory->destroy(plist);
+  memory->destroy(slist);
+  memory->destroy(dellist);
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixMerge::setmask()
+{
+  int mask = 0;
+  mask |= END_OF_STEP;
+  return mask;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixMerge::init()
+{
+  if (!grid->cellweightflag)
+    error->all(FLERR,"Fix merge requires cell weighting");
+
+  // discrete vibrational energies cannot be rescaled
+
+  evibflag = 1;
+  if (collide && collide->vibstyle == DISCRETE) evibflag = 0;
+
+  // per-species arrays
+
+  if (particle->nspecies != nspecies) {
+    memory->destroy(scount);
+    memory->destroy(sfirst);
+    memory->destroy(kcount);
+    memory->destroy(kfirst);
+    memory->destroy(before);
+    memory->destroy(ucom);
+    nspecies = particle->nspecies;
+    memory->create(scount,nspecies,"merge:scount");
+    memory->create(sfirst,nspecies,"merge:sfirst");
+    memory->create(kcount,nspecies,"merge:kcount");
+    memory->create(kfirst,nspecies,"merge:kfirst");
+    memory->create(before,nspecies,NSUM,"merge:before");
+    memory->create(ucom,nspecies,3,"merge:ucom");
+  }
+
+  // if any fix ave/grid exists, require that:
+  //   (1) Nevery is a multiple of its Nfreq
+  //   (2) it comes before this fix
+  //   (3) it is not a running ave
+  // its computes tally unweighted samples and apply the current cell
+  //   weight when it normalizes at the end of an Nfreq window,
+  //   so cell weights can only change after the last sample of a window
+
+  int fixme = modify->find_fix(id);
+  for (int i = 0; i < modify->nfix; i++) {
+    if (strcmp(modify->fix[i]->style,"ave/grid") == 0) {
+      if (nevery % modify->fix[i]->per_grid_freq)
+        error->all(FLERR,"Fix merge N is not a multiple of "
+                   "fix ave/grid Nfreq");
+      if (i > fixme)
+        error->all(FLERR,"Fix merge must come after fix ave/grid");
+      if (((FixAveGrid *) modify->fix[i])->ave == RUNNING)
+        error->all(FLERR,"Fix merge does not allow use of "
+                   "fix ave/grid ave running");
+    }
+  }
+
+  // emit fixes which set their insertion counts from cell weights
+
+  delete [] emitlist;
+  emitlist = new int[modify->nfix];
+  nemit = 0;
+  for (int i = 0; i < modify->nfix; i++)
+    if (strncmp(modify->fix[i]->style,"emit",4) == 0) emitlist[nemit++] = i;
+}
+
+/* ----------------------------------------------------------------------
+   merge particles in cells with more than Nmax particles
+   split particles in cells with fewer than Nmin particles
+   either one resets the cell weight so cell holds about Ntarget particles
+------------------------------------------------------------------------- */
+
+void FixMerge::end_of_step()
+{
+  if (update->ntimestep % nevery) return;
+
+  if (!particle->sorted) particle->sort();
+
+  Grid::ChildCell *cells = grid->cells;
+  Grid::ChildInfo *cinfo = grid->cinfo;
+  int nglocal = grid->nlocal;
+
+  int np,nnow;
+  double weight,wnew,wbase;
+
+  ndelete = 0;
+  bigint nlocal_original = particle->nlocal;
+  bigint ncell_original = ncell_running;
+
+  for (int icell = 0; icell < nglocal; icell++) {
+    if (cells[icell].nsplit > 1) continue;
+
+    np = cinfo[icell].count;
+    weight = cinfo[icell].weight;
+
+    // target weight is heavier for a crowded cell, optionally capped
+    //   by maxfactor, and lighter for a sparse cell, not below its base
+    // a cell with no particles just returns to its base weight
+
+    if (np > nmax) {
+      wnew = weight * np/ntarget;
+      if (maxfactor > 0.0) {
+        wbase = grid->weight_base(icell);
+        if (wnew > maxfactor*wbase) wnew = maxfactor*wbase;
+      }
+      if (wnew <= weight) continue;
+    } else if (np < nmin) {
+      wbase = grid->weight_base(icell);
+      if (weight <= wbase) continue;
+      wnew = weight * np/ntarget;
+      if (wnew < wbase) wnew = wbase;
+    } else continue;
+
+    // new weight is set from # of particles actually resampled
+    // so weight * count of the cell is unchanged
+
+    if (np) {
+      nnow = resample(icell,weight/wnew);
+      if (nnow) wnew = weight * np/nnow;
+    }
+    cinfo[icell].weight = wnew;
+    ncell_running++;
+  }
+
+  // split particles were appended, merged ones are deleted now
+  // particles are no longer sorted
+
+  bigint nadd = particle->nlocal - nlocal_original;
+  nsplit_running += nadd;
+  nmerge_running += ndelete;
+
+  if (ndelete) particle->compress_reactions(ndelete,dellist);
+  if (ndelete || nadd) particle->sorted = 0;
+
+  // emit fixes cache per-cell insertion counts scaled by cell weight
+  // have them rebuild their tasks if any cell weight changed
+
+  if (nemit) {
+    int changed = 0;
+    if (ncell_running > ncell_original) changed = 1;
+    int anychanged;
+    MPI_Allreduce(&changed,&anychanged,1,MPI_INT,MPI_MAX,world);
+    if (anychanged)
+      for (int i = 0; i < nemit; i++)
+        modify->fix[emitlist[i]]->grid_changed();
+  }
+}
+
+/* ----------------------------------------------------------------------
+   resample particles in one cell whose weight changes by about 1/ratio
+   ratio < 1: keep random subset of each species, delete others
+   ratio > 1: clone each particle ratio-1 times, rounded up or down
+   # for each species is n*ratio, systematically rounded across species
+     from one random offset, so it is within 1 of n*ratio and
+     the total is within 1 of np*ratio
+   afterwards restore momentum and energies of cell
+   return # of particles in cell after resampling
+------------------------------------------------------------------------- */
+
+int FixMerge::resample(int icell, double ratio)
+{
+  int i,j,m,n,ip,ispecies,nnew,nbase,nextra,nclone;
+  double fraction;
+
+  Particle::OnePart *particles = particle->particles;
+  int *next = particle->next;
+  Grid::ChildInfo *cinfo = grid->cinfo;
+
+  int np = cinfo[icell].count;
+
+  // plist = particles in cell, grouped by species
+
+  if (np > maxplist) {
+    while (maxplist < np) maxplist += DELTA;
+    memory->destroy(plist);
+    memory->create(plist,maxplist,"merge:plist");
+  }
+
+  for (m = 0; m < nspecies; m++) scount[m] = 0;
+  ip = cinfo[icell].first;
+  while (ip >= 0) {
+    scount[particles[ip].ispecies]++;
+    ip = next[ip];
+  }
+
+  n = 0;
+  for (m = 0; m < nspecies; m++) {
+    sfirst[m] = n;
+    n += scount[m];
+    scount[m] = 0;
+  }
+
+  ip = cinfo[icell].first;
+  while (ip >= 0) {
+    ispecies = particles[ip].ispecies;
+    plist[sfirst[ispecies]+scount[ispecies]] = ip;
+    scount[ispecies]++;
+    ip = next[ip];
+  }
+
+  // resample each species separately
+  // slist = resampled particles in cell, also grouped by species
+  // kfirst/kcount = index into slist and count for each species
+
+  int ns = 0;
+  double offset = random->uniform();
+
+  for (ispecies = 0; ispecies < nspecies; ispecies++) {
+    n = scount[ispecies];
+    kfirst[ispecies] = ns;
+    kcount[ispecies] = 0;
+    before[ispecies][COUNT] = 0.0;
+    if (n == 0) continue;
+
+    int *list = &plist[sfirst[ispecies]];
+    sums(n,list,before[ispecies]);
+
+    // nnew = # of particles of this species after resampling
+
+    fraction = n*ratio;
+    nnew = static_cast<int> (offset+fraction) - static_cast<int> (offset);
+    offset += fraction;
+
+    if (ns + nnew > maxslist) {
+      while (maxslist < ns + nnew) maxslist += DELTA;
+      memory->grow(slist,maxslist,"merge:slist");
+    }
+
+    if (ratio < 1.0) {
+
+      // random partial shuffle selects the nnew kept particles
+
+      for (i = 0; i < nnew; i++) {
+        j = i + static_cast<int> (random->uniform()*(n-i));
+        if (j >= n) j = n-1;
+        ip = list[i];
+        list[i] = list[j];
+        list[j] = ip;
+      }
+
+      if (ndelete + n-nnew > maxdelete) {
+        while (maxdelete < ndelete + n-nnew) maxdelete += DELTA;
+        memory->grow(dellist,maxdelete,"merge:dellist");
+      }
+      for (i = nnew; i < n; i++) dellist[ndelete++] = list[i];
+
+      for (i = 0; i < nnew; i++) slist[ns++] = list[i];
+
+    } else {
+
+      // each particle is kept and cloned nbase-1 times
+      // random partial shuffle selects nextra particles cloned once more
+      // clones are appended to particle list
+
+      nbase = static_cast<int> (ratio);
+      nextra = nnew - n*nbase;
+
+      for (i = 0; i < nextra; i++) {
+        j = i + static_cast<int> (random->uniform()*(n-i));
+        if (j >= n) j = n-1;
+        ip = list[i];
+        list[i] = list[j];
+        list[j] = ip;
+      }
+
+      for (i = 0; i < n; i++) {
+        slist[ns++] = list[i];
+        nclone = nbase-1;
+        if (i < nextra) nclone++;
+
+        for (m = 0; m < nclone; m++) {
+          particle->clone_particle(list[i]);
+          particle->particles[particle->nlocal-1].id =
+            MAXSMALLINT*random->uniform();
+          slist[ns++] = particle->nlocal-1;
+        }
+      }
+    }
+
+    kcount[ispecies] = ns - kfirst[ispecies];
+  }
+
+  if (ns) restore(np,ns);
+  return ns;
+}
+
+/* ----------------------------------------------------------------------
+   tally count, velocity and energy sums for N particles of one species
+------------------------------------------------------------------------- */
+
+void FixMerge::sums(int n, int *list, double *sum)
+{
+  Particle::OnePart *particles = particle->particles;
+  double *v;
+
+  for (int k = 0; k < NSUM; k++) sum[k] = 0.0;
+
+  for (int i = 0; i < n; i++) {
+    v = particles[list[i]].v;
+    sum[VX] += v[0];
+    sum[VY] += v[1];
+    sum[VZ] += v[2];
+    sum[VSQ] += v[0]*v[0] + v[1]*v[1] + v[2]*v[2];
+    sum[EROT] += particles[list[i]].erot;
+    sum[EVIB] += particles[list[i]].evib;
+  }
+  sum[COUNT] = n;
+}
+
+/* ----------------------------------------------------------------------
+   restore conserved quantities of Nold original and Nnow resampled
+     particles in a cell, caller sets new cell weight = weight*Nold/Nnow
+   so per-particle sums of resampled particles must be Nnow/Nold times
+     per-particle sums of original particles
+   shift velocities of each species to its old mean velocity plus
+     one common shift so momentum of cell is unchanged
+   scale thermal velocities of all species by one factor so
+     kinetic energy of cell is unchanged, likewise for erot and evib
+   one factor per cell avoids wild per-species factors when only
+     a few particles of a species remain
+------------------------------------------------------------------------- */
+
+void FixMerge::restore(int nold, int nnow)
+{
+  int i,k,n,ispecies;
+  double mass,del[3];
+  double *v,*uold;
+
+  Particle::OnePart *particles = particle->particles;
+  Particle::Species *species = particle->species;
+
+  double ratio = (double) nnow / nold;
+
+  double pold[3],pnow[3],shift[3];
+  pold[0] = pold[1] = pold[2] = 0.0;
+  pnow[0] = pnow[1] = pnow[2] = 0.0;
+  double mnow = 0.0;
+
+  double keold = 0.0;
+  double thnow = 0.0;
+  double bulknow = 0.0;
+  double erotold = 0.0;
+  double erotnow = 0.0;
+  double evibold = 0.0;
+  double evibnow = 0.0;
+
+  // old mean velocity of each species
+  // tally momentum and kinetic energy of old particles
+  // tally momentum and mass of resampled particles at old mean velocities
+
+  for (ispecies = 0; ispecies < nspecies; ispecies++) {
+    double *old = before[ispecies];
+    if (old[COUNT] == 0.0) continue;
+
+    mass = species[ispecies].mass;
+    uold = ucom[ispecies];
+    for (k = 0; k < 3; k++) {
+      uold[k] = old[VX+k]/old[COUNT];
+      pold[k] += mass*old[VX+k];
+      pnow[k] += mass*kcount[ispecies]*uold[k];
+    }
+    mnow += mass*kcount[ispecies];
+    keold += mass*old[VSQ];
+    erotold += old[EROT];
+    evibold += old[EVIB];
+  }
+
+  // common shift restores momentum of cell
+
+  for (k = 0; k < 3; k++) shift[k] = (ratio*pold[k] - pnow[k]) / mnow;
+
+  // shift each species to its old mean velocity plus common shift
+  // tally thermal and bulk kinetic energy of resampled particles
+
+  for (ispecies = 0; ispecies < nspecies; ispecies++) {
+    n = kcount[ispecies];
+    if (n == 0) continue;
+    int *list = &slist[kfirst[ispecies]];
+
+    mass = species[ispecies].mass;
+    uold = ucom[ispecies];
+    for (k = 0; k < 3; k++) uold[k] += shift[k];
+
+    double now[NSUM];
+    sums(n,list,now);
+    del[0] = uold[0] - now[VX]/n;
+    del[1] = uold[1] - now[VY]/n;
+    del[2] = uold[2] - now[VZ]/n;
+
+    for (i = 0; i < n; i++) {
+      v = particles[list[i]].v;
+      v[0] += del[0];
+      v[1] += del[1];
+      v[2] += del[2];
+      thnow += mass * ((v[0]-uold[0])*(v[0]-uold[0]) +
+                       (v[1]-uold[1])*(v[1]-uold[1]) +
+                       (v[2]-uold[2])*(v[2]-uold[2]));
+    }
+    bulknow += mass*n *
+      (uold[0]*uold[0] + uold[1]*uold[1] + uold[2]*uold[2]);
+    erotnow += now[EROT];
+    evibnow += now[EVIB];
+  }
+
+  // thermal energy of resampled particles makes up the kinetic energy
+  //   of the cell not carried by their mean velocities
+  // if that is not positive, cell kinetic energy cannot be conserved,
+  //   just leave thermal velocities as they are
+
+  double vscale = 1.0;
+  double thtarget = ratio*keold - bulknow;
+  if (thnow > 0.0 && thtarget > 0.0) vscale = sqrt(thtarget/thnow);
+  double rscale = 1.0;
+  if (erotnow > 0.0) rscale = ratio*erotold/erotnow;
+  double vibscale = 1.0;
+  if (evibflag && evibnow > 0.0) vibscale = ratio*evibold/evibnow;
+
+  for (ispecies = 0; ispecies < nspecies; ispecies++) {
+    n = kcount[ispecies];
+    if (n == 0) continue;
+    int *list = &slist[kfirst[ispecies]];
+    uold = ucom[ispecies];
+
+    for (i = 0; i < n; i++) {
+      v = particles[list[i]].v;
+      v[0] = uold[0] + vscale*(v[0]-uold[0]);
+      v[1] = uold[1] + vscale*(v[1]-uold[1]);
+      v[2] = uold[2] + vscale*(v[2]-uold[2]);
+      particles[list[i]].erot *= rscale;
+      particles[list[i]].evib *= vibscale;
+    }
+  }
+}
+
+/* ----------------------------------------------------------------------
+   return cumulative particles merged away, particles split off,
+   and cells whose weight was changed
+------------------------------------------------------------------------- */
+
+double FixMerge::compute_vector(int i)
+{
+  bigint one,all;
+
+  if (i == 0) one = nmerge_running;
+  else if (i == 1) one = nsplit_running;
+  else one = ncell_running;
+
+  MPI_Allreduce(&one,&all,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  return (double) all;
+}
+
+/* ----------------------------------------------------------------------
+   memory usage
+------------------------------------------------------------------------- */
+
+double FixMerge::memory_usage()
+{
+  double bytes = 0.0;
+  bytes += nspecies*(4*sizeof(int) + (NSUM+3)*sizeof(double));
+  bytes += (maxplist + maxslist + maxdelete) * sizeof(int);
+  return bytes;
+}
@@ -0,0 +1,113 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(merge,FixMerge)
+
+#else
+
+#ifndef SPARTA_FIX_MERGE_H
+#define SPARTA_FIX_MERGE_H
+
+#include "fix.h"
+
+namespace SPARTA_NS {
+
+class FixMerge : public Fix {
+ public:
+  FixMerge(class SPARTA *, int, char **);
+  ~FixMerge();
+  int setmask();
+  void init();
+  void end_of_step();
+  double compute_vector(int);
+  double memory_usage();
+
+ private:
+  int me;
+  int nmax;                  // merge cells with more than nmax particles
+  int ntarget;               // particle count to merge or split a cell to
+  int nmin;                  // split cells with fewer than nmin particles
+  double maxfactor;          // max ratio of cell weight to its base weight
+  int evibflag;              // 1 if evib can be rescaled continuously
+  int nemit;                 // # of emit fixes
+  int *emitlist;             // indices of emit fixes
+
+  bigint nmerge_running;     // # of particles removed by merging
+  bigint nsplit_running;     // # of particles added by splitting
+  bigint ncell_running;      // # of cells whose weight was changed
+
+  int nspecies;
+  int *scount;               // # of particles of each species in a cell
+  int *sfirst;               // index into plist of 1st particle of species
+  int *kcount;               // # of resampled particles of each species
+  int *kfirst;               // index into slist of 1st particle of species
+  double **before;           // per-species sums of cell before resampling
+  double **ucom;             // per-species mean velocity before resampling
+
+  int maxplist;
+  int *plist;                // particles in one cell, grouped by species
+  int maxslist;
+  int *slist;                // particles in one cell after resampling
+  int maxdelete;
+  int ndelete;
+  int *dellist;              // particles to delete after all cells are done
+
+  class RanKnuth *random;
+
+  int resample(int, double);
+  void sums(int, int *, double *);
+  void restore(int, int);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running SPARTA to see the offending line.
+
+E: Cannot use fix merge with Kokkos
+
+Self-explanatory.
+
+E: Fix merge requires cell weighting
+
+Merging particles raises the fnum weight of individual grid cells, so
+per-cell weighting must be enabled via the global weight command.
+
+E: Fix merge N is not a multiple of fix ave/grid Nfreq
+
+Cell weights can only change at the end of a fix ave/grid averaging
+window, since its computes apply the current cell weight to all
+samples in the window.
+
+E: Fix merge must come after fix ave/grid
+
+So that fix ave/grid takes the last sample of its window before cell
+weights change on the same timestep.
+
+E: Fix merge does not allow use of fix ave/grid ave running
+
+A running average spans many changes of cell weight, but its computes
+apply only the current cell weight to all of its samples.
+
+*/
@@ -0,0 +1,594 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#include "math.h"
+#include "stdlib.h"
+#include "string.h"
+#include "fix_steady.h"
+#include "update.h"
+#include "particle.h"
+#include "grid.h"
+#include "modify.h"
+#include "compute.h"
+#include "input.h"
+#include "variable.h"
+#include "comm.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace SPARTA_NS;
+
+enum{NP,COMPUTE,FIX,VARIABLE};
+enum{TRANSIENT,SAMPLING,CONVERGED};
+
+#define INVOKED_SCALAR 1
+#define INVOKED_VECTOR 2
+
+/* ---------------------------------------------------------------------- */
+
+FixSteady::FixSteady(SPARTA *sparta, int narg, char **arg) :
+  Fix(sparta, narg, arg)
+{
+  if (narg < 5) error->all(FLERR,"Illegal fix steady command");
+
+  MPI_Comm_rank(world,&me);
+
+  nevery = atoi(arg[2]);
+  nwindow = atoi(arg[3]);
+  if (nevery <= 0 || nwindow <= 1)
+    error->all(FLERR,"Illegal fix steady command");
+
+  time_depend = 1;
+  vector_flag = 1;
+  size_vector = 3;
+  global_freq = nevery;
+
+  // gridmigrate so grid_changed() is invoked when grid cells change
+
+  gridmigrate = 1;
+
+  // count values
+
+  nvalues = 0;
+  int iarg = 4;
+  while (iarg < narg) {
+    if ((strcmp(arg[iarg],"np") == 0) ||
+        (strncmp(arg[iarg],"c_",2) == 0) ||
+        (strncmp(arg[iarg],"f_",2) == 0) ||
+        (strncmp(arg[iarg],"v_",2) == 0)) {
+      nvalues++;
+      iarg++;
+    } else break;
+  }
+
+  if (nvalues == 0) error->all(FLERR,"No values in fix steady command");
+
+  // parse values
+
+  which = new int[nvalues];
+  argindex = new int[nvalues];
+  value2index = new int[nvalues];
+  pergrid = new int[nvalues];
+  ids = new char*[nvalues];
+
+  for (int i = 0; i < nvalues; i++) {
+    char *str = arg[4+i];
+    pergrid[i] = 0;
+    argindex[i] = 0;
+    ids[i] = NULL;
+
+    if (strcmp(str,"np") == 0) {
+      which[i] = NP;
+      continue;
+    }
+
+    if (str[0] == 'c') which[i] = COMPUTE;
+    else if (str[0] == 'f') which[i] = FIX;
+    else if (str[0] == 'v') which[i] = VARIABLE;
+
+    int n = strlen(str);
+    char *suffix = new char[n];
+    strcpy(suffix,&str[2]);
+
+    char *ptr = strchr(suffix,'[');
+    if (ptr) {
+      if (suffix[strlen(suffix)-1] != ']')
+        error->all(FLERR,"Illegal fix steady command");
+      argindex[i] = atoi(ptr+1);
+      *ptr = '\0';
+    }
+
+    n = strlen(suffix) + 1;
+    ids[i] = new char[n];
+    strcpy(ids[i],suffix);
+    delete [] suffix;
+  }
+
+  // optional args
+
+  tol = 0.01;
+  ntol = 3;
+  errtarget = 0.01;
+  nmin = 5;
+  stopflag = 1;
+  nsample = 0;
+  idsample = NULL;
+
+  iarg = 4 + nvalues;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"tol") == 0) {
+      if (iarg+3 > narg) error->all(FLERR,"Illegal fix steady command");
+      tol = atof(arg[iarg+1]);
+      ntol = atoi(arg[iarg+2]);
+      if (tol <= 0.0 || ntol <= 0)
+        error->all(FLERR,"Illegal fix steady command");
+      iarg += 3;
+    } else if (strcmp(arg[iarg],"error") == 0) {
+      if (iarg+3 > narg) error->all(FLERR,"Illegal fix steady command");
+      errtarget = atof(arg[iarg+1]);
+      nmin = atoi(arg[iarg+2]);
+      if (errtarget <= 0.0 || nmin < 2)
+        error->all(FLERR,"Illegal fix steady command");
+      iarg += 3;
+    } else if (strcmp(arg[iarg],"stop") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal fix steady command");
+      if (strcmp(arg[iarg+1],"yes") == 0) stopflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) stopflag = 0;
+      else error->all(FLERR,"Illegal fix steady command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"sample") == 0) {
+      iarg++;
+      while (iarg < narg) {
+        if (strcmp(arg[iarg],"tol") == 0 || strcmp(arg[iarg],"error") == 0 ||
+            strcmp(arg[iarg],"stop") == 0) break;
+        char **newids = new char*[nsample+1];
+        for (int m = 0; m < nsample; m++) newids[m] = idsample[m];
+        delete [] idsample;
+        idsample = newids;
+        int n = strlen(arg[iarg]) + 1;
+        idsample[nsample] = new char[n];
+        strcpy(idsample[nsample],arg[iarg]);
+        nsample++;
+        iarg++;
+      }
+    } else error->all(FLERR,"Illegal fix steady command");
+  }
+
+  // error checks on values
+  // per-grid fix values are compared once per window,
+  //   global values are sampled every Nevery steps
+
+  for (int i = 0; i < nvalues; i++) {
+    if (which[i] == COMPUTE) {
+      int icompute = modify->find_compute(ids[i]);
+      if (icompute < 0)
+        error->all(FLERR,"Compute ID for fix steady does not exist");
+      Compute *compute = modify->compute[icompute];
+      if (argindex[i] == 0 && compute->scalar_flag == 0)
+        error->all(FLERR,"Fix steady compute does not calculate a scalar");
+      if (argindex[i] && compute->vector_flag == 0)
+        error->all(FLERR,"Fix steady compute does not calculate a vector");
+      if (argindex[i] && argindex[i] > compute->size_vector)
+        error->all(FLERR,"Fix steady compute vector is accessed out-of-range");
+
+    } else if (which[i] == FIX) {
+      int ifix = modify->find_fix(ids[i]);
+      if (ifix < 0)
+        error->all(FLERR,"Fix ID for fix steady does not exist");
+      Fix *fix = modify->fix[ifix];
+
+      if (fix->per_grid_flag) {
+        pergrid[i] = 1;
+        if (argindex[i] == 0 && fix->size_per_grid_cols != 0)
+          error->all(FLERR,"Fix steady fix does not calculate "
+                     "a scalar or per-grid values");
+        if (argindex[i] && fix->size_per_grid_cols == 0)
+          error->all(FLERR,"Fix steady fix does not calculate "
+                     "a vector or per-grid array");
+        if (argindex[i] && argindex[i] > fix->size_per_grid_cols)
+          error->all(FLERR,
+                     "Fix steady fix vector or array is accessed out-of-range");
+        if ((nevery*nwindow) % fix->per_grid_freq)
+          error->all(FLERR,"Fix for fix steady not computed at compatible time");
+      } else {
+        if (argindex[i] == 0 && fix->scalar_flag == 0)
+          error->all(FLERR,"Fix steady fix does not calculate "
+                     "a scalar or per-grid values");
+        if (argindex[i] && fix->vector_flag == 0)
+          error->all(FLERR,"Fix steady fix does not calculate "
+                     "a vector or per-grid array");
+        if (argindex[i] && argindex[i] > fix->size_vector)
+          error->all(FLERR,
+                     "Fix steady fix vector or array is accessed out-of-range");
+        if (nevery % fix->global_freq)
+          error->all(FLERR,"Fix for fix steady not computed at compatible time");
+      }
+
+    } else if (which[i] == VARIABLE) {
+      int ivariable = input->variable->find(ids[i]);
+      if (ivariable < 0)
+        error->all(FLERR,"Variable name for fix steady does not exist");
+      if (input->variable->equal_style(ivariable) == 0)
+        error->all(FLERR,"Fix steady variable is not equal-style variable");
+    }
+  }
+
+  for (int m = 0; m < nsample; m++) {
+    int ifix = modify->find_fix(idsample[m]);
+    if (ifix < 0) error->all(FLERR,"Fix steady sample fix does not exist");
+    if (!modify->fix[ifix]->flag_reset_sampling)
+      error->all(FLERR,"Fix steady sample fix cannot reset its sampling");
+  }
+
+  // per-window statistics
+
+  wsum = new double[nvalues];
+  mprev = new double[nvalues];
+  bsum = new double[nvalues];
+  bsumsq = new double[nvalues];
+  for (int i = 0; i < nvalues; i++) wsum[i] = mprev[i] = 0.0;
+  for (int i = 0; i < nvalues; i++) bsum[i] = bsumsq[i] = 0.0;
+
+  phase = TRANSIENT;
+  isample = ncount = 0;
+  prevflag = 0;
+  metric = 0.0;
+
+  maxgrid = 0;
+  gprev = NULL;
+  gprevflag = 0;
+
+  // nvalid = next step on which end_of_step does something
+  // add nvalid to all computes that store invocation times
+
+  nvalid = nextvalid();
+  modify->addstep_compute_all(nvalid);
+}
+
+/* ---------------------------------------------------------------------- */
+
+FixSteady::~FixSteady()
+{
+  if (copymode) return;
+
+  delete [] which;
+  delete [] argindex;
+  delete [] value2index;
+  delete [] pergrid;
+  for (int i = 0; i < nvalues; i++) delete [] ids[i];
+  delete [] ids;
+
+  for (int i = 0; i < nsample; i++) delete [] idsample[i];
+  delete [] idsample;
+
+  delete [] wsum;
+  delete [] mprev;
+  delete [] bsum;
+  delete [] bsumsq;
+
+  memory->destroy(gprev);
+}
+
+/* ---------------------------------------------------------------------- */
+
+int FixSteady::setmask()
+{
+  int mask = 0;
+  mask |= END_OF_STEP;
+  return mask;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixSteady::init()
+{
+  // set current indices for all computes,fixes,variables
+
+  for (int i = 0; i < nvalues; i++) {
+    if (which[i] == COMPUTE) {
+      int icompute = modify->find_compute(ids[i]);
+      if (icompute < 0)
+        error->all(FLERR,"Compute ID for fix steady does not exist");
+      value2index[i] = icompute;
+
+    } else if (which[i] == FIX) {
+      int ifix = modify->find_fix(ids[i]);
+      if (ifix < 0)
+        error->all(FLERR,"Fix ID for fix steady does not exist");
+      if (pergrid[i] && ifix > modify->find_fix(id))
+        error->all(FLERR,"Fix steady per-grid fix must be defined before "
+                   "fix steady");
+      value2index[i] = ifix;
+
+    } else if (which[i] == VARIABLE) {
+      int ivariable = input->variable->find(ids[i]);
+      if (ivariable < 0)
+        error->all(FLERR,"Variable name for fix steady does not exist");
+      value2index[i] = ivariable;
+    }
+  }
+
+  for (int m = 0; m < nsample; m++)
+    if (modify->find_fix(idsample[m]) < 0)
+      error->all(FLERR,"Fix steady sample fix does not exist");
+
+  // grid cells may have changed since last run
+
+  gprevflag = 0;
+}
+
+/* ----------------------------------------------------------------------
+   sample global values every Nevery steps
+   evaluate convergence at end of each window of Nwindow samples
+------------------------------------------------------------------------- */
+
+void FixSteady::end_of_step()
+{
+  bigint ntimestep = update->ntimestep;
+  if (ntimestep != nvalid) return;
+
+  // nothing more to do once converged
+
+  if (phase == CONVERGED) {
+    nvalid = ntimestep + nevery;
+    return;
+  }
+
+  // compute/fix/variable may invoke computes so wrap with clear/add
+
+  modify->clearstep_compute();
+
+  for (int i = 0; i < nvalues; i++)
+    if (!pergrid[i]) wsum[i] += global_value(i);
+  isample++;
+
+  if (isample == nwindow) window();
+
+  nvalid = ntimestep + nevery;
+  modify->addstep_compute(nvalid);
+}
+
+/* ----------------------------------------------------------------------
+   end of a window of samples
+   TRANSIENT: window means of global values and per-grid values must
+     change by less than tol for Ntol consecutive windows,
+     then sample fixes are reset and SAMPLING begins
+   SAMPLING: each window mean is one batch mean,
+     relative standard error of batch means of global values and
+     window-to-window change of per-grid values must be < error target
+     after Nmin windows, then run is halted if requested
+------------------------------------------------------------------------- */
+
+void FixSteady::window()
+{
+  int i;
+  double mean,delta,scale,err;
+
+  metric = 0.0;
+  int valid = 1;
+
+  for (i = 0; i < nvalues; i++) {
+    if (pergrid[i]) {
+      delta = grid_change(i);
+      if (delta < 0.0) valid = 0;
+      else metric = MAX(metric,delta);
+      continue;
+    }
+
+    mean = wsum[i] / nwindow;
+    wsum[i] = 0.0;
+
+    if (phase == TRANSIENT) {
+      if (prevflag) {
+        scale = MAX(fabs(mean),fabs(mprev[i]));
+        if (scale > 0.0) delta = fabs(mean-mprev[i]) / scale;
+        else delta = 0.0;
+        metric = MAX(metric,delta);
+      } else valid = 0;
+      mprev[i] = mean;
+
+    } else {
+      bsum[i] += mean;
+      bsumsq[i] += mean*mean;
+      int nb = ncount + 1;
+      if (nb < 2) {
+        valid = 0;
+        continue;
+      }
+      double bmean = bsum[i] / nb;
+      double var = (bsumsq[i] - nb*bmean*bmean) / (nb-1);
+      if (var < 0.0) var = 0.0;
+      err = sqrt(var/nb);
+      if (bmean != 0.0) err /= fabs(bmean);
+      metric = MAX(metric,err);
+    }
+  }
+
+  prevflag = 1;
+  isample = 0;
+
+  if (phase == TRANSIENT) {
+    if (valid && metric < tol) ncount++;
+    else ncount = 0;
+    if (ncount >= ntol) begin_sampling();
+    return;
+  }
+
+  ncount++;
+  if (!valid || ncount < nmin || metric >= errtarget) return;
+
+  phase = CONVERGED;
+  char str[128];
+  sprintf(str,"Fix steady: sampled statistics converged on step "
+          BIGINT_FORMAT,update->ntimestep);
+  message(str);
+  if (stopflag) update->haltflag = 1;
+}
+
+/* ----------------------------------------------------------------------
+   switch from TRANSIENT to SAMPLING phase
+   sample fixes discard their accumulated averages
+------------------------------------------------------------------------- */
+
+void FixSteady::begin_sampling()
+{
+  phase = SAMPLING;
+  ncount = 0;
+  for (int i = 0; i < nvalues; i++) bsum[i] = bsumsq[i] = 0.0;
+
+  for (int m = 0; m < nsample; m++)
+    modify->fix[modify->find_fix(idsample[m])]->reset_sampling();
+
+  char str[128];
+  sprintf(str,"Fix steady: steady state reached on step "
+          BIGINT_FORMAT ", sampling begins",update->ntimestep);
+  message(str);
+}
+
+/* ----------------------------------------------------------------------
+   return current global value I
+------------------------------------------------------------------------- */
+
+double FixSteady::global_value(int i)
+{
+  if (which[i] == NP) {
+    bigint nme = particle->nlocal;
+    bigint nall;
+    MPI_Allreduce(&nme,&nall,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+    return (double) nall;
+  }
+
+  int m = value2index[i];
+
+  if (which[i] == COMPUTE) {
+    Compute *compute = modify->compute[m];
+    if (argindex[i] == 0) {
+      if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+        modify->invoke_begin(compute);
+        compute->compute_scalar();
+        modify->invoke_end();
+        compute->invoked_flag |= INVOKED_SCALAR;
+      }
+      return compute->scalar;
+    }
+    if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+      modify->invoke_begin(compute);
+      compute->compute_vector();
+      modify->invoke_end();
+      compute->invoked_flag |= INVOKED_VECTOR;
+    }
+    return compute->vector[argindex[i]-1];
+  }
+
+  if (which[i] == FIX) {
+    if (argindex[i] == 0) return modify->fix[m]->compute_scalar();
+    return modify->fix[m]->compute_vector(argindex[i]-1);
+  }
+
+  return input->variable->compute_equal(m);
+}
+
+/* ----------------------------------------------------------------------
+   relative L2 norm of change in per-grid fix value I since last window
+   store current values for next window
+   return -1 if no valid previous values, e.g. grid cells changed
+------------------------------------------------------------------------- */
+
+double FixSteady::grid_change(int i)
+{
+  Fix *fix = modify->fix[value2index[i]];
+  int nglocal = grid->nlocal;
+  int j = argindex[i];
+
+  if (nglocal > maxgrid) {
+    memory->destroy(gprev);
+    maxgrid = nglocal;
+    memory->create(gprev,maxgrid,nvalues,"steady:gprev");
+    gprevflag = 0;
+  }
+
+  double value;
+  double sum[2],sumall[2];
+  sum[0] = sum[1] = 0.0;
+
+  for (int icell = 0; icell < nglocal; icell++) {
+    if (j == 0) value = fix->vector_grid[icell];
+    else value = fix->array_grid[icell][j-1];
+    sum[0] += (value-gprev[icell][i]) * (value-gprev[icell][i]);
+    sum[1] += value*value;
+    gprev[icell][i] = value;
+  }
+
+  MPI_Allreduce(sum,sumall,2,MPI_DOUBLE,MPI_SUM,world);
+
+  // gprevflag is only reset once all per-grid values have been stored
+
+  int flag = gprevflag;
+  int last = 1;
+  for (int m = i+1; m < nvalues; m++)
+    if (pergrid[m]) last = 0;
+  if (last) gprevflag = 1;
+
+  if (!flag) return -1.0;
+  if (sumall[1] == 0.0) return 0.0;
+  return sqrt(sumall[0]/sumall[1]);
+}
+
+/* ----------------------------------------------------------------------
+   grid cells have changed during a run, e.g. due to load balancing
+   per-grid values from previous window can no longer be compared
+------------------------------------------------------------------------- */
+
+void FixSteady::grid_changed()
+{
+  gprevflag = 0;
+}
+
+/* ----------------------------------------------------------------------
+   return phase, # of windows in current phase, last convergence metric
+------------------------------------------------------------------------- */
+
+double FixSteady::compute_vector(int i)
+{
+  if (i == 0) return (double) phase;
+  if (i == 1) return (double) ncount;
+  return metric;
+}
+
+/* ---------------------------------------------------------------------- */
+
+void FixSteady::message(const char *str)
+{
+  if (me) return;
+  if (screen) fprintf(screen,"%s\n",str);
+  if (logfile) fprintf(logfile,"%s\n",str);
+}
+
+/* ----------------------------------------------------------------------
+   calculate nvalid = next step on which end_of_step does something
+------------------------------------------------------------------------- */
+
+bigint FixSteady::nextvalid()
+{
+  return (update->ntimestep/nevery)*nevery + nevery;
+}
+
+/* ---------------------------------------------------------------------- */
+
+double FixSteady::memory_usage()
+{
+  double bytes = 4*nvalues * sizeof(double);
+  bytes += (double) maxgrid*nvalues * sizeof(double);
+  return bytes;
+}
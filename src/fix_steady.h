@@ -0,0 +1,155 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifdef FIX_CLASS
+
+FixStyle(steady,FixSteady)
+
+#else
+
+#ifndef SPARTA_FIX_STEADY_H
+#define SPARTA_FIX_STEADY_H
+
+#include "fix.h"
+
+namespace SPARTA_NS {
+
+class FixSteady : public Fix {
+ public:
+  FixSteady(class SPARTA *, int, char **);
+  ~FixSteady();
+  int setmask();
+  void init();
+  void end_of_step();
+  bigint next_end_of_step() {return nvalid;}
+  void grid_changed();
+  double compute_vector(int);
+  double memory_usage();
+
+ private:
+  int me,nvalues,nwindow;
+  int phase;                 // TRANSIENT, SAMPLING, CONVERGED
+  int isample;               // # of samples in current window
+  int ncount;                // consecutive steady windows or sampled windows
+  bigint nvalid;
+
+  double tol;                // rel change between windows to be steady
+  int ntol;                  // # of consecutive windows below tol
+  double errtarget;          // target rel error of sampled statistics
+  int nmin;                  // min # of sampled windows before stopping
+  int stopflag;              // 1 to end run once converged
+  double metric;             // max criterion of all values, last window
+
+  int *which,*argindex,*value2index,*pergrid;
+  char **ids;
+
+  int nsample;               // fixes to reset when sampling begins
+  char **idsample;
+
+  double *wsum;              // sum of samples in current window
+  double *mprev;             // mean of previous window
+  int prevflag;              // 1 if mprev is set
+  double *bsum,*bsumsq;      // sum and sum of squares of window means
+                             //   while sampling
+
+  int maxgrid;               // # of owned cells gprev is allocated for
+  double **gprev;            // per-grid values at end of previous window
+  int gprevflag;             // 1 if gprev is valid for current grid
+
+  void window();
+  double global_value(int);
+  double grid_change(int);
+  void begin_sampling();
+  void message(const char *);
+  bigint nextvalid();
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Illegal ... command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.  You can use -echo screen as a
+command-line option when running SPARTA to see the offending line.
+
+E: No values in fix steady command
+
+Self-explanatory.
+
+E: Compute ID for fix steady does not exist
+
+Self-explanatory.
+
+E: Fix steady compute does not calculate a scalar
+
+Self-explanatory.
+
+E: Fix steady compute does not calculate a vector
+
+Self-explanatory.
+
+E: Fix steady compute vector is accessed out-of-range
+
+Self-explanatory.
+
+E: Fix ID for fix steady does not exist
+
+Self-explanatory.
+
+E: Fix steady fix does not calculate a scalar or per-grid values
+
+Self-explanatory.
+
+E: Fix steady fix does not calculate a vector or per-grid array
+
+Self-explanatory.
+
+E: Fix steady fix vector or array is accessed out-of-range
+
+Self-explanatory.
+
+E: Fix for fix steady not computed at compatible time
+
+Global fix values must be produced on every sampling step.  Per-grid
+fix values must be produced at the end of every window of Nevery *
+Nwindow steps.
+
+E: Fix steady per-grid fix must be defined before fix steady
+
+So that its per-grid values are updated before fix steady compares
+them on the same timestep.
+
+E: Variable name for fix steady does not exist
+
+Self-explanatory.
+
+E: Fix steady variable is not equal-style variable
+
+Self-explanatory.
+
+E: Fix steady sample fix does not exist
+
+Self-explanatory.
+
+E: Fix steady sample fix cannot reset its sampling
+
+Only fixes which accumulate averages, such as fix ave/grid and fix
+ave/surf, can be listed with the sample keyword.
+
+*/
@@ -23,10 +23,13 @@
 #include "domain.h"
 #include "comm.h"
 #include "surf.h"
+#include "grid.h"
+#include "irregular.h"
 #include "modify.h"
 #include "compute.h"
 #include "fix.h"
 #include "input.h"
+#include "variable.h"
 #include "update.h"
 #include "memory.h"
 #include "error.h"
@@ -39,7 +42,7 @@ using namespace SPARTA_NS;
 #define SB_CGS 5.670374419e-5
 
 enum{INT,DOUBLE};                      // several files
-enum{COMPUTE,FIX};
+enum{COMPUTE,FIX,VARIABLE};
 
 /* ---------------------------------------------------------------------- */
 
@@ -59,6 +62,10 @@ FixSurfTemp::FixSurfTemp(SPARTA *sparta, int narg, char **arg) :
 
   nevery = atoi(arg[3]);
 
+  // gridmigrate so grid_changed() is invoked when grid cells change
+
+  gridmigrate = 1;
+
   if (strncmp(arg[4],"c_",2) == 0) {
     source = COMPUTE;
     int n = strlen(arg[4]);
@@ -117,6 +124,21 @@ FixSurfTemp::FixSurfTemp(SPARTA *sparta, int narg, char **arg) :
     if (nevery % fqw->per_surf_freq)
       error->all(FLERR,"Fix surf/temp source not computed at compatible times");
 
+  } else if (strncmp(arg[4],"v_",2) == 0) {
+    source = VARIABLE;
+    int n = strlen(arg[4]);
+    id_qw = new char[n];
+    strcpy(id_qw,&arg[4][2]);
+    qwindex = 0;
+
+    // error checks
+
+    ivariable = input->variable->find(id_qw);
+    if (ivariable < 0)
+      error->all(FLERR,"Could not find fix surf/temp variable name");
+    if (input->variable->surf_style(ivariable) == 0)
+      error->all(FLERR,"Fix surf/temp variable is not surf-style variable");
+
   } else error->all(FLERR,"Invalid source in fix surf/temp command");
 
   twall = input->numeric(FLERR,arg[5]);
@@ -153,9 +175,15 @@ FixSurfTemp::FixSurfTemp(SPARTA *sparta, int narg, char **arg) :
 
   firstflag = 1;
 
-  // initialize data structure
+  // initialize data structures
 
-  tvector_me = NULL;
+  qwvar = NULL;
+
+  patternflag = 0;
+  irregular = NULL;
+  nsend = nrecv = 0;
+  send_index = recv_index = NULL;
+  sbuf = rbuf = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -163,7 +191,13 @@ FixSurfTemp::FixSurfTemp(SPARTA *sparta, int narg, char **arg) :
 FixSurfTemp::~FixSurfTemp()
 {
   delete [] id_qw;
-  memory->destroy(tvector_me);
+  memory->destroy(qwvar);
+
+  delete irregular;
+  memory->destroy(send_index);
+  memory->destroy(recv_index);
+  memory->destroy(sbuf);
+  memory->destroy(rbuf);
   surf->remove_custom(tindex);
 }
 
@@ -180,6 +214,18 @@ int FixSurfTemp::setmask()
 
 void FixSurfTemp::init()
 {
+  // reset variable index in case it was re-defined
+
+  if (source == VARIABLE) {
+    ivariable = input->variable->find(id_qw);
+    if (ivariable < 0)
+      error->all(FLERR,"Could not find fix surf/temp variable name");
+  }
+
+  // grid cells or their surfs may have changed since last run
+
+  patternflag = 0;
+
   // one-time initialization of temperature for all surfs in custom vector
 
   if (!firstflag) return;
@@ -191,9 +237,21 @@ void FixSurfTemp::init()
   for (int i = 0; i < nlocal; i++)
     tvector[i] = twall;
 
-  // allocate per-surf vector for explicit all surfs
+  // allocate per-surf vector for surf-style variable values of surfs I own
+
+  if (source == VARIABLE)
+    memory->create(qwvar,surf->nown,"surf/temp:qwvar");
+}
+
+/* ----------------------------------------------------------------------
+   grid cells may have changed since last run, e.g. via balance_grid
+   rebuild comm pattern and send current temperatures before 1st step
+------------------------------------------------------------------------- */
 
-  memory->create(tvector_me,nlocal,"surf/temp:tvector_me");
+void FixSurfTemp::setup()
+{
+  setup_pattern();
+  send_temperatures();
 }
 
 /* ----------------------------------------------------------------------
@@ -210,35 +268,40 @@ void FixSurfTemp::end_of_step()
   int nprocs = comm->nprocs;
   int dimension = domain->dimension;
 
-  // access source compute or fix
+  // access source compute or fix or evaluate source variable
   // set new temperature via Stefan-Boltzmann eq for nown surfs I own
   // use Twall if surf is not in surf group or eng flux is too small
   // compute/fix output is just my nown surfs, indexed by M
-  // store in tvector_me = all nlocal surfs, indexed by I
+  // store in tvector = all nlocal surfs, indexed by I
 
   Surf::Line *lines = surf->lines;
   Surf::Tri *tris = surf->tris;
 
   int nlocal = surf->nlocal;
-
-  memset(tvector_me,0,nlocal*sizeof(double));
+  double *tvector = surf->edvec[surf->ewhich[tindex]];
 
   if (qwindex == 0) {
     double *vector;
     if (source == COMPUTE) {
       cqw->post_process_surf();
       vector = cqw->vector_surf;
-    } else vector = fqw->vector_surf;
+    } else if (source == FIX) vector = fqw->vector_surf;
+    else {
+      modify->clearstep_compute();
+      input->variable->compute_surf(ivariable,qwvar,1,0);
+      modify->addstep_compute(update->ntimestep + nevery);
+      vector = qwvar;
+    }
 
     m = 0;
     for (i = me; i < nlocal; i += nprocs) {
       if (dimension == 3) mask = tris[i].mask;
       else mask = lines[i].mask;
-      if (!(mask & groupbit)) tvector_me[i] = twall;
+      if (!(mask & groupbit)) tvector[i] = twall;
       else {
         qw = vector[m];
-        if (qw > threshold) tvector_me[i] = pow(prefactor*qw,0.25);
-        else tvector_me[i] = twall;
+        if (qw > threshold) tvector[i] = pow(prefactor*qw,0.25);
+        else tvector[i] = twall;
       }
       m++;
     }
@@ -256,20 +319,154 @@ void FixSurfTemp::end_of_step()
     for (i = me; i < nlocal; i += nprocs) {
       if (dimension == 3) mask = tris[i].mask;
       else mask = lines[i].mask;
-      if (!(mask & groupbit)) tvector_me[i] = twall;
+      if (!(mask & groupbit)) tvector[i] = twall;
       else {
         qw = array[m][icol];
-        if (qw > threshold) tvector_me[i] = pow(prefactor*qw,0.25);
-        else tvector_me[i] = twall;
+        if (qw > threshold) tvector[i] = pow(prefactor*qw,0.25);
+        else tvector[i] = twall;
       }
       m++;
     }
   }
 
-  // Allreduce tvector_me with my owned surfs to tvector custom variable
-  // so that all procs know new temperature of all surfs
-  // NOTE: could possibly just Allreduce a vector size of surface group
+  // send new temperatures of my owned surfs to procs whose cells use them
+  // temperatures of other surfs are not needed by this proc
+
+  if (!patternflag) setup_pattern();
+  send_temperatures();
+}
+
+/* ----------------------------------------------------------------------
+   grid cells have changed during a run, e.g. due to load balancing
+   rebuild comm pattern and send current temperatures right away,
+     else surfs in cells I gained keep stale values until next end_of_step
+------------------------------------------------------------------------- */
+
+void FixSurfTemp::grid_changed()
+{
+  setup_pattern();
+  send_temperatures();
+}
+
+/* ----------------------------------------------------------------------
+   send current temperatures of my owned surfs to procs that use them
+   uses comm pattern built by setup_pattern()
+------------------------------------------------------------------------- */
+
+void FixSurfTemp::send_temperatures()
+{
+  int i;
 
   double *tvector = surf->edvec[surf->ewhich[tindex]];
-  MPI_Allreduce(tvector_me,tvector,nlocal,MPI_DOUBLE,MPI_SUM,world);
+
+  for (i = 0; i < nsend; i++) sbuf[i] = tvector[send_index[i]];
+  irregular->exchange_uniform((char *) sbuf,sizeof(double),(char *) rbuf);
+  for (i = 0; i < nrecv; i++) tvector[recv_index[i]] = rbuf[i];
+}
+
+/* ----------------------------------------------------------------------
+   setup comm pattern for new temperatures
+   surf I = owned by proc I % nprocs, same as in end_of_step()
+   request each surf in group that is in one of my owned or ghost cells
+     and is owned by another proc
+   owners then send the temperature of each requested surf to requestor
+------------------------------------------------------------------------- */
+
+void FixSurfTemp::setup_pattern()
+{
+  int i,j,m,isurf,mask;
+
+  int me = comm->me;
+  int nprocs = comm->nprocs;
+  int dimension = domain->dimension;
+
+  Surf::Line *lines = surf->lines;
+  Surf::Tri *tris = surf->tris;
+  int nslocal = surf->nlocal;
+
+  // flag surfs in group contained by my owned or ghost cells
+
+  int *flag;
+  memory->create(flag,nslocal,"surf/temp:flag");
+  for (i = 0; i < nslocal; i++) flag[i] = 0;
+
+  Grid::ChildCell *cells = grid->cells;
+  int ncell = grid->nlocal + grid->nghost;
+
+  for (int icell = 0; icell < ncell; icell++) {
+    if (cells[icell].nsurf <= 0) continue;
+    surfint *csurfs = cells[icell].csurfs;
+    for (j = 0; j < cells[icell].nsurf; j++) {
+      isurf = csurfs[j];
+      if (isurf % nprocs == me) continue;
+      if (dimension == 3) mask = tris[isurf].mask;
+      else mask = lines[isurf].mask;
+      if (mask & groupbit) flag[isurf] = 1;
+    }
+  }
+
+  // request = surf index + my proc ID, sent to owner of surf
+
+  int nrequest = 0;
+  for (i = 0; i < nslocal; i++)
+    if (flag[i]) nrequest++;
+
+  int *proclist,*request;
+  memory->create(proclist,nrequest,"surf/temp:proclist");
+  memory->create(request,2*nrequest,"surf/temp:request");
+
+  m = 0;
+  for (i = 0; i < nslocal; i++) {
+    if (!flag[i]) continue;
+    proclist[m] = i % nprocs;
+    request[2*m] = i;
+    request[2*m+1] = me;
+    m++;
+  }
+
+  memory->destroy(flag);
+
+  Irregular *ireq = new Irregular(sparta);
+  int nreqrecv = ireq->create_data_uniform(nrequest,proclist,
+                                           comm->commsortflag);
+
+  int *reqrecv;
+  memory->create(reqrecv,2*nreqrecv,"surf/temp:reqrecv");
+  ireq->exchange_uniform((char *) request,2*sizeof(int),(char *) reqrecv);
+  delete ireq;
+
+  memory->destroy(proclist);
+  memory->destroy(request);
+
+  // persistent pattern of owned surfs to send to each requestor
+  // exchange surf indices once, so later exchanges only send temperatures
+
+  nsend = nreqrecv;
+  memory->destroy(send_index);
+  memory->create(send_index,nsend,"surf/temp:send_index");
+  memory->create(proclist,nsend,"surf/temp:proclist");
+
+  for (i = 0; i < nsend; i++) {
+    send_index[i] = reqrecv[2*i];
+    proclist[i] = reqrecv[2*i+1];
+  }
+
+  memory->destroy(reqrecv);
+
+  delete irregular;
+  irregular = new Irregular(sparta);
+  nrecv = irregular->create_data_uniform(nsend,proclist,comm->commsortflag);
+  memory->destroy(proclist);
+
+  memory->destroy(recv_index);
+  memory->create(recv_index,nrecv,"surf/temp:recv_index");
+  irregular->exchange_uniform((char *) send_index,sizeof(int),
+                              (char *) recv_index);
+
+  memory->destroy(sbuf);
+  memory->destroy(rbuf);
+  memory->create(sbuf,nsend,"surf/temp:sbuf");
+  memory->create(rbuf,nrecv,"surf/temp:rbuf");
+
+  patternflag = 1;
 }
@@ -32,10 +32,12 @@ class FixSurfTemp : public Fix {
   virtual ~FixSurfTemp();
   int setmask();
   virtual void init();
+  virtual void setup();
   virtual void end_of_step();
+  void grid_changed();
 
  private:
-  int source,icompute,ifix,firstflag;
+  int source,icompute,ifix,ivariable,firstflag;
   int groupbit;
   double twall,emi;
   int tindex,qwindex;
@@ -45,7 +47,21 @@ class FixSurfTemp : public Fix {
   class Fix *fqw;
 
   double prefactor,threshold;
-  double *tvector_me;
+  double *qwvar;           // surf-style variable values for surfs I own
+
+  // sparse comm of new temperatures from the proc that owns each surf
+  //   to procs whose owned or ghost cells contain it
+  // pattern is rebuilt and sent at start of run and when the grid changes
+
+  int patternflag;         // 1 if comm pattern is current
+  class Irregular *irregular;
+  int nsend,nrecv;         // # of temperatures I send and recv
+  int *send_index;         // index of each surf I send
+  int *recv_index;         // index of each surf I recv
+  double *sbuf,*rbuf;
+
+  void setup_pattern();
+  void send_temperatures();
 };
 
 }
@@ -61,6 +77,14 @@ Self-explanatory.  Check the input script syntax and compare to the
 documentation for the command.  You can use -echo screen as a
 command-line option when running SPARTA to see the offending line.
 
+E: Could not find fix surf/temp variable name
+
+Self-explanatory.
+
+E: Fix surf/temp variable is not surf-style variable
+
+Only surf-style variables can be used as the heat flux source.
+
 E: Cannot use non-rcb fix balance with a grid cutoff
 
 This is because the load-balancing will generate a partitioning
@@ -18,11 +18,16 @@
 #include "update.h"
 #include "grid.h"
 #include "particle.h"
+#include "collide.h"
 #include "memory.h"
 #include "error.h"
 
 using namespace SPARTA_NS;
 
+enum{NONE,DISCRETE,SMOOTH};            // several files
+
+#define DELTA 64
+
 /* ---------------------------------------------------------------------- */
 
 FixTempRescale::FixTempRescale(SPARTA *sparta, int narg, char **arg) :
@@ -38,9 +43,10 @@ FixTempRescale::FixTempRescale(SPARTA *sparta, int narg, char **arg) :
   if (tstart < 0.0 || tstop < 0.0)
     error->all(FLERR,"Illegal fix temp/rescale command");
 
-  // optional keyword
+  // optional keywords
 
   aveflag = 0;
+  rotflag = vibflag = 0;
 
   int iarg = 5;
   while (iarg < narg) {
@@ -50,6 +56,18 @@ FixTempRescale::FixTempRescale(SPARTA *sparta, int narg, char **arg) :
       else if (strcmp(arg[iarg+1],"no") == 0) aveflag = 0;
       else error->all(FLERR,"Invalid fix temp/rescale command");
       iarg += 2;
+    } else if (strcmp(arg[iarg],"rot") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Invalid fix temp/rescale command");
+      if (strcmp(arg[iarg+1],"yes") == 0) rotflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) rotflag = 0;
+      else error->all(FLERR,"Invalid fix temp/rescale command");
+      iarg += 2;
+    } else if (strcmp(arg[iarg],"vib") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Invalid fix temp/rescale command");
+      if (strcmp(arg[iarg+1],"yes") == 0) vibflag = 1;
+      else if (strcmp(arg[iarg+1],"no") == 0) vibflag = 0;
+      else error->all(FLERR,"Invalid fix temp/rescale command");
+      iarg += 2;
     } else error->all(FLERR,"Invalid fix temp/rescale command");
   }
 
@@ -57,6 +75,11 @@ FixTempRescale::FixTempRescale(SPARTA *sparta, int narg, char **arg) :
 
   maxgrid = 0;
   vcom = NULL;
+
+  // per-cell list of particle indices for aveflag = 0 case
+
+  maxplist = 0;
+  plist = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -66,6 +89,7 @@ FixTempRescale::~FixTempRescale()
   if (copymode) return;
 
   memory->destroy(vcom);
+  memory->destroy(plist);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -82,6 +106,13 @@ int FixTempRescale::setmask()
 void FixTempRescale::init()
 {
   tprefactor = update->mvv2e / (3.0*update->boltz);
+  rvprefactor = 2.0*update->mvv2e / update->boltz;
+
+  // discrete vibrational energies cannot be continuously rescaled
+
+  if (vibflag && collide && collide->vibstyle == DISCRETE)
+    error->all(FLERR,
+               "Fix temp/rescale vib requires smooth or no vibrational modes");
 }
 
 /* ---------------------------------------------------------------------- */
@@ -112,9 +143,14 @@ void FixTempRescale::end_of_step()
 
 void FixTempRescale::end_of_step_no_average(double t_target)
 {
-  // loop over grid cells and twice over particles in each cell
-  // 1st pass: calc thermal temp via same logic as in ComputeThermalGrid
-  // 2nd pass: rescale thermal velocity components
+  // loop over grid cells, single walk of each cell's particle list
+  // tally pass: calc thermal temp via same logic as in ComputeThermalGrid
+  //   and store indices of cell's particles contiguously in plist
+  // rescale pass: rescale thermal velocity components of plist particles,
+  //   also rotational and vibrational energies if requested
+  // scale factors depend on tallies of the whole cell, so rescaling
+  //   cannot be folded into the walk, but it streams over plist
+  //   rather than following the next pointers a second time
 
   Particle::OnePart *particles = particle->particles;
   Particle::Species *species = particle->species;
@@ -124,27 +160,41 @@ void FixTempRescale::end_of_step_no_average(double t_target)
 
   // loop over grid cells with more than 1 particle
 
-  int ip,ispecies,count;
+  int i,ip,ispecies,count;
   double mass;
   double totmass,mvx,mvy,mvz,mvsq;
+  double erot,rotdof,evib,vibdof;
   double invtotmass,vscale;
   double vxcom,vycom,vzcom;
   double t_current;
   double *v;
 
+  double rscale = 1.0;
+  double bscale = 1.0;
+
   for (int icell = 0; icell < nglocal; icell++) {
     if (cinfo[icell].count <= 1) continue;
 
     count = cinfo[icell].count;
+    if (count > maxplist) {
+      maxplist = count + DELTA;
+      memory->destroy(plist);
+      memory->create(plist,maxplist,"temp/rescale:plist");
+    }
+
     totmass = 0.0;
     mvx = mvy = mvz = 0.0;
     mvsq = 0.0;
+    erot = rotdof = evib = vibdof = 0.0;
 
-    // 1st pass: loop over particles in cell
+    // tally pass: loop over particles in cell
     // 5 tallies per particle: Mass, mVx, mVy, mVz, mV^2
+    // plus Erot, rot DOF, Evib, vib DOF if requested
 
+    i = 0;
     ip = cinfo[icell].first;
     while (ip >= 0) {
+      plist[i++] = ip;
       ispecies = particles[ip].ispecies;
       mass = species[ispecies].mass;
       v = particles[ip].v;
@@ -155,6 +205,15 @@ void FixTempRescale::end_of_step_no_average(double t_target)
       mvz += mass*v[2];
       mvsq += mass * (v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
 
+      if (rotflag) {
+        erot += particles[ip].erot;
+        rotdof += species[ispecies].rotdof;
+      }
+      if (vibflag) {
+        evib += particles[ip].evib;
+        vibdof += species[ispecies].vibdof;
+      }
+
       ip = next[ip];
     }
 
@@ -171,23 +230,25 @@ void FixTempRescale::end_of_step_no_average(double t_target)
     t_current *= tprefactor/count;
 
     // vscale = scale factor for thermal velocity components
+    // rscale,bscale = scale factors for rotational,vibrational energies
 
     vscale = sqrt(t_target/t_current);
+    if (rotflag) rscale = t_target/t_internal(erot,rotdof,t_target);
+    if (vibflag) bscale = t_target/t_internal(evib,vibdof,t_target);
 
-    // 2nd pass: loop over particles in cell
+    // rescale pass: loop over particles in cell
     // rescale thermal velocity components
 
-    ip = cinfo[icell].first;
-    while (ip >= 0) {
-      ispecies = particles[ip].ispecies;
-      mass = species[ispecies].mass;
+    for (i = 0; i < count; i++) {
+      ip = plist[i];
       v = particles[ip].v;
 
       v[0] = vscale*(v[0]-vxcom) + vxcom;
       v[1] = vscale*(v[1]-vycom) + vycom;
       v[2] = vscale*(v[2]-vzcom) + vzcom;
 
-      ip = next[ip];
+      if (rotflag) particles[ip].erot *= rscale;
+      if (vibflag) particles[ip].evib *= bscale;
     }
   }
 }
@@ -219,11 +280,13 @@ void FixTempRescale::end_of_step_average(double t_target)
   int ip,ispecies,count;
   double mass;
   double totmass,mvx,mvy,mvz,mvsq;
+  double erot,rotdof,evib,vibdof;
   double invtotmass,t_one;
   double *v;
 
-  bigint n_current_mine = 0.0;
-  double t_current_mine = 0.0;
+  bigint n_current_mine = 0;
+  double current_mine[3],current[3];
+  current_mine[0] = current_mine[1] = current_mine[2] = 0.0;
 
   for (int icell = 0; icell < nglocal; icell++) {
     if (cells[icell].nsplit > 1) continue;
@@ -232,9 +295,11 @@ void FixTempRescale::end_of_step_average(double t_target)
     totmass = 0.0;
     mvx = mvy = mvz = 0.0;
     mvsq = 0.0;
+    erot = rotdof = evib = vibdof = 0.0;
 
     // loop over particles in cell
     // 5 tallies per particle: Mass, mVx, mVy, mVz, mV^2
+    // plus Erot, rot DOF, Evib, vib DOF if requested
 
     ip = cinfo[icell].first;
     while (ip >= 0) {
@@ -248,6 +313,15 @@ void FixTempRescale::end_of_step_average(double t_target)
       mvz += mass*v[2];
       mvsq += mass * (v[0]*v[0]+v[1]*v[1]+v[2]*v[2]);
 
+      if (rotflag) {
+        erot += particles[ip].erot;
+        rotdof += species[ispecies].rotdof;
+      }
+      if (vibflag) {
+        evib += particles[ip].evib;
+        vibdof += species[ispecies].vibdof;
+      }
+
       ip = next[ip];
     }
 
@@ -276,25 +350,30 @@ void FixTempRescale::end_of_step_average(double t_target)
     }
 
     // accumulate thermal T over my cells
+    // likewise rotational and vibrational T if requested
 
-    t_current_mine += t_one;
+    current_mine[0] += t_one;
+    if (rotflag) current_mine[1] += t_internal(erot,rotdof,t_target);
+    if (vibflag) current_mine[2] += t_internal(evib,vibdof,t_target);
     n_current_mine++;
   }
 
-  // t_current = average of cellwise thermal T across all cells
-  // n_current = total # of cells contributing to t_current
+  // current = sum of cellwise thermal, rotational, vibrational T
+  // n_current = total # of cells contributing to current
 
-  double t_current;
-  MPI_Allreduce(&t_current_mine,&t_current,1,MPI_DOUBLE,MPI_SUM,world);
+  MPI_Allreduce(current_mine,current,3,MPI_DOUBLE,MPI_SUM,world);
 
   bigint n_current;
   MPI_Allreduce(&n_current_mine,&n_current,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
 
   // t_current = cellwise averaged thermal T
   // scale all particles in all cells by vscale
+  // rscale,bscale = likewise for rotational,vibrational energies
 
-  t_current /= n_current;
+  double t_current = current[0] / n_current;
   double vscale = sqrt(t_target/t_current);
+  double rscale = t_target / (current[1]/n_current);
+  double bscale = t_target / (current[2]/n_current);
 
   // loop over grid cells to rescale velocity of particles in each
   // single-particle cells are also rescaled, their vcom = 0.0
@@ -315,11 +394,26 @@ void FixTempRescale::end_of_step_average(double t_target)
       v[1] = vscale*(v[1]-vcom[icell][1]) + vcom[icell][1];
       v[2] = vscale*(v[2]-vcom[icell][2]) + vcom[icell][2];
 
+      if (rotflag) particles[ip].erot *= rscale;
+      if (vibflag) particles[ip].evib *= bscale;
+
       ip = next[ip];
     }
   }
 }
 
+/* ----------------------------------------------------------------------
+   return rotational or vibrational T of particles in a cell
+   esum,dofsum = summed internal energy and DOF of the particles
+   return t_target if T is undefined or zero, so no rescaling is done
+------------------------------------------------------------------------- */
+
+double FixTempRescale::t_internal(double esum, double dofsum, double t_target)
+{
+  if (dofsum == 0.0 || esum == 0.0) return t_target;
+  return rvprefactor * esum/dofsum;
+}
+
 /* ----------------------------------------------------------------------
    memory usage
 ------------------------------------------------------------------------- */
@@ -328,5 +422,6 @@ double FixTempRescale::memory_usage()
 {
   double bytes = 0.0;
   bytes += maxgrid*3 * sizeof(double);    // vcom
+  bytes += maxplist * sizeof(int);        // plist
   return bytes;
 }
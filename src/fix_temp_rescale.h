@@ -37,14 +37,19 @@ class FixTempRescale : public Fix {
 
  protected:
   int aveflag;
+  int rotflag,vibflag;             // 1 if rescale erot,evib as well
   double tstart,tstop;
-  double tprefactor;
+  double tprefactor,rvprefactor;
 
   int maxgrid;
   double **vcom;
 
+  int maxplist;                    // particle indices of one cell
+  int *plist;
+
   virtual void end_of_step_no_average(double);
   virtual void end_of_step_average(double);
+  double t_internal(double, double, double);
 };
 
 }
@@ -64,4 +69,9 @@ E: Cannot open fix print file %s
 
 The output file generated by the fix print command cannot be opened
 
+E: Fix temp/rescale vib requires smooth or no vibrational modes
+
+Rescaling vibrational energies by a continuous factor is not possible
+when the collide_modify vibrate setting is discrete.
+
 */
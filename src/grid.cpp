@@ -63,6 +63,7 @@ enum{PERAUTO,PERCELL,PERSURF};                  // several files
 enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};           // several files
 enum{NCHILD,NPARENT,NUNKNOWN,NPBCHILD,NPBPARENT,NPBUNKNOWN,NBOUND};  // Update
 enum{NOWEIGHT,VOLWEIGHT,RADWEIGHT,RADONLYWEIGHT};
+enum{MARK,EDGE};                                  // set_inout() requests
 
 // corners[i][j] = J corner points of face I of a grid cell
 // works for 2d quads and 3d hexes
@@ -70,11 +71,20 @@ enum{NOWEIGHT,VOLWEIGHT,RADWEIGHT,RADONLYWEIGHT};
 int corners[6][4] = {{0,2,4,6}, {1,3,5,7}, {0,1,4,5}, {2,3,6,7},
                      {0,1,2,3}, {4,5,6,7}};
 
+int compare_edges(const void *, const void *);
+
 /* ---------------------------------------------------------------------- */
 
 Grid::Grid(SPARTA *sparta) : Pointers(sparta)
 {
   exist = exist_ghost = clumped = 0;
+  ghost_hold = 0;
+  ghost_stash = 0;
+  stashbuf = NULL;
+  stashhash = newhash = NULL;
+  nboxprev = 0;
+  boxprev = NULL;
+  changeflag = NULL;
   MPI_Comm_rank(world,&me);
 
   gnames = (char **) memory->smalloc(MAXGROUP*sizeof(char *),"grid:gnames");
@@ -129,6 +139,7 @@ Grid::Grid(SPARTA *sparta) : Pointers(sparta)
 
   cutoff = -1.0;
   cellweightflag = NOWEIGHT;
+  dtlevelflag = 0;
 
   ncustom = 0;
   ename = NULL;
@@ -152,6 +163,10 @@ Grid::Grid(SPARTA *sparta) : Pointers(sparta)
   cut2d = NULL;
   cut3d = NULL;
 
+  maxchildbin = maxchildsurf = 0;
+  childcount = childfirst = NULL;
+  childsurfs = NULL;
+
   // allocate hash for cell IDs
 
   hash = new MyHash();
@@ -183,6 +198,10 @@ Grid::~Grid()
   delete csubs;
   delete hash;
 
+  clear_stash();
+  delete [] boxprev;
+  memory->destroy(changeflag);
+
   memory->sfree(ename);
   memory->destroy(etype);
   memory->destroy(esize);
@@ -199,6 +218,10 @@ Grid::~Grid()
   memory->sfree(edarray);
   memory->destroy(edcol);
 
+  memory->destroy(childcount);
+  memory->destroy(childfirst);
+  memory->destroy(childsurfs);
+
   delete cut2d;
   delete cut3d;
 }
@@ -220,6 +243,7 @@ void Grid::remove()
   delete csubs;
 
   exist_ghost = clumped = 0;
+  dtlevelflag = 0;
   ncell = nunsplit = nsplit = nsub = 0;
   nlocal = nghost = maxlocal = maxcell = 0;
   nsplitlocal = nsplitghost = maxsplit = 0;
@@ -229,6 +253,12 @@ void Grid::remove()
   hash->clear();
   hashfilled = 0;
 
+  clear_stash();
+  delete [] boxprev;
+  boxprev = NULL;
+  memory->destroy(changeflag);
+  changeflag = NULL;
+
   cells = NULL;
   cinfo = NULL;
   sinfo = NULL;
@@ -292,6 +322,7 @@ void Grid::add_child_cell(cellint id, int level, double *lo, double *hi)
   c->csurfs = NULL;
   c->nsplit = 1;
   c->isplit = -1;
+  c->dtlevel = 0;
 
   ChildInfo *ci = &cinfo[nlocal];
   ci->count = 0;
@@ -308,12 +339,26 @@ void Grid::add_child_cell(cellint id, int level, double *lo, double *hi)
   else
     ci->volume = (hi[0]-lo[0]) * (hi[1]-lo[1]);
 
+  // track cells created by grid adaptation for update_ghosts()
+
+  if (ghost_stash) (*newhash)[id] = 0;
+
   // increment both since are adding an unsplit cell
 
   nunsplitlocal++;
   nlocal++;
 }
 
+/* ----------------------------------------------------------------------
+   insure cells and cinfo can hold N more owned cells
+   lets a caller adding many cells one at a time reallocate only once
+------------------------------------------------------------------------- */
+
+void Grid::reserve_cells(int n)
+{
+  grow_cells(n,n);
+}
+
 /* ----------------------------------------------------------------------
    add a single split cell to sinfo
    ownflag = 1/0 if split cell is owned or ghost
@@ -444,9 +489,366 @@ void Grid::remove_ghosts()
   hashfilled = 0;
   exist_ghost = 0;
   nghost = nunsplitghost = nsplitghost = nsubghost = 0;
+  memory->destroy(changeflag);
+  changeflag = NULL;
   surf->remove_ghosts();
 }
 
+/* ----------------------------------------------------------------------
+   remove ghost grid cells and surfs, but remember their counts
+   their data stays in place after owned cells and surfs
+   restore_ghosts() reinstates them, only valid if no owned cells
+     were added, deleted, or reordered in between
+   else stash_ghosts() must be called before owned cells change,
+     so update_ghosts() can reinstate the ghosts of unchanged cells
+   used by grid adaptation, which often changes no or few cells
+------------------------------------------------------------------------- */
+
+void Grid::hold_ghosts()
+{
+  ghost_hold = exist_ghost;
+  nghost_hold = nghost;
+  nunsplitghost_hold = nunsplitghost;
+  nsplitghost_hold = nsplitghost;
+  nsubghost_hold = nsubghost;
+  nsurfghost_hold = surf->nghost;
+
+  remove_ghosts();
+}
+
+/* ----------------------------------------------------------------------
+   reinstate ghost cells and surfs removed by hold_ghosts()
+   neighbor indices of owned and ghost cells are still valid,
+     so only the cell ID hash needs to be rebuilt
+   if no ghosts were held, acquire them and find neighbors from scratch
+------------------------------------------------------------------------- */
+
+void Grid::restore_ghosts()
+{
+  if (!ghost_hold) {
+    acquire_ghosts();
+    find_neighbors();
+    return;
+  }
+
+  exist_ghost = 1;
+  nghost = nghost_hold;
+  nunsplitghost = nunsplitghost_hold;
+  nsplitghost = nsplitghost_hold;
+  nsubghost = nsubghost_hold;
+  surf->nghost = nsurfghost_hold;
+  ghost_hold = 0;
+  clear_stash();
+
+  rehash();
+}
+
+/* ----------------------------------------------------------------------
+   pack ghost cells removed by hold_ghosts() so that update_ghosts()
+     can reinstate the ones whose owning cell was not changed
+   also convert neigh[] of owned and held ghost cells to cell IDs,
+     same as unset_neighbors(), so they survive owned cells changing
+   must be called before any owned cell is added, deleted, or reordered
+   no-op if already stashed or if held ghosts cannot be updated,
+     i.e. they were not acquired by acquire_ghosts_near()
+------------------------------------------------------------------------- */
+
+void Grid::stash_ghosts()
+{
+  if (ghost_stash || !ghost_hold || !boxprev) return;
+  if (update->have_mem_limit()) return;
+  if (surf->distributed || surf->implicit || ncustom) return;
+
+  int ntotal = nlocal + nghost_hold;
+
+  // no change in neigh[] needed if nflag = NUNKNOWN, NPBUNKNOWN, or NBOUND
+
+  int i,nmask,nflag;
+  cellint *neigh;
+
+  for (int icell = 0; icell < ntotal; icell++) {
+    neigh = cells[icell].neigh;
+    nmask = cells[icell].nmask;
+
+    for (i = 0; i < 6; i++) {
+      nflag = neigh_decode(nmask,i);
+      if (nflag == NCHILD || nflag == NPBCHILD)
+        neigh[i] = cells[neigh[i]].id;
+      else if (nflag == NPARENT || nflag == NPBPARENT)
+        neigh[i] = pcells[neigh[i]].id;
+    }
+  }
+
+  // pack each unsplit or split ghost cell
+  // subcells will be packed by split cell
+
+  bigint bsize = 0;
+  for (int icell = nlocal; icell < ntotal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    bsize += pack_one(icell,NULL,0,0,1,0);
+  }
+
+  if (bsize > MAXSMALLINT)
+    error->one(FLERR,"Stash ghosts buffer exceeds 2 GB");
+
+  memory->create(stashbuf,bsize,"grid:stashbuf");
+  stashhash = new MyHash();
+  newhash = new MyHash();
+
+  int offset = 0;
+  for (int icell = nlocal; icell < ntotal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    (*stashhash)[cells[icell].id] = offset;
+    offset += pack_one(icell,&stashbuf[offset],0,0,1,1);
+  }
+
+  ghost_stash = 1;
+}
+
+/* ----------------------------------------------------------------------
+   free ghost cells packed by stash_ghosts()
+------------------------------------------------------------------------- */
+
+void Grid::clear_stash()
+{
+  ghost_stash = 0;
+  memory->destroy(stashbuf);
+  delete stashhash;
+  delete newhash;
+  stashbuf = NULL;
+  stashhash = newhash = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   acquire ghost cells and find neighbors after grid adaptation
+   only cells created by adaptation or which now overlap a different
+     set of procs are communicated in full and have neighbors searched for
+   all other ghost cells are reinstated from stash_ghosts() with
+     updated owner indices, and their neighbor IDs are remapped to indices
+   changeflag is set so set_inout() only floods near new cells
+   return 0 if any proc did not stash its ghosts, caller must then
+     call acquire_ghosts() and find_neighbors()
+------------------------------------------------------------------------- */
+
+int Grid::update_ghosts()
+{
+  int allstash;
+  MPI_Allreduce(&ghost_stash,&allstash,1,MPI_INT,MPI_MIN,world);
+  if (!allstash) {
+    clear_stash();
+    return 0;
+  }
+
+  ghost_hold = 0;
+  exist_ghost = 1;
+
+  // boxall = current extended bboxes of all procs
+
+  int i,j,oflag,lastproc,isnew;
+  double bblo[3],bbhi[3];
+  double *lo,*hi;
+
+  int nboxall;
+  Box *boxall = ghost_boxes(bblo,bbhi,nboxall);
+
+  // list/listprev = current/previous boxes that overlap with my bbox,
+  //   skipping self boxes
+  // each is ordered by proc, same as in acquire_ghosts_near()
+
+  int me = comm->me;
+  int nprocs = comm->nprocs;
+
+  int nlist = 0;
+  int nlistprev = 0;
+  int *list,*listprev;
+  memory->create(list,nboxall,"grid:list");
+  memory->create(listprev,nboxprev,"grid:listprev");
+
+  for (i = 0; i < nboxall; i++) {
+    if (boxall[i].proc == me) continue;
+    if (box_overlap(bblo,bbhi,boxall[i].lo,boxall[i].hi)) list[nlist++] = i;
+  }
+  for (i = 0; i < nboxprev; i++) {
+    if (boxprev[i].proc == me) continue;
+    if (box_overlap(bblo,bbhi,boxprev[i].lo,boxprev[i].hi))
+      listprev[nlistprev++] = i;
+  }
+
+  // loop over my owned cells, not including sub cells
+  // for each other proc the cell overlaps, same as acquire_ghosts_near(),
+  //   send it in full if it is new or overlapped that proc differently
+  //   before adaptation, i.e. proc does not have it stashed as same ghost
+  // oflagprev = previous overlap of the cell with each proc
+
+  int *oflagprev;
+  memory->create(oflagprev,nprocs,"grid:oflagprev");
+  for (i = 0; i < nprocs; i++) oflagprev[i] = 0;
+
+  int nsend = 0;
+  int maxsend = 0;
+  int *proclist = NULL;
+  int *celllist = NULL;
+  int *fulllist = NULL;
+  int *oflaglist = NULL;
+
+  for (int icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    lo = cells[icell].lo;
+    hi = cells[icell].hi;
+
+    lastproc = -1;
+    for (i = 0; i < nlistprev; i++) {
+      j = listprev[i];
+      oflag = box_overlap(lo,hi,boxprev[j].lo,boxprev[j].hi);
+      if (!oflag) continue;
+      if (boxprev[j].proc == lastproc) continue;
+      lastproc = boxprev[j].proc;
+      oflagprev[lastproc] = oflag;
+    }
+
+    isnew = (newhash->find(cells[icell].id) != newhash->end());
+
+    lastproc = -1;
+    for (i = 0; i < nlist; i++) {
+      j = list[i];
+      oflag = box_overlap(lo,hi,boxall[j].lo,boxall[j].hi);
+      if (!oflag) continue;
+      if (boxall[j].proc == lastproc) continue;
+      lastproc = boxall[j].proc;
+
+      if (nsend == maxsend) {
+        maxsend += DELTA;
+        memory->grow(proclist,maxsend,"grid:proclist");
+        memory->grow(celllist,maxsend,"grid:celllist");
+        memory->grow(fulllist,maxsend,"grid:fulllist");
+        memory->grow(oflaglist,maxsend,"grid:oflaglist");
+      }
+
+      proclist[nsend] = lastproc;
+      celllist[nsend] = icell;
+      if (isnew) fulllist[nsend] = 2;
+      else if (oflag != oflagprev[lastproc]) fulllist[nsend] = 1;
+      else fulllist[nsend] = 0;
+      oflaglist[nsend] = oflag;
+      nsend++;
+    }
+
+    for (i = 0; i < nlistprev; i++) oflagprev[boxprev[listprev[i]].proc] = 0;
+  }
+
+  memory->destroy(list);
+  memory->destroy(listprev);
+  memory->destroy(oflagprev);
+
+  // create send buf and fill it
+
+  int *sizelist;
+  memory->create(sizelist,nsend,"grid:sizelist");
+
+  bigint bsendsize = 0;
+  for (i = 0; i < nsend; i++) {
+    sizelist[i] = pack_update(celllist[i],fulllist[i],oflaglist[i],NULL,0);
+    bsendsize += sizelist[i];
+  }
+
+  if (bsendsize > MAXSMALLINT)
+    error->one(FLERR,"Update ghosts send buffer exceeds 2 GB");
+  int sendsize = bsendsize;
+
+  char *sbuf;
+  memory->create(sbuf,sendsize,"grid:sbuf");
+  memset(sbuf,0,sendsize);
+
+  sendsize = 0;
+  for (i = 0; i < nsend; i++)
+    sendsize += pack_update(celllist[i],fulllist[i],oflaglist[i],
+                            &sbuf[sendsize],1);
+
+  // perform irregular communication of list of ghost cell updates
+
+  Irregular *irregular = new Irregular(sparta);
+  int recvsize;
+  int nrecv = irregular->create_data_variable(nsend,proclist,sizelist,
+                                              recvsize,comm->commsortflag);
+
+  char *rbuf;
+  memory->create(rbuf,recvsize,"grid:rbuf");
+  memset(rbuf,0,recvsize);
+
+  irregular->exchange_variable(sbuf,sizelist,rbuf);
+  delete irregular;
+
+  // unpack received updates as ghost cells
+  // first = index of first ghost cell created by each update
+
+  int *first,*full;
+  memory->create(first,nrecv+1,"grid:first");
+  memory->create(full,nrecv,"grid:full");
+
+  int offset = 0;
+  for (i = 0; i < nrecv; i++) {
+    first[i] = nlocal + nghost;
+    full[i] = ((GhostUpdate *) &rbuf[offset])->full;
+    offset += unpack_update(&rbuf[offset]);
+  }
+  first[nrecv] = nlocal + nghost;
+
+  // changeflag = 2 for my owned cells created by adaptation
+  // ghost cells and their sub cells take flag of their update
+
+  memory->create(changeflag,nlocal+nghost,"grid:changeflag");
+
+  for (int icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    if (newhash->find(cells[icell].id) != newhash->end())
+      changeflag[icell] = 2;
+    else changeflag[icell] = 0;
+  }
+  for (int icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit > 0) continue;
+    changeflag[icell] = changeflag[sinfo[cells[icell].isplit].icell];
+  }
+
+  for (i = 0; i < nrecv; i++)
+    for (int icell = first[i]; icell < first[i+1]; icell++)
+      changeflag[icell] = full[i];
+
+  // clean up
+  // current boxes are previous boxes for next update
+
+  memory->destroy(proclist);
+  memory->destroy(celllist);
+  memory->destroy(fulllist);
+  memory->destroy(oflaglist);
+  memory->destroy(sizelist);
+  memory->destroy(sbuf);
+  memory->destroy(rbuf);
+  memory->destroy(first);
+  memory->destroy(full);
+
+  clear_stash();
+  delete [] boxprev;
+  boxprev = boxall;
+  nboxprev = nboxall;
+
+  // set nempty = # of EMPTY ghost cells I store
+
+  nempty = 0;
+  for (int icell = nlocal; icell < nlocal+nghost; icell++)
+    if (cells[icell].nsurf < 0) nempty++;
+
+  // neighbors of unchanged cells are remapped, others are searched for
+  // set_inout() uses changeflag, only needed if surfs exist
+
+  find_neighbors();
+  if (!surf->exist) {
+    memory->destroy(changeflag);
+    changeflag = NULL;
+  }
+
+  return 1;
+}
+
 /* ----------------------------------------------------------------------
    acquire ghost cells from local cells of other procs
    if surfs are distributed, also acquire ghost cell surfs
@@ -457,6 +859,13 @@ void Grid::remove_ghosts()
 
 void Grid::acquire_ghosts(int surfflag)
 {
+  ghost_hold = 0;
+  clear_stash();
+  memory->destroy(changeflag);
+  changeflag = NULL;
+  delete [] boxprev;
+  boxprev = NULL;
+
   if (surf->distributed && !surf->implicit) surf->rehash();
 
   if (cutoff < 0.0) acquire_ghosts_all(surfflag);
@@ -542,77 +951,16 @@ void Grid::acquire_ghosts_near(int surfflag)
 
   exist_ghost = 1;
 
+  // boxall = extended bboxes of all procs
   // bb lo/hi = bounding box for my owned cells
 
   int i;
   double bblo[3],bbhi[3];
   double *lo,*hi;
 
-  for (i = 0; i < 3; i++) {
-    bblo[i] = BIG;
-    bbhi[i] = -BIG;
-  }
-
-  for (int icell = 0; icell < nlocal; icell++) {
-    if (cells[icell].nsplit <= 0) continue;
-    lo = cells[icell].lo;
-    hi = cells[icell].hi;
-    for (i = 0; i < 3; i++) {
-      bblo[i] = MIN(bblo[i],lo[i]);
-      bbhi[i] = MAX(bbhi[i],hi[i]);
-    }
-  }
-
-  // ebb lo/hi = bbox + grid cutoff
-  // trim to simulation box in non-periodic dims
-  // if bblo/hi is at periodic boundary and cutoff is 0.0,
-  //   add cell_epsilon to insure ghosts across periodic boundary acquired,
-  //   else may be UNKNOWN to owned cell
-
-  double *boxlo = domain->boxlo;
-  double *boxhi = domain->boxhi;
-  int *bflag = domain->bflag;
-
-  double ebblo[3],ebbhi[3];
-  for (i = 0; i < 3; i++) {
-    ebblo[i] = bblo[i] - cutoff;
-    ebbhi[i] = bbhi[i] + cutoff;
-    if (bflag[2*i] != PERIODIC) ebblo[i] = MAX(ebblo[i],boxlo[i]);
-    if (bflag[2*i] != PERIODIC) ebbhi[i] = MIN(ebbhi[i],boxhi[i]);
-    if (bflag[2*i] == PERIODIC && bblo[i] == boxlo[i] && cutoff == 0.0)
-      ebblo[i] -= cell_epsilon;
-    if (bflag[2*i] == PERIODIC && bbhi[i] == boxhi[i] && cutoff == 0.0)
-      ebbhi[i] += cell_epsilon;
-  }
-
-  // box = ebbox split across periodic BC
-  // 27 is max number of periodic images in 3d
-
-  Box box[27];
-  int nbox = box_periodic(ebblo,ebbhi,box);
-
-  // boxall = collection of boxes from all procs
-
-  int me = comm->me;
-  int nprocs = comm->nprocs;
-
   int nboxall;
-  MPI_Allreduce(&nbox,&nboxall,1,MPI_INT,MPI_SUM,world);
-
-  int *recvcounts,*displs;
-  memory->create(recvcounts,nprocs,"grid:recvcounts");
-  memory->create(displs,nprocs,"grid:displs");
-
-  int nsend = nbox*sizeof(Box);
-  MPI_Allgather(&nsend,1,MPI_INT,recvcounts,1,MPI_INT,world);
-  displs[0] = 0;
-  for (i = 1; i < nprocs; i++) displs[i] = displs[i-1] + recvcounts[i-1];
-
-  Box *boxall = new Box[nboxall];
-  MPI_Allgatherv(box,nsend,MPI_CHAR,boxall,recvcounts,displs,MPI_CHAR,world);
-
-  memory->destroy(recvcounts);
-  memory->destroy(displs);
+  Box *boxall = ghost_boxes(bblo,bbhi,nboxall);
+  int me = comm->me;
 
   // nlist = # of boxes that overlap with my bbox, skipping self boxes
   // list = indices into boxall of overlaps
@@ -636,7 +984,7 @@ void Grid::acquire_ghosts_near(int surfflag)
 
   int j,oflag,lastproc,nsurf_hold;
 
-  nsend = 0;
+  int nsend = 0;
   bigint bsendsize = 0;
 
   for (int icell = 0; icell < nlocal; icell++) {
@@ -707,9 +1055,13 @@ void Grid::acquire_ghosts_near(int surfflag)
   }
 
   // clean up
+  // keep boxall so update_ghosts() can tell which ghosts procs already have
 
   memory->destroy(list);
-  delete [] boxall;
+  if (surfflag) {
+    boxprev = boxall;
+    nboxprev = nboxall;
+  } else delete [] boxall;
 
   // perform irregular communication of list of ghost cells
 
@@ -986,6 +1338,87 @@ void Grid::acquire_ghosts_near_less_memory(int surfflag)
     if (cells[icell].nsurf < 0) nempty++;
 }
 
+/* ----------------------------------------------------------------------
+   compute bblo/bbhi = bounding box of my owned cells
+   return boxall = extended bounding boxes of all procs, ordered by proc
+     extended = bbox + grid cutoff, split across periodic boundaries
+   nboxall = # of boxes in boxall, caller must delete it
+------------------------------------------------------------------------- */
+
+Grid::Box *Grid::ghost_boxes(double *bblo, double *bbhi, int &nboxall)
+{
+  // bb lo/hi = bounding box for my owned cells
+
+  int i;
+  double *lo,*hi;
+
+  for (i = 0; i < 3; i++) {
+    bblo[i] = BIG;
+    bbhi[i] = -BIG;
+  }
+
+  for (int icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    lo = cells[icell].lo;
+    hi = cells[icell].hi;
+    for (i = 0; i < 3; i++) {
+      bblo[i] = MIN(bblo[i],lo[i]);
+      bbhi[i] = MAX(bbhi[i],hi[i]);
+    }
+  }
+
+  // ebb lo/hi = bbox + grid cutoff
+  // trim to simulation box in non-periodic dims
+  // if bblo/hi is at periodic boundary and cutoff is 0.0,
+  //   add cell_epsilon to insure ghosts across periodic boundary acquired,
+  //   else may be UNKNOWN to owned cell
+
+  double *boxlo = domain->boxlo;
+  double *boxhi = domain->boxhi;
+  int *bflag = domain->bflag;
+
+  double ebblo[3],ebbhi[3];
+  for (i = 0; i < 3; i++) {
+    ebblo[i] = bblo[i] - cutoff;
+    ebbhi[i] = bbhi[i] + cutoff;
+    if (bflag[2*i] != PERIODIC) ebblo[i] = MAX(ebblo[i],boxlo[i]);
+    if (bflag[2*i] != PERIODIC) ebbhi[i] = MIN(ebbhi[i],boxhi[i]);
+    if (bflag[2*i] == PERIODIC && bblo[i] == boxlo[i] && cutoff == 0.0)
+      ebblo[i] -= cell_epsilon;
+    if (bflag[2*i] == PERIODIC && bbhi[i] == boxhi[i] && cutoff == 0.0)
+      ebbhi[i] += cell_epsilon;
+  }
+
+  // box = ebbox split across periodic BC
+  // 27 is max number of periodic images in 3d
+
+  Box box[27];
+  int nbox = box_periodic(ebblo,ebbhi,box);
+
+  // boxall = collection of boxes from all procs
+
+  int nprocs = comm->nprocs;
+
+  MPI_Allreduce(&nbox,&nboxall,1,MPI_INT,MPI_SUM,world);
+
+  int *recvcounts,*displs;
+  memory->create(recvcounts,nprocs,"grid:recvcounts");
+  memory->create(displs,nprocs,"grid:displs");
+
+  int nsend = nbox*sizeof(Box);
+  MPI_Allgather(&nsend,1,MPI_INT,recvcounts,1,MPI_INT,world);
+  displs[0] = 0;
+  for (i = 1; i < nprocs; i++) displs[i] = displs[i-1] + recvcounts[i-1];
+
+  Box *boxall = new Box[nboxall];
+  MPI_Allgatherv(box,nsend,MPI_CHAR,boxall,recvcounts,displs,MPI_CHAR,world);
+
+  memory->destroy(recvcounts);
+  memory->destroy(displs);
+
+  return boxall;
+}
+
 /* ----------------------------------------------------------------------
    check for overlap of 2 orthongal boxes, alo/ahi and blo/bhi
    if no overlap, return 0
@@ -1094,181 +1527,233 @@ void Grid::rehash()
   // key = ID, value = index for child cells
   // skip sub cells
 
-  hash->clear();
+  hash->clear();
+
+  for (int icell = 0; icell < nlocal+nghost; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    (*hash)[cells[icell].id] = icell;
+  }
+
+  hashfilled = 1;
+}
+
+/* ----------------------------------------------------------------------
+   find and set neighbor indices for all owned and ghost cells
+   if changeflag is set by update_ghosts(), only search for neighbors
+     of changed cells and cells with a changed neighbor,
+     remap neighbor IDs of other cells to indices
+   when done, hash table is valid for all owned and ghost cells
+   no-op if ghosts don't exist
+------------------------------------------------------------------------- */
+
+void Grid::find_neighbors()
+{
+  int icell;
+
+  if (!exist_ghost) return;
+
+  // insure cell IDs (owned + ghost) are hashed
+
+  rehash();
+
+  // clear parent cells data structure since will (re)build it here
+
+  nparent = 0;
+
+  // set neigh flags and nmask for each owned and ghost child cell
+  // skip sub cells, loop below copies their info from original split cell
+
+  int nunknown = 0;
+
+  for (icell = 0; icell < nlocal+nghost; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    if (changeflag && !changeflag[icell])
+      nunknown += remap_neighbors_one(icell);
+    else nunknown += find_neighbors_one(icell);
+  }
+
+  // for sub cells, copy neighbor info from original split cell
+
+  int m,splitcell;
+
+  for (icell = 0; icell < nlocal+nghost; icell++) {
+    if (cells[icell].nsplit >= 1) continue;
+    splitcell = sinfo[cells[icell].isplit].icell;
+    for (m = 0; m < 6; m++)
+      cells[icell].neigh[m] = cells[splitcell].neigh[m];
+    cells[icell].nmask = cells[splitcell].nmask;
+  }
+
+  // error if any UNKNOWN neighbors for an owned cell
+  // cannot move particle to new proc to continue move
 
-  for (int icell = 0; icell < nlocal+nghost; icell++) {
-    if (cells[icell].nsplit <= 0) continue;
-    (*hash)[cells[icell].id] = icell;
-  }
+  int nall;
+  MPI_Allreduce(&nunknown,&nall,1,MPI_INT,MPI_SUM,world);
 
-  hashfilled = 1;
+  if (nall) {
+    char str[128];
+    sprintf(str,"Owned cells with unknown neighbors = %d",nall);
+    error->all(FLERR,str);
+  }
 }
 
 /* ----------------------------------------------------------------------
-   find and set neighbor indices for all owned and ghost cells
-   when done, hash table is valid for all owned and ghost cells
-   no-op if ghosts don't exist
+   set neigh[] and nmask for one owned or ghost child cell
+   search hash for a same level, finer, or coarser neighbor across each face
+   new PARENT neighbors are appended to pcells
+   return 1 if an owned cell has an UNKNOWN neighbor, else 0
 ------------------------------------------------------------------------- */
 
-void Grid::find_neighbors()
+int Grid::find_neighbors_one(int icell)
 {
-  int icell,idim,iface,ilevel,level,nmask,boundary,periodic;
+  int idim,iface,ilevel,level,nmask,boundary,periodic;
   int found,face_touching,unknownflag;
   cellint id,neighID,refineID,coarsenID;
   cellint *neigh;
   double *lo,*hi;
 
-  if (!exist_ghost) return;
-
   int dimension = domain->dimension;
   int *bflag = domain->bflag;
   double *boxlo = domain->boxlo;
   double *boxhi = domain->boxhi;
 
-  // insure cell IDs (owned + ghost) are hashed
+  id = cells[icell].id;
+  level = cells[icell].level;
+  lo = cells[icell].lo;
+  hi = cells[icell].hi;
+  neigh = cells[icell].neigh;
+  nmask = 0;
+  unknownflag = 0;
 
-  rehash();
+  for (iface = 0; iface < 6; iface++) {
+    idim = iface/2;
 
-  // clear parent cells data structure since will (re)build it here
+    // set boundary and periodic flags for this face
+    // treat 2d Z boundaries as non-periodic
 
-  nparent = 0;
+    if (iface % 2 == 0 && lo[idim] == boxlo[idim]) boundary = 1;
+    else if (iface % 2 == 1 && hi[idim] == boxhi[idim]) boundary = 1;
+    else boundary = 0;
+    if (bflag[iface] == PERIODIC) periodic = 1;
+    else periodic = 0;
+    if (dimension == 2 && (iface == ZLO || iface == ZHI))
+      periodic = 0;
 
-  // set neigh flags and nmask for each owned and ghost child cell
-  // skip sub cells, loop below copies their info from original split cell
+    // face = non-periodic boundary, neighbor is BOUND
 
-  int nunknown = 0;
+    if (boundary && !periodic) {
+      neigh[iface] = 0;
+      nmask = neigh_encode(NBOUND,nmask,iface);
+      continue;
+    }
 
-  for (icell = 0; icell < nlocal+nghost; icell++) {
-    if (cells[icell].nsplit <= 0) continue;
+    // neighID = ID of neighbor cell at same level as icell
 
-    id = cells[icell].id;
-    level = cells[icell].level;
-    lo = cells[icell].lo;
-    hi = cells[icell].hi;
-    neigh = cells[icell].neigh;
-    nmask = 0;
-    unknownflag = 0;
+    neighID = id_neigh_same_parent(id,level,iface);
+    if (neighID == 0) neighID = id_neigh_same_level(id,level,iface);
 
-    for (iface = 0; iface < 6; iface++) {
-      idim = iface/2;
+    // if in hash, neighbor is CHILD
 
-      // set boundary and periodic flags for this face
-      // treat 2d Z boundaries as non-periodic
+    if (hash->find(neighID) != hash->end()) {
+      neigh[iface] = (*hash)[neighID];
+      if (!boundary) nmask = neigh_encode(NCHILD,nmask,iface);
+      else nmask = neigh_encode(NPBCHILD,nmask,iface);
+      continue;
+    }
 
-      if (iface % 2 == 0 && lo[idim] == boxlo[idim]) boundary = 1;
-      else if (iface % 2 == 1 && hi[idim] == boxhi[idim]) boundary = 1;
-      else boundary = 0;
-      if (bflag[iface] == PERIODIC) periodic = 1;
-      else periodic = 0;
-      if (dimension == 2 && (iface == ZLO || iface == ZHI))
-        periodic = 0;
+    // refine from neighID until reach maxlevel
+    // look for a child cell on touching face I do own (or ghost)
+    // if find one, neighbor is PARENT, add its ID and lo/hi to local pcells
 
-      // face = non-periodic boundary, neighbor is BOUND
+    face_touching = iface % 2 ? iface-1 : iface+1;
+    refineID = neighID;
+    ilevel = level;
+    found = 0;
 
-      if (boundary && !periodic) {
-        neigh[iface] = 0;
-        nmask = neigh_encode(NBOUND,nmask,iface);
-        continue;
-      }
+    while (ilevel < maxlevel) {
+      refineID = id_refine(refineID,ilevel,face_touching);
+      if (hash->find(refineID) != hash->end()) {
+        neigh[iface] = nparent;
+        if (!boundary) nmask = neigh_encode(NPARENT,nmask,iface);
+        else nmask = neigh_encode(NPBPARENT,nmask,iface);
 
-      // neighID = ID of neighbor cell at same level as icell
+        if (nparent == maxparent) grow_pcells();
+        pcells[nparent].id = neighID;
+        id_lohi(neighID,level,boxlo,boxhi,pcells[nparent].lo,pcells[nparent].hi);
+        nparent++;
+
+        found = 1;
+        break;
+      } else ilevel++;
+    }
+    if (found) continue;
 
-      neighID = id_neigh_same_parent(id,level,iface);
-      if (neighID == 0) neighID = id_neigh_same_level(id,level,iface);
+    // coarsen from neighID until reach top level
+    // if find one, neighbor is CHILD
 
-      // if in hash, neighbor is CHILD
+    coarsenID = neighID;
+    ilevel = level;
+    found = 0;
 
-      if (hash->find(neighID) != hash->end()) {
-        neigh[iface] = (*hash)[neighID];
+    while (ilevel > 1) {
+      coarsenID = id_coarsen(coarsenID,ilevel);
+      if (hash->find(coarsenID) != hash->end()) {
+        neigh[iface] = (*hash)[coarsenID];
         if (!boundary) nmask = neigh_encode(NCHILD,nmask,iface);
         else nmask = neigh_encode(NPBCHILD,nmask,iface);
-        continue;
-      }
-
-      // refine from neighID until reach maxlevel
-      // look for a child cell on touching face I do own (or ghost)
-      // if find one, neighbor is PARENT, add its ID and lo/hi to local pcells
-
-      face_touching = iface % 2 ? iface-1 : iface+1;
-      refineID = neighID;
-      ilevel = level;
-      found = 0;
-
-      while (ilevel < maxlevel) {
-        refineID = id_refine(refineID,ilevel,face_touching);
-        if (hash->find(refineID) != hash->end()) {
-          neigh[iface] = nparent;
-          if (!boundary) nmask = neigh_encode(NPARENT,nmask,iface);
-          else nmask = neigh_encode(NPBPARENT,nmask,iface);
-
-          if (nparent == maxparent) grow_pcells();
-          pcells[nparent].id = neighID;
-          id_lohi(neighID,level,boxlo,boxhi,pcells[nparent].lo,pcells[nparent].hi);
-          nparent++;
-
-          found = 1;
-          break;
-        } else ilevel++;
-      }
-      if (found) continue;
-
-      // coarsen from neighID until reach top level
-      // if find one, neighbor is CHILD
-
-      coarsenID = neighID;
-      ilevel = level;
-      found = 0;
-
-      while (ilevel > 1) {
-        coarsenID = id_coarsen(coarsenID,ilevel);
-        if (hash->find(coarsenID) != hash->end()) {
-          neigh[iface] = (*hash)[coarsenID];
-          if (!boundary) nmask = neigh_encode(NCHILD,nmask,iface);
-          else nmask = neigh_encode(NPBCHILD,nmask,iface);
-          found = 1;
-          break;
-        } else ilevel--;
-      }
-      if (found) continue;
-
-      // found nothing, so UNKNOWN neighbor
-      // should never happend for an owned cell (error check below)
-      // can happen for a ghost cell
+        found = 1;
+        break;
+      } else ilevel--;
+    }
+    if (found) continue;
 
-      neigh[iface] = 0;
-      if (!boundary) nmask = neigh_encode(NUNKNOWN,nmask,iface);
-      else nmask = neigh_encode(NPBUNKNOWN,nmask,iface);
+    // found nothing, so UNKNOWN neighbor
+    // should never happend for an owned cell (error check in caller)
+    // can happen for a ghost cell
 
-      if (icell < nlocal) unknownflag = 1;
-    }
+    neigh[iface] = 0;
+    if (!boundary) nmask = neigh_encode(NUNKNOWN,nmask,iface);
+    else nmask = neigh_encode(NPBUNKNOWN,nmask,iface);
 
-    cells[icell].nmask = nmask;
-    if (unknownflag) nunknown++;
+    if (icell < nlocal) unknownflag = 1;
   }
 
-  // for sub cells, copy neighbor info from original split cell
+  cells[icell].nmask = nmask;
+  return unknownflag;
+}
 
-  int m,splitcell;
+/* ----------------------------------------------------------------------
+   reset neigh[] of one unchanged owned or ghost child cell
+   neigh[] currently stores cell IDs, set by stash_ghosts()
+   if every face is a boundary or a CHILD neighbor that still exists,
+     convert IDs to local indices, nmask is unchanged
+   otherwise a neighbor was refined, coarsened, or is a parent or unknown
+     cell, so search for all neighbors of the cell
+   return 1 if an owned cell has an UNKNOWN neighbor, else 0
+------------------------------------------------------------------------- */
 
-  for (icell = 0; icell < nlocal+nghost; icell++) {
-    if (cells[icell].nsplit >= 1) continue;
-    splitcell = sinfo[cells[icell].isplit].icell;
-    for (m = 0; m < 6; m++)
-      cells[icell].neigh[m] = cells[splitcell].neigh[m];
-    cells[icell].nmask = cells[splitcell].nmask;
+int Grid::remap_neighbors_one(int icell)
+{
+  int i,nflag;
+
+  cellint *neigh = cells[icell].neigh;
+  int nmask = cells[icell].nmask;
+
+  for (i = 0; i < 6; i++) {
+    nflag = neigh_decode(nmask,i);
+    if (nflag == NBOUND) continue;
+    if (nflag != NCHILD && nflag != NPBCHILD)
+      return find_neighbors_one(icell);
+    if (hash->find(neigh[i]) == hash->end())
+      return find_neighbors_one(icell);
   }
 
-  // error if any UNKNOWN neighbors for an owned cell
-  // cannot move particle to new proc to continue move
-
-  int nall;
-  MPI_Allreduce(&nunknown,&nall,1,MPI_INT,MPI_SUM,world);
-
-  if (nall) {
-    char str[128];
-    sprintf(str,"Owned cells with unknown neighbors = %d",nall);
-    error->all(FLERR,str);
+  for (i = 0; i < 6; i++) {
+    nflag = neigh_decode(nmask,i);
+    if (nflag == NCHILD || nflag == NPBCHILD) neigh[i] = (*hash)[neigh[i]];
   }
+
+  return 0;
 }
 
 /* ----------------------------------------------------------------------
@@ -1389,20 +1874,22 @@ void Grid::reset_neighbors()
      may just be flagged as warning in type_check(),
      but it means a non-zero volume for a cell that
        is effectively OUTSIDE will not be set correctly
+   algorithm uses a fixed # of comm rounds, regardless of domain size:
+     flood fill on-proc from OVERLAP cells
+     group remaining UNKNOWN cells on each proc into connected components
+     one irregular comm of marks and component connections across procs
+     reduce global graph of components on every proc via one allgather
+     one irregular comm of marks by newly marked cells
 ------------------------------------------------------------------------- */
 
 void Grid::set_inout()
 {
-  int i,j,m,icell,jcell,itype,jtype,marktype;
-  int nflag,iface,icorner,ctype,ic;
-  int iset,nset,nsetnew;
-  int nsend,maxsend,nrecv,maxrecv;
-  int *set,*setnew,*jcorner;
+  int i,j,m,icell,jcell,itype,marktype,flag;
+  int iface,ctype,nneigh,root,jroot;
+  int iset,nset,nsetnew,nrecv;
+  int *set,*setnew;
   int *cflags;
-  int *proclist;
-  double xcorner[3];
-  ParentCell *pcell;
-  Connect *sbuf,*rbuf;
+  int jlist[4];
 
   if (!exist_ghost)
     error->all(FLERR,"Cannot mark grid cells as inside/outside surfs because "
@@ -1412,328 +1899,313 @@ void Grid::set_inout()
 
   if (surf->all_transparent()) {
     for (icell = 0; icell < nlocal; icell++) cinfo[icell].type = OUTSIDE;
+    memory->destroy(changeflag);
+    changeflag = NULL;
     return;
   }
 
   // set dimensional dependent quantities
 
-  int faceflip[6] = {XHI,XLO,YHI,YLO,ZHI,ZLO};
-
   int me = comm->me;
   int dimension = domain->dimension;
-  int ncorner,nface,nface_pts;
+  int nface,nface_pts;
   if (dimension == 3) {
-    ncorner = 8;
     nface = 6;
     nface_pts = 4;
   } else {
-    ncorner = 4;
     nface = 4;
     nface_pts = 2;
   }
 
-  // create irregular communicator for exchanging off-processor cell types
+  // create irregular communicator for exchanging off-processor cell info
 
   Irregular *irregular = new Irregular(sparta);
 
   // create set1 and set2 lists so can swap between them
 
   int *set1,*set2;
-  memory->create(set1,nlocal*nface,"grid:set1");
-  memory->create(set2,nlocal*nface,"grid:set2");
+  memory->create(set1,nlocal,"grid:set1");
+  memory->create(set2,nlocal,"grid:set2");
+
+  nsend_inout = maxsend_inout = 0;
+  proc_inout = NULL;
+  sbuf_inout = NULL;
 
-  // initial set list = overlapped cells with corner values which are set
+  // (1) flood fill my cells from OVERLAP cells with corner values which are set
+  // for unmarked neighbor cells I own, mark them and add to new set list
+  // for neighbor cells I would mark but don't own, add MARK to comm list
+  // if changeflag is set by update_ghosts(), only unchanged cells are marked,
+  //   so only flood from OVERLAP cells which are new or have a new neighbor
 
-  nset = nsetnew = 0;
+  nset = 0;
   set = set1;
   setnew = set2;
 
   for (icell = 0; icell < nlocal; icell++) {
     if (cells[icell].nsplit <= 0) continue;
-    if (cinfo[icell].type == OVERLAP && cinfo[icell].corner[0] != UNKNOWN)
-      set[nset++] = icell;
+    if (cinfo[icell].type != OVERLAP || cinfo[icell].corner[0] == UNKNOWN)
+      continue;
+    if (changeflag && !inout_changed(icell)) continue;
+    set[nset++] = icell;
   }
 
-  // loop until no more cell types are set
-
-  maxsend = maxrecv = 0;
-  proclist = NULL;
-  sbuf = rbuf = NULL;
-
-  while (1) {
-    nsend = 0;
+  while (nset) {
+    nsetnew = 0;
+    for (iset = 0; iset < nset; iset++) {
+      icell = set[iset];
+      itype = cinfo[icell].type;
+      cflags = cinfo[icell].corner;
+
+      // loop over my cell's faces
+
+      for (iface = 0; iface < nface; iface++) {
+
+        // if I am an OUTSIDE/INSIDE cell: marktype = my itype
+        // if I am an OVERLAP cell:
+        //   can only mark neighbor if all corner pts on face are same
+        //   marktype = value of those corner pts = OUTSIDE or INSIDE
+
+        if (itype != OVERLAP) marktype = itype;
+        else {
+          ctype = cflags[corners[iface][0]];
+          for (m = 1; m < nface_pts; m++)
+            if (cflags[corners[iface][m]] != ctype) break;
+          if (m < nface_pts) continue;
+          if (ctype == OUTSIDE) marktype = OUTSIDE;
+          else if (ctype == INSIDE) marktype = INSIDE;
+          else continue;
+        }
 
-    // process local set list
-    // for unmarked neighbor cells I own, mark them and add to new set list
-    // for neighbor cells I would mark but don't own, add to comm list
-
-    while (nset) {
-      nsetnew = 0;
-      for (iset = 0; iset < nset; iset++) {
-        icell = set[iset];
-        itype = cinfo[icell].type;
-        cflags = cinfo[icell].corner;
-
-        // loop over my cell's faces
-
-        for (iface = 0; iface < nface; iface++) {
-
-          // if I am an OUTSIDE/INSIDE cell: marktype = my itype
-          // if I am an OVERLAP cell:
-          //   can only mark neighbor if all corner pts on face are same
-          //   marktype = value of those corner pts = OUTSIDE or INSIDE
-
-          if (itype != OVERLAP) marktype = itype;
-          else {
-            ctype = cflags[corners[iface][0]];
-            for (m = 1; m < nface_pts; m++)
-              if (cflags[corners[iface][m]] != ctype) break;
-            if (m < nface_pts) continue;
-            if (ctype == OUTSIDE) marktype = OUTSIDE;
-            else if (ctype == INSIDE) marktype = INSIDE;
-            else continue;
-          }
-
-          jcell = cells[icell].neigh[iface];
-          nflag = neigh_decode(cells[icell].nmask,iface);
-
-          if (nflag == NCHILD || nflag == NPBCHILD) {
-
-            // this proc owns neighbor cell
-            // perform this marking logic (here and below):
-            // (1) if jtype = UNKNOWN:
-            //     set jtype = marktype = OUTSIDE/INSIDE
-            //     add jcell to new set
-            // (2) else if jtype = OVERLAP:
-            //     skip if jcell's corners are already marked
-            //     set jcell corner pts = marktype = OUTSIDE/INSIDE
-            //     also set its volume to full cell or zero
-            //     do not add jcell to new set, since is OVERLAP cell
-            //       maybe could add, but not sure need to,
-            //       and could be marked wrong ?
-            // (3) else jcell = OUTSIDE/INSIDE:
-            //     if jcell mark is different than marktype,
-            //     error b/c markings are inconsistent
-
-            if (cells[jcell].proc == me) {
-              jtype = cinfo[jcell].type;
-
-              if (jtype == UNKNOWN) {
-                cinfo[jcell].type = marktype;
-                setnew[nsetnew++] = jcell;
-              } else if (jtype == OVERLAP) {
-                // don't think this restriction needed (Mar 2017)
-                //if (itype == OVERLAP) continue;
-                jcorner = cinfo[jcell].corner;
-                if (jcorner[0] != UNKNOWN) continue;
-                for (icorner = 0; icorner < ncorner; icorner++)
-                  jcorner[icorner] = marktype;
-                if (marktype == INSIDE) cinfo[jcell].volume = 0.0;
-                else if (marktype == OUTSIDE) {
-                  double *lo = cells[jcell].lo;
-                  double *hi = cells[jcell].hi;
-                  if (dimension == 3)
-                    cinfo[jcell].volume =
-                      (hi[0]-lo[0]) * (hi[1]-lo[1]) * (hi[2]-lo[2]);
-                  else if (domain->axisymmetric)
-                    cinfo[jcell].volume =
-                      MY_PI * (hi[1]*hi[1]-lo[1]*lo[1]) * (hi[0]-lo[0]);
-                  else
-                    cinfo[jcell].volume = (hi[0]-lo[0]) * (hi[1]-lo[1]);
-                }
-                // do not add to setnew, see comment above
-                //setnew[nsetnew++] = jcell;
-              } else {
-                if (jtype != marktype) {
-                  printf("CELL1 proc %d icell %d id " CELLINT_FORMAT " iface %d "
-                         "jcell %d id " CELLINT_FORMAT " marktype %d jtype %d\n",
-                         me,icell,cells[icell].id,iface,jcell,cells[jcell].id,
-                         marktype,jtype);
-                  error->one(FLERR,"Cell type mis-match when marking on self");
-                }
-              }
-
-            // this proc does not own neighbor cell
-            // pack sbuf with info to send
-
-            } else {
-              if (nsend == maxsend) {
-                maxsend += DELTA;
-                memory->grow(proclist,maxsend,"grid:proclist");
-                sbuf = (Connect *)
-                  memory->srealloc(sbuf,maxsend*sizeof(Connect),"grid:sbuf");
-              }
-              proclist[nsend] = cells[jcell].proc;
-              sbuf[nsend].itype = itype;
-              sbuf[nsend].marktype = marktype;
-              sbuf[nsend].jcell = cells[jcell].ilocal;
-              nsend++;
-            }
-
-          } else if (nflag == NPARENT || nflag == NPBPARENT) {
-
-            // neighbor is a parent cell, not a child cell
-            // for each corner points of icell face:
-            //   find jcell = child cell owner of the face corner pt
-            //   if I own the child cell, mark it in same manner as above
-
-            pcell = &pcells[jcell];
-            for (m = 0; m < nface_pts; m++) {
-              ic = corners[iface][m];
-              if (ic % 2) xcorner[0] = cells[icell].hi[0];
-              else xcorner[0] = cells[icell].lo[0];
-              if ((ic/2) % 2) xcorner[1] = cells[icell].hi[1];
-              else xcorner[1] = cells[icell].lo[1];
-              if (ic/4) xcorner[2] = cells[icell].hi[2];
-              else xcorner[2] = cells[icell].lo[2];
-
-              if (nflag == NPBPARENT)
-                domain->uncollide(faceflip[iface],xcorner);
-
-              jcell = id_find_child(pcell->id,cells[icell].level,
-                                    pcell->lo,pcell->hi,xcorner);
-              if (jcell < 0) error->one(FLERR,"Parent cell child missing");
-
-              // this proc owns neighbor cell
-              // perform same marking logic as above
-
-              if (cells[jcell].proc == me) {
-                jtype = cinfo[jcell].type;
-
-                if (jtype == UNKNOWN) {
-                  cinfo[jcell].type = marktype;
-                  setnew[nsetnew++] = jcell;
-                } else if (jtype == OVERLAP) {
-                  // don't think this restriction needed (Mar 2017)
-                  //if (itype == OVERLAP) continue;
-                  jcorner = cinfo[jcell].corner;
-                  if (jcorner[0] != UNKNOWN) continue;
-                  for (icorner = 0; icorner < ncorner; icorner++)
-                    jcorner[icorner] = marktype;
-                  if (marktype == INSIDE) cinfo[jcell].volume = 0.0;
-                  else if (marktype == OUTSIDE) {
-                    double *lo = cells[jcell].lo;
-                    double *hi = cells[jcell].hi;
-                    if (dimension == 3)
-                      cinfo[jcell].volume =
-                        (hi[0]-lo[0]) * (hi[1]-lo[1]) * (hi[2]-lo[2]);
-                    else if (domain->axisymmetric)
-                      cinfo[jcell].volume =
-                        MY_PI * (hi[1]*hi[1]-lo[1]*lo[1]) * (hi[0]-lo[0]);
-                    else
-                      cinfo[jcell].volume = (hi[0]-lo[0]) * (hi[1]-lo[1]);
-                  }
-                  // do not add to setnew, see comment above
-                  //setnew[nsetnew++] = jcell;
-                } else {
-                  if (jtype != marktype) {
-                    printf("CELL2 proc %d icell %d id " CELLINT_FORMAT
-                           " iface %d "
-                           "jcell %d id " CELLINT_FORMAT " marktype %d "
-                           "jtype %d\n",
-                           me,icell,cells[icell].id,iface,jcell,cells[jcell].id,
-                           marktype,jtype);
-                    error->one(FLERR,
-                               "Cell type mis-match when marking on self");
-                  }
-                }
-
-              // this proc does not own neighbor cell
-              // pack sbuf with info to send
-
-              } else {
-                if (nsend == maxsend) {
-                  maxsend += DELTA;
-                  memory->grow(proclist,maxsend,"grid:proclist");
-                  sbuf = (Connect *)
-                    memory->srealloc(sbuf,maxsend*sizeof(Connect),"grid:sbuf");
-                }
-                proclist[nsend] = cells[jcell].proc;
-                sbuf[nsend].itype = itype;
-                sbuf[nsend].marktype = marktype;
-                sbuf[nsend].jcell = cells[jcell].ilocal;
-                nsend++;
-              }
-            }
-          } else continue;
+        nneigh = inout_neighbors(icell,iface,jlist);
+
+        for (j = 0; j < nneigh; j++) {
+          jcell = jlist[j];
+          if (cells[jcell].proc == me) {
+            flag = mark_inout(jcell,marktype);
+            if (flag < 0)
+              error->one(FLERR,"Cell type mis-match when marking on self");
+            if (flag) setnew[nsetnew++] = jcell;
+          } else send_inout(cells[jcell].proc,MARK,marktype,
+                            cells[jcell].ilocal,0);
         }
       }
+    }
+
+    // swap set lists
+
+    nset = nsetnew;
+    if (set == set1) {
+      set = set2;
+      setnew = set1;
+    } else {
+      set = set1;
+      setnew = set2;
+    }
+  }
+
+  // (2) group my cells which are still UNKNOWN into connected components
+  // union-find over faces shared by two UNKNOWN cells I own
+  // cellcomp = component of each cell, -1 if not UNKNOWN
+  // component IDs are global, offset by # of components on lower procs
 
-      // swap set lists
+  int *cellcomp;
+  memory->create(cellcomp,nlocal,"grid:cellcomp");
 
-      nset = nsetnew;
-      if (set == set1) {
-        set = set2;
-        setnew = set1;
-      } else {
-        set = set1;
-        setnew = set2;
+  for (icell = 0; icell < nlocal; icell++) {
+    if (cells[icell].nsplit > 0 && cinfo[icell].type == UNKNOWN)
+      cellcomp[icell] = icell;
+    else cellcomp[icell] = -1;
+  }
+
+  for (icell = 0; icell < nlocal; icell++) {
+    if (cellcomp[icell] < 0) continue;
+    for (iface = 0; iface < nface; iface++) {
+      nneigh = inout_neighbors(icell,iface,jlist);
+      for (j = 0; j < nneigh; j++) {
+        jcell = jlist[j];
+        if (cells[jcell].proc != me || cellcomp[jcell] < 0) continue;
+        root = find_inout(cellcomp,icell);
+        jroot = find_inout(cellcomp,jcell);
+        if (root < jroot) cellcomp[jroot] = root;
+        else if (jroot < root) cellcomp[root] = jroot;
       }
     }
+  }
+
+  // number the components 0 to ncomp-1 via their root cell
+  // set1 = component of each root cell, set2 = component of each cell
+
+  int ncomp = 0;
+  for (icell = 0; icell < nlocal; icell++)
+    if (cellcomp[icell] == icell) set1[icell] = ncomp++;
 
-    // if no proc has info to communicate, then done iterating
+  for (icell = 0; icell < nlocal; icell++)
+    if (cellcomp[icell] >= 0) set2[icell] = set1[find_inout(cellcomp,icell)];
+  for (icell = 0; icell < nlocal; icell++)
+    if (cellcomp[icell] >= 0) cellcomp[icell] = set2[icell];
 
-    int anysend;
-    MPI_Allreduce(&nsend,&anysend,1,MPI_INT,MPI_MAX,world);
-    if (!anysend) break;
+  bigint bcomp = ncomp;
+  bigint compoffset;
+  MPI_Scan(&bcomp,&compoffset,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  compoffset -= bcomp;
 
-    // perform irregular comm of each proc's comm list
-    // realloc rbuf as needed
+  // for neighbor cells of my components which I don't own,
+  //   add EDGE to comm list, so owner can connect the two components
 
-    nrecv = irregular->create_data_uniform(nsend,proclist,comm->commsortflag);
-    if (nrecv > maxrecv) {
-      memory->sfree(rbuf);
-      maxrecv = nrecv;
-      rbuf = (Connect *) memory->smalloc(maxrecv*sizeof(Connect),"grid:rbuf");
+  for (icell = 0; icell < nlocal; icell++) {
+    if (cellcomp[icell] < 0) continue;
+    for (iface = 0; iface < nface; iface++) {
+      nneigh = inout_neighbors(icell,iface,jlist);
+      for (j = 0; j < nneigh; j++) {
+        jcell = jlist[j];
+        if (cells[jcell].proc == me) continue;
+        send_inout(cells[jcell].proc,EDGE,UNKNOWN,cells[jcell].ilocal,
+                   compoffset + cellcomp[icell]);
+      }
     }
+  }
+
+  // (3) single irregular comm of all MARK and EDGE requests
+  // MARK of a cell in one of my components sets the component type
+  // MARK of any other cell performs same marking logic as above
+  // EDGE of a cell in one of my components adds a component graph edge
 
-    irregular->exchange_uniform((char *) sbuf,sizeof(Connect),(char *) rbuf);
+  int *comptype;
+  memory->create(comptype,ncomp,"grid:comptype");
+  for (i = 0; i < ncomp; i++) comptype[i] = UNKNOWN;
 
-    // this proc received info to mark neighbor cell it owns
-    // perform same marking logic as above
+  InOut *rbuf;
+  nrecv = irregular->create_data_uniform(nsend_inout,proc_inout,
+                                         comm->commsortflag);
+  rbuf = (InOut *) memory->smalloc((bigint) nrecv*sizeof(InOut),"grid:rbuf");
+  irregular->exchange_uniform((char *) sbuf_inout,sizeof(InOut),(char *) rbuf);
 
-    for (i = 0; i < nrecv; i++) {
-      itype = rbuf[i].itype;
+  int nedge = 0;
+  bigint *edges;
+  memory->create(edges,2*nrecv,"grid:edges");
+
+  for (i = 0; i < nrecv; i++) {
+    jcell = rbuf[i].jcell;
+    if (rbuf[i].flag == MARK) {
       marktype = rbuf[i].marktype;
-      jcell = rbuf[i].jcell;
-      jtype = cinfo[jcell].type;
-
-      if (jtype == UNKNOWN) {
-        cinfo[jcell].type = marktype;
-        set[nset++] = jcell;
-      } else if (jtype == OVERLAP) {
-        // don't think this restriction needed (Mar 2017)
-        //if (itype == OVERLAP) continue;
-        jcorner = cinfo[jcell].corner;
-        if (jcorner[0] != UNKNOWN) continue;
-        for (icorner = 0; icorner < ncorner; icorner++)
-          jcorner[icorner] = marktype;
-        if (marktype == INSIDE) cinfo[jcell].volume = 0.0;
-        else if (marktype == OUTSIDE) {
-          double *lo = cells[jcell].lo;
-          double *hi = cells[jcell].hi;
-          if (dimension == 3)
-            cinfo[jcell].volume =
-              (hi[0]-lo[0]) * (hi[1]-lo[1]) * (hi[2]-lo[2]);
-          else if (domain->axisymmetric)
-            cinfo[jcell].volume =
-              MY_PI * (hi[1]*hi[1]-lo[1]*lo[1]) * (hi[0]-lo[0]);
-          else
-            cinfo[jcell].volume = (hi[0]-lo[0]) * (hi[1]-lo[1]);
-        }
-        // do not add to setnew, see comment above
-        //set[nset++] = jcell;
-      } else {
-        if (marktype != jtype) {
-          printf("CELL3 me %d jcell %d id " CELLINT_FORMAT
-                 " marktype %d jtype %d\n",
-                 me,jcell,cells[jcell].id,marktype,jtype);
+      if (cellcomp[jcell] >= 0) {
+        m = cellcomp[jcell];
+        if (comptype[m] == UNKNOWN) comptype[m] = marktype;
+        else if (comptype[m] != marktype)
           error->one(FLERR,"Cell type mis-match when marking on neigh proc");
-        }
+      } else if (mark_inout(jcell,marktype) < 0)
+        error->one(FLERR,"Cell type mis-match when marking on neigh proc");
+    } else if (cellcomp[jcell] >= 0) {
+      edges[2*nedge] = rbuf[i].icomp;
+      edges[2*nedge+1] = compoffset + cellcomp[jcell];
+      nedge++;
+    }
+  }
+
+  memory->sfree(rbuf);
+
+  // remove duplicate edges, many cell faces can connect the same components
+
+  qsort(edges,nedge,2*sizeof(bigint),compare_edges);
+
+  m = 0;
+  for (i = 0; i < nedge; i++) {
+    if (m && edges[2*i] == edges[2*m-2] && edges[2*i+1] == edges[2*m-1])
+      continue;
+    edges[2*m] = edges[2*i];
+    edges[2*m+1] = edges[2*i+1];
+    m++;
+  }
+  nedge = m;
+
+  // (4) reduce the component graph on every proc
+  // all procs acquire types of all components and all edges
+  // union-find over edges, each connected set of components takes
+  //   the type any of them were marked with
+  // number of comm rounds does not depend on the size of the domain
+
+  bigint ncomptotal = compoffset + bcomp;
+  MPI_Bcast(&ncomptotal,1,MPI_SPARTA_BIGINT,comm->nprocs-1,world);
+  bigint nedgeall = nedge;
+  bigint nedgetotal;
+  MPI_Allreduce(&nedgeall,&nedgetotal,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  if (ncomptotal > MAXSMALLINT || 2*nedgetotal > MAXSMALLINT)
+    error->all(FLERR,"Too many cell components to mark inside/outside");
+
+  int *allcomptype;
+  memory->create(allcomptype,ncomptotal,"grid:allcomptype");
+  allgather_inout(comptype,ncomp,allcomptype,MPI_INT);
+
+  bigint *alledges;
+  memory->create(alledges,2*nedgetotal,"grid:alledges");
+  allgather_inout(edges,2*nedge,alledges,MPI_SPARTA_BIGINT);
+
+  bigint *compparent;
+  memory->create(compparent,ncomptotal,"grid:compparent");
+  for (bigint k = 0; k < ncomptotal; k++) compparent[k] = k;
+
+  bigint ki,kj;
+  for (i = 0; i < nedgetotal; i++) {
+    ki = find_inout(compparent,alledges[2*i]);
+    kj = find_inout(compparent,alledges[2*i+1]);
+    if (ki == kj) continue;
+    if (kj < ki) {
+      bigint tmp = ki;
+      ki = kj;
+      kj = tmp;
+    }
+    compparent[kj] = ki;
+    if (allcomptype[ki] == UNKNOWN) allcomptype[ki] = allcomptype[kj];
+    else if (allcomptype[kj] != UNKNOWN && allcomptype[kj] != allcomptype[ki])
+      error->all(FLERR,"Cell type mis-match when marking on neigh proc");
+  }
+
+  for (i = 0; i < ncomp; i++)
+    comptype[i] = allcomptype[find_inout(compparent,compoffset+i)];
+
+  memory->destroy(edges);
+  memory->destroy(allcomptype);
+  memory->destroy(alledges);
+  memory->destroy(compparent);
+
+  // (5) set type of cells in my components which are now marked
+  // they mark OVERLAP neighbor cells with UNKNOWN corner pts
+  //   and check consistency with other marked neighbors
+  // add MARK to comm list for neighbor cells I don't own
+
+  for (icell = 0; icell < nlocal; icell++)
+    if (cellcomp[icell] >= 0) cinfo[icell].type = comptype[cellcomp[icell]];
+
+  nsend_inout = 0;
+
+  for (icell = 0; icell < nlocal; icell++) {
+    if (cellcomp[icell] < 0) continue;
+    marktype = cinfo[icell].type;
+    if (marktype == UNKNOWN) continue;
+    for (iface = 0; iface < nface; iface++) {
+      nneigh = inout_neighbors(icell,iface,jlist);
+      for (j = 0; j < nneigh; j++) {
+        jcell = jlist[j];
+        if (cells[jcell].proc == me) {
+          if (mark_inout(jcell,marktype) < 0)
+            error->one(FLERR,"Cell type mis-match when marking on self");
+        } else send_inout(cells[jcell].proc,MARK,marktype,
+                          cells[jcell].ilocal,0);
       }
     }
   }
 
+  nrecv = irregular->create_data_uniform(nsend_inout,proc_inout,
+                                         comm->commsortflag);
+  rbuf = (InOut *) memory->smalloc((bigint) nrecv*sizeof(InOut),"grid:rbuf");
+  irregular->exchange_uniform((char *) sbuf_inout,sizeof(InOut),(char *) rbuf);
+
+  for (i = 0; i < nrecv; i++)
+    if (mark_inout(rbuf[i].jcell,rbuf[i].marktype) < 0)
+      error->one(FLERR,"Cell type mis-match when marking on neigh proc");
+
+  memory->sfree(rbuf);
+
   // NOTE: at this point could make a final attempt to mark
   //   any remaining UNKNOWN corner pts of an overlap cell
   //   to avoid warnings and errors in type_check()
@@ -1750,6 +2222,8 @@ void Grid::set_inout()
   // all done with marking
   // set type and cflags for all sub cells from split cell it belongs to
 
+  int ncorner = 8;
+  if (dimension == 2) ncorner = 4;
   int splitcell;
 
   for (icell = 0; icell < nlocal; icell++) {
@@ -1767,34 +2241,202 @@ void Grid::set_inout()
   for (icell = 0; icell < nlocal; icell++)
     if (cinfo[icell].type == INSIDE) cinfo[icell].volume = 0.0;
 
-  /*
-  printf("POST INOUT %d: %d\n",comm->me,grid->nlocal);
-  for (int i = 0; i < grid->nlocal; i++) {
-    Grid::ChildCell *g = &grid->cells[i];
-    if (g->id == 52)
-    printf("ICELL %d: %d id %d pid %d lo %g %g "
-           "hi %g %g type %d corners %d %d %d %d vol %g\n",
-           comm->me,i,g->id,pcells[g->iparent].id,
-           g->lo[0],
-           g->lo[1],
-           g->hi[0],
-           g->hi[1],
-           grid->cinfo[i].type,
-           grid->cinfo[i].corner[0],
-           grid->cinfo[i].corner[1],
-           grid->cinfo[i].corner[2],
-           grid->cinfo[i].corner[3],grid->cinfo[i].volume);
-  }
-  */
-
   // clean up
 
   delete irregular;
   memory->destroy(set1);
   memory->destroy(set2);
-  memory->destroy(proclist);
-  memory->sfree(sbuf);
-  memory->sfree(rbuf);
+  memory->destroy(cellcomp);
+  memory->destroy(comptype);
+  memory->destroy(proc_inout);
+  memory->sfree(sbuf_inout);
+  memory->destroy(changeflag);
+  changeflag = NULL;
+}
+
+/* ----------------------------------------------------------------------
+   return 1 if owned icell or any cell across one of its faces
+     was created by grid adaptation, as flagged in changeflag
+   else return 0
+------------------------------------------------------------------------- */
+
+int Grid::inout_changed(int icell)
+{
+  if (changeflag[icell] == 2) return 1;
+
+  int nface = 6;
+  if (domain->dimension == 2) nface = 4;
+
+  int j,nneigh;
+  int jlist[4];
+
+  for (int iface = 0; iface < nface; iface++) {
+    nneigh = inout_neighbors(icell,iface,jlist);
+    for (j = 0; j < nneigh; j++)
+      if (changeflag[jlist[j]] == 2) return 1;
+  }
+
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   find cells (owned or ghost) across face iface of owned icell
+   return # of cells found, up to one per face corner pt
+   if neighbor is a child cell, it is the only one
+   if neighbor is a parent cell, find child cell at each face corner pt
+   boundary and unknown neighbors are not returned
+------------------------------------------------------------------------- */
+
+int Grid::inout_neighbors(int icell, int iface, int *jlist)
+{
+  int faceflip[6] = {XHI,XLO,YHI,YLO,ZHI,ZLO};
+  double xcorner[3];
+
+  int nflag = neigh_decode(cells[icell].nmask,iface);
+
+  if (nflag == NCHILD || nflag == NPBCHILD) {
+    jlist[0] = cells[icell].neigh[iface];
+    return 1;
+  }
+
+  if (nflag != NPARENT && nflag != NPBPARENT) return 0;
+
+  int nface_pts = 4;
+  if (domain->dimension == 2) nface_pts = 2;
+
+  ParentCell *pcell = &pcells[cells[icell].neigh[iface]];
+
+  int ic,jcell;
+  for (int m = 0; m < nface_pts; m++) {
+    ic = corners[iface][m];
+    if (ic % 2) xcorner[0] = cells[icell].hi[0];
+    else xcorner[0] = cells[icell].lo[0];
+    if ((ic/2) % 2) xcorner[1] = cells[icell].hi[1];
+    else xcorner[1] = cells[icell].lo[1];
+    if (ic/4) xcorner[2] = cells[icell].hi[2];
+    else xcorner[2] = cells[icell].lo[2];
+
+    if (nflag == NPBPARENT)
+      domain->uncollide(faceflip[iface],xcorner);
+
+    jcell = id_find_child(pcell->id,cells[icell].level,
+                          pcell->lo,pcell->hi,xcorner);
+    if (jcell < 0) error->one(FLERR,"Parent cell child missing");
+    jlist[m] = jcell;
+  }
+
+  return nface_pts;
+}
+
+/* ----------------------------------------------------------------------
+   mark owned jcell as marktype = OUTSIDE/INSIDE:
+   (1) if jcell type = UNKNOWN:
+       set its type = marktype, return 1
+   (2) else if jcell type = OVERLAP:
+       skip if its corners are already marked
+       set its corner pts = marktype
+       also set its volume to full cell or zero
+       return 0, do not propagate from an OVERLAP cell
+   (3) else jcell type = OUTSIDE/INSIDE:
+       return -1 if its type is different than marktype
+       b/c markings are inconsistent, else return 0
+------------------------------------------------------------------------- */
+
+int Grid::mark_inout(int jcell, int marktype)
+{
+  int jtype = cinfo[jcell].type;
+
+  if (jtype == UNKNOWN) {
+    cinfo[jcell].type = marktype;
+    return 1;
+  }
+
+  if (jtype == OVERLAP) {
+    int *jcorner = cinfo[jcell].corner;
+    if (jcorner[0] != UNKNOWN) return 0;
+
+    int ncorner = 8;
+    if (domain->dimension == 2) ncorner = 4;
+    for (int icorner = 0; icorner < ncorner; icorner++)
+      jcorner[icorner] = marktype;
+
+    if (marktype == INSIDE) cinfo[jcell].volume = 0.0;
+    else if (marktype == OUTSIDE) {
+      double *lo = cells[jcell].lo;
+      double *hi = cells[jcell].hi;
+      if (domain->dimension == 3)
+        cinfo[jcell].volume = (hi[0]-lo[0]) * (hi[1]-lo[1]) * (hi[2]-lo[2]);
+      else if (domain->axisymmetric)
+        cinfo[jcell].volume =
+          MY_PI * (hi[1]*hi[1]-lo[1]*lo[1]) * (hi[0]-lo[0]);
+      else
+        cinfo[jcell].volume = (hi[0]-lo[0]) * (hi[1]-lo[1]);
+    }
+    return 0;
+  }
+
+  if (jtype != marktype) return -1;
+  return 0;
+}
+
+/* ----------------------------------------------------------------------
+   add a MARK or EDGE request for cell jcell owned by proc to comm list
+------------------------------------------------------------------------- */
+
+void Grid::send_inout(int proc, int flag, int marktype, int jcell,
+                      bigint icomp)
+{
+  if (nsend_inout == maxsend_inout) {
+    maxsend_inout += DELTA;
+    memory->grow(proc_inout,maxsend_inout,"grid:proc_inout");
+    sbuf_inout = (InOut *)
+      memory->srealloc(sbuf_inout,maxsend_inout*sizeof(InOut),
+                       "grid:sbuf_inout");
+  }
+
+  proc_inout[nsend_inout] = proc;
+  sbuf_inout[nsend_inout].flag = flag;
+  sbuf_inout[nsend_inout].marktype = marktype;
+  sbuf_inout[nsend_inout].jcell = jcell;
+  sbuf_inout[nsend_inout].icomp = icomp;
+  nsend_inout++;
+}
+
+/* ----------------------------------------------------------------------
+   gather N values from every proc into all, in proc order
+   caller allocates all to hold sum of N over all procs
+------------------------------------------------------------------------- */
+
+template <typename T>
+void Grid::allgather_inout(T *mine, int n, T *all, MPI_Datatype datatype)
+{
+  int nprocs = comm->nprocs;
+  int *recvcounts = new int[nprocs];
+  int *displs = new int[nprocs];
+
+  MPI_Allgather(&n,1,MPI_INT,recvcounts,1,MPI_INT,world);
+  displs[0] = 0;
+  for (int iproc = 1; iproc < nprocs; iproc++)
+    displs[iproc] = displs[iproc-1] + recvcounts[iproc-1];
+
+  MPI_Allgatherv(mine,n,datatype,all,recvcounts,displs,datatype,world);
+
+  delete [] recvcounts;
+  delete [] displs;
+}
+
+/* ----------------------------------------------------------------------
+   return root of union-find tree containing i, with path halving
+------------------------------------------------------------------------- */
+
+template <typename T>
+T Grid::find_inout(T *parent, T i)
+{
+  while (parent[i] != i) {
+    parent[i] = parent[parent[i]];
+    i = parent[i];
+  }
+  return i;
 }
 
 /* ----------------------------------------------------------------------
@@ -1939,7 +2581,10 @@ void Grid::type_check(int outflag)
    for volume, use volume of cell, whether axisymmetric or not
    for radius, use radius of cell centroid from axisymmetric axis
    weight() called from input script and read_restart (with narg = -1)
-   weight_one() is called only for adapted cells from grid_adapt
+   read_restart keeps the per-cell weights stored in the restart file,
+     which may have been changed by fix merge
+   weight_one() is called only for adapted cells from grid_adapt,
+     caller then rescales it by weight_factor() of the old cells
 ------------------------------------------------------------------------- */
 
 void Grid::weight(int narg, char **arg)
@@ -1957,6 +2602,12 @@ void Grid::weight(int narg, char **arg)
     else if (strcmp(arg[0],"radius") == 0) cellweightflag = RADWEIGHT;
     else if (strcmp(arg[0],"radius/only") == 0) cellweightflag = RADONLYWEIGHT;
     else error->all(FLERR,"Illegal weight command");
+
+    // resetting to static weights would discard cell weights set by fix merge
+
+    for (i = 0; i < modify->nfix; i++)
+      if (strcmp(modify->fix[i]->style,"merge") == 0)
+        error->all(FLERR,"Cannot reset cell weights while fix merge is defined");
   }
 
   if (cellweightflag == RADWEIGHT && !domain->axisymmetric)
@@ -1965,38 +2616,77 @@ void Grid::weight(int narg, char **arg)
   if (cellweightflag == RADONLYWEIGHT && !domain->axisymmetric)
     error->all(FLERR,"Cannot use weight cell radius/only unless axisymmetric");
 
-  // set per-cell weights
+  // set per-cell weights, unless already restored from restart file
 
+  if (narg < 0) return;
   for (i = 0; i < nlocal; i++) weight_one(i);
 }
 
 void Grid::weight_one(int icell)
+{
+  cinfo[icell].weight = weight_base(icell);
+}
+
+/* ----------------------------------------------------------------------
+   return static weight of a cell for current cellweightflag
+   also used by fix merge to limit how far it lowers a cell weight
+------------------------------------------------------------------------- */
+
+double Grid::weight_base(int icell)
 {
   double *lo,*hi;
 
   int dimension = domain->dimension;
   int axisymmetric = domain->axisymmetric;
 
-  if (cellweightflag == NOWEIGHT) {
-    cinfo[icell].weight = 1.0;
-  } else if (cellweightflag == VOLWEIGHT) {
+  double weight = 1.0;
+
+  if (cellweightflag == VOLWEIGHT) {
     lo = cells[icell].lo;
     hi = cells[icell].hi;
     if (dimension == 3)
-      cinfo[icell].weight = (hi[0]-lo[0]) * (hi[1]-lo[1]) * (hi[2]-lo[2]);
+      weight = (hi[0]-lo[0]) * (hi[1]-lo[1]) * (hi[2]-lo[2]);
     else if (axisymmetric)
-      cinfo[icell].weight = MY_PI * (hi[1]*hi[1]-lo[1]*lo[1]) * (hi[0]-lo[0]);
+      weight = MY_PI * (hi[1]*hi[1]-lo[1]*lo[1]) * (hi[0]-lo[0]);
     else
-      cinfo[icell].weight = (hi[0]-lo[0]) * (hi[1]-lo[1]);
+      weight = (hi[0]-lo[0]) * (hi[1]-lo[1]);
   } else if (cellweightflag == RADWEIGHT) {
     lo = cells[icell].lo;
     hi = cells[icell].hi;
-    cinfo[icell].weight = 0.5*(hi[1]+lo[1]) * (hi[0]-lo[0]);
+    weight = 0.5*(hi[1]+lo[1]) * (hi[0]-lo[0]);
   } else if (cellweightflag == RADONLYWEIGHT) {
     lo = cells[icell].lo;
     hi = cells[icell].hi;
-    cinfo[icell].weight = 0.5*(hi[1]+lo[1]);
+    weight = 0.5*(hi[1]+lo[1]);
+  }
+
+  return weight;
+}
+
+/* ----------------------------------------------------------------------
+   return ratio of current to static weight of a cell
+   differs from 1 only if fix merge has changed the cell weight
+   for a split cell, average over its sub cells weighted by particle count
+   used by grid adaptation so new cells keep the scaling of old cells
+------------------------------------------------------------------------- */
+
+double Grid::weight_factor(int icell)
+{
+  int nsplit = cells[icell].nsplit;
+  if (nsplit <= 1) return cinfo[icell].weight/weight_base(icell);
+
+  int *csubs = sinfo[cells[icell].isplit].csubs;
+  int jcell;
+  int np = 0;
+  double wsum = 0.0;
+  for (int i = 0; i < nsplit; i++) {
+    jcell = csubs[i];
+    np += cinfo[jcell].count;
+    wsum += cinfo[jcell].count * cinfo[jcell].weight;
   }
+
+  if (np == 0) return cinfo[icell].weight/weight_base(icell);
+  return wsum/np/weight_base(icell);
 }
 
 ///////////////////////////////////////////////////////////////////////////
@@ -2431,6 +3121,8 @@ void Grid::write_restart(FILE *fp)
   fwrite(&maxlevel,sizeof(int),1,fp);
   fwrite(plevels,sizeof(ParentLevel),maxlevel,fp);
 
+  fwrite(&dtlevelflag,sizeof(int),1,fp);
+
   fwrite(&ngroup,sizeof(int),1,fp);
 
   int n;
@@ -2465,6 +3157,11 @@ void Grid::read_restart(FILE *fp)
   MPI_Bcast(&maxlevel,1,MPI_INT,0,world);
   MPI_Bcast(plevels,maxlevel*sizeof(ParentLevel),MPI_CHAR,0,world);
 
+  // read local timestep flag, per-cell levels are read with the cells
+
+  if (me == 0) tmp = fread(&dtlevelflag,sizeof(int),1,fp);
+  MPI_Bcast(&dtlevelflag,1,MPI_INT,0,world);
+
   // if any exist, clear existing group names, before reading new ones
 
   for (int i = 0; i < ngroup; i++) delete [] gnames[i];
@@ -2498,6 +3195,10 @@ int Grid::size_restart()
   n = IROUNDUP(n);
   n += nlocal * sizeof(int);
   n = IROUNDUP(n);
+  n += nlocal * sizeof(int);
+  n = IROUNDUP(n);
+  n += nlocal * sizeof(double);
+  n = IROUNDUP(n);
   return n;
 }
 
@@ -2516,13 +3217,17 @@ int Grid::size_restart(int nlocal_restart)
   n = IROUNDUP(n);
   n += nlocal_restart * sizeof(int);
   n = IROUNDUP(n);
+  n += nlocal_restart * sizeof(int);
+  n = IROUNDUP(n);
+  n += nlocal_restart * sizeof(double);
+  n = IROUNDUP(n);
   return n;
 }
 
 /* ----------------------------------------------------------------------
    pack my child grid info into buf
    nlocal, clumped as scalars
-   ID, level, nsplit as vectors for all owned cells
+   ID, level, nsplit, dtlevel, weight as vectors for all owned cells
    // NOTE: worry about N overflowing int, and in IROUNDUP ???
 ------------------------------------------------------------------------- */
 
@@ -2554,13 +3259,26 @@ int Grid::pack_restart(char *buf)
   n += nlocal * sizeof(int);
   n = IROUNDUP(n);
 
+  ibuf = (int *) &buf[n];
+  for (int i = 0; i < nlocal; i++)
+    ibuf[i] = cells[i].dtlevel;
+  n += nlocal * sizeof(int);
+  n = IROUNDUP(n);
+
+  double *dbuf = (double *) &buf[n];
+  for (int i = 0; i < nlocal; i++)
+    dbuf[i] = cinfo[i].weight;
+  n += nlocal * sizeof(double);
+  n = IROUNDUP(n);
+
   return n;
 }
 
 /* ----------------------------------------------------------------------
    unpack child grid info into restart storage
    nlocal_restart, clumped as scalars
-   id_restart, nsplit_restart as vectors
+   id_restart, level_restart, nsplit_restart, dtlevel_restart,
+     weight_restart as vectors
    allocate vectors here, will be deallocated by ReadRestart
 ------------------------------------------------------------------------- */
 
@@ -2577,6 +3295,8 @@ int Grid::unpack_restart(char *buf)
   memory->create(id_restart,nlocal_restart,"grid:id_restart");
   memory->create(level_restart,nlocal_restart,"grid:nlevel_restart");
   memory->create(nsplit_restart,nlocal_restart,"grid:nsplit_restart");
+  memory->create(dtlevel_restart,nlocal_restart,"grid:dtlevel_restart");
+  memory->create(weight_restart,nlocal_restart,"grid:weight_restart");
 
   cellint *cbuf = (cellint *) &buf[n];
   for (int i = 0; i < nlocal_restart; i++)
@@ -2596,6 +3316,18 @@ int Grid::unpack_restart(char *buf)
   n += nlocal_restart * sizeof(int);
   n = IROUNDUP(n);
 
+  ibuf = (int *) &buf[n];
+  for (int i = 0; i < nlocal_restart; i++)
+    dtlevel_restart[i] = ibuf[i];
+  n += nlocal_restart * sizeof(int);
+  n = IROUNDUP(n);
+
+  double *dbuf = (double *) &buf[n];
+  for (int i = 0; i < nlocal_restart; i++)
+    weight_restart[i] = dbuf[i];
+  n += nlocal_restart * sizeof(double);
+  n = IROUNDUP(n);
+
   return n;
 }
 
@@ -2639,3 +3371,19 @@ void Grid::debug()
     printf("  volume %g\n",cinfo[i].volume);
   }
 }
+
+/* ----------------------------------------------------------------------
+   comparison function invoked by qsort() in set_inout()
+   sort component graph edges by both component IDs
+------------------------------------------------------------------------- */
+
+int compare_edges(const void *iptr, const void *jptr)
+{
+  bigint *i = (bigint *) iptr;
+  bigint *j = (bigint *) jptr;
+  if (i[0] < j[0]) return -1;
+  if (i[0] > j[0]) return 1;
+  if (i[1] < j[1]) return -1;
+  if (i[1] > j[1]) return 1;
+  return 0;
+}
@@ -43,6 +43,7 @@ class Grid : protected Pointers {
   double cutoff;        // cutoff for ghost cells, -1.0 = infinite
   double cell_epsilon;  // half of smallest cellside of any cell in any dim
   int cellweightflag;   // 0/1+ for no/yes usage of cellwise fnum weighting
+  int dtlevelflag;      // 1 if any cell uses a local timestep, else 0
 
   int surfgrid_algorithm;  // algorithm for overlap of surfs & grid cells
   int maxsurfpercell;   // max surf elements in one child cell
@@ -139,6 +140,9 @@ class Grid : protected Pointers {
                               // N <= 0, neg of sub cell index (0 to Nsplit-1)
     int isplit;               // index into sinfo
                               // set for split and sub cells, -1 if unsplit
+
+    int dtlevel;              // local timestep of cell = dt * 2^dtlevel
+                              // 0 = global timestep
   };
 
   // info specific to owned child cell
@@ -210,6 +214,8 @@ class Grid : protected Pointers {
   int nlocal_restart;
   cellint *id_restart;
   int *level_restart,*nsplit_restart;
+  int *dtlevel_restart;
+  double *weight_restart;
 
   // methods
 
@@ -218,6 +224,7 @@ class Grid : protected Pointers {
   void remove();
   void init();
   void add_child_cell(cellint, int, double *, double *);
+  void reserve_cells(int);
   void add_split_cell(int);
   void add_sub_cell(int, int);
   void notify_changed();
@@ -225,6 +232,10 @@ class Grid : protected Pointers {
   void set_maxlevel();
   void setup_owned();
   void remove_ghosts();
+  void hold_ghosts();
+  void stash_ghosts();
+  void restore_ghosts();
+  int update_ghosts();
   void acquire_ghosts(int surfflag=1);
   void rehash();
   void find_neighbors();
@@ -235,6 +246,12 @@ class Grid : protected Pointers {
   void type_check(int flag=1);
   void weight(int, char **);
   void weight_one(int);
+  double weight_base(int);
+  double weight_factor(int);
+
+  // scale factor on global timestep and fnum for a cell's local timestep
+
+  double dtscale(int icell) {return (double) (1 << cells[icell].dtlevel);}
 
   void refine_cell(int, int *, class Cut2d *, class Cut3d *);
   void coarsen_cell(cellint, int, double *, double *,
@@ -285,7 +302,7 @@ class Grid : protected Pointers {
 
   void surf2grid(int, int outflag=1);
   void surf2grid_implicit(int, int outflag=1);
-  void surf2grid_one(int, int, int, int, class Cut3d *, class Cut2d *);
+  void surf2grid_one(int, int, int, surfint *, class Cut3d *, class Cut2d *);
   void clear_surf();
   void clear_surf_restart();
   void combine_split_cell_particles(int, int);
@@ -367,14 +384,20 @@ class Grid : protected Pointers {
   class Cut2d *cut2d;
   class Cut3d *cut3d;
 
-  // connection between one of my cells and a neighbor cell on another proc
+  // request from one of my cells to a neighbor cell on another proc
+  // MARK = set type of neighbor cell, EDGE = connect two cell components
 
-  struct Connect {
-    int itype;           // type of sending cell
+  struct InOut {
+    int flag;            // MARK or EDGE
     int marktype;        // new type value (IN/OUT) for neighbor cell
     int jcell;           // index of neighbor cell on receiving proc (owner)
+    bigint icomp;        // global ID of component of sending cell for EDGE
   };
 
+  int nsend_inout,maxsend_inout;  // requests buffered by set_inout()
+  int *proc_inout;                // proc each request is sent to
+  InOut *sbuf_inout;
+
   // bounding box for a clump of grid cells
 
   struct Box {
@@ -416,6 +439,46 @@ class Grid : protected Pointers {
     typedef std::tr1::unordered_map<surfint,int>::iterator MyIterator;
 #endif
 
+  // surfs of a parent cell being refined, binned by child cell
+
+  int maxchildbin;            // length of childcount and childfirst
+  int maxchildsurf;           // length of childsurfs
+  int *childcount;            // # of surfs which may overlap each child
+  int *childfirst;            // index into childsurfs of 1st surf of child
+  surfint *childsurfs;        // surf indices of all children
+
+  // ghost counts saved by hold_ghosts()
+
+  int ghost_hold;             // 1 if held ghosts can be restored
+  int nghost_hold,nunsplitghost_hold,nsplitghost_hold,nsubghost_hold;
+  int nsurfghost_hold;
+
+  // held ghosts packed by stash_ghosts() for update_ghosts()
+
+  int ghost_stash;            // 1 if held ghosts are packed in stashbuf
+  char *stashbuf;             // packed held ghost cells
+  MyHash *stashhash;          // ghost cell ID -> offset in stashbuf
+  MyHash *newhash;            // IDs of cells created since stash_ghosts()
+
+  int nboxprev;               // extended bboxes of all procs used by
+  Box *boxprev;               //   last acquire_ghosts_near(), NULL if none
+
+  int *changeflag;            // per owned + ghost cell, set by update_ghosts()
+                              // 0 = unchanged, 1 = ghost resent, 2 = new cell
+                              // NULL if all cells are treated as new
+
+  // owner's update for a ghost cell of another proc, sent by update_ghosts()
+  // followed by pack_one() data if full is set,
+  //   else by owner's indices of its Nsplit sub cells if split
+
+  struct GhostUpdate {
+    cellint id;               // ID of the cell
+    int full;                 // 1 if cell is new to receiver
+    int ilocal;               // owner's local index of the cell
+    int dtlevel;              // local timestep level of the cell
+    int nsplit;               // # of sub cells, 1 if unsplit
+  };
+
   // Particle class values used for packing/unpacking particles in grid comm
 
   int ncustom_particle;
@@ -437,9 +500,24 @@ class Grid : protected Pointers {
              GridTree *);
   void box_drop(int *, int *, int, int, GridTree *, int &, int *);
 
+  void bin_child_surfs(int, int, int, int);
+
+  int inout_neighbors(int, int, int *);
+  int mark_inout(int, int);
+  void send_inout(int, int, int, int, bigint);
+  template <typename T> void allgather_inout(T *, int, T *, MPI_Datatype);
+  template <typename T> T find_inout(T *, T);
+
   void acquire_ghosts_all(int);
   void acquire_ghosts_near(int);
   void acquire_ghosts_near_less_memory(int);
+  Box *ghost_boxes(double *, double *, int &);
+  void clear_stash();
+  int find_neighbors_one(int);
+  int remap_neighbors_one(int);
+  int pack_update(int, int, int, char *, int);
+  int unpack_update(char *);
+  int inout_changed(int);
 
   void box_intersect(double *, double *, double *, double *,
                      double *, double *);
@@ -487,6 +565,29 @@ One or more grid cells have unknown neighbors which will prevent
 particles from moving correctly.  Please report the issue to the
 SPARTA developers.
 
+E: Stash ghosts buffer exceeds 2 GB
+
+The ghost cells stored by a processor are too large to save during
+grid adaptation.  Use fewer ghost cells via the global gridcut
+command or more processors.
+
+E: Update ghosts send buffer exceeds 2 GB
+
+The ghost cell updates sent by a processor after grid adaptation are
+too large.  Use fewer ghost cells via the global gridcut command or
+more processors.
+
+E: Updated ghost cell was not stashed
+
+A ghost cell to restore after grid adaptation was not saved before
+it.  Please report the issue to the SPARTA developers.
+
+E: Updated ghost cell does not match stashed cell
+
+A ghost cell to restore after grid adaptation is split differently
+than when it was saved before it.  Please report the issue to the
+SPARTA developers.
+
 E: Grid in/out self-mark error %d for icell %d, icorner %d, connect %d %d, other cell %d, other corner %d, values %d %d\n
 
 A grid cell was incorrectly marked as inside, outside, or overlapping
@@ -513,6 +614,13 @@ E: Cell type mis-match when marking on neigh proc
 Grid cell marking as inside, outside, or overlapping with surface
 elements failed.  Please report the issue to the SPARTA developers.
 
+E: Too many cell components to mark inside/outside
+
+Grid cells not yet marked as inside or outside surfaces are grouped
+into connected components on each processor.  The total number of
+components or connections between them is too large to gather on
+every processor.
+
 E: Grid cells marked as unknown = %d
 
 Grid cell marking as inside, outside, or overlapping with surface
@@ -547,4 +655,10 @@ E: Cannot use weight cell radius unless axisymmetric
 
 An axisymmetric model is required for this style of cell weighting.
 
+E: Cannot reset cell weights while fix merge is defined
+
+Fix merge changes individual cell weights, which would be overwritten
+by the static weights set by the global weight command.  Unfix fix
+merge first.
+
 */
@@ -13,6 +13,7 @@
 ------------------------------------------------------------------------- */
 
 #include "grid.h"
+#include "surf.h"
 #include "particle.h"
 #include "update.h"
 #include "modify.h"
@@ -20,16 +21,22 @@
 #include "adapt_grid.h"
 #include "cut3d.h"
 #include "cut2d.h"
+#include "memory.h"
 #include "error.h"
 
 using namespace SPARTA_NS;
 
 enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};   // several files
 
+#define EPSBIN 1.0e-6           // fraction of child cell size
+
 /* ----------------------------------------------------------------------
    refine child icell into Nx by Ny by Nz new child cells
    icell still exists, will be deleted when grid is compressed later
    childlist is workspace of length Nx by Ny by Nz, passed by caller
+   new child cells are not added to the grid hash,
+     caller must rehash once grid is compressed
+   caller must also add per-cell fix and collide data for all new cells
 ------------------------------------------------------------------------- */
 
 void Grid::refine_cell(int icell, int *childlist, Cut2d *cut2d, Cut3d *cut3d)
@@ -52,8 +59,16 @@ void Grid::refine_cell(int icell, int *childlist, Cut2d *cut2d, Cut3d *cut3d)
   int ny = plevels[plevel].ny;
   int nz = plevels[plevel].nz;
 
+  // if surfs in parent cell, bin them by the child cells they may overlap
+  // so each child only clips its own subset of parent surfs
+
+  if (cells[icell].nsurf) bin_child_surfs(icell,nx,ny,nz);
+
+  // new child cells keep any fix merge scaling of parent cell weight
+
+  double wfactor = weight_factor(icell);
+
   // loop over creation of new child cells
-  // add new children to hash, so id_find_child() for particles will work
   // set plo/phi inside loop b/c cells can be realloced by add_child_cell()
 
   m = 0;
@@ -67,14 +82,11 @@ void Grid::refine_cell(int icell, int *childlist, Cut2d *cut2d, Cut3d *cut3d)
         phi = cells[icell].hi;
         id_child_lohi(plevel,plo,phi,m,lo,hi);
         add_child_cell(childID,plevel+1,lo,hi);
+        cells[nlocal-1].dtlevel = cells[icell].dtlevel;
         weight_one(nlocal-1);
-        (*hash)[childID] = nlocal-1;
-
-        // update any per grid fixes for the new child cell
+        cinfo[nlocal-1].weight *= wfactor;
 
-        if (modify->n_pergrid) modify->add_grid_one();
-
-        // if surfs in parent cell, intersect them with child cell
+        // if surfs in parent cell, intersect binned ones with child cell
         // add_child_cell marked child type as OUTSIDE
         //   correct only if no surfs in parent
         //   if surfs in parent, mark all child cells as UNKNOWN
@@ -84,13 +96,9 @@ void Grid::refine_cell(int icell, int *childlist, Cut2d *cut2d, Cut3d *cut3d)
         if (cells[icell].nsurf) {
           ichild = nlocal - 1;
           cinfo[ichild].type = UNKNOWN;
-          surf2grid_one(0,ichild,icell,-1,cut3d,cut2d);
-
-          // update any per grid fixes for the newly created sub cells
-
-          if (modify->n_pergrid)
-            for (i = ichild+1; i < nlocal; i++)
-              modify->add_grid_one();
+          if (childcount[m-1])
+            surf2grid_one(0,ichild,childcount[m-1],
+                          &childsurfs[childfirst[m-1]],cut3d,cut2d);
         }
       }
 
@@ -150,14 +158,10 @@ void Grid::refine_cell(int icell, int *childlist, Cut2d *cut2d, Cut3d *cut3d)
     p = &particles[ip];
 
     // ichild = index of new unsplit or split child cell the particle is now in
+    // new children are not hashed, but are all in childlist
 
-    ichild = id_find_child(parentID,plevel,plo,phi,p->x);
-
-    if (ichild < 0) {
-      printf("BAD CHILD %d: %d " CELLINT_FORMAT ": %g %g %g\n",
-             me,icell,parentID,p->x[0],p->x[1],p->x[2]);
-      error->one(FLERR,"Adapt refine particle could not be mapped to child cell");
-    }
+    id_point_child(p->x,plo,phi,nx,ny,nz,ix,iy,iz);
+    ichild = childlist[iz*ny*nx + iy*nx + ix];
 
     // if ichild is split cell:
     //   use split2d/3d to find which sub cell particle is in
@@ -185,6 +189,120 @@ void Grid::refine_cell(int icell, int *childlist, Cut2d *cut2d, Cut3d *cut3d)
   }
 }
 
+/* ----------------------------------------------------------------------
+   bin surfs of parent icell by the Nx by Ny by Nz child cells they may overlap
+   use bounding box of each surf, expanded by EPSBIN of a child cell
+     so a surf which touches a child cell boundary is binned with both
+   binning is conservative, Cut2d/Cut3d surf2grid_list() does exact test
+   surfs of each child stay in same order as in parent
+   child M in loop order of refine_cell() has childcount[M] surfs
+     starting at childsurfs[childfirst[M]]
+------------------------------------------------------------------------- */
+
+void Grid::bin_child_surfs(int icell, int nx, int ny, int nz)
+{
+  int i,m,n,ix,iy,iz,ilo,ihi,jlo,jhi,klo,khi;
+  double bblo[3],bbhi[3];
+  double *x1,*x2,*x3;
+
+  int dim = domain->dimension;
+  int nchild = nx*ny*nz;
+
+  if (nchild > maxchildbin) {
+    maxchildbin = nchild;
+    memory->destroy(childcount);
+    memory->destroy(childfirst);
+    memory->create(childcount,maxchildbin,"grid:childcount");
+    memory->create(childfirst,maxchildbin,"grid:childfirst");
+  }
+
+  Surf::Line *lines = surf->lines;
+  Surf::Tri *tris = surf->tris;
+
+  double *plo = cells[icell].lo;
+  double *phi = cells[icell].hi;
+  int nsurf = cells[icell].nsurf;
+  surfint *psurfs = cells[icell].csurfs;
+
+  double xscale = nx/(phi[0]-plo[0]);
+  double yscale = ny/(phi[1]-plo[1]);
+  double zscale = nz/(phi[2]-plo[2]);
+
+  // pass 0 = count surfs in each child, pass 1 = fill childsurfs
+  // childcount is reused as fill counter in pass 1
+
+  for (m = 0; m < nchild; m++) childcount[m] = 0;
+
+  for (int pass = 0; pass < 2; pass++) {
+    for (i = 0; i < nsurf; i++) {
+      if (dim == 2) {
+        x1 = lines[psurfs[i]].p1;
+        x2 = lines[psurfs[i]].p2;
+        bblo[0] = MIN(x1[0],x2[0]);
+        bbhi[0] = MAX(x1[0],x2[0]);
+        bblo[1] = MIN(x1[1],x2[1]);
+        bbhi[1] = MAX(x1[1],x2[1]);
+      } else {
+        x1 = tris[psurfs[i]].p1;
+        x2 = tris[psurfs[i]].p2;
+        x3 = tris[psurfs[i]].p3;
+        bblo[0] = MIN(x1[0],x2[0]);
+        bblo[0] = MIN(bblo[0],x3[0]);
+        bbhi[0] = MAX(x1[0],x2[0]);
+        bbhi[0] = MAX(bbhi[0],x3[0]);
+        bblo[1] = MIN(x1[1],x2[1]);
+        bblo[1] = MIN(bblo[1],x3[1]);
+        bbhi[1] = MAX(x1[1],x2[1]);
+        bbhi[1] = MAX(bbhi[1],x3[1]);
+        bblo[2] = MIN(x1[2],x2[2]);
+        bblo[2] = MIN(bblo[2],x3[2]);
+        bbhi[2] = MAX(x1[2],x2[2]);
+        bbhi[2] = MAX(bbhi[2],x3[2]);
+      }
+
+      ilo = static_cast<int> ((bblo[0]-plo[0])*xscale - EPSBIN);
+      ihi = static_cast<int> ((bbhi[0]-plo[0])*xscale + EPSBIN);
+      jlo = static_cast<int> ((bblo[1]-plo[1])*yscale - EPSBIN);
+      jhi = static_cast<int> ((bbhi[1]-plo[1])*yscale + EPSBIN);
+      ilo = MAX(ilo,0);
+      ihi = MIN(ihi,nx-1);
+      jlo = MAX(jlo,0);
+      jhi = MIN(jhi,ny-1);
+
+      if (dim == 2) klo = khi = 0;
+      else {
+        klo = static_cast<int> ((bblo[2]-plo[2])*zscale - EPSBIN);
+        khi = static_cast<int> ((bbhi[2]-plo[2])*zscale + EPSBIN);
+        klo = MAX(klo,0);
+        khi = MIN(khi,nz-1);
+      }
+
+      for (iz = klo; iz <= khi; iz++)
+        for (iy = jlo; iy <= jhi; iy++)
+          for (ix = ilo; ix <= ihi; ix++) {
+            m = iz*ny*nx + iy*nx + ix;
+            if (pass) childsurfs[childfirst[m]+childcount[m]] = psurfs[i];
+            childcount[m]++;
+          }
+    }
+
+    if (pass) break;
+
+    n = 0;
+    for (m = 0; m < nchild; m++) {
+      childfirst[m] = n;
+      n += childcount[m];
+      childcount[m] = 0;
+    }
+
+    if (n > maxchildsurf) {
+      maxchildsurf = n;
+      memory->destroy(childsurfs);
+      memory->create(childsurfs,maxchildsurf,"grid:childsurfs");
+    }
+  }
+}
+
 /* ----------------------------------------------------------------------
    create a new coarnsed child cell with parentID
    use info from its nchild child cells
@@ -209,6 +327,18 @@ void Grid::coarsen_cell(cellint parentID, int plevel, double *plo, double *phi,
   (*hash)[parentID] = nlocal-1;
   int newcell = nlocal - 1;
 
+  // new cell uses finest local timestep of any of its children I own
+
+  if (dtlevelflag) {
+    int dtlevel = -1;
+    for (m = 0; m < nchild; m++)
+      if (index[m] >= 0) {
+        if (dtlevel < 0) dtlevel = cells[index[m]].dtlevel;
+        else dtlevel = MIN(dtlevel,cells[index[m]].dtlevel);
+      }
+    if (dtlevel > 0) cells[newcell].dtlevel = dtlevel;
+  }
+
   // update any per grid fixes for the new child cell
 
   if (modify->n_pergrid) modify->add_grid_one();
@@ -332,7 +462,7 @@ void Grid::coarsen_cell(cellint parentID, int plevel, double *plo, double *phi,
     cells[newcell].csurfs = ptr;
     csurfs->vgot(nsurf);
 
-    surf2grid_one(1,newcell,-1,nsurf,cut3d,cut2d);
+    surf2grid_one(1,newcell,nsurf,NULL,cut3d,cut2d);
 
     // update any per grid fixes for newly created sub cells
 
@@ -20,6 +20,7 @@
 #include "collide.h"
 #include "modify.h"
 #include "adapt_grid.h"
+#include "error.h"
 
 using namespace SPARTA_NS;
 
@@ -410,6 +411,102 @@ int Grid::unpack_one(char *buf,
   return ptr - buf;
 }
 
+/* ----------------------------------------------------------------------
+   pack update of owned icell for a proc which stores it as a ghost cell
+   full = 0 if proc stashed the ghost cell, else 1 or 2 (new cell)
+   oflag = 2 if icell just touches the proc's box, send as EMPTY ghost
+   if full, pack entire cell via pack_one()
+   else pack only indices of icell and its sub cells on this proc
+   memflag = 0/1 = no/yes to actually pack into buf, 0 = just length
+   return length of packing in bytes
+------------------------------------------------------------------------- */
+
+int Grid::pack_update(int icell, int full, int oflag, char *buf, int memflag)
+{
+  char *ptr = buf;
+
+  if (memflag) {
+    GhostUpdate *g = (GhostUpdate *) ptr;
+    g->id = cells[icell].id;
+    g->full = full;
+    g->ilocal = cells[icell].ilocal;
+    g->dtlevel = cells[icell].dtlevel;
+    g->nsplit = cells[icell].nsplit;
+  }
+  ptr += sizeof(GhostUpdate);
+  ptr = ROUNDUP(ptr);
+
+  // pack entire cell, flag EMPTY ghost by setting nsurf = -1
+
+  if (full) {
+    int nsurf_hold = cells[icell].nsurf;
+    if (oflag == 2) cells[icell].nsurf = -1;
+    ptr += pack_one(icell,ptr,0,0,1,memflag);
+    cells[icell].nsurf = nsurf_hold;
+    return ptr - buf;
+  }
+
+  // EMPTY ghost cell has no sub cells
+
+  if (oflag == 2 || cells[icell].nsplit == 1) return ptr - buf;
+
+  int nsplit = cells[icell].nsplit;
+  if (memflag)
+    memcpy(ptr,sinfo[cells[icell].isplit].csubs,nsplit*sizeof(int));
+  ptr += nsplit*sizeof(int);
+  ptr = ROUNDUP(ptr);
+
+  return ptr - buf;
+}
+
+/* ----------------------------------------------------------------------
+   unpack update of a cell packed by pack_update() as a ghost cell
+   if not full, reinstate ghost cell from stash_ghosts() with
+     new indices of it and its sub cells on their owning proc
+   return length of unpacking in bytes
+------------------------------------------------------------------------- */
+
+int Grid::unpack_update(char *buf)
+{
+  char *ptr = buf;
+
+  GhostUpdate *g = (GhostUpdate *) ptr;
+  ptr += sizeof(GhostUpdate);
+  ptr = ROUNDUP(ptr);
+
+  if (g->full) {
+    ptr += unpack_one(ptr,0,0,1);
+    return ptr - buf;
+  }
+
+  if (stashhash->find(g->id) == stashhash->end())
+    error->one(FLERR,"Updated ghost cell was not stashed");
+
+  int icell = nlocal + nghost;
+  unpack_one(&stashbuf[(*stashhash)[g->id]],0,0,1);
+  cells[icell].ilocal = g->ilocal;
+  cells[icell].dtlevel = g->dtlevel;
+
+  // stashed EMPTY ghost cell has no sub cells
+
+  if (cells[icell].nsplit == 1) return ptr - buf;
+
+  int nsplit = cells[icell].nsplit;
+  if (nsplit != g->nsplit)
+    error->one(FLERR,"Updated ghost cell does not match stashed cell");
+
+  int *ilocals = (int *) ptr;
+  int *csubs = sinfo[cells[icell].isplit].csubs;
+  for (int i = 0; i < nsplit; i++) {
+    cells[csubs[i]].ilocal = ilocals[i];
+    cells[csubs[i]].dtlevel = g->dtlevel;
+  }
+  ptr += nsplit*sizeof(int);
+  ptr = ROUNDUP(ptr);
+
+  return ptr - buf;
+}
+
 /* ----------------------------------------------------------------------
    pack single icell into buf with grid adaptation info
    memflag = 0/1 = no/yes to actually pack into buf, 0 = just length
@@ -107,13 +107,17 @@ void Grid::surf2grid_implicit(int subflag, int outflag)
 /* ----------------------------------------------------------------------
    map surf elements into a single grid cell = icell
    flag = 0 for grid refinement, 1 for grid coarsening
+   for refinement: nsurf_caller/slist = surfs of parent which may overlap icell
+   for coarsening: nsurf_caller = # of surfs already assigned to icell
    in cells: set nsurf, csurfs, nsplit, isplit
    in cinfo: set type, corner, volume
    initialize sinfo as needed
+   for refinement, caller adds per-cell collide and fix data for all new
+     cells in one pass, for coarsening it is added here for new sub cells
    called from AdaptGrid
 ------------------------------------------------------------------------- */
 
-void Grid::surf2grid_one(int flag, int icell, int iparent, int nsurf_caller,
+void Grid::surf2grid_one(int flag, int icell, int nsurf_caller, surfint *slist,
                          Cut3d *cut3d, Cut2d *cut2d)
 {
   int nsurf,isub,xsub,nsplitone;
@@ -131,12 +135,12 @@ void Grid::surf2grid_one(int flag, int icell, int iparent, int nsurf_caller,
     if (dim == 3)
       nsurf = cut3d->surf2grid_list(cells[icell].id,
                                     cells[icell].lo,cells[icell].hi,
-                                    cells[iparent].nsurf,cells[iparent].csurfs,
+                                    nsurf_caller,slist,
                                     sptr,maxsurfpercell);
     else
       nsurf = cut2d->surf2grid_list(cells[icell].id,
                                     cells[icell].lo,cells[icell].hi,
-                                    cells[iparent].nsurf,cells[iparent].csurfs,
+                                    nsurf_caller,slist,
                                     sptr,maxsurfpercell);
 
     if (nsurf == 0) return;
@@ -188,13 +192,15 @@ void Grid::surf2grid_one(int flag, int icell, int iparent, int nsurf_caller,
     iptr = s->csubs = csubs->vget();
 
     // add nsplitone sub cells
-    // collide and fixes also need to add cells
+    // collide and fixes also need to add cells when coarsening
 
     for (int i = 0; i < nsplitone; i++) {
       isub = nlocal;
       add_sub_cell(icell,1);
-      if (collide) collide->add_grid_one();
-      if (modify->n_pergrid) modify->add_grid_one();
+      if (flag) {
+        if (collide) collide->add_grid_one();
+        if (modify->n_pergrid) modify->add_grid_one();
+      }
       cells[isub].nsplit = -i;
       cinfo[isub].volume = vols[i];
       iptr[i] = isub;
@@ -0,0 +1,100 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#include "mpi.h"
+#include "stdlib.h"
+#include "local_timestep.h"
+#include "grid.h"
+#include "comm.h"
+#include "error.h"
+
+using namespace SPARTA_NS;
+
+#define MAXDTLEVEL 10
+
+/* ---------------------------------------------------------------------- */
+
+LocalTimestep::LocalTimestep(SPARTA *sparta) : Pointers(sparta) {}
+
+/* ---------------------------------------------------------------------- */
+
+void LocalTimestep::command(int narg, char **arg)
+{
+  if (!grid->exist)
+    error->all(FLERR,"Cannot use local_timestep before grid is defined");
+
+  if (narg != 2) error->all(FLERR,"Illegal local_timestep command");
+
+  if (sparta->kokkos)
+    error->all(FLERR,"Cannot use local_timestep with Kokkos");
+
+  int igroup = grid->find_group(arg[0]);
+  if (igroup < 0) error->all(FLERR,"Local_timestep group ID does not exist");
+  int groupbit = grid->bitmask[igroup];
+
+  int dtlevel = atoi(arg[1]);
+  if (dtlevel < 0 || dtlevel > MAXDTLEVEL)
+    error->all(FLERR,"Illegal local_timestep command");
+
+  // assign level to unsplit and split cells in group
+  // sub cells then inherit level of their split cell
+
+  Grid::ChildCell *cells = grid->cells;
+  Grid::ChildInfo *cinfo = grid->cinfo;
+  Grid::SplitInfo *sinfo = grid->sinfo;
+  int nglocal = grid->nlocal;
+
+  bigint nme = 0;
+  for (int icell = 0; icell < nglocal; icell++) {
+    if (cells[icell].nsplit <= 0) continue;
+    if (!(cinfo[icell].mask & groupbit)) continue;
+    cells[icell].dtlevel = dtlevel;
+    nme++;
+  }
+
+  for (int icell = 0; icell < nglocal; icell++) {
+    if (cells[icell].nsplit > 0) continue;
+    cells[icell].dtlevel = cells[sinfo[cells[icell].isplit].icell].dtlevel;
+  }
+
+  // dtlevelflag = 1 if any cell now uses a local timestep
+
+  int flag = 0;
+  for (int icell = 0; icell < nglocal; icell++)
+    if (cells[icell].dtlevel) flag = 1;
+  MPI_Allreduce(&flag,&grid->dtlevelflag,1,MPI_INT,MPI_MAX,world);
+
+  // re-acquire ghost cells so they store new levels of their owned cells
+  // particle moves need level of cells they enter
+
+  if (grid->exist_ghost) {
+    grid->unset_neighbors();
+    grid->remove_ghosts();
+    grid->acquire_ghosts();
+    grid->reset_neighbors();
+    comm->reset_neighbors();
+  }
+
+  bigint nall;
+  MPI_Allreduce(&nme,&nall,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+
+  if (comm->me == 0) {
+    if (screen)
+      fprintf(screen,"Local timestep level %d assigned to "
+              BIGINT_FORMAT " cells\n",dtlevel,nall);
+    if (logfile)
+      fprintf(logfile,"Local timestep level %d assigned to "
+              BIGINT_FORMAT " cells\n",dtlevel,nall);
+  }
+}
@@ -0,0 +1,59 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifdef COMMAND_CLASS
+
+CommandStyle(local_timestep,LocalTimestep)
+
+#else
+
+#ifndef SPARTA_LOCAL_TIMESTEP_H
+#define SPARTA_LOCAL_TIMESTEP_H
+
+#include "pointers.h"
+
+namespace SPARTA_NS {
+
+class LocalTimestep : protected Pointers {
+ public:
+  LocalTimestep(class SPARTA *);
+  void command(int, char **);
+};
+
+}
+
+#endif
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Cannot use local_timestep before grid is defined
+
+Self-explanatory.
+
+E: Illegal local_timestep command
+
+Self-explanatory.  Check the input script syntax and compare to the
+documentation for the command.
+
+E: Cannot use local_timestep with Kokkos
+
+Local timesteps are only supported by the non-Kokkos move and
+collision styles.
+
+E: Local_timestep group ID does not exist
+
+Self-explanatory.
+
+*/
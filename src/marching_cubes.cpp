@@ -50,6 +50,36 @@ MarchingCubes::MarchingCubes(SPARTA *sparta, int ggroup_caller,
 
   ggroup = ggroup_caller;
   thresh = thresh_caller;
+  restricted = 0;
+
+  maxcell = 0;
+  count = offset = first = reuse = NULL;
+  cache_id = NULL;
+  cache_type = cache_n = first_cache = NULL;
+  cache_flags = NULL;
+  cache_values = NULL;
+
+  maxnew = maxcache = maxnext = 0;
+  newpts = cachepts = cachepts_next = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+MarchingCubes::~MarchingCubes()
+{
+  memory->destroy(count);
+  memory->destroy(offset);
+  memory->destroy(first);
+  memory->destroy(reuse);
+  memory->destroy(cache_id);
+  memory->destroy(cache_type);
+  memory->destroy(cache_n);
+  memory->destroy(first_cache);
+  memory->destroy(cache_flags);
+  memory->destroy(cache_values);
+  memory->destroy(newpts);
+  memory->destroy(cachepts);
+  memory->destroy(cachepts_next);
 }
 
 /* ----------------------------------------------------------------------
@@ -67,11 +97,21 @@ MarchingCubes::MarchingCubes(SPARTA *sparta, int ggroup_caller,
    order 2 points in each line segment to give normal into flow volume
    treat two saddle point cases (my 9,6) (Wiki 5,10)
      based on ave value at cell center
+   two passes over cells:
+     1st pass counts tris in each cell and computes them into newpts,
+       in restricted mode a cell whose corner values are unchanged since
+       the last invocation reuses its cached tris
+     prefix sum of counts gives each cell its slots in Surf tris list
+     2nd pass writes each cell's tris into its own slots,
+       so no cell depends on another
+   1st pass uses per-cube state in this class, so it stays serial,
+     2nd pass and restricted cache lookups could be done in parallel
 ------------------------------------------------------------------------- */
 
 void MarchingCubes::invoke(double **cvalues, int *svalues, int **mcflags)
 {
-  int i,j,ipt,isurf,nsurf,icase,which;
+  int i,j,m,icell,isurf,nsurf,icase,itype;
+  double *src,*dest;
   surfint *ptr;
 
   Grid::ChildCell *cells = grid->cells;
@@ -80,356 +120,510 @@ void MarchingCubes::invoke(double **cvalues, int *svalues, int **mcflags)
   int nglocal = grid->nlocal;
   int groupbit = grid->bitmask[ggroup];
 
-  for (int icell = 0; icell < nglocal; icell++) {
-    if (!(cinfo[icell].mask & groupbit)) continue;
-    if (cells[icell].nsplit <= 0) continue;
-    lo = cells[icell].lo;
-    hi = cells[icell].hi;
+  grow_cell(nglocal);
 
-    // nsurf = # of tris in cell
-    // cvalues[8] = 8 corner point values, each is 0 to 255 inclusive
-    // thresh = value between 0 and 255 to threshhold on
-    // lo[3] = lower left corner pt of grid cell
-    // hi[3] = upper right corner pt of grid cell
-    // pt = list of 3*nsurf points that are the corner pts of each tri
-
-    // cvalues are ordered
-    // bottom-lower-left, bottom-lower-right,
-    // bottom-upper-left, bottom-upper-right
-    // top-lower-left, top-lower-right, top-upper-left, top-upper-right
-    // Vzyx encodes this as 0/1 in each dim
-
-    v000 = cvalues[icell][0];
-    v001 = cvalues[icell][1];
-    v010 = cvalues[icell][2];
-    v011 = cvalues[icell][3];
-    v100 = cvalues[icell][4];
-    v101 = cvalues[icell][5];
-    v110 = cvalues[icell][6];
-    v111 = cvalues[icell][7];
-
-    v000iso = v000 - thresh;
-    v001iso = v001 - thresh;
-    v010iso = v010 - thresh;
-    v011iso = v011 - thresh;
-    v100iso = v100 - thresh;
-    v101iso = v101 - thresh;
-    v110iso = v110 - thresh;
-    v111iso = v111 - thresh;
-
-    // make bits 2, 3, 6 and 7 consistent with Lewiner paper (see NOTE above)
-
-    bit0 = v000 <= thresh ? 0 : 1;
-    bit1 = v001 <= thresh ? 0 : 1;
-    bit2 = v011 <= thresh ? 0 : 1;
-    bit3 = v010 <= thresh ? 0 : 1;
-    bit4 = v100 <= thresh ? 0 : 1;
-    bit5 = v101 <= thresh ? 0 : 1;
-    bit6 = v111 <= thresh ? 0 : 1;
-    bit7 = v110 <= thresh ? 0 : 1;
-
-    which = (bit7 << 7) + (bit6 << 6) + (bit5 << 5) + (bit4 << 4) +
-      (bit3 << 3) + (bit2 << 2) + (bit1 << 1) + bit0;
-
-    // icase = case of the active cube in [0..15]
-
-    icase = cases[which][0];
-    config = cases[which][1];
-    subconfig = 0;
-
-    switch (icase) {
-    case  0:
-      nsurf = 0;
-      break;
+  // 1st pass: count tris in each cell
+  // reuse = 1 if cell's cached tris are still valid
 
-    case  1:
-      nsurf = add_triangle(tiling1[config], 1);
-      break;
+  int nnew = 0;
 
-    case  2:
-      nsurf = add_triangle(tiling2[config], 2);
-      break;
+  for (icell = 0; icell < nglocal; icell++) {
+    count[icell] = -1;
+    if (!(cinfo[icell].mask & groupbit)) {
+      cache_id[icell] = 0;
+      continue;
+    }
+    if (cells[icell].nsplit <= 0) {
+      cache_id[icell] = 0;
+      continue;
+    }
 
-    case  3:
-      if (test_face(test3[config]))
-        nsurf = add_triangle(tiling3_2[config], 4); // 3.2
-      else
-        nsurf = add_triangle(tiling3_1[config], 2); // 3.1
-      break;
+    itype = svalues ? svalues[icell] : 1;
+
+    if (restricted && cache_id[icell] == cells[icell].id &&
+        cache_type[icell] == itype) {
+      for (j = 0; j < 8; j++)
+        if (cache_values[icell][j] != cvalues[icell][j]) break;
+      if (j == 8) {
+        reuse[icell] = 1;
+        count[icell] = cache_n[icell];
+        mcflags[icell][0] = cache_flags[icell][0];
+        mcflags[icell][1] = cache_flags[icell][1];
+        mcflags[icell][2] = cache_flags[icell][2];
+        mcflags[icell][3] = cache_n[icell];
+        continue;
+      }
+    }
 
-    case  4:
-      if (modified_test_interior(test4[config],icase))
-        nsurf = add_triangle(tiling4_1[config], 2); // 4.1.1
-      else
-        nsurf = add_triangle(tiling4_2[config], 6); // 4.1.2
-      break;
+    nsurf = cell_tris(cvalues[icell],cells[icell].lo,cells[icell].hi,icase);
 
-    case  5:
-      nsurf = add_triangle(tiling5[config], 3);
-      break;
+    // store 4 MC labels for FixAblate caller
 
-    case  6:
-      if (test_face(test6[config][0]))
-        nsurf = add_triangle(tiling6_2[config], 5); // 6.2
-      else {
-        if (modified_test_interior(test6[config][1],icase))
-          nsurf = add_triangle(tiling6_1_1[config], 3); // 6.1.1
-        else {
-          nsurf = add_triangle(tiling6_1_2[config], 9); // 6.1.2
-        }
+    mcflags[icell][0] = icase;
+    mcflags[icell][1] = config;
+    mcflags[icell][2] = subconfig;
+    mcflags[icell][3] = nsurf;
+
+    // store tris in newpts, with pts in order they are added to Surf
+
+    if (nnew + nsurf > maxnew) {
+      maxnew += DELTA;
+      memory->grow(newpts,9*maxnew,"marching_cubes:newpts");
+    }
+    dest = &newpts[9*nnew];
+    for (i = 0; i < nsurf; i++)
+      for (m = 2; m >= 0; m--) {
+        *dest++ = pt[3*i+m][0];
+        *dest++ = pt[3*i+m][1];
+        *dest++ = pt[3*i+m][2];
       }
-      break;
 
-    case  7:
-      if (test_face(test7[config][0])) subconfig +=  1;
-      if (test_face(test7[config][1])) subconfig +=  2;
-      if (test_face(test7[config][2])) subconfig +=  4;
-      switch (subconfig) {
-      case 0:
-        nsurf = add_triangle(tiling7_1[config], 3); break;
-      case 1:
-        nsurf = add_triangle(tiling7_2[config][0], 5); break;
-      case 2:
-        nsurf = add_triangle(tiling7_2[config][1], 5); break;
-      case 3:
-        nsurf = add_triangle(tiling7_3[config][0], 9); break;
-      case 4:
-        nsurf = add_triangle(tiling7_2[config][2], 5); break;
-      case 5:
-        nsurf = add_triangle(tiling7_3[config][1], 9); break;
-      case 6:
-        nsurf = add_triangle(tiling7_3[config][2], 9); break;
-      case 7:
-        if (test_interior(test7[config][3],icase))
-          nsurf = add_triangle(tiling7_4_2[config], 9);
-        else
-          nsurf = add_triangle(tiling7_4_1[config], 5);
-        break;
-      };
-      break;
+    reuse[icell] = 0;
+    first[icell] = nnew;
+    count[icell] = nsurf;
+    nnew += nsurf;
+
+    if (restricted) {
+      cache_id[icell] = cells[icell].id;
+      cache_type[icell] = itype;
+      cache_flags[icell][0] = icase;
+      cache_flags[icell][1] = config;
+      cache_flags[icell][2] = subconfig;
+      for (j = 0; j < 8; j++) cache_values[icell][j] = cvalues[icell][j];
+    }
+  }
 
-    case  8:
-      nsurf = add_triangle(tiling8[config], 2);
-      break;
+  // prefix sum of counts = offset of each cell's 1st tri
+  // insure Surf and cache have room for all tris
 
-    case  9:
-      nsurf = add_triangle(tiling9[config], 4);
-      break;
+  int ntotal = 0;
+  for (icell = 0; icell < nglocal; icell++) {
+    offset[icell] = ntotal;
+    if (count[icell] > 0) ntotal += count[icell];
+  }
 
-    case 10:
-      if (test_face(test10[config][0])) {
-        if (test_face(test10[config][1]))
-          nsurf = add_triangle(tiling10_1_1_[config], 4); // 10.1.1
-        else {
-          nsurf = add_triangle(tiling10_2[config], 8); // 10.2
-        }
-      } else {
-        if (test_face(test10[config][1])) {
-          nsurf = add_triangle(tiling10_2_[config], 8); // 10.2
-        } else {
-          if (test_interior(test10[config][2],icase))
-            nsurf = add_triangle(tiling10_1_1[config], 4); // 10.1.1
-          else
-            nsurf = add_triangle(tiling10_1_2[config], 8); // 10.1.2
-        }
+  surf->reserve(ntotal);
+  if (restricted && ntotal > maxnext) {
+    maxnext = ntotal;
+    memory->destroy(cachepts_next);
+    memory->create(cachepts_next,9*maxnext,"marching_cubes:cachepts");
+  }
+
+  // csurfs pages are allocated serially, in cell order
+
+  int nbase = surf->nlocal;
+
+  for (icell = 0; icell < nglocal; icell++) {
+    nsurf = count[icell];
+    if (nsurf < 0) continue;
+    ptr = csurfs->get(nsurf);
+    for (i = 0; i < nsurf; i++) ptr[i] = nbase + offset[icell] + i;
+    cells[icell].nsurf = nsurf;
+    if (nsurf) {
+      cells[icell].csurfs = ptr;
+      cinfo[icell].type = OVERLAP;
+    }
+  }
+
+  // 2nd pass: populate Surf data structs
+  // each cell writes only its own slots of tris list and cache
+  // points will be duplicated, not unique
+  // surf ID = cell ID for all surfs in cell
+
+  for (icell = 0; icell < nglocal; icell++) {
+    nsurf = count[icell];
+    if (nsurf <= 0) {
+      if (nsurf == 0) cache_n[icell] = 0;
+      continue;
+    }
+
+    if (reuse[icell]) src = &cachepts[9*first_cache[icell]];
+    else src = &newpts[9*first[icell]];
+
+    itype = svalues ? svalues[icell] : 1;
+    isurf = nbase + offset[icell];
+
+    for (i = 0; i < nsurf; i++)
+      surf->set_tri(isurf+i,cells[icell].id,itype,
+                    &src[9*i],&src[9*i+3],&src[9*i+6]);
+
+    if (restricted) {
+      dest = &cachepts_next[9*offset[icell]];
+      for (i = 0; i < 9*nsurf; i++) dest[i] = src[i];
+      first_cache[icell] = offset[icell];
+      cache_n[icell] = nsurf;
+    }
+  }
+
+  surf->nlocal = nbase + ntotal;
+
+  // cache for next invocation = tris just created, in same order
+
+  if (restricted) {
+    double *tmp = cachepts;
+    cachepts = cachepts_next;
+    cachepts_next = tmp;
+    int itmp = maxcache;
+    maxcache = maxnext;
+    maxnext = itmp;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   compute triangles in one grid cell from its 8 corner point values cv
+   lo/hi = corner points of grid cell
+   return # of tris, their 3*nsurf corner pts are stored in pt
+   return icase = case of the cube, config and subconfig are also set
+------------------------------------------------------------------------- */
+
+int MarchingCubes::cell_tris(double *cv, double *lo_cell, double *hi_cell,
+                             int &icase)
+{
+  int nsurf,which;
+
+  lo = lo_cell;
+  hi = hi_cell;
+
+  // nsurf = # of tris in cell
+  // cvalues[8] = 8 corner point values, each is 0 to 255 inclusive
+  // thresh = value between 0 and 255 to threshhold on
+  // lo[3] = lower left corner pt of grid cell
+  // hi[3] = upper right corner pt of grid cell
+  // pt = list of 3*nsurf points that are the corner pts of each tri
+
+  // cvalues are ordered
+  // bottom-lower-left, bottom-lower-right,
+  // bottom-upper-left, bottom-upper-right
+  // top-lower-left, top-lower-right, top-upper-left, top-upper-right
+  // Vzyx encodes this as 0/1 in each dim
+
+  v000 = cv[0];
+  v001 = cv[1];
+  v010 = cv[2];
+  v011 = cv[3];
+  v100 = cv[4];
+  v101 = cv[5];
+  v110 = cv[6];
+  v111 = cv[7];
+
+  v000iso = v000 - thresh;
+  v001iso = v001 - thresh;
+  v010iso = v010 - thresh;
+  v011iso = v011 - thresh;
+  v100iso = v100 - thresh;
+  v101iso = v101 - thresh;
+  v110iso = v110 - thresh;
+  v111iso = v111 - thresh;
+
+  // make bits 2, 3, 6 and 7 consistent with Lewiner paper (see NOTE above)
+
+  bit0 = v000 <= thresh ? 0 : 1;
+  bit1 = v001 <= thresh ? 0 : 1;
+  bit2 = v011 <= thresh ? 0 : 1;
+  bit3 = v010 <= thresh ? 0 : 1;
+  bit4 = v100 <= thresh ? 0 : 1;
+  bit5 = v101 <= thresh ? 0 : 1;
+  bit6 = v111 <= thresh ? 0 : 1;
+  bit7 = v110 <= thresh ? 0 : 1;
+
+  which = (bit7 << 7) + (bit6 << 6) + (bit5 << 5) + (bit4 << 4) +
+    (bit3 << 3) + (bit2 << 2) + (bit1 << 1) + bit0;
+
+  // icase = case of the active cube in [0..15]
+
+  icase = cases[which][0];
+  config = cases[which][1];
+  subconfig = 0;
+
+  switch (icase) {
+  case  0:
+    nsurf = 0;
+    break;
+
+  case  1:
+    nsurf = add_triangle(tiling1[config], 1);
+    break;
+
+  case  2:
+    nsurf = add_triangle(tiling2[config], 2);
+    break;
+
+  case  3:
+    if (test_face(test3[config]))
+      nsurf = add_triangle(tiling3_2[config], 4); // 3.2
+    else
+      nsurf = add_triangle(tiling3_1[config], 2); // 3.1
+    break;
+
+  case  4:
+    if (modified_test_interior(test4[config],icase))
+      nsurf = add_triangle(tiling4_1[config], 2); // 4.1.1
+    else
+      nsurf = add_triangle(tiling4_2[config], 6); // 4.1.2
+    break;
+
+  case  5:
+    nsurf = add_triangle(tiling5[config], 3);
+    break;
+
+  case  6:
+    if (test_face(test6[config][0]))
+      nsurf = add_triangle(tiling6_2[config], 5); // 6.2
+    else {
+      if (modified_test_interior(test6[config][1],icase))
+        nsurf = add_triangle(tiling6_1_1[config], 3); // 6.1.1
+      else {
+        nsurf = add_triangle(tiling6_1_2[config], 9); // 6.1.2
       }
-      break;
+    }
+    break;
 
-    case 11:
-      nsurf = add_triangle(tiling11[config], 4);
+  case  7:
+    if (test_face(test7[config][0])) subconfig +=  1;
+    if (test_face(test7[config][1])) subconfig +=  2;
+    if (test_face(test7[config][2])) subconfig +=  4;
+    switch (subconfig) {
+    case 0:
+      nsurf = add_triangle(tiling7_1[config], 3); break;
+    case 1:
+      nsurf = add_triangle(tiling7_2[config][0], 5); break;
+    case 2:
+      nsurf = add_triangle(tiling7_2[config][1], 5); break;
+    case 3:
+      nsurf = add_triangle(tiling7_3[config][0], 9); break;
+    case 4:
+      nsurf = add_triangle(tiling7_2[config][2], 5); break;
+    case 5:
+      nsurf = add_triangle(tiling7_3[config][1], 9); break;
+    case 6:
+      nsurf = add_triangle(tiling7_3[config][2], 9); break;
+    case 7:
+      if (test_interior(test7[config][3],icase))
+        nsurf = add_triangle(tiling7_4_2[config], 9);
+      else
+        nsurf = add_triangle(tiling7_4_1[config], 5);
       break;
+    };
+    break;
 
-    case 12:
-      if (test_face(test12[config][0])) {
-        if (test_face(test12[config][1]))
-          nsurf = add_triangle(tiling12_1_1_[config], 4); // 12.1.1
-        else {
-          nsurf = add_triangle(tiling12_2[config], 8); // 12.2
-        }
+  case  8:
+    nsurf = add_triangle(tiling8[config], 2);
+    break;
+
+  case  9:
+    nsurf = add_triangle(tiling9[config], 4);
+    break;
+
+  case 10:
+    if (test_face(test10[config][0])) {
+      if (test_face(test10[config][1]))
+        nsurf = add_triangle(tiling10_1_1_[config], 4); // 10.1.1
+      else {
+        nsurf = add_triangle(tiling10_2[config], 8); // 10.2
+      }
+    } else {
+      if (test_face(test10[config][1])) {
+        nsurf = add_triangle(tiling10_2_[config], 8); // 10.2
       } else {
-        if (test_face(test12[config][1])) {
-          nsurf = add_triangle(tiling12_2_[config], 8); // 12.2
-        } else {
-          if (test_interior(test12[config][2],icase))
-            nsurf = add_triangle(tiling12_1_1[config], 4); // 12.1.1
-          else
-            nsurf = add_triangle(tiling12_1_2[config], 8); // 12.1.2
-        }
+        if (test_interior(test10[config][2],icase))
+          nsurf = add_triangle(tiling10_1_1[config], 4); // 10.1.1
+        else
+          nsurf = add_triangle(tiling10_1_2[config], 8); // 10.1.2
       }
-      break;
+    }
+    break;
 
-    case 13:
-      if (test_face(test13[config][0])) subconfig +=  1;
-      if (test_face(test13[config][1])) subconfig +=  2;
-      if (test_face(test13[config][2])) subconfig +=  4;
-      if (test_face(test13[config][3])) subconfig +=  8;
-      if (test_face(test13[config][4])) subconfig += 16;
-      if (test_face(test13[config][5])) subconfig += 32;
-
-      switch (subconfig13[subconfig]) {
-      case 0:/* 13.1 */
-        nsurf = add_triangle(tiling13_1[config], 4); break;
-
-      case 1:/* 13.2 */
-        nsurf = add_triangle(tiling13_2[config][0], 6); break;
-      case 2:/* 13.2 */
-        nsurf = add_triangle(tiling13_2[config][1], 6); break;
-      case 3:/* 13.2 */
-        nsurf = add_triangle(tiling13_2[config][2], 6); break;
-      case 4:/* 13.2 */
-        nsurf = add_triangle(tiling13_2[config][3], 6); break;
-      case 5:/* 13.2 */
-        nsurf = add_triangle(tiling13_2[config][4], 6); break;
-      case 6:/* 13.2 */
-        nsurf = add_triangle(tiling13_2[config][5], 6); break;
-
-      case 7:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][0], 10); break;
-      case 8:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][1], 10); break;
-      case 9:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][2], 10); break;
-      case 10:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][3], 10); break;
-      case 11:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][4], 10); break;
-      case 12:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][5], 10); break;
-      case 13:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][6], 10); break;
-      case 14:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][7], 10); break;
-      case 15:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][8], 10); break;
-      case 16:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][9], 10); break;
-      case 17:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][10], 10); break;
-      case 18:/* 13.3 */
-        nsurf = add_triangle(tiling13_3[config][11], 10); break;
-
-      case 19:/* 13.4 */
-        nsurf = add_triangle(tiling13_4[config][0], 12); break;
-      case 20:/* 13.4 */
-        nsurf = add_triangle(tiling13_4[config][1], 12); break;
-      case 21:/* 13.4 */
-        nsurf = add_triangle(tiling13_4[config][2], 12); break;
-      case 22:/* 13.4 */
-        nsurf = add_triangle(tiling13_4[config][3], 12); break;
-
-      case 23:/* 13.5 */
-        subconfig = 0;
-        if (interior_test_case13())
-          nsurf = add_triangle(tiling13_5_1[config][0], 6);
-        else
-          nsurf = add_triangle(tiling13_5_2[config][0], 10);
-        break;
+  case 11:
+    nsurf = add_triangle(tiling11[config], 4);
+    break;
 
-      case 24:/* 13.5 */
-        subconfig = 1;
-        if (interior_test_case13())
-          nsurf = add_triangle(tiling13_5_1[config][1], 6);
+  case 12:
+    if (test_face(test12[config][0])) {
+      if (test_face(test12[config][1]))
+        nsurf = add_triangle(tiling12_1_1_[config], 4); // 12.1.1
+      else {
+        nsurf = add_triangle(tiling12_2[config], 8); // 12.2
+      }
+    } else {
+      if (test_face(test12[config][1])) {
+        nsurf = add_triangle(tiling12_2_[config], 8); // 12.2
+      } else {
+        if (test_interior(test12[config][2],icase))
+          nsurf = add_triangle(tiling12_1_1[config], 4); // 12.1.1
         else
-          nsurf = add_triangle(tiling13_5_2[config][1], 10);
-        break;
+          nsurf = add_triangle(tiling12_1_2[config], 8); // 12.1.2
+      }
+    }
+    break;
 
-      case 25:/* 13.5 */
-        subconfig = 2;
-        if (interior_test_case13())
-          nsurf = add_triangle(tiling13_5_1[config][2], 6);
-        else
-          nsurf = add_triangle(tiling13_5_2[config][2], 10);
-        break;
+  case 13:
+    if (test_face(test13[config][0])) subconfig +=  1;
+    if (test_face(test13[config][1])) subconfig +=  2;
+    if (test_face(test13[config][2])) subconfig +=  4;
+    if (test_face(test13[config][3])) subconfig +=  8;
+    if (test_face(test13[config][4])) subconfig += 16;
+    if (test_face(test13[config][5])) subconfig += 32;
+
+    switch (subconfig13[subconfig]) {
+    case 0:/* 13.1 */
+      nsurf = add_triangle(tiling13_1[config], 4); break;
+
+    case 1:/* 13.2 */
+      nsurf = add_triangle(tiling13_2[config][0], 6); break;
+    case 2:/* 13.2 */
+      nsurf = add_triangle(tiling13_2[config][1], 6); break;
+    case 3:/* 13.2 */
+      nsurf = add_triangle(tiling13_2[config][2], 6); break;
+    case 4:/* 13.2 */
+      nsurf = add_triangle(tiling13_2[config][3], 6); break;
+    case 5:/* 13.2 */
+      nsurf = add_triangle(tiling13_2[config][4], 6); break;
+    case 6:/* 13.2 */
+      nsurf = add_triangle(tiling13_2[config][5], 6); break;
+
+    case 7:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][0], 10); break;
+    case 8:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][1], 10); break;
+    case 9:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][2], 10); break;
+    case 10:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][3], 10); break;
+    case 11:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][4], 10); break;
+    case 12:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][5], 10); break;
+    case 13:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][6], 10); break;
+    case 14:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][7], 10); break;
+    case 15:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][8], 10); break;
+    case 16:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][9], 10); break;
+    case 17:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][10], 10); break;
+    case 18:/* 13.3 */
+      nsurf = add_triangle(tiling13_3[config][11], 10); break;
+
+    case 19:/* 13.4 */
+      nsurf = add_triangle(tiling13_4[config][0], 12); break;
+    case 20:/* 13.4 */
+      nsurf = add_triangle(tiling13_4[config][1], 12); break;
+    case 21:/* 13.4 */
+      nsurf = add_triangle(tiling13_4[config][2], 12); break;
+    case 22:/* 13.4 */
+      nsurf = add_triangle(tiling13_4[config][3], 12); break;
+
+    case 23:/* 13.5 */
+      subconfig = 0;
+      if (interior_test_case13())
+        nsurf = add_triangle(tiling13_5_1[config][0], 6);
+      else
+        nsurf = add_triangle(tiling13_5_2[config][0], 10);
+      break;
 
-      case 26:/* 13.5 */
-        subconfig = 3;
-        if (interior_test_case13())
-          nsurf = add_triangle(tiling13_5_1[config][3], 6);
-        else
-          nsurf = add_triangle(tiling13_5_2[config][3], 10);
-        break;
+    case 24:/* 13.5 */
+      subconfig = 1;
+      if (interior_test_case13())
+        nsurf = add_triangle(tiling13_5_1[config][1], 6);
+      else
+        nsurf = add_triangle(tiling13_5_2[config][1], 10);
+      break;
 
-      case 27:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][0], 10); break;
-      case 28:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][1], 10); break;
-      case 29:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][2], 10); break;
-      case 30:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][3], 10); break;
-      case 31:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][4], 10); break;
-      case 32:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][5], 10); break;
-      case 33:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][6], 10); break;
-      case 34:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][7], 10); break;
-      case 35:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][8], 10); break;
-      case 36:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][9], 10); break;
-      case 37:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][10], 10); break;
-      case 38:/* 13.3 */
-        nsurf = add_triangle(tiling13_3_[config][11], 10); break;
-
-      case 39:/* 13.2 */
-        nsurf = add_triangle(tiling13_2_[config][0], 6); break;
-      case 40:/* 13.2 */
-        nsurf = add_triangle(tiling13_2_[config][1], 6); break;
-      case 41:/* 13.2 */
-        nsurf = add_triangle(tiling13_2_[config][2], 6); break;
-      case 42:/* 13.2 */
-        nsurf = add_triangle(tiling13_2_[config][3], 6); break;
-      case 43:/* 13.2 */
-        nsurf = add_triangle(tiling13_2_[config][4], 6); break;
-      case 44:/* 13.2 */
-        nsurf = add_triangle(tiling13_2_[config][5], 6); break;
-
-      case 45:/* 13.1 */
-        nsurf = add_triangle(tiling13_1_[config], 4); break;
-
-      default:
-        print_cube();
-        error->one(FLERR,"Marching cubes - impossible case 13");
-      }
+    case 25:/* 13.5 */
+      subconfig = 2;
+      if (interior_test_case13())
+        nsurf = add_triangle(tiling13_5_1[config][2], 6);
+      else
+        nsurf = add_triangle(tiling13_5_2[config][2], 10);
       break;
 
-    case 14:
-      nsurf = add_triangle(tiling14[config], 4);
+    case 26:/* 13.5 */
+      subconfig = 3;
+      if (interior_test_case13())
+        nsurf = add_triangle(tiling13_5_1[config][3], 6);
+      else
+        nsurf = add_triangle(tiling13_5_2[config][3], 10);
       break;
-    };
 
-    // store 4 MC labels for FixAblate caller
+    case 27:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][0], 10); break;
+    case 28:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][1], 10); break;
+    case 29:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][2], 10); break;
+    case 30:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][3], 10); break;
+    case 31:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][4], 10); break;
+    case 32:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][5], 10); break;
+    case 33:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][6], 10); break;
+    case 34:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][7], 10); break;
+    case 35:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][8], 10); break;
+    case 36:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][9], 10); break;
+    case 37:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][10], 10); break;
+    case 38:/* 13.3 */
+      nsurf = add_triangle(tiling13_3_[config][11], 10); break;
+
+    case 39:/* 13.2 */
+      nsurf = add_triangle(tiling13_2_[config][0], 6); break;
+    case 40:/* 13.2 */
+      nsurf = add_triangle(tiling13_2_[config][1], 6); break;
+    case 41:/* 13.2 */
+      nsurf = add_triangle(tiling13_2_[config][2], 6); break;
+    case 42:/* 13.2 */
+      nsurf = add_triangle(tiling13_2_[config][3], 6); break;
+    case 43:/* 13.2 */
+      nsurf = add_triangle(tiling13_2_[config][4], 6); break;
+    case 44:/* 13.2 */
+      nsurf = add_triangle(tiling13_2_[config][5], 6); break;
+
+    case 45:/* 13.1 */
+      nsurf = add_triangle(tiling13_1_[config], 4); break;
 
-    mcflags[icell][0] = icase;
-    mcflags[icell][1] = config;
-    mcflags[icell][2] = subconfig;
-    mcflags[icell][3] = nsurf;
+    default:
+      print_cube();
+      error->one(FLERR,"Marching cubes - impossible case 13");
+    }
+    break;
 
-    // populate Grid and Surf data structs
-    // points will be duplicated, not unique
-    // surf ID = cell ID for all surfs in cell
+  case 14:
+    nsurf = add_triangle(tiling14[config], 4);
+    break;
+  };
 
-    ptr = csurfs->get(nsurf);
+  return nsurf;
+}
 
-    ipt = 0;
-    for (i = 0; i < nsurf; i++) {
-      if (svalues) surf->add_tri(cells[icell].id,svalues[icell],
-                                 pt[ipt+2],pt[ipt+1],pt[ipt]);
-      else surf->add_tri(cells[icell].id,1,pt[ipt+2],pt[ipt+1],pt[ipt]);
-      ipt += 3;
-      isurf = surf->nlocal - 1;
-      ptr[i] = isurf;
-    }
+/* ----------------------------------------------------------------------
+   insure per-cell vectors are allocated for N cells
+   new cells have no valid cached tris
+------------------------------------------------------------------------- */
 
-    cells[icell].nsurf = nsurf;
-    if (nsurf) {
-      cells[icell].csurfs = ptr;
-      cinfo[icell].type = OVERLAP;
-    }
-  }
+void MarchingCubes::grow_cell(int n)
+{
+  if (n <= maxcell) return;
+
+  memory->grow(count,n,"marching_cubes:count");
+  memory->grow(offset,n,"marching_cubes:offset");
+  memory->grow(first,n,"marching_cubes:first");
+  memory->grow(reuse,n,"marching_cubes:reuse");
+  memory->grow(cache_id,n,"marching_cubes:cache_id");
+  memory->grow(cache_type,n,"marching_cubes:cache_type");
+  memory->grow(cache_n,n,"marching_cubes:cache_n");
+  memory->grow(first_cache,n,"marching_cubes:first_cache");
+  memory->grow(cache_flags,n,3,"marching_cubes:cache_flags");
+  memory->grow(cache_values,n,8,"marching_cubes:cache_values");
+
+  for (int i = maxcell; i < n; i++) cache_id[i] = 0;
+  maxcell = n;
 }
 
 /* ----------------------------------------------------------------------
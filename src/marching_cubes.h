@@ -22,8 +22,11 @@ namespace SPARTA_NS {
 
 class MarchingCubes : protected Pointers {
  public:
+  int restricted;         // 1 to only regenerate cells whose corner
+                          //   values changed since last invoke()
+
   MarchingCubes(class SPARTA *, int, double);
-  ~MarchingCubes() {}
+  ~MarchingCubes();
   void invoke(double **, int *, int **);
   void cleanup();
 
@@ -40,6 +43,28 @@ class MarchingCubes : protected Pointers {
   int config;     // configuration of the active cube
   int subconfig;  // subconfiguration of the active cube
 
+  // per-cell info for two-pass invoke(), indexed by local cell
+
+  int maxcell;
+  int *count;             // # of tris in cell, -1 if cell is skipped
+  int *offset;            // offset of cell's 1st tri in new tris
+  int *first;             // index of cell's 1st tri in newpts
+  int *reuse;             // 1 if cell's cached tris are reused
+
+  // cache of tris from last invoke(), for restricted mode
+
+  cellint *cache_id;      // ID of cell tris were cached for, 0 if none
+  int *cache_type;        // surf type of cached tris
+  int *cache_n;           // # of cached tris
+  int *first_cache;       // index of cell's 1st tri in cachepts
+  int **cache_flags;      // case,config,subconfig of cached tris
+  double **cache_values;  // corner values cached tris were computed from
+
+  int maxnew,maxcache,maxnext;
+  double *newpts;         // 3 corner pts of tris computed this pass
+  double *cachepts;       // 3 corner pts of tris cached from last invoke()
+  double *cachepts_next;  // cache being built by this invoke()
+
   // message datums for cleanup()
 
   struct SendDatum {
@@ -49,6 +74,8 @@ class MarchingCubes : protected Pointers {
     Surf::Tri tri1,tri2;
   };
 
+  void grow_cell(int);
+  int cell_tris(double *, double *, double *, int &);
   double interpolate(double, double, double, double);
   int add_triangle(int *, int);
   bool test_face(int);
@@ -15,11 +15,14 @@
 #include "marching_squares.h"
 #include "grid.h"
 #include "surf.h"
+#include "memory.h"
 
 using namespace SPARTA_NS;
 
 enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};           // several files
 
+#define DELTA 1024
+
 /* ---------------------------------------------------------------------- */
 
 MarchingSquares::MarchingSquares(SPARTA *sparta, int ggroup_caller,
@@ -28,6 +31,34 @@ MarchingSquares::MarchingSquares(SPARTA *sparta, int ggroup_caller,
 {
   ggroup = ggroup_caller;
   thresh = thresh_caller;
+  restricted = 0;
+
+  maxcell = 0;
+  count = offset = first = reuse = NULL;
+  cache_id = NULL;
+  cache_type = cache_n = first_cache = NULL;
+  cache_values = NULL;
+
+  maxnew = maxcache = maxnext = 0;
+  newpts = cachepts = cachepts_next = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+MarchingSquares::~MarchingSquares()
+{
+  memory->destroy(count);
+  memory->destroy(offset);
+  memory->destroy(first);
+  memory->destroy(reuse);
+  memory->destroy(cache_id);
+  memory->destroy(cache_type);
+  memory->destroy(cache_n);
+  memory->destroy(first_cache);
+  memory->destroy(cache_values);
+  memory->destroy(newpts);
+  memory->destroy(cachepts);
+  memory->destroy(cachepts_next);
 }
 
 /* ----------------------------------------------------------------------
@@ -45,229 +76,380 @@ MarchingSquares::MarchingSquares(SPARTA *sparta, int ggroup_caller,
    order 2 points in each line segment to give normal into flow volume
    treat two saddle point cases (my 9,6) (Wiki 5,10)
      based on ave value at cell center
+   two passes over cells:
+     1st pass counts lines in each cell and computes them into newpts,
+       in restricted mode a cell whose corner values are unchanged since
+       the last invocation reuses its cached lines
+     prefix sum of counts gives each cell its slots in Surf lines list
+     2nd pass writes each cell's lines into its own slots,
+       so no cell depends on another and cells could be done in parallel
 ------------------------------------------------------------------------- */
 
 void MarchingSquares::invoke(double **cvalues, int *svalues)
 {
-  int i,ipt,isurf,nsurf,which,splitflag;
-  double v00,v01,v10,v11;
-  int bit0,bit1,bit2,bit3;
-  double ave;
-  double *lo,*hi;
+  int i,j,icell,isurf,nsurf,itype;
+  double *src,*dest;
   surfint *ptr;
 
-  double pt[4][3];
-  pt[0][2] = pt[1][2] = pt[2][2] = pt[3][2] = 0.0;
-
   Grid::ChildCell *cells = grid->cells;
   Grid::ChildInfo *cinfo = grid->cinfo;
   MyPage<surfint> *csurfs = grid->csurfs;
   int nglocal = grid->nlocal;
   int groupbit = grid->bitmask[ggroup];
 
-  for (int icell = 0; icell < nglocal; icell++) {
-    if (!(cinfo[icell].mask & groupbit)) continue;
-    if (cells[icell].nsplit <= 0) continue;
-    lo = cells[icell].lo;
-    hi = cells[icell].hi;
+  grow_cell(nglocal);
 
-    // cvalues are ordered lower-left, lower-right, upper-left, upper-right
-    // Vyx encodes this as 0/1 in each dim
+  // 1st pass: count lines in each cell
+  // reuse = 1 if cell's cached lines are still valid
 
-    v00 = cvalues[icell][0];
-    v01 = cvalues[icell][1];
-    v10 = cvalues[icell][2];
-    v11 = cvalues[icell][3];
+  double pt[4][3];
+  pt[0][2] = pt[1][2] = pt[2][2] = pt[3][2] = 0.0;
 
-    // make last 2 bits consistent with Wiki page (see NOTE above)
+  int nnew = 0;
 
-    bit0 = v00 <= thresh ? 0 : 1;
-    bit1 = v01 <= thresh ? 0 : 1;
-    bit2 = v11 <= thresh ? 0 : 1;
-    bit3 = v10 <= thresh ? 0 : 1;
+  for (icell = 0; icell < nglocal; icell++) {
+    count[icell] = -1;
+    if (!(cinfo[icell].mask & groupbit)) {
+      cache_id[icell] = 0;
+      continue;
+    }
+    if (cells[icell].nsplit <= 0) {
+      cache_id[icell] = 0;
+      continue;
+    }
 
-    which = (bit3 << 3) + (bit2 << 2) + (bit1 << 1) + bit0;
-    splitflag = 0;
+    itype = svalues ? svalues[icell] : 1;
+
+    if (restricted && cache_id[icell] == cells[icell].id &&
+        cache_type[icell] == itype &&
+        cache_values[icell][0] == cvalues[icell][0] &&
+        cache_values[icell][1] == cvalues[icell][1] &&
+        cache_values[icell][2] == cvalues[icell][2] &&
+        cache_values[icell][3] == cvalues[icell][3]) {
+      reuse[icell] = 1;
+      count[icell] = cache_n[icell];
+      continue;
+    }
 
-    switch (which) {
+    nsurf = cell_lines(cvalues[icell],cells[icell].lo,cells[icell].hi,pt);
 
-    case 0:
-      nsurf = 0;
-      break;
+    if (nnew + nsurf > maxnew) {
+      maxnew += DELTA;
+      memory->grow(newpts,4*maxnew,"marching_squares:newpts");
+    }
+    dest = &newpts[4*nnew];
+    for (i = 0; i < 2*nsurf; i++) {
+      dest[2*i] = pt[i][0];
+      dest[2*i+1] = pt[i][1];
+    }
 
-    case 1:
-      nsurf = 1;
-      pt[0][0] = lo[0];
-      pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
-      pt[1][0] = interpolate(v00,v01,lo[0],hi[0]);
-      pt[1][1] = lo[1];
-      break;
+    reuse[icell] = 0;
+    first[icell] = nnew;
+    count[icell] = nsurf;
+    nnew += nsurf;
 
-    case 2:
-      nsurf = 1;
-      pt[0][0] = interpolate(v00,v01,lo[0],hi[0]);
-      pt[0][1] = lo[1];
-      pt[1][0] = hi[0];
-      pt[1][1] = interpolate(v01,v11,lo[1],hi[1]);
-      break;
+    if (restricted) {
+      cache_id[icell] = cells[icell].id;
+      cache_type[icell] = itype;
+      for (j = 0; j < 4; j++) cache_values[icell][j] = cvalues[icell][j];
+    }
+  }
+
+  // prefix sum of counts = offset of each cell's 1st line
+  // insure Surf and cache have room for all lines
+
+  int ntotal = 0;
+  for (icell = 0; icell < nglocal; icell++) {
+    offset[icell] = ntotal;
+    if (count[icell] > 0) ntotal += count[icell];
+  }
+
+  surf->reserve(ntotal);
+  if (restricted && ntotal > maxnext) {
+    maxnext = ntotal;
+    memory->destroy(cachepts_next);
+    memory->create(cachepts_next,4*maxnext,"marching_squares:cachepts");
+  }
+
+  // csurfs pages are allocated serially, in cell order
+
+  int nbase = surf->nlocal;
+
+  for (icell = 0; icell < nglocal; icell++) {
+    nsurf = count[icell];
+    if (nsurf < 0) continue;
+    ptr = csurfs->get(nsurf);
+    for (i = 0; i < nsurf; i++) ptr[i] = nbase + offset[icell] + i;
+    cells[icell].nsurf = nsurf;
+    if (nsurf) {
+      cells[icell].csurfs = ptr;
+      cinfo[icell].type = OVERLAP;
+    }
+  }
+
+  // 2nd pass: populate Surf data structs
+  // each cell writes only its own slots of lines list and cache
+  // points will be duplicated, not unique
+  // surf ID = cell ID for all surfs in cell
+
+  double p1[2],p2[2];
+
+  for (icell = 0; icell < nglocal; icell++) {
+    nsurf = count[icell];
+    if (nsurf <= 0) {
+      if (nsurf == 0) cache_n[icell] = 0;
+      continue;
+    }
+
+    if (reuse[icell]) src = &cachepts[4*first_cache[icell]];
+    else src = &newpts[4*first[icell]];
+
+    itype = svalues ? svalues[icell] : 1;
+    isurf = nbase + offset[icell];
+
+    for (i = 0; i < nsurf; i++) {
+      p1[0] = src[4*i];
+      p1[1] = src[4*i+1];
+      p2[0] = src[4*i+2];
+      p2[1] = src[4*i+3];
+      surf->set_line(isurf+i,cells[icell].id,itype,p1,p2);
+    }
+
+    if (restricted) {
+      dest = &cachepts_next[4*offset[icell]];
+      for (i = 0; i < 4*nsurf; i++) dest[i] = src[i];
+      first_cache[icell] = offset[icell];
+      cache_n[icell] = nsurf;
+    }
+  }
+
+  surf->nlocal = nbase + ntotal;
 
-    case 3:
-      nsurf = 1;
+  // cache for next invocation = lines just created, in same order
+
+  if (restricted) {
+    double *tmp = cachepts;
+    cachepts = cachepts_next;
+    cachepts_next = tmp;
+    int itmp = maxcache;
+    maxcache = maxnext;
+    maxnext = itmp;
+  }
+}
+
+/* ----------------------------------------------------------------------
+   compute 0,1,2 lines in one grid cell from its 4 corner point values cv
+   lo/hi = corner points of grid cell
+   return # of lines, their end points are stored consecutively in pt
+------------------------------------------------------------------------- */
+
+int MarchingSquares::cell_lines(double *cv, double *lo, double *hi,
+                                double pt[4][3])
+{
+  int nsurf,which,splitflag;
+  double v00,v01,v10,v11;
+  int bit0,bit1,bit2,bit3;
+  double ave;
+
+  // cvalues are ordered lower-left, lower-right, upper-left, upper-right
+  // Vyx encodes this as 0/1 in each dim
+
+  v00 = cv[0];
+  v01 = cv[1];
+  v10 = cv[2];
+  v11 = cv[3];
+
+  // make last 2 bits consistent with Wiki page (see NOTE above)
+
+  bit0 = v00 <= thresh ? 0 : 1;
+  bit1 = v01 <= thresh ? 0 : 1;
+  bit2 = v11 <= thresh ? 0 : 1;
+  bit3 = v10 <= thresh ? 0 : 1;
+
+  which = (bit3 << 3) + (bit2 << 2) + (bit1 << 1) + bit0;
+  splitflag = 0;
+
+  switch (which) {
+
+  case 0:
+    nsurf = 0;
+    break;
+
+  case 1:
+    nsurf = 1;
+    pt[0][0] = lo[0];
+    pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
+    pt[1][0] = interpolate(v00,v01,lo[0],hi[0]);
+    pt[1][1] = lo[1];
+    break;
+
+  case 2:
+    nsurf = 1;
+    pt[0][0] = interpolate(v00,v01,lo[0],hi[0]);
+    pt[0][1] = lo[1];
+    pt[1][0] = hi[0];
+    pt[1][1] = interpolate(v01,v11,lo[1],hi[1]);
+    break;
+
+  case 3:
+    nsurf = 1;
+    pt[0][0] = lo[0];
+    pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
+    pt[1][0] = hi[0];
+    pt[1][1] = interpolate(v01,v11,lo[1],hi[1]);
+    break;
+
+  case 4:
+    nsurf = 1;
+    pt[0][0] = hi[0];
+    pt[0][1] = interpolate(v01,v11,lo[1],hi[1]);
+    pt[1][0] = interpolate(v10,v11,lo[0],hi[0]);
+    pt[1][1] = hi[1];
+    break;
+
+  case 5:
+    nsurf = 2;
+    ave = 0.25 * (v00 + v01 + v10 + v11);
+    if (ave > thresh) {
+      splitflag = 1;
       pt[0][0] = lo[0];
       pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
-      pt[1][0] = hi[0];
-      pt[1][1] = interpolate(v01,v11,lo[1],hi[1]);
-      break;
-
-    case 4:
-      nsurf = 1;
-      pt[0][0] = hi[0];
-      pt[0][1] = interpolate(v01,v11,lo[1],hi[1]);
-      pt[1][0] = interpolate(v10,v11,lo[0],hi[0]);
-      pt[1][1] = hi[1];
-      break;
-
-    case 5:
-      nsurf = 2;
-      ave = 0.25 * (v00 + v01 + v10 + v11);
-      if (ave > thresh) {
-        splitflag = 1;
-        pt[0][0] = lo[0];
-        pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
-        pt[1][0] = interpolate(v10,v11,lo[0],hi[0]);
-        pt[1][1] = hi[1];
-        pt[2][0] = hi[0];
-        pt[2][1] = interpolate(v01,v11,lo[1],hi[1]);
-        pt[3][0] = interpolate(v00,v01,lo[0],hi[0]);
-        pt[3][1] = lo[1];
-      } else {
-        pt[0][0] = lo[0];
-        pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
-        pt[1][0] = interpolate(v00,v01,lo[0],hi[0]);
-        pt[1][1] = lo[1];
-        pt[2][0] = hi[0];
-        pt[2][1] = interpolate(v01,v11,lo[1],hi[1]);
-        pt[3][0] = interpolate(v10,v11,lo[0],hi[0]);
-        pt[3][1] = hi[1];
-      }
-      break;
-
-    case 6:
-      nsurf = 1;
-      pt[0][0] = interpolate(v00,v01,lo[0],hi[0]);
-      pt[0][1] = lo[1];
       pt[1][0] = interpolate(v10,v11,lo[0],hi[0]);
       pt[1][1] = hi[1];
-      break;
-
-    case 7:
-      nsurf = 1;
+      pt[2][0] = hi[0];
+      pt[2][1] = interpolate(v01,v11,lo[1],hi[1]);
+      pt[3][0] = interpolate(v00,v01,lo[0],hi[0]);
+      pt[3][1] = lo[1];
+    } else {
       pt[0][0] = lo[0];
       pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
-      pt[1][0] = interpolate(v10,v11,lo[0],hi[0]);
-      pt[1][1] = hi[1];
-      break;
-
-    case 8:
-      nsurf = 1;
-      pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
-      pt[0][1] = hi[1];
-      pt[1][0] = lo[0];
-      pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
-      break;
-
-    case 9:
-      nsurf = 1;
-      pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
-      pt[0][1] = hi[1];
-      pt[1][0] = interpolate(v00,v01,lo[0],hi[0]);
-      pt[1][1] = lo[1];
-      break;
-
-    case 10:
-      nsurf = 2;
-      ave = 0.25 * (v00 + v01 + v10 + v11);
-      if (ave > thresh) {
-        splitflag = 1;
-        pt[0][0] = interpolate(v00,v01,lo[0],hi[0]);
-        pt[0][1] = lo[1];
-        pt[1][0] = lo[0];
-        pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
-        pt[2][0] = interpolate(v10,v11,lo[0],hi[0]);
-        pt[2][1] = hi[1];
-        pt[3][0] = hi[0];
-        pt[3][1] = interpolate(v01,v11,lo[1],hi[1]);
-      } else {
-        pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
-        pt[0][1] = hi[1];
-        pt[1][0] = lo[0];
-        pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
-        pt[2][0] = interpolate(v00,v01,lo[0],hi[0]);
-        pt[2][1] = lo[1];
-        pt[3][0] = hi[0];
-        pt[3][1] = interpolate(v01,v11,lo[1],hi[1]);
-      }
-      break;
-
-    case 11:
-      nsurf = 1;
-      pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
-      pt[0][1] = hi[1];
-      pt[1][0] = hi[0];
-      pt[1][1] = interpolate(v01,v11,lo[1],hi[1]);
-      break;
-
-    case 12:
-      nsurf = 1;
-      pt[0][0] = hi[0];
-      pt[0][1] = interpolate(v01,v11,lo[1],hi[1]);
-      pt[1][0] = lo[0];
-      pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
-      break;
-
-    case 13:
-      nsurf = 1;
-      pt[0][0] = hi[0];
-      pt[0][1] = interpolate(v01,v11,lo[1],hi[1]);
       pt[1][0] = interpolate(v00,v01,lo[0],hi[0]);
       pt[1][1] = lo[1];
-      break;
-
-    case 14:
-      nsurf = 1;
+      pt[2][0] = hi[0];
+      pt[2][1] = interpolate(v01,v11,lo[1],hi[1]);
+      pt[3][0] = interpolate(v10,v11,lo[0],hi[0]);
+      pt[3][1] = hi[1];
+    }
+    break;
+
+  case 6:
+    nsurf = 1;
+    pt[0][0] = interpolate(v00,v01,lo[0],hi[0]);
+    pt[0][1] = lo[1];
+    pt[1][0] = interpolate(v10,v11,lo[0],hi[0]);
+    pt[1][1] = hi[1];
+    break;
+
+  case 7:
+    nsurf = 1;
+    pt[0][0] = lo[0];
+    pt[0][1] = interpolate(v00,v10,lo[1],hi[1]);
+    pt[1][0] = interpolate(v10,v11,lo[0],hi[0]);
+    pt[1][1] = hi[1];
+    break;
+
+  case 8:
+    nsurf = 1;
+    pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
+    pt[0][1] = hi[1];
+    pt[1][0] = lo[0];
+    pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
+    break;
+
+  case 9:
+    nsurf = 1;
+    pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
+    pt[0][1] = hi[1];
+    pt[1][0] = interpolate(v00,v01,lo[0],hi[0]);
+    pt[1][1] = lo[1];
+    break;
+
+  case 10:
+    nsurf = 2;
+    ave = 0.25 * (v00 + v01 + v10 + v11);
+    if (ave > thresh) {
+      splitflag = 1;
       pt[0][0] = interpolate(v00,v01,lo[0],hi[0]);
       pt[0][1] = lo[1];
       pt[1][0] = lo[0];
       pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
-      break;
-
-    case 15:
-      nsurf = 0;
-      break;
+      pt[2][0] = interpolate(v10,v11,lo[0],hi[0]);
+      pt[2][1] = hi[1];
+      pt[3][0] = hi[0];
+      pt[3][1] = interpolate(v01,v11,lo[1],hi[1]);
+    } else {
+      pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
+      pt[0][1] = hi[1];
+      pt[1][0] = lo[0];
+      pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
+      pt[2][0] = interpolate(v00,v01,lo[0],hi[0]);
+      pt[2][1] = lo[1];
+      pt[3][0] = hi[0];
+      pt[3][1] = interpolate(v01,v11,lo[1],hi[1]);
     }
+    break;
+
+  case 11:
+    nsurf = 1;
+    pt[0][0] = interpolate(v10,v11,lo[0],hi[0]);
+    pt[0][1] = hi[1];
+    pt[1][0] = hi[0];
+    pt[1][1] = interpolate(v01,v11,lo[1],hi[1]);
+    break;
+
+  case 12:
+    nsurf = 1;
+    pt[0][0] = hi[0];
+    pt[0][1] = interpolate(v01,v11,lo[1],hi[1]);
+    pt[1][0] = lo[0];
+    pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
+    break;
+
+  case 13:
+    nsurf = 1;
+    pt[0][0] = hi[0];
+    pt[0][1] = interpolate(v01,v11,lo[1],hi[1]);
+    pt[1][0] = interpolate(v00,v01,lo[0],hi[0]);
+    pt[1][1] = lo[1];
+    break;
+
+  case 14:
+    nsurf = 1;
+    pt[0][0] = interpolate(v00,v01,lo[0],hi[0]);
+    pt[0][1] = lo[1];
+    pt[1][0] = lo[0];
+    pt[1][1] = interpolate(v00,v10,lo[1],hi[1]);
+    break;
+
+  case 15:
+    nsurf = 0;
+    break;
+  }
 
-    // populate Grid and Surf data structs
-    // points will be duplicated, not unique
-    // surf ID = cell ID for all surfs in cell
-
-    ptr = csurfs->get(nsurf);
+  return nsurf;
+}
 
-    ipt = 0;
-    for (i = 0; i < nsurf; i++) {
-      if (svalues) surf->add_line(cells[icell].id,svalues[icell],
-                                  pt[ipt],pt[ipt+1]);
-      else surf->add_line(cells[icell].id,1,pt[ipt],pt[ipt+1]);
-      ipt += 2;
-      isurf = surf->nlocal - 1;
-      ptr[i] = isurf;
-    }
+/* ----------------------------------------------------------------------
+   insure per-cell vectors are allocated for N cells
+   new cells have no valid cached lines
+------------------------------------------------------------------------- */
 
-    cells[icell].nsurf = nsurf;
-    if (nsurf) {
-      cells[icell].csurfs = ptr;
-      cinfo[icell].type = OVERLAP;
-    }
-  }
+void MarchingSquares::grow_cell(int n)
+{
+  if (n <= maxcell) return;
+
+  memory->grow(count,n,"marching_squares:count");
+  memory->grow(offset,n,"marching_squares:offset");
+  memory->grow(first,n,"marching_squares:first");
+  memory->grow(reuse,n,"marching_squares:reuse");
+  memory->grow(cache_id,n,"marching_squares:cache_id");
+  memory->grow(cache_type,n,"marching_squares:cache_type");
+  memory->grow(cache_n,n,"marching_squares:cache_n");
+  memory->grow(first_cache,n,"marching_squares:first_cache");
+  memory->grow(cache_values,n,4,"marching_squares:cache_values");
+
+  for (int i = maxcell; i < n; i++) cache_id[i] = 0;
+  maxcell = n;
 }
 
 /* ----------------------------------------------------------------------
@@ -21,14 +21,40 @@ namespace SPARTA_NS {
 
 class MarchingSquares : protected Pointers {
  public:
+  int restricted;         // 1 to only regenerate cells whose corner
+                          //   values changed since last invoke()
+
   MarchingSquares(class SPARTA *, int, double);
-  ~MarchingSquares() {}
+  ~MarchingSquares();
   void invoke(double **, int *);
 
  private:
   int ggroup;
   double thresh;
 
+  // per-cell info for two-pass invoke(), indexed by local cell
+
+  int maxcell;
+  int *count;             // # of lines in cell, -1 if cell is skipped
+  int *offset;            // offset of cell's 1st line in new lines
+  int *first;             // index of cell's 1st line in newpts
+  int *reuse;             // 1 if cell's cached lines are reused
+
+  // cache of lines from last invoke(), for restricted mode
+
+  cellint *cache_id;      // ID of cell lines were cached for, 0 if none
+  int *cache_type;        // surf type of cached lines
+  int *cache_n;           // # of cached lines
+  int *first_cache;       // index of cell's 1st line in cachepts
+  double **cache_values;  // corner values cached lines were computed from
+
+  int maxnew,maxcache,maxnext;
+  double *newpts;         // 2 end pts (x,y) of lines computed this pass
+  double *cachepts;       // 2 end pts of lines cached from last invoke()
+  double *cachepts_next;  // cache being built by this invoke()
+
+  void grow_cell(int);
+  int cell_lines(double *, double *, double *, double [4][3]);
   double interpolate(double, double, double, double);
 };
 
@@ -44,7 +44,9 @@ Modify::Modify(SPARTA *sparta) : Pointers(sparta)
   fmask = NULL;
   list_start_of_step = list_end_of_step = NULL;
 
-  end_of_step_every = NULL;
+  start_of_step_every = end_of_step_every = NULL;
+  start_of_step_next = end_of_step_next = NULL;
+  next_start_of_step = next_end_of_step = 0;
   list_pergrid = NULL;
   list_update_custom = NULL;
   list_gas_react = NULL;
@@ -79,7 +81,10 @@ Modify::~Modify()
   delete [] list_start_of_step;
   delete [] list_end_of_step;
 
+  delete [] start_of_step_every;
   delete [] end_of_step_every;
+  delete [] start_of_step_next;
+  delete [] end_of_step_next;
   delete [] list_pergrid;
   delete [] list_update_custom;
   delete [] list_gas_react;
@@ -97,8 +102,10 @@ void Modify::init()
 
   // create lists of fixes with masks for calling at each stage of run
 
-  list_init(START_OF_STEP,n_start_of_step,list_start_of_step);
-  list_init_end_of_step(END_OF_STEP,n_end_of_step,list_end_of_step);
+  list_init_every(START_OF_STEP,n_start_of_step,list_start_of_step,
+                  start_of_step_every,start_of_step_next);
+  list_init_every(END_OF_STEP,n_end_of_step,list_end_of_step,
+                  end_of_step_every,end_of_step_next);
 
   // create other lists of fixes and computes
 
@@ -135,28 +142,55 @@ void Modify::setup()
   // setup each fix
 
   for (int i = 0; i < nfix; i++) fix[i]->setup();
+
+  // schedule start_of_step and end_of_step fixes after setup,
+  //   since it can invoke them
+
+  schedule_fixes();
 }
 
 /* ----------------------------------------------------------------------
    start-of-timestep call, only for relevant fixes
+   only call fix->start_of_step() on the next step it was scheduled for
+   then reschedule the invoked fixes and reset next_start_of_step
 ------------------------------------------------------------------------- */
 
 void Modify::start_of_step()
 {
-  for (int i = 0; i < n_start_of_step; i++)
-    fix[list_start_of_step[i]]->start_of_step();
+  bigint ntimestep = update->ntimestep;
+  if (ntimestep < next_start_of_step) return;
+
+  next_start_of_step = MAXBIGINT;
+  for (int i = 0; i < n_start_of_step; i++) {
+    if (start_of_step_next[i] == ntimestep) {
+      fix[list_start_of_step[i]]->start_of_step();
+      start_of_step_next[i] = next_step_fix(0,start_of_step_every[i]);
+    }
+    next_start_of_step = MIN(next_start_of_step,start_of_step_next[i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
    end-of-timestep call, only for relevant fixes
-   only call fix->end_of_step() on timesteps that are multiples of nevery
+   only call fix->end_of_step() on the next step it was scheduled for
+   then reschedule the invoked fixes and reset next_end_of_step
 ------------------------------------------------------------------------- */
 
 void Modify::end_of_step()
 {
-  for (int i = 0; i < n_end_of_step; i++)
-    if (update->ntimestep % end_of_step_every[i] == 0)
+  bigint ntimestep = update->ntimestep;
+  if (ntimestep < next_end_of_step) return;
+
+  next_end_of_step = MAXBIGINT;
+  for (int i = 0; i < n_end_of_step; i++) {
+    if (end_of_step_next[i] == ntimestep) {
       fix[list_end_of_step[i]]->end_of_step();
+      end_of_step_next[i] =
+        next_step_fix(fix[list_end_of_step[i]]->next_end_of_step(),
+                      end_of_step_every[i]);
+    }
+    next_end_of_step = MIN(next_end_of_step,end_of_step_next[i]);
+  }
 }
 
 /* ----------------------------------------------------------------------
@@ -207,6 +241,17 @@ void Modify::add_grid_one()
     fix[list_pergrid[i]]->add_grid_one();
 }
 
+/* ----------------------------------------------------------------------
+   add_grid_many call, only for relevant fixes
+   invoked by adapt_grid and fix adapt after N new child cells are created
+------------------------------------------------------------------------- */
+
+void Modify::add_grid_many(int n)
+{
+  for (int i = 0; i < n_pergrid; i++)
+    fix[list_pergrid[i]]->add_grid_many(n);
+}
+
 /* ----------------------------------------------------------------------
    reset_grid call, only for relevant fixes
    invoked after all grid cell removals
@@ -469,6 +514,17 @@ int Modify::find_compute(const char *id)
   return icompute;
 }
 
+/* ----------------------------------------------------------------------
+   called before and after any caller invokes a compute_*() method
+   nothing to do here, accelerator versions track which compute is running
+------------------------------------------------------------------------- */
+
+void Modify::invoke_begin(Compute *) {}
+
+/* ---------------------------------------------------------------------- */
+
+void Modify::invoke_end() {}
+
 /* ----------------------------------------------------------------------
    clear invoked flag of all computes
    called everywhere that computes are used, before computes are invoked
@@ -510,41 +566,66 @@ void Modify::addstep_compute_all(bigint newstep)
 
 /* ----------------------------------------------------------------------
    create list of fix indices for fixes which match mask
+   also create every[] = nevery of each fix and next[] to schedule them
 ------------------------------------------------------------------------- */
 
-void Modify::list_init(int mask, int &n, int *&list)
+void Modify::list_init_every(int mask, int &n, int *&list,
+                             int *&every, bigint *&next)
 {
   delete [] list;
+  delete [] every;
+  delete [] next;
 
   n = 0;
   for (int i = 0; i < nfix; i++) if (fmask[i] & mask) n++;
   list = new int[n];
+  every = new int[n];
+  next = new bigint[n];
 
   n = 0;
-  for (int i = 0; i < nfix; i++) if (fmask[i] & mask) list[n++] = i;
+  for (int i = 0; i < nfix; i++)
+    if (fmask[i] & mask) {
+      list[n] = i;
+      every[n++] = fix[i]->nevery;
+    }
 }
 
 /* ----------------------------------------------------------------------
-   create list of fix indices for end_of_step fixes
-   also create end_of_step_every[]
+   set next step each start_of_step and end_of_step fix is invoked on
+   set next_start_of_step and next_end_of_step = soonest of those steps
+   idle timesteps before them invoke no fixes
+   start_of_step fixes are invoked on multiples of their nevery
 ------------------------------------------------------------------------- */
 
-void Modify::list_init_end_of_step(int mask, int &n, int *&list)
+void Modify::schedule_fixes()
 {
-  delete [] list;
-  delete [] end_of_step_every;
+  int i;
 
-  n = 0;
-  for (int i = 0; i < nfix; i++) if (fmask[i] & mask) n++;
-  list = new int[n];
-  end_of_step_every = new int[n];
+  next_start_of_step = MAXBIGINT;
+  for (i = 0; i < n_start_of_step; i++) {
+    start_of_step_next[i] = next_step_fix(0,start_of_step_every[i]);
+    next_start_of_step = MIN(next_start_of_step,start_of_step_next[i]);
+  }
 
-  n = 0;
-  for (int i = 0; i < nfix; i++)
-    if (fmask[i] & mask) {
-      list[n] = i;
-      end_of_step_every[n++] = fix[i]->nevery;
-    }
+  next_end_of_step = MAXBIGINT;
+  for (i = 0; i < n_end_of_step; i++) {
+    end_of_step_next[i] =
+      next_step_fix(fix[list_end_of_step[i]]->next_end_of_step(),
+                    end_of_step_every[i]);
+    next_end_of_step = MIN(next_end_of_step,end_of_step_next[i]);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   return next step after current one that a fix is invoked on
+   smallest multiple of its nevery >= step the fix next does something on
+   next = 0 if fix does not know, then next multiple of nevery is used
+------------------------------------------------------------------------- */
+
+bigint Modify::next_step_fix(bigint next, int nevery)
+{
+  next = MAX(next,update->ntimestep+1);
+  return (next+nevery-1)/nevery * nevery;
 }
 
 /* ----------------------------------------------------------------------
@@ -24,6 +24,8 @@ class Modify : protected Pointers {
  public:
   int nfix,maxfix;
   int n_start_of_step,n_end_of_step;
+  bigint next_start_of_step; // next step any start_of_step fix is invoked on
+  bigint next_end_of_step;   // next step any end_of_step fix is invoked on
   int n_pergrid,n_update_custom,n_gas_react,n_surf_react;
 
   class Fix **fix;           // list of fixes
@@ -43,6 +45,7 @@ class Modify : protected Pointers {
   virtual int unpack_grid_one(int, char *);
   virtual void copy_grid_one(int, int);
   virtual void add_grid_one();
+  virtual void add_grid_many(int);
   virtual void reset_grid_count(int);
   virtual void grid_changed();
 
@@ -54,6 +57,8 @@ class Modify : protected Pointers {
   void delete_compute(const char *);
   int find_compute(const char *);
 
+  virtual void invoke_begin(class Compute *);
+  virtual void invoke_end();
   void clearstep_compute();
   void addstep_compute(bigint);
   void addstep_compute_all(bigint);
@@ -73,7 +78,9 @@ class Modify : protected Pointers {
 
   int *list_start_of_step,*list_end_of_step;
 
-  int *end_of_step_every;
+  int *start_of_step_every,*end_of_step_every;
+  bigint *start_of_step_next;  // next step each start_of_step fix is invoked on
+  bigint *end_of_step_next;    // next step each end_of_step fix is invoked on
 
   int *list_pergrid;         // list of fixes that store per grid cell info
   int *list_update_custom;    // list of fixes with update_custom() method
@@ -83,8 +90,9 @@ class Modify : protected Pointers {
   int n_timeflag;            // list of computes that store time invocation
   int *list_timeflag;
 
-  void list_init(int, int &, int *&);
-  void list_init_end_of_step(int, int &, int *&);
+  void list_init_every(int, int &, int *&, int *&, bigint *&);
+  void schedule_fixes();
+  bigint next_step_fix(bigint, int);
 };
 
 }
@@ -25,6 +25,7 @@
 #include "collide.h"
 #include "random_mars.h"
 #include "random_knuth.h"
+#include "random_counter.h"
 #include "memory.h"
 #include "error.h"
 #include "fix_vibmode.h"
@@ -39,6 +40,8 @@ enum{INT,DOUBLE};                      // several files
 #define DELTASPECIES 16
 #define DELTAMIXTURE 8
 #define MAXLINE 1024
+#define NETABLE 1024
+#define ECUT 10.0                 // energy cut-off in kT for DOF > 2
 
 // customize by adding an abbreviation string
 // also add a check for the keyword in 2 places in add_species()
@@ -60,12 +63,19 @@ Particle::Particle(SPARTA *sparta) : Pointers(sparta)
   species = NULL;
   maxvibmode = 0;
 
+  netable = NETABLE;
+  maxetable = 0;
+  etable = NULL;
+
   //maxgrid = 0;
   //cellcount = NULL;
   //first = NULL;
   maxsort = 0;
   next = NULL;
 
+  maxcompress = 0;
+  cdest = csrc = NULL;
+
   // create two default mixtures
 
   nmixture = maxmixture = 0;
@@ -112,6 +122,7 @@ Particle::~Particle()
   if (copy || copymode) return;
 
   memory->sfree(species);
+  memory->destroy(etable);
   for (int i = 0; i < nmixture; i++) delete mixture[i];
   memory->sfree(mixture);
 
@@ -119,6 +130,8 @@ Particle::~Particle()
   //memory->destroy(cellcount);
   //memory->destroy(first);
   memory->destroy(next);
+  memory->destroy(cdest);
+  memory->destroy(csrc);
 
   for (int i = 0; i < ncustom; i++) delete [] ename[i];
   memory->sfree(ename);
@@ -192,6 +205,15 @@ void Particle::init()
     }
   }
 
+  // energy tables for rot and vib DOF of all species
+
+  int maxdof = 0;
+  for (int isp = 0; isp < nspecies; isp++) {
+    maxdof = MAX(maxdof,species[isp].rotdof);
+    maxdof = MAX(maxdof,species[isp].vibdof);
+  }
+  energy_table(maxdof);
+
   // reallocate cellcount and first lists as needed
   // NOTE: when grid becomes dynamic, will need to do this in sort()
 
@@ -208,7 +230,6 @@ void Particle::init()
    compress particle list to remove particles with indices in mlist
    mlist indices MUST be in ascending order
    overwrite deleted particle with particle from end of nlocal list
-   inner while loop avoids overwrite with deleted particle at end of mlist
    called every step from Comm::migrate_particles() when particles migrate
    this is similar to compress_reactions(), but does not need
      an auxiliary vector b/c indices are in ascending order
@@ -217,39 +238,30 @@ void Particle::init()
 
 void Particle::compress_migrate(int nmigrate, int *mlist)
 {
-  int i,j,k;
-  int nbytes = sizeof(OnePart);
+  // upper = new nlocal
+  // holes = deleted indices < upper = first ncopy entries of mlist
+  // fill holes in ascending order with kept particles >= upper,
+  //   taken from end of list, skipping ones that are also deleted
 
-  if (!ncustom) {
-    for (i = 0; i < nmigrate; i++) {
-      j = mlist[i];
-      k = nlocal - 1;
-      while (k == mlist[nmigrate-1] && k > j) {
-        nmigrate--;
-        nlocal--;
-        k--;
-      }
-      nlocal--;
-      if (j == k) continue;
-      memcpy(&particles[j],&particles[k],nbytes);
-    }
+  grow_compress(nmigrate);
 
-  } else {
-    for (i = 0; i < nmigrate; i++) {
-      j = mlist[i];
-      k = nlocal - 1;
-      while (k == mlist[nmigrate-1] && k > j) {
-        nmigrate--;
-        nlocal--;
-        k--;
-      }
-      nlocal--;
-      if (j == k) continue;
-      memcpy(&particles[j],&particles[k],nbytes);
-      copy_custom(j,k);
+  int upper = nlocal - nmigrate;
+  int ncopy = 0;
+  int k = nmigrate-1;
+
+  for (int j = nlocal-1; j >= upper; j--) {
+    if (k >= 0 && mlist[k] == j) {
+      k--;
+      continue;
     }
+    cdest[ncopy] = mlist[ncopy];
+    csrc[ncopy] = j;
+    ncopy++;
   }
 
+  nlocal = upper;
+  compress_copy(ncopy);
+
   sorted = 0;
 }
 
@@ -265,27 +277,8 @@ void Particle::compress_migrate(int nmigrate, int *mlist)
 
 void Particle::compress_rebalance()
 {
-  int nbytes = sizeof(OnePart);
-
-  if (!ncustom) {
-    int i = 0;
-    while (i < nlocal) {
-      if (particles[i].icell < 0) {
-        memcpy(&particles[i],&particles[nlocal-1],nbytes);
-        nlocal--;
-      } else i++;
-    }
-
-  } else {
-    int i = 0;
-    while (i < nlocal) {
-      if (particles[i].icell < 0) {
-        memcpy(&particles[i],&particles[nlocal-1],nbytes);
-        copy_custom(i,nlocal-1);
-        nlocal--;
-      } else i++;
-    }
-  }
+  int ncopy = compress_plan();
+  compress_copy(ncopy);
 
   sorted = 0;
 }
@@ -298,59 +291,32 @@ void Particle::compress_rebalance()
 
 void Particle::compress_rebalance_sorted()
 {
-  int nbytes = sizeof(OnePart);
+  int i,m;
 
-  Grid::ChildInfo *cinfo = grid->cinfo;
+  int nold = nlocal;
+  int ncopy = compress_plan();
 
-  if (!ncustom) {
-    int i = 0;
-    while (i < nlocal) {
-      if (particles[i].icell < 0) {
-        int icell = particles[nlocal-1].icell;
-        if (icell >= 0) {
-          if (cinfo[icell].first == nlocal-1) cinfo[icell].first = i;
-          else {
-            int ip = cinfo[icell].first;
-            while (ip >= 0) {
-              if (next[ip] == nlocal-1) {
-                next[ip] = i;
-                break;
-              }
-              ip = next[ip];
-            }
-          }
-          next[i] = next[nlocal-1];
-        }
-        memcpy(&particles[i],&particles[nlocal-1],nbytes);
-        nlocal--;
-      } else i++;
-    }
+  // moved particle inherits next of its old index
+  // then use next at old indices >= nlocal as a map to new index
+  // remap links and cell heads that point to a moved particle
+  // links of deleted particles are left as is, same as before compression
 
-  } else {
-    int i = 0;
-    while (i < nlocal) {
-      if (particles[i].icell < 0) {
-        int icell = particles[nlocal-1].icell;
-        if (icell >= 0) {
-          if (cinfo[icell].first == nlocal-1) cinfo[icell].first = i;
-          else {
-            int ip = cinfo[icell].first;
-            while (ip >= 0) {
-              if (next[ip] == nlocal-1) {
-                next[ip] = i;
-                break;
-              }
-              ip = next[ip];
-            }
-          }
-          next[i] = next[nlocal-1];
-        }
-        memcpy(&particles[i],&particles[nlocal-1],nbytes);
-        copy_custom(i,nlocal-1);
-        nlocal--;
-      } else i++;
-    }
+  for (m = 0; m < ncopy; m++) next[cdest[m]] = next[csrc[m]];
+  for (i = nlocal; i < nold; i++) next[i] = i;
+  for (m = 0; m < ncopy; m++) next[csrc[m]] = cdest[m];
+
+  for (i = 0; i < nlocal; i++)
+    if (next[i] >= nlocal && next[i] < nold) next[i] = next[next[i]];
+
+  Grid::ChildInfo *cinfo = grid->cinfo;
+  int nglocal = grid->nlocal;
+
+  for (int icell = 0; icell < nglocal; icell++) {
+    i = cinfo[icell].first;
+    if (i >= nlocal && i < nold) cinfo[icell].first = next[i];
   }
+
+  compress_copy(ncopy);
 }
 
 /* ----------------------------------------------------------------------
@@ -367,9 +333,7 @@ void Particle::compress_rebalance_sorted()
 
 void Particle::compress_reactions(int ndelete, int *dellist)
 {
-  int i;
-
-  int nbytes = sizeof(OnePart);
+  int i,j;
 
   // reallocate next list as needed
 
@@ -379,40 +343,140 @@ void Particle::compress_reactions(int ndelete, int *dellist)
     memory->create(next,maxsort,"particle:next");
   }
 
+  grow_compress(ndelete);
+
   // use next as a scratch vector
   // is always defined when performing collisions and thus gas reactions
   // next is only used for upper locs from nlocal-ndelete to nlocal
   // next[i] = current index of atom originally at index i, when i >= nlocal
   // next[i] = original index of atom currently at index i, when i <= nlocal
+  // the moves are only tracked here, no particle is copied
+  // cdest[j-upper] = final index < upper of atom originally at j >= upper,
+  //   -1 if it is deleted or still above upper
 
   int upper = nlocal-ndelete;
-  for (i = upper; i < nlocal; i++) next[i] = i;
+  for (i = upper; i < nlocal; i++) {
+    next[i] = i;
+    cdest[i-upper] = -1;
+  }
 
   // i = current index of atom to remove, even if it previously moved
 
-  if (!ncustom) {
-    for (int m = 0; m < ndelete; m++) {
-      i = dellist[m];
-      if (i >= nlocal) i = next[i];
-      nlocal--;
-      if (i == nlocal) continue;
-      memcpy(&particles[i],&particles[nlocal],nbytes);
-      if (i >= upper) next[i] = next[nlocal];
-      next[next[nlocal]] = i;
-    }
+  for (int m = 0; m < ndelete; m++) {
+    i = dellist[m];
+    if (i >= upper) cdest[i-upper] = -1;
+    if (i >= nlocal) i = next[i];
+    nlocal--;
+    if (i == nlocal) continue;
+    if (i < upper) cdest[next[nlocal]-upper] = i;
+    if (i >= upper) next[i] = next[nlocal];
+    next[next[nlocal]] = i;
+  }
 
-  } else {
-    for (int m = 0; m < ndelete; m++) {
-      i = dellist[m];
-      if (i >= nlocal) i = next[i];
-      nlocal--;
-      if (i == nlocal) continue;
-      memcpy(&particles[i],&particles[nlocal],nbytes);
-      copy_custom(i,nlocal);
-      if (i >= upper) next[i] = next[nlocal];
-      next[next[nlocal]] = i;
-    }
+  // convert tracked moves into list of copies
+
+  int ncopy = 0;
+  for (j = 0; j < ndelete; j++) {
+    if (cdest[j] < 0) continue;
+    cdest[ncopy] = cdest[j];
+    csrc[ncopy] = upper + j;
+    ncopy++;
   }
+
+  compress_copy(ncopy);
+}
+
+/* ----------------------------------------------------------------------
+   plan compression of particle list to remove particles with icell < 0
+   keep mask = icell >= 0, new nlocal = # of kept particles
+   holes = deleted indices < new nlocal, filled in ascending order
+     by kept particles >= new nlocal, taken from end of list
+   same result as repeatedly moving last particle into a deleted slot
+   return # of copies in cdest/csrc, reset nlocal
+------------------------------------------------------------------------- */
+
+int Particle::compress_plan()
+{
+  int i;
+
+  int nkeep = 0;
+  for (i = 0; i < nlocal; i++)
+    if (particles[i].icell >= 0) nkeep++;
+
+  grow_compress(nlocal-nkeep);
+
+  int ncopy = 0;
+  int j = nlocal;
+
+  for (i = 0; i < nkeep; i++) {
+    if (particles[i].icell >= 0) continue;
+    j--;
+    while (particles[j].icell < 0) j--;
+    cdest[ncopy] = i;
+    csrc[ncopy] = j;
+    ncopy++;
+  }
+
+  nlocal = nkeep;
+  return ncopy;
+}
+
+/* ----------------------------------------------------------------------
+   perform Ncopy copies of particle csrc[m] into particle cdest[m]
+   all cdest are unique and < nlocal, all csrc are >= nlocal
+   so copies are independent of each other and can be done in any order
+   copy OnePart for all pairs, then each custom vector/array in turn,
+     rather than all custom attributes of one particle via copy_custom()
+------------------------------------------------------------------------- */
+
+void Particle::compress_copy(int ncopy)
+{
+  int i,m;
+
+  int nbytes = sizeof(OnePart);
+
+  for (m = 0; m < ncopy; m++)
+    memcpy(&particles[cdest[m]],&particles[csrc[m]],nbytes);
+
+  if (!ncustom) return;
+
+  for (i = 0; i < ncustom_ivec; i++) {
+    int *ivec = eivec[i];
+    for (m = 0; m < ncopy; m++) ivec[cdest[m]] = ivec[csrc[m]];
+  }
+
+  for (i = 0; i < ncustom_iarray; i++) {
+    int **iarray = eiarray[i];
+    int ibytes = eicol[i]*sizeof(int);
+    for (m = 0; m < ncopy; m++)
+      memcpy(iarray[cdest[m]],iarray[csrc[m]],ibytes);
+  }
+
+  for (i = 0; i < ncustom_dvec; i++) {
+    double *dvec = edvec[i];
+    for (m = 0; m < ncopy; m++) dvec[cdest[m]] = dvec[csrc[m]];
+  }
+
+  for (i = 0; i < ncustom_darray; i++) {
+    double **darray = edarray[i];
+    int dbytes = edcol[i]*sizeof(double);
+    for (m = 0; m < ncopy; m++)
+      memcpy(darray[cdest[m]],darray[csrc[m]],dbytes);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   insure cdest/csrc copy lists for compression can hold N pairs
+------------------------------------------------------------------------- */
+
+void Particle::grow_compress(int n)
+{
+  if (n <= maxcompress) return;
+  maxcompress = n;
+  memory->destroy(cdest);
+  memory->destroy(csrc);
+  memory->create(cdest,maxcompress,"particle:cdest");
+  memory->create(csrc,maxcompress,"particle:csrc");
 }
 
 /* ----------------------------------------------------------------------
@@ -562,6 +626,7 @@ void Particle::post_weight()
     nclone--;
     if (wrandom->uniform() < fraction) nclone++;
 
+    reserve(nclone);
     for (m = 0; m < nclone; m++) {
       clone_particle(i);
       particles[nlocal-1].id = MAXSMALLINT*wrandom->uniform();
@@ -572,6 +637,7 @@ void Particle::post_weight()
 
 /* ----------------------------------------------------------------------
    insure particle list can hold nextra new particles
+   grow geometrically so repeated small requests realloc O(log N) times
    if defined, also grow custom particle arrays and initialize with zeroes
 ------------------------------------------------------------------------- */
 
@@ -582,7 +648,7 @@ void Particle::grow(int nextra)
 
   int oldmax = maxlocal;
   bigint newmax = maxlocal;
-  while (newmax < target) newmax += DELTA;
+  while (newmax < target) newmax += MAX(DELTA,newmax/10);
 
   if (newmax > MAXSMALLINT)
     error->one(FLERR,"Per-processor particle count is too big");
@@ -1028,11 +1094,13 @@ int Particle::find_mixture(char *id)
 /* ----------------------------------------------------------------------
    generate random rotational energy for a particle
    only a function of species index and species properties
+   RNG = any generator with a uniform() method
 ------------------------------------------------------------------------- */
 
-double Particle::erot(int isp, double temp_thermal, RanKnuth *erandom)
+template <class RNG>
+double Particle::erot(int isp, double temp_thermal, RNG *erandom)
 {
-  double eng,a,erm,b;
+  double eng;
   int rotstyle = NONE;
   if (collide) rotstyle = collide->rotstyle;
 
@@ -1046,14 +1114,13 @@ double Particle::erot(int isp, double temp_thermal, RanKnuth *erandom)
   } else if (rotstyle == SMOOTH && species[isp].rotdof == 2) {
     eng = -log(erandom->uniform()) * update->boltz * temp_thermal;
   } else {
-    a = 0.5*particle->species[isp].rotdof-1.0;
-    while (1) {
-      // energy cut-off at 10 kT
-      erm = 10.0*erandom->uniform();
-      b = pow(erm/a,a) * exp(a-erm);
-      if (b > erandom->uniform()) break;
-    }
-    eng = erm * update->boltz * temp_thermal;
+    int dof = species[isp].rotdof;
+    if (dof > maxetable) energy_table(dof);
+    double *table = etable[dof];
+    double x = erandom->uniform() * netable;
+    int k = static_cast<int> (x);
+    eng = (table[k] + (x-k)*(table[k+1]-table[k])) *
+      update->boltz * temp_thermal;
   }
 
   return eng;
@@ -1066,9 +1133,10 @@ double Particle::erot(int isp, double temp_thermal, RanKnuth *erandom)
      -1 if not defined for this model
 ------------------------------------------------------------------------- */
 
-double Particle::evib(int isp, double temp_thermal, RanKnuth *erandom)
+template <class RNG>
+double Particle::evib(int isp, double temp_thermal, RNG *erandom)
 {
-  double eng,a,erm,b;
+  double eng;
 
   int vibstyle = NONE;
   if (collide) vibstyle = collide->vibstyle;
@@ -1087,20 +1155,84 @@ double Particle::evib(int isp, double temp_thermal, RanKnuth *erandom)
     if (species[isp].vibdof == 2)
       eng = -log(erandom->uniform()) * update->boltz * temp_thermal;
     else if (species[isp].vibdof > 2) {
-      a = 0.5*particle->species[isp].vibdof-1.;
-      while (1) {
-        // energy cut-off at 10 kT
-        erm = 10.0*erandom->uniform();
-        b = pow(erm/a,a) * exp(a-erm);
-        if (b > erandom->uniform()) break;
-      }
-      eng = erm * update->boltz * temp_thermal;
+      int dof = species[isp].vibdof;
+      if (dof > maxetable) energy_table(dof);
+      double *table = etable[dof];
+      double x = erandom->uniform() * netable;
+      int k = static_cast<int> (x);
+      eng = (table[k] + (x-k)*(table[k+1]-table[k])) *
+        update->boltz * temp_thermal;
     }
   }
 
   return eng;
 }
 
+// generators used with erot() and evib()
+
+template double Particle::erot<RanKnuth>(int, double, RanKnuth *);
+template double Particle::evib<RanKnuth>(int, double, RanKnuth *);
+template double Particle::erot<RanCounter>(int, double, RanCounter *);
+template double Particle::evib<RanCounter>(int, double, RanCounter *);
+
+/* ----------------------------------------------------------------------
+   create energy tables for all DOF from 3 up to DOF, if not already done
+   energy of DOF > 2 internal modes has a Gamma(DOF/2) distribution in
+     units of kT, cut off at ECUT, same as the former rejection sampling
+   table = inverse of its CDF at NETABLE+1 evenly spaced CDF values,
+     found by bisection with CDF = gamma_lower(DOF/2,E) / (same at ECUT)
+   erot() and evib() interpolate table at a uniform RN
+------------------------------------------------------------------------- */
+
+void Particle::energy_table(int dof)
+{
+  if (dof <= maxetable || dof <= 2) return;
+
+  memory->grow(etable,dof+1,netable+1,"particle:etable");
+
+  for (int idof = MAX(maxetable+1,3); idof <= dof; idof++) {
+    double *table = etable[idof];
+    double shape = 0.5*idof;
+    double cdfmax = gamma_lower(shape,ECUT);
+
+    table[0] = 0.0;
+    table[netable] = ECUT;
+    for (int k = 1; k < netable; k++) {
+      double target = cdfmax * k/netable;
+      double lo = table[k-1];
+      double hi = ECUT;
+      for (int iter = 0; iter < 60; iter++) {
+        double mid = 0.5*(lo+hi);
+        if (gamma_lower(shape,mid) < target) lo = mid;
+        else hi = mid;
+      }
+      table[k] = 0.5*(lo+hi);
+    }
+  }
+
+  maxetable = dof;
+}
+
+/* ----------------------------------------------------------------------
+   lower incomplete gamma function of shape S at X via its power series
+   converges quickly for X <= ECUT
+------------------------------------------------------------------------- */
+
+double Particle::gamma_lower(double s, double x)
+{
+  if (x <= 0.0) return 0.0;
+
+  double term = 1.0/s;
+  double sum = term;
+  for (int n = 1; n < 1000; n++) {
+    term *= x/(s+n);
+    sum += term;
+    if (term < sum*1.0e-16) break;
+  }
+
+  return sum * exp(s*log(x) - x);
+}
+
 /* ----------------------------------------------------------------------
    read list of species defined in species file
    store info in filespecies and nfile
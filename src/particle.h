@@ -63,6 +63,13 @@ class Particle : protected Pointers {
   int nspecies;             // # of defined species
   int maxvibmode;           // max vibmode of any species (mode = dof/2)
 
+  // inverse CDF of internal energy E/kT for rot or vib DOF > 2,
+  //   sampled by erot() and evib() with one uniform RN
+
+  int netable;              // # of bins in each energy table
+  int maxetable;            // max # of DOF with an energy table
+  double **etable;          // etable[dof] = E/kT at netable+1 CDF values
+
   class Mixture **mixture;
   int nmixture;
   int maxmixture;
@@ -150,14 +157,25 @@ class Particle : protected Pointers {
 
   virtual int add_particle(int, int, int, double *, double *, double, double);
   virtual int add_particle();
+
+  // insure room for N more particles, return ptr to first of them
+  // caller either fills up to N of them and calls commit() with that count
+  //   or makes up to N add_particle() calls which will not realloc
+
+  OnePart *reserve(int n) {
+    if ((bigint) nlocal + n > maxlocal) grow(n);
+    return &particles[nlocal];
+  }
+  void commit(int n) {nlocal += n;}
   int clone_particle(int);
   void add_species(int, char **);
   int find_species(char *);
   void species_modify(int, char **);
   void add_mixture(int, char **);
   int find_mixture(char *);
-  double erot(int, double, class RanKnuth *);
-  double evib(int, double, class RanKnuth *);
+  template <class RNG> double erot(int, double, RNG *);
+  template <class RNG> double evib(int, double, RNG *);
+  virtual void energy_table(int);
 
   void write_restart_species(FILE *fp);
   void read_restart_species(FILE *fp);
@@ -177,6 +195,7 @@ class Particle : protected Pointers {
   virtual void grow_custom(int, int, int);
   virtual void remove_custom(int);
   virtual void copy_custom(int, int);
+  virtual void compress_copy(int);
   int sizeof_custom();
   void write_restart_custom(FILE *fp);
   void read_restart_custom(FILE *fp);
@@ -189,8 +208,14 @@ class Particle : protected Pointers {
   int me;
   int maxgrid;              // max # of indices first can hold
   int maxsort;              // max # of particles next can hold
+  int maxcompress;          // max # of pairs cdest/csrc can hold
+  int *cdest,*csrc;         // particle copies to perform when compressing
   int maxspecies;           // max size of species list
 
+  double gamma_lower(double, double);
+  int compress_plan();
+  void grow_compress(int);
+
   FILE *fp;                 // file pointer for species, rotation, vibration
   int nfile;                // # of species read from file
   int maxfile;              // max size of file list
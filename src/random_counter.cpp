@@ -0,0 +1,57 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+
+#include "random_counter.h"
+
+using namespace SPARTA_NS;
+
+#define GAMMA 0x9e3779b97f4a7c15ULL
+#define STREAMBITS 32
+#define TWO32 4294967296.0
+#define TWOM53 (1.0/9007199254740992.0)
+
+/* ----------------------------------------------------------------------
+   set 64-bit seed from 2 RNs
+   assume 0.0 <= rseed < 1.0
+------------------------------------------------------------------------ */
+
+RanCounter::RanCounter(double rseed1, double rseed2)
+{
+  seed = ((uint64_t) (rseed1*TWO32) << 32) | (uint64_t) (rseed2*TWO32);
+  state = seed;
+}
+
+/* ----------------------------------------------------------------------
+   jump to start of stream N
+------------------------------------------------------------------------ */
+
+void RanCounter::reset(bigint n)
+{
+  state = seed + ((uint64_t) n << STREAMBITS) * GAMMA;
+}
+
+/* ----------------------------------------------------------------------
+   uniform RN strictly between 0 and 1
+------------------------------------------------------------------------- */
+
+double RanCounter::uniform()
+{
+  state += GAMMA;
+  uint64_t z = state;
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  z ^= z >> 31;
+  return ((z >> 11) + 0.5) * TWOM53;
+}
@@ -0,0 +1,42 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+
+#ifndef SPARTA_RAN_COUNTER_H
+#define SPARTA_RAN_COUNTER_H
+
+#include "spatype.h"
+
+namespace SPARTA_NS {
+
+// counter-based RNG, SplitMix64 algorithm
+// Nth draw is a hash of seed + N*gamma, so the generator can jump
+//   ahead any number of draws in constant time
+// sequence is split into streams of 2^32 draws each, reset(M) jumps
+//   to start of stream M, so that streams can be generated in any order
+
+class RanCounter {
+ public:
+  RanCounter(double, double);
+  ~RanCounter() {}
+  void reset(bigint);
+  double uniform();
+
+  uint64_t seed;        // state at start of stream 0
+  uint64_t state;
+};
+
+}
+
+#endif
@@ -36,6 +36,10 @@ React::React(SPARTA *sparta, int, char **arg) : Pointers(sparta)
   recomb_boost = 1000.0;
   recomb_boost_inverse = 0.001;
 
+  tableflag = 0;
+  table_nmax = 10000;
+  table_tol = 1.0e-3;
+
   random = new RanKnuth(update->ranmaster->uniform());
   double seed = update->ranmaster->uniform();
   random->reset(seed,comm->me,100);
@@ -73,6 +77,20 @@ void React::modify_params(int narg, char **arg)
       if (recomb_boost < 1.0) error->all(FLERR,"Illegal react_modify command");
       recomb_boost_inverse = 1.0 / recomb_boost;
       iarg += 2;
+    } else if (strcmp(arg[iarg],"table") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal react_modify command");
+      if (strcmp(arg[iarg+1],"no") == 0) {
+        tableflag = 0;
+        iarg += 2;
+      } else {
+        if (iarg+3 > narg) error->all(FLERR,"Illegal react_modify command");
+        tableflag = 1;
+        table_nmax = input->inumeric(FLERR,arg[iarg+1]);
+        table_tol = input->numeric(FLERR,arg[iarg+2]);
+        if (table_nmax < 1 || table_tol <= 0.0)
+          error->all(FLERR,"Illegal react_modify command");
+        iarg += 3;
+      }
     } else error->all(FLERR,"Illegal react_modify command");
   }
 }
@@ -33,6 +33,10 @@ class React : protected Pointers {
   double recomb_boost_inverse;   // inverse of boost parameter
   Particle::OnePart *recomb_part3;  // ptr to 3rd particle in recomb reaction
 
+  int tableflag;             // 1 to tabulate reaction probabilities
+  int table_nmax;            // max # of bins in a probability table
+  double table_tol;          // error bound of tabulated probabilities
+
   int copy,copymode;         // 1 if class copy
 
   React(class SPARTA *, int, char **);
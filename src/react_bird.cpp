@@ -41,6 +41,8 @@ enum{ARRHENIUS,QUANTUM};                               // other react files
 
 #define MAXLINE 1024
 #define DELTALIST 16
+#define MINBIN 16
+#define SMALL 1.0e-10
 
 /* ---------------------------------------------------------------------- */
 
@@ -61,6 +63,11 @@ ReactBird::ReactBird(SPARTA *sparta, int narg, char **arg) :
   reactions = NULL;
   list_ij = NULL;
   sp2recomb_ij = NULL;
+  emin_ij = NULL;
+
+  tnbin = tlo = thi = NULL;
+  ptable = NULL;
+  maxbin = 0;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -71,6 +78,9 @@ ReactBird::ReactBird(SPARTA *sparta) : React(sparta)
   reactions = NULL;
   list_ij = NULL;
   sp2recomb_ij = NULL;
+  emin_ij = NULL;
+  tnbin = tlo = thi = NULL;
+  ptable = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -101,6 +111,11 @@ ReactBird::~ReactBird()
   memory->destroy(reactions);
   memory->destroy(list_ij);
   memory->destroy(sp2recomb_ij);
+  memory->destroy(emin_ij);
+  memory->destroy(tnbin);
+  memory->destroy(tlo);
+  memory->destroy(thi);
+  memory->destroy(ptable);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -210,6 +225,32 @@ void ReactBird::init()
     reactions[j][i].list[reactions[j][i].n++] = m;
   }
 
+  // emin_ij = min threshold energy of remaining reactions in each IJ list
+  // zmax = max rotational DOF factor of reactions in each IJ list
+  // attempt() methods stop looping over a list once collision energy
+  //   cannot exceed threshold of any remaining reaction
+
+  memory->destroy(emin_ij);
+  memory->create(emin_ij,n,"react/bird:emin_ij");
+
+  offset = 0;
+  for (int i = 0; i < nspecies; i++)
+    for (int j = 0; j < nspecies; j++) {
+      int nij = reactions[i][j].n;
+      int *list = reactions[i][j].list;
+      double *emin = reactions[i][j].emin = &emin_ij[offset];
+      offset += nij;
+
+      reactions[i][j].zmax = 0.0;
+      for (int k = 0; k < nij; k++)
+        reactions[i][j].zmax =
+          MAX(reactions[i][j].zmax,rlist[list[k]].coeff[0]);
+      for (int k = nij-1; k >= 0; k--) {
+        emin[k] = rlist[list[k]].coeff[1];
+        if (k < nij-1) emin[k] = MIN(emin[k],emin[k+1]);
+      }
+    }
+
   // modify Arrhenius coefficients for TCE model
   // C1,C2 Bird 94, p 127
   // initflag logic insures only done once per reaction
@@ -406,6 +447,156 @@ void ReactBird::init()
     }
 }
 
+/* ----------------------------------------------------------------------
+   tabulate TCE probability of each dissociation, ionization, exchange
+     reaction vs u = Ea/Ecc, so attempt() can interpolate instead of
+     evaluating pow() twice per reaction
+   u spans all collision energies above threshold Ea with a finite range
+   table of each reaction uses fewest bins (doubled from MINBIN to
+     table_nmax) for which linear interpolation is within table_tol of
+     exact probability, relative to max probability of the reaction
+   if probability diverges at u = 0 or u = 1, e.g. as (1-u)^-0.1,
+     no bin width interpolates the bins next to it accurately,
+     so table uses table_nmax bins and attempt() computes probability
+     exactly in bins at that end which do not meet the error bound,
+     only bins tlo to thi-1 are interpolated
+   reactions with Ea <= 0 or which do not meet error bound are not tabulated
+------------------------------------------------------------------------- */
+
+void ReactBird::create_tables()
+{
+  memory->destroy(tnbin);
+  memory->destroy(tlo);
+  memory->destroy(thi);
+  memory->destroy(ptable);
+  tnbin = tlo = thi = NULL;
+  ptable = NULL;
+  maxbin = 0;
+
+  if (!tableflag) return;
+
+  memory->create(tnbin,nlist,"react/bird:tnbin");
+  memory->create(tlo,nlist,"react/bird:tlo");
+  memory->create(thi,nlist,"react/bird:thi");
+
+  double *berr;
+  memory->create(berr,table_nmax,"react/bird:berr");
+
+  int nfail = 0;
+
+  for (int m = 0; m < nlist; m++) {
+    OneReaction *r = &rlist[m];
+    tnbin[m] = tlo[m] = thi[m] = 0;
+    if (!r->active || r->type == RECOMBINATION) continue;
+    if (r->coeff[1] <= 0.0) continue;
+
+    int divlo = (r->coeff[3] > SMALL);
+    int divhi = (r->coeff[3]+r->coeff[5] < -SMALL);
+    int nbin = MIN(MINBIN,table_nmax);
+    int ilo,ihi;
+
+    while (1) {
+
+      // berr = interpolation error of each bin at its quarter points
+
+      double pmax = 0.0;
+      double plo = tce_prob(r,0.0);
+      for (int k = 0; k < nbin; k++) {
+        double phi = tce_prob(r,(k+1.0)/nbin);
+        berr[k] = 0.0;
+        for (int q = 1; q < 4; q++) {
+          double frac = 0.25*q;
+          double prob = tce_prob(r,(k+frac)/nbin);
+          pmax = MAX(pmax,prob);
+          berr[k] = MAX(berr[k],fabs(plo + frac*(phi-plo) - prob));
+        }
+        plo = phi;
+      }
+
+      // ilo,ihi = interpolated bins, skipping failed bins at divergent ends
+      // table is done if all bins in between meet error bound
+
+      double tol = table_tol*pmax;
+      ilo = 0;
+      ihi = nbin;
+      if (divlo) while (ilo < ihi && berr[ilo] > tol) ilo++;
+      if (divhi) while (ihi > ilo && berr[ihi-1] > tol) ihi--;
+
+      int converged = 1;
+      for (int k = ilo; k < ihi; k++)
+        if (berr[k] > tol) converged = 0;
+      if (converged && ilo == 0 && ihi == nbin) break;
+      if (nbin == table_nmax) {
+        if (!converged || ilo == ihi) nbin = 0;
+        break;
+      }
+
+      nbin = MIN(2*nbin,table_nmax);
+    }
+
+    if (nbin == 0) {
+      nfail++;
+      continue;
+    }
+
+    tnbin[m] = nbin;
+    tlo[m] = ilo;
+    thi[m] = ihi;
+    maxbin = MAX(maxbin,nbin);
+  }
+
+  memory->destroy(berr);
+
+  memory->create(ptable,nlist,maxbin+1,"react/bird:ptable");
+
+  for (int m = 0; m < nlist; m++) {
+    int nbin = tnbin[m];
+    for (int k = 0; k <= maxbin; k++) {
+      if (nbin && k <= nbin) ptable[m][k] = tce_prob(&rlist[m],1.0*k/nbin);
+      else ptable[m][k] = 0.0;
+    }
+  }
+
+  if (nfail && comm->me == 0) {
+    char str[128];
+    sprintf(str,"%d reaction probability tables do not meet error bound",
+            nfail);
+    error->warning(FLERR,str);
+  }
+}
+
+/* ----------------------------------------------------------------------
+   TCE probability of reaction R at u = Ea/Ecc
+   capped at 1.0, which selects the reaction in attempt() the same way
+     as any larger probability
+   u = 0 and u = 1 are limits of infinite and threshold collision energy
+------------------------------------------------------------------------- */
+
+double ReactBird::tce_prob(OneReaction *r, double u)
+{
+  double ea = r->coeff[1];
+
+  if (u <= 0.0) {
+    if (r->coeff[3] < -SMALL) return 0.0;
+    if (r->coeff[3] > SMALL) return 1.0;
+    return MIN(r->coeff[2],1.0);
+  }
+
+  // as Ecc -> Ea, prob ~ (Ecc-Ea)^(coeff[3]+coeff[5])
+
+  if (u >= 1.0) {
+    double power = r->coeff[3] + r->coeff[5];
+    if (power > SMALL) return 0.0;
+    if (power < -SMALL) return 1.0;
+    return MIN(r->coeff[2]*pow(ea,r->coeff[3]),1.0);
+  }
+
+  double ecc = ea/u;
+  double prob = r->coeff[2] * pow(ecc-ea,r->coeff[3]) *
+    pow(1.0-ea/ecc,r->coeff[5]);
+  return MIN(prob,1.0);
+}
+
 /* ----------------------------------------------------------------------
    return 1 if any recombination reactions are defined for species pair ISP,JSP
    else return 0
@@ -70,6 +70,10 @@ class ReactBird : public React {
                      //   one index for all 3rd particle species,
                      //   just a ptr into sub-section of long sp2recomb_ij
                      //   vector for all pairs which have recomb reactions
+    double *emin;    // emin[k] = min threshold energy of reactions K to N-1
+                     //   in list, for early exit from loops over list,
+                     //   just a ptr into sub-section of long emin_ij vector
+    double zmax;     // max rotational DOF factor of reactions in list
     int n;           // # of reactions in list
   };
 
@@ -85,7 +89,21 @@ class ReactBird : public React {
                               //   stored in contiguous vector
                               //   length of each chunk is # of species
                               // pointed into by reactions[i][k].sp2recomb
+  double *emin_ij;            // chunks of threshold energies, same layout
+                              //   as list_ij
 
+  // optional tables of TCE reaction probability vs Ea/Ecc
+
+  int *tnbin;                 // # of table bins for each reaction,
+                              //   0 if not tabulated
+  int *tlo,*thi;              // bins tlo to thi-1 are interpolated,
+                              //   others are computed exactly
+  double **ptable;            // probabilities at tnbin+1 evenly spaced
+                              //   values of Ea/Ecc from 0 to 1
+  int maxbin;                 // max tnbin of any reaction
+
+  void create_tables();
+  double tce_prob(OneReaction *, double);
   void readfile(char *);
   int readone(char *, char *, int &, int &);
   void check_duplicate();
@@ -120,6 +138,12 @@ E: Unknown outcome in reaction
 The specified type of the reaction is not encoded in the reaction
 style.
 
+W: %d reaction probability tables do not meet error bound
+
+These reactions are not tabulated and their probabilities are computed
+exactly.  Use a larger number of bins with the react_modify table
+command if needed.
+
 E: Cannot open reaction file %s
 
 Self-explanatory.
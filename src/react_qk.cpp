@@ -68,12 +68,22 @@ int ReactQK::attempt(Particle::OnePart *ip, Particle::OnePart *jp,
 
   double pre_ave_rotdof = (species[isp].rotdof + species[jsp].rotdof)/2.0;
 
-  double omega = collide->extract(isp,jsp,"omega");
-
   int n = reactions[isp][jsp].n;
 
   if (n == 0) return 0;
   int *list = reactions[isp][jsp].list;
+  double *emin = reactions[isp][jsp].emin;
+
+  // ecc_max = upper bound on collision energy of any reaction in list
+  // no reaction is possible once it is below threshold of all remaining ones
+
+  double ecc_max = pre_etrans;
+  if (pre_ave_rotdof > 0.1)
+    ecc_max += pre_erot*reactions[isp][jsp].zmax/pre_ave_rotdof;
+  if (ecc_max <= emin[0]) return 0;
+
+  double omega = collide->extract(isp,jsp,"omega");
+  inverse_kT = 1.0 / (update->boltz * species[isp].vibtemp[0]);
 
   // probablity to compare to reaction probability
 
@@ -83,6 +93,7 @@ int ReactQK::attempt(Particle::OnePart *ip, Particle::OnePart *jp,
   // loop over possible reactions for these 2 species
 
   for (int i = 0; i < n; i++) {
+    if (ecc_max <= emin[i]) break;
     r = &rlist[list[i]];
 
     // ignore energetically impossible reactions
@@ -97,8 +108,6 @@ int ReactQK::attempt(Particle::OnePart *ip, Particle::OnePart *jp,
 
     // compute probability of reaction
 
-    inverse_kT = 1.0 / (update->boltz * species[isp].vibtemp[0]);
-
     switch (r->type) {
     case DISSOCIATION:
       {
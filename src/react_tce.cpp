@@ -38,6 +38,7 @@ void ReactTCE::init()
     error->all(FLERR,"React tce can only be used with collide vss");
 
   ReactBird::init();
+  create_tables();
 }
 
 /* ---------------------------------------------------------------------- */
@@ -58,6 +59,15 @@ int ReactTCE::attempt(Particle::OnePart *ip, Particle::OnePart *jp,
   int n = reactions[isp][jsp].n;
   if (n == 0) return 0;
   int *list = reactions[isp][jsp].list;
+  double *emin = reactions[isp][jsp].emin;
+
+  // ecc_max = upper bound on collision energy of any reaction in list
+  // no reaction is possible once it is below threshold of all remaining ones
+
+  double ecc_max = pre_etrans;
+  if (pre_ave_rotdof > 0.1)
+    ecc_max += pre_erot*reactions[isp][jsp].zmax/pre_ave_rotdof;
+  if (ecc_max <= emin[0]) return 0;
 
   // probablity to compare to reaction probability
 
@@ -67,6 +77,7 @@ int ReactTCE::attempt(Particle::OnePart *ip, Particle::OnePart *jp,
   // loop over possible reactions for these 2 species
 
   for (int i = 0; i < n; i++) {
+    if (ecc_max <= emin[i]) break;
     r = &rlist[list[i]];
 
     // ignore energetically impossible reactions
@@ -86,6 +97,19 @@ int ReactTCE::attempt(Particle::OnePart *ip, Particle::OnePart *jp,
     case IONIZATION:
     case EXCHANGE:
       {
+        // interpolate in table of probability vs Ea/Ecc if it exists
+
+        if (ptable && tnbin[list[i]]) {
+          int m = list[i];
+          double x = r->coeff[1]/ecc * tnbin[m];
+          int k = static_cast<int> (x);
+          if (k >= tlo[m] && k < thi[m]) {
+            double *table = ptable[m];
+            react_prob += table[k] + (x-k)*(table[k+1]-table[k]);
+            break;
+          }
+        }
+
         react_prob += r->coeff[2] *
           pow(ecc-r->coeff[1],r->coeff[3]) *
           pow(1.0-r->coeff[1]/ecc,r->coeff[5]);
@@ -20,6 +20,7 @@
 #include "comm.h"
 #include "input.h"
 #include "hash3.h"
+#include "irregular.h"
 #include "memory.h"
 #include "error.h"
 
@@ -27,6 +28,7 @@ using namespace SPARTA_NS;
 
 #define MAXLINE 256
 #define CHUNK 1024
+#define DELTA 16384
 
 /* ---------------------------------------------------------------------- */
 
@@ -84,6 +86,7 @@ void ReadGrid::read(char *filename, int external)
       fprintf(screen,"Reading grid file ... %s\n",filename);
     open(filename);
   }
+  MPI_Bcast(&compressed,1,MPI_INT,0,world);
 
   // read header and Cells section
 
@@ -92,7 +95,8 @@ void ReadGrid::read(char *filename, int external)
   if (strcmp(keyword,"Cells") != 0)
     error->all(FLERR,
                "Read_grid did not find Cells section of grid file");
-  read_cells();
+  if (compressed) read_cells();
+  else read_cells_parallel(filename);
 
   // close file
 
@@ -189,19 +193,118 @@ void ReadGrid::read_cells()
   }
 }
 
+/* ----------------------------------------------------------------------
+   read/store all child cells with every proc reading part of file
+   each proc reads lines which start in its 1/P byte range of Cells section
+   cell IDs are sent to procs in same round-robin fashion as read_cells()
+   only used for uncompressed file, since gzipped file cannot be seeked
+------------------------------------------------------------------------- */
+
+void ReadGrid::read_cells_parallel(char *filename)
+{
+  int i,nlines;
+  bigint offset,filesize;
+
+  // proc 0 is positioned at start of Cells section
+  // other procs open file themselves
+
+  if (me == 0) {
+    offset = ftell(fp);
+    fseek(fp,0,SEEK_END);
+    filesize = ftell(fp);
+  }
+  MPI_Bcast(&offset,1,MPI_SPARTA_BIGINT,0,world);
+  MPI_Bcast(&filesize,1,MPI_SPARTA_BIGINT,0,world);
+
+  FILE *fpme;
+  if (me == 0) fpme = fp;
+  else {
+    fpme = fopen(filename,"r");
+    if (fpme == NULL) {
+      char str[128];
+      sprintf(str,"Cannot open file %s",filename);
+      error->one(FLERR,str);
+    }
+  }
+
+  // read first word of each non-blank line which starts in my byte range
+  // skip partial line at start of range, previous proc reads it
+
+  bigint lo = offset + me*(filesize-offset)/nprocs;
+  bigint hi = offset + (me+1)*(filesize-offset)/nprocs;
+
+  int maxids = 0;
+  cellint *ids = NULL;
+  nlines = 0;
+
+  if (lo > offset) {
+    fseek(fpme,lo-1,SEEK_SET);
+    if (fgetc(fpme) != '\n')
+      while (fgets(line,MAXLINE,fpme) && !strchr(line,'\n'));
+  } else fseek(fpme,lo,SEEK_SET);
+
+  char *word;
+  while (ftell(fpme) < hi) {
+    if (fgets(line,MAXLINE,fpme) == NULL) break;
+    word = strtok(line," \t\n\r\f");
+    if (word == NULL) continue;
+    if (nlines == maxids) {
+      maxids += DELTA;
+      memory->grow(ids,maxids,"read_grid:ids");
+    }
+    ids[nlines++] = ATOCELLINT(word);
+  }
+
+  if (me) fclose(fpme);
+
+  // first = index of my first line in Cells section
+  // lines beyond ncell are ignored
+
+  bigint bnlines = nlines;
+  bigint first,nall;
+  MPI_Scan(&bnlines,&first,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  first -= bnlines;
+  MPI_Allreduce(&bnlines,&nall,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  if (nall < ncell) error->all(FLERR,"Unexpected end of grid file");
+
+  if (first >= ncell) nlines = 0;
+  else if (first + nlines > ncell) nlines = ncell - first;
+
+  // send each cell ID to proc which owns it in round-robin ordering
+  // sort recv data by sending proc so cells are stored in file order
+
+  int *proclist;
+  memory->create(proclist,nlines,"read_grid:proclist");
+  for (i = 0; i < nlines; i++) proclist[i] = (first+i) % nprocs;
+
+  Irregular *irregular = new Irregular(sparta);
+  int nrecv = irregular->create_data_uniform(nlines,proclist,1);
+  cellint *rbuf;
+  memory->create(rbuf,nrecv,"read_grid:rbuf");
+  irregular->exchange_uniform((char *) ids,sizeof(cellint),(char *) rbuf);
+  delete irregular;
+
+  for (i = 0; i < nrecv; i++) add_cell(rbuf[i]);
+
+  memory->destroy(ids);
+  memory->destroy(proclist);
+  memory->destroy(rbuf);
+
+  grid->ncell = ncell;
+
+  if (me == 0) {
+    if (screen) fprintf(screen,"  " BIGINT_FORMAT " grid cells\n",grid->ncell);
+    if (logfile) fprintf(logfile,"  " BIGINT_FORMAT " grid cells\n",grid->ncell);
+  }
+}
+
 /* ----------------------------------------------------------------------
    create one child cell per line of Cells section of grid file
 ------------------------------------------------------------------------- */
 
 void ReadGrid::create_cells(int n, char *buf)
 {
-  int level;
-  cellint id;
   char *next,*idptr;
-  double lo[3],hi[3];
-
-  double *boxlo = domain->boxlo;
-  double *boxhi = domain->boxhi;
 
   // create one child cell for each line
   // assign to procs in round-robin fasion
@@ -211,13 +314,7 @@ void ReadGrid::create_cells(int n, char *buf)
 
     if (me == whichproc) {
       idptr = strtok(buf," \t\n\r\f");
-      id = ATOCELLINT(idptr);
-      if (id < 0) error->all(FLERR,"Invalid cell ID in grid file");
-
-      level = grid->id_level(id);
-      if (level < 0) error->one(FLERR,"Cell ID in grid file exceeds maxlevel");
-      grid->id_lohi(id,level,boxlo,boxhi,lo,hi);
-      grid->add_child_cell(id,level,lo,hi);
+      add_cell(ATOCELLINT(idptr));
     }
 
     whichproc++;
@@ -227,6 +324,23 @@ void ReadGrid::create_cells(int n, char *buf)
   }
 }
 
+/* ----------------------------------------------------------------------
+   add a child cell with ID to my owned cells
+------------------------------------------------------------------------- */
+
+void ReadGrid::add_cell(cellint id)
+{
+  int level;
+  double lo[3],hi[3];
+
+  if (id < 0) error->one(FLERR,"Invalid cell ID in grid file");
+
+  level = grid->id_level(id);
+  if (level < 0) error->one(FLERR,"Cell ID in grid file exceeds maxlevel");
+  grid->id_lohi(id,level,domain->boxlo,domain->boxhi,lo,hi);
+  grid->add_child_cell(id,level,lo,hi);
+}
+
 /* ----------------------------------------------------------------------
    proc 0 opens grid file
    test if gzipped
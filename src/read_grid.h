@@ -51,7 +51,9 @@ class ReadGrid : protected Pointers {
   };
 
   void read_cells();
+  void read_cells_parallel(char *);
   void create_cells(int, char *);
+  void add_cell(cellint);
   void open(char *);
   void header();
   void parse_keyword(int);
@@ -21,6 +21,7 @@
 #include "domain.h"
 #include "comm.h"
 #include "input.h"
+#include "irregular.h"
 #include "memory.h"
 #include "error.h"
 
@@ -30,6 +31,7 @@ enum{UNKNOWN,OUTSIDE,INSIDE,OVERLAP};   // same as Grid
 
 #define MAXLINE 1024        // max line length in dump file
 #define CHUNK 1024
+#define DELTA 16384
 
 /* ---------------------------------------------------------------------- */
 
@@ -90,27 +92,127 @@ void ReadParticles::command(int narg, char **arg)
   if (me == 0) np = read_header();
   MPI_Bcast(&np,1,MPI_INT,0,world);
 
-  // read, broadcast, and process particles from snapshot in chunks
+  // each proc reads particle lines which start in its 1/P byte range
+  //   from start of snapshot to end of file
   // for now, assume fields are ID,ispecies,x,y,z,vx,vy,vz
 
+  bigint offset,filesize;
+  if (me == 0) {
+    offset = ftell(fp);
+    fseek(fp,0,SEEK_END);
+    filesize = ftell(fp);
+  }
+  MPI_Bcast(&offset,1,MPI_SPARTA_BIGINT,0,world);
+  MPI_Bcast(&filesize,1,MPI_SPARTA_BIGINT,0,world);
+
+  if (me) {
+    fp = fopen(file,"r");
+    if (fp == NULL) error->one(FLERR,"Read_particles could not open file");
+  }
+
   int nfield = 8;
-  double **fields;
-  memory->create(fields,CHUNK,nfield,"read_particles:fields");
+  double **fields = NULL;
 
   int nlocal_previous = particle->nlocal;
   bigint nglobal_previous = particle->nglobal;
 
-  int nchunk;
-  bigint nread = 0;
-  while (nread < np) {
-    nchunk = MIN(np-nread,CHUNK);
-    if (me == 0) read_particles(nchunk,nfield,fields);
-    MPI_Bcast(&fields[0][0],nchunk*nfield,MPI_DOUBLE,0,world);
-    process_particles(nchunk,nfield,fields);
-    nread += nchunk;
+  int n = read_range(offset,filesize,np,nfield,fields);
+
+  // find proc which owns grid cell of each particle via my owned+ghost cells
+  // discard particles outside simulation box
+  // compress particles to send to owning procs, in file order
+  // particles in cells I do not know are saved in others
+
+  Grid::ChildCell *cells = grid->cells;
+  double *boxlo = domain->boxlo;
+  double *boxhi = domain->boxhi;
+
+  int i,m,icell;
+  double *x;
+
+  int *proclist;
+  memory->create(proclist,n,"read_particles:proclist");
+
+  int nsend = 0;
+  int nother = 0;
+  double **others = NULL;
+
+  for (i = 0; i < n; i++) {
+    x = &fields[i][2];
+    if (x[0] < boxlo[0] || x[0] > boxhi[0] ||
+        x[1] < boxlo[1] || x[1] > boxhi[1] ||
+        x[2] < boxlo[2] || x[2] > boxhi[2]) continue;
+
+    icell = grid->id_find_child(0,0,boxlo,boxhi,x);
+    if (icell < 0) {
+      if (others == NULL)
+        memory->create(others,n-i,nfield,"read_particles:others");
+      for (m = 0; m < nfield; m++) others[nother][m] = fields[i][m];
+      nother++;
+      continue;
+    }
+
+    proclist[nsend] = cells[icell].proc;
+    if (nsend != i)
+      for (m = 0; m < nfield; m++) fields[nsend][m] = fields[i][m];
+    nsend++;
   }
 
+  // single irregular comm of particles to owning procs
+  // sort recv data by sending proc so particles are stored in file order
+
+  Irregular *irregular = new Irregular(sparta);
+  int nrecv = irregular->create_data_uniform(nsend,proclist,1);
+  double **rbuf = NULL;
+  if (nrecv) memory->create(rbuf,nrecv,nfield,"read_particles:rbuf");
+  irregular->exchange_uniform(n ? (char *) &fields[0][0] : NULL,
+                              nfield*sizeof(double),
+                              nrecv ? (char *) &rbuf[0][0] : NULL);
+  delete irregular;
+
+  process_particles(nrecv,nfield,rbuf);
+
   memory->destroy(fields);
+  memory->destroy(proclist);
+  memory->destroy(rbuf);
+
+  // particles in cells no proc knew about, only possible for ghost cutoff
+  //   set by global gridcut, are gathered by all procs in chunks
+  // each proc stores the ones in grid cells it owns
+
+  bigint nothertotal;
+  bigint bother = nother;
+  MPI_Allreduce(&bother,&nothertotal,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+
+  if (nothertotal) {
+    int nprocs = comm->nprocs;
+    int *recvcounts = new int[nprocs];
+    int *displs = new int[nprocs];
+    double **allothers;
+    memory->create(allothers,nprocs*CHUNK,nfield,"read_particles:allothers");
+
+    int nchunk,nall,iproc;
+    int ndone = 0;
+    while (nothertotal) {
+      nchunk = MIN(nother-ndone,CHUNK) * nfield;
+      MPI_Allgather(&nchunk,1,MPI_INT,recvcounts,1,MPI_INT,world);
+      displs[0] = 0;
+      for (iproc = 1; iproc < nprocs; iproc++)
+        displs[iproc] = displs[iproc-1] + recvcounts[iproc-1];
+      nall = displs[nprocs-1] + recvcounts[nprocs-1];
+      MPI_Allgatherv(nchunk ? &others[ndone][0] : NULL,nchunk,MPI_DOUBLE,
+                     &allothers[0][0],recvcounts,displs,MPI_DOUBLE,world);
+      process_particles(nall/nfield,nfield,allothers);
+      ndone += nchunk/nfield;
+      nothertotal -= nall/nfield;
+    }
+
+    delete [] recvcounts;
+    delete [] displs;
+    memory->destroy(allothers);
+  }
+
+  memory->destroy(others);
 
   MPI_Barrier(world);
   double time2 = MPI_Wtime();
@@ -122,7 +224,7 @@ void ReadParticles::command(int narg, char **arg)
 
   int flag = 0;
 
-  for (int i = nlocal_previous; i < nlocal; i++)
+  for (i = nlocal_previous; i < nlocal; i++)
     if (particles[i].ispecies > nspecies) flag++;
 
   int flagall;
@@ -138,7 +240,7 @@ void ReadParticles::command(int narg, char **arg)
   Grid::ChildInfo *cinfo = grid->cinfo;
 
   flag = 0;
-  for (int i = nlocal_previous; i < nlocal; i++)
+  for (i = nlocal_previous; i < nlocal; i++)
     if (cinfo[particles[i].icell].type == INSIDE) flag++;
 
   MPI_Allreduce(&flag,&flagall,1,MPI_INT,MPI_SUM,world);
@@ -150,7 +252,7 @@ void ReadParticles::command(int narg, char **arg)
 
   // close file
 
-  if (me == 0) fclose(fp);
+  fclose(fp);
   delete [] line;
 
   // print stats
@@ -188,6 +290,8 @@ void ReadParticles::process_particles(int n, int, double **fields)
   double *boxlo = domain->boxlo;
   double *boxhi = domain->boxhi;
 
+  particle->reserve(n);
+
   for (int i = 0; i < n; i++) {
     x[0] = fields[i][2];
     x[1] = fields[i][3];
@@ -279,37 +383,86 @@ bigint ReadParticles::read_header()
 }
 
 /* ----------------------------------------------------------------------
-   read N particle lines from dump file
-   stores appropriate values in fields array
-   return 0 if success, 1 if error
-   only called by proc 0
+   read particle lines which start in my 1/P byte range of file
+   offset = start of particle lines of snapshot, filesize = end of file
+   a partial line at start of range is read by previous proc
+   stop at next snapshot, lines beyond Np particles are also discarded
+   store fields of each line in fields array, grown as needed
+   return # of lines I read which are particles of the snapshot
 ------------------------------------------------------------------------- */
 
-void ReadParticles::read_particles(int n, int nfield, double **fields)
+int ReadParticles::read_range(bigint offset, bigint filesize, int np,
+                              int nfield, double **&fields)
 {
-  int i,m,nwords;
-  char *eof,*word;
-
-  for (i = 0; i < n; i++) {
-    eof = fgets(line,MAXLINE,fp);
-    if (eof == NULL) error->one(FLERR,"Unexpected end of read_particles file");
-
-    if (i == 0) {
-      nwords = input->count_words(line);
-      if (nwords != nfield)
-        error->one(FLERR,"Bad particle line in read_particles file");
+  int m;
+  char *word;
+
+  int nprocs = comm->nprocs;
+  bigint lo = offset + me*(filesize-offset)/nprocs;
+  bigint hi = offset + (me+1)*(filesize-offset)/nprocs;
+
+  if (lo > offset) {
+    fseek(fp,lo-1,SEEK_SET);
+    if (fgetc(fp) != '\n')
+      while (fgets(line,MAXLINE,fp) && !strchr(line,'\n'));
+  } else fseek(fp,lo,SEEK_SET);
+
+  // tokenize each line and convert words to fields
+  // firstbad = 1st line with wrong # of words, only an error if kept
+
+  int n = 0;
+  int maxfields = 0;
+  int firstbad = -1;
+  int itemflag = 0;
+
+  while (ftell(fp) < hi) {
+    if (fgets(line,MAXLINE,fp) == NULL) break;
+    if (strstr(line,"ITEM:") == line) {
+      itemflag = 1;
+      break;
     }
 
-    // tokenize the line and convert words to fields
+    if (n == maxfields) {
+      maxfields += DELTA;
+      memory->grow(fields,maxfields,nfield,"read_particles:fields");
+    }
 
     for (m = 0; m < nfield; m++) {
       if (m == 0) word = strtok(line," \t\n\r\f");
       else word = strtok(NULL," \t\n\r\f");
-      if (word == NULL)
-        error->one(FLERR,"Bad particle line in read_particles file");
-      fields[i][m] = atof(word);
+      if (word == NULL) break;
+      fields[n][m] = atof(word);
     }
+    if ((m < nfield || strtok(NULL," \t\n\r\f")) && firstbad < 0)
+      firstbad = n;
+    n++;
   }
+
+  // first = index of my first line in snapshot
+  // discard my lines if a previous proc reached next snapshot
+  // else discard my lines beyond Np
+
+  bigint bn = n;
+  bigint first;
+  MPI_Scan(&bn,&first,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  first -= bn;
+
+  int itemprev;
+  MPI_Scan(&itemflag,&itemprev,1,MPI_INT,MPI_SUM,world);
+  itemprev -= itemflag;
+
+  if (itemprev || first >= np) n = 0;
+  else if (first + n > np) n = np - first;
+
+  if (firstbad >= 0 && firstbad < n)
+    error->one(FLERR,"Bad particle line in read_particles file");
+
+  bigint nall;
+  bn = n;
+  MPI_Allreduce(&bn,&nall,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  if (nall < np) error->all(FLERR,"Unexpected end of read_particles file");
+
+  return n;
 }
 
 /* ----------------------------------------------------------------------
@@ -42,7 +42,7 @@ class ReadParticles : protected Pointers {
   int read_time(bigint &);
   void skip();
   bigint read_header();
-  void read_particles(int, int, double **);
+  int read_range(bigint, bigint, int, int, double **&);
   void read_lines(int);
 };
 
@@ -1232,6 +1232,8 @@ void ReadRestart::create_child_cells(int skipflag)
   cellint *ids = grid->id_restart;
   int *levels = grid->level_restart;
   int *nsplits = grid->nsplit_restart;
+  int *dtlevels = grid->dtlevel_restart;
+  double *weights = grid->weight_restart;
 
   for (int i = 0; i < nlocal; i++) {
     id = ids[i];
@@ -1251,6 +1253,8 @@ void ReadRestart::create_child_cells(int skipflag)
       icell = grid->nlocal - 1;
       (*hash)[id] = icell;
       grid->cells[icell].nsplit = nsplit;
+      grid->cells[icell].dtlevel = dtlevels[i];
+      grid->cinfo[icell].weight = weights[i];
       if (nsplit > 1) {
         grid->nunsplitlocal--;
         grid->add_split_cell(1);
@@ -1271,6 +1275,8 @@ void ReadRestart::create_child_cells(int skipflag)
       grid->add_sub_cell(index,1);
       icell = grid->nlocal - 1;
       grid->cells[icell].nsplit = nsplit;
+      grid->cells[icell].dtlevel = dtlevels[i];
+      grid->cinfo[icell].weight = weights[i];
       isplit = grid->cells[icell].isplit;
       grid->sinfo[isplit].csubs[-nsplit] = icell;
     }
@@ -1281,6 +1287,8 @@ void ReadRestart::create_child_cells(int skipflag)
   memory->destroy(grid->id_restart);
   memory->destroy(grid->level_restart);
   memory->destroy(grid->nsplit_restart);
+  memory->destroy(grid->dtlevel_restart);
+  memory->destroy(grid->weight_restart);
 }
 
 /* ----------------------------------------------------------------------
@@ -1308,6 +1316,8 @@ void ReadRestart::assign_particles(int skipflag)
 
   Particle::OnePartRestart *p;
 
+  particle->reserve(nlocal);
+
   for (int i = 0; i < nlocal; i++) {
     p = (Particle::OnePartRestart *) ptr;
     if (skipflag && hash->find(p->icell) == hash->end()) {
@@ -39,6 +39,12 @@ class Region : protected Pointers {
 
   virtual int inside(double *) = 0;
 
+  // flat copy of geometry so accelerator styles can test points themselves
+  // stores at most MAXGEOMETRY values, returns 0 if region cannot
+
+  enum{MAXGEOMETRY=6};
+  virtual int geometry(double *) {return 0;}
+
  protected:
   void options(int, char **);
 };
@@ -74,3 +74,18 @@ int RegBlock::inside(double *x)
     return 1;
   return 0;
 }
+
+/* ----------------------------------------------------------------------
+   store geometry in params, return # of values stored
+------------------------------------------------------------------------- */
+
+int RegBlock::geometry(double *params)
+{
+  params[0] = xlo;
+  params[1] = xhi;
+  params[2] = ylo;
+  params[3] = yhi;
+  params[4] = zlo;
+  params[5] = zhi;
+  return 6;
+}
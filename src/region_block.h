@@ -29,6 +29,7 @@ class RegBlock : public Region {
  public:
   RegBlock(class SPARTA *, int, char **);
   int inside(double *);
+  int geometry(double *);
 
  private:
   double xlo,xhi,ylo,yhi,zlo,zhi;
@@ -110,3 +110,20 @@ int RegCylinder::inside(double *x)
 
   return inside;
 }
+
+/* ----------------------------------------------------------------------
+   store geometry in params, return # of values stored
+------------------------------------------------------------------------- */
+
+int RegCylinder::geometry(double *params)
+{
+  if (axis == 'x') params[0] = 0;
+  else if (axis == 'y') params[0] = 1;
+  else params[0] = 2;
+  params[1] = c1;
+  params[2] = c2;
+  params[3] = radius;
+  params[4] = lo;
+  params[5] = hi;
+  return 6;
+}
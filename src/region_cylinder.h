@@ -29,6 +29,7 @@ class RegCylinder : public Region {
  public:
   RegCylinder(class SPARTA *, int, char **);
   int inside(double *);
+  int geometry(double *);
 
  private:
   char axis;
@@ -60,3 +60,18 @@ int RegPlane::inside(double *x)
   if (dot >= 0.0) return 1;
   return 0;
 }
+
+/* ----------------------------------------------------------------------
+   store geometry in params, return # of values stored
+------------------------------------------------------------------------- */
+
+int RegPlane::geometry(double *params)
+{
+  params[0] = xp;
+  params[1] = yp;
+  params[2] = zp;
+  params[3] = normal[0];
+  params[4] = normal[1];
+  params[5] = normal[2];
+  return 6;
+}
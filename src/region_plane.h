@@ -29,6 +29,7 @@ class RegPlane : public Region {
  public:
   RegPlane(class SPARTA *, int, char **);
   int inside(double *);
+  int geometry(double *);
 
  private:
   double xp,yp,zp;
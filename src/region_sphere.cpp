@@ -64,3 +64,16 @@ int RegSphere::inside(double *x)
   if (r <= radius) return 1;
   return 0;
 }
+
+/* ----------------------------------------------------------------------
+   store geometry in params, return # of values stored
+------------------------------------------------------------------------- */
+
+int RegSphere::geometry(double *params)
+{
+  params[0] = xc;
+  params[1] = yc;
+  params[2] = zc;
+  params[3] = radius;
+  return 4;
+}
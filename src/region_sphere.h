@@ -29,6 +29,7 @@ class RegSphere : public Region {
  public:
   RegSphere(class SPARTA *, int, char **);
   int inside(double *);
+  int geometry(double *);
 
  private:
   double xc,yc,zc;
@@ -216,11 +216,15 @@ void Run::command(int narg, char **arg)
       time_multiple_runs += timer->array[TIME_LOOP];
 
       Finish finish(sparta);
-      if (postflag || nleft <= nsteps) {
+      if (postflag || nleft <= nsteps || update->haltflag) {
         if (preflag) finish.end(1,0.0);
         else finish.end(1,time_multiple_runs);
       } else finish.end(0,0.0);
 
+      // a fix ended the run early, skip remaining runs and commands
+
+      if (update->haltflag) break;
+
       // wrap command invocation with clearstep/addstep
       // since a command may invoke computes via variables
 
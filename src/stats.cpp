@@ -240,17 +240,23 @@ void Stats::compute(int flag)
   for (i = 0; i < ncompute; i++)
     if (compute_which[i] == SCALAR) {
       if (!(computes[i]->invoked_flag & INVOKED_SCALAR)) {
+        modify->invoke_begin(computes[i]);
         computes[i]->compute_scalar();
+        modify->invoke_end();
         computes[i]->invoked_flag |= INVOKED_SCALAR;
       }
     } else if (compute_which[i] == VECTOR) {
       if (!(computes[i]->invoked_flag & INVOKED_VECTOR)) {
+        modify->invoke_begin(computes[i]);
         computes[i]->compute_vector();
+        modify->invoke_end();
         computes[i]->invoked_flag |= INVOKED_VECTOR;
       }
     } else if (compute_which[i] == ARRAY) {
       if (!(computes[i]->invoked_flag & INVOKED_ARRAY)) {
+        modify->invoke_begin(computes[i]);
         computes[i]->compute_array();
+        modify->invoke_end();
         computes[i]->invoked_flag |= INVOKED_ARRAY;
       }
     }
@@ -414,20 +414,31 @@ void Surf::add_line(surfint id, int itype, double *p1, double *p2)
     grow(nmax-DELTA);
   }
 
-  lines[nlocal].id = id;
-  lines[nlocal].type = itype;
-  lines[nlocal].mask = 1;
-  lines[nlocal].isc = lines[nlocal].isr = -1;
-  lines[nlocal].p1[0] = p1[0];
-  lines[nlocal].p1[1] = p1[1];
-  lines[nlocal].p1[2] = 0.0;
-  lines[nlocal].p2[0] = p2[0];
-  lines[nlocal].p2[1] = p2[1];
-  lines[nlocal].p2[2] = 0.0;
-  lines[nlocal].transparent = 0;
+  set_line(nlocal,id,itype,p1,p2);
   nlocal++;
 }
 
+/* ----------------------------------------------------------------------
+   set line I in lines list, I must already be allocated via reserve()
+   does not change nlocal, so multiple callers can fill disjoint lines
+   called by add_line() and Marching Squares
+------------------------------------------------------------------------- */
+
+void Surf::set_line(int i, surfint id, int itype, double *p1, double *p2)
+{
+  lines[i].id = id;
+  lines[i].type = itype;
+  lines[i].mask = 1;
+  lines[i].isc = lines[i].isr = -1;
+  lines[i].p1[0] = p1[0];
+  lines[i].p1[1] = p1[1];
+  lines[i].p1[2] = 0.0;
+  lines[i].p2[0] = p2[0];
+  lines[i].p2[1] = p2[1];
+  lines[i].p2[2] = 0.0;
+  lines[i].transparent = 0;
+}
+
 /* ----------------------------------------------------------------------
    add a line to owned or ghost lines list, depending on ownflag
    called by Grid::unpack_one() or Grid::coarsen_cell()
@@ -529,23 +540,50 @@ void Surf::add_tri(surfint id, int itype, double *p1, double *p2, double *p3)
     grow(nmax-DELTA);
   }
 
-  tris[nlocal].id = id;
-  tris[nlocal].type = itype;
-  tris[nlocal].mask = 1;
-  tris[nlocal].isc = tris[nlocal].isr = -1;
-  tris[nlocal].p1[0] = p1[0];
-  tris[nlocal].p1[1] = p1[1];
-  tris[nlocal].p1[2] = p1[2];
-  tris[nlocal].p2[0] = p2[0];
-  tris[nlocal].p2[1] = p2[1];
-  tris[nlocal].p2[2] = p2[2];
-  tris[nlocal].p3[0] = p3[0];
-  tris[nlocal].p3[1] = p3[1];
-  tris[nlocal].p3[2] = p3[2];
-  tris[nlocal].transparent = 0;
+  set_tri(nlocal,id,itype,p1,p2,p3);
   nlocal++;
 }
 
+/* ----------------------------------------------------------------------
+   set triangle I in tris list, I must already be allocated via reserve()
+   does not change nlocal, so multiple callers can fill disjoint tris
+   called by add_tri() and Marching Cubes
+------------------------------------------------------------------------- */
+
+void Surf::set_tri(int i, surfint id, int itype,
+                   double *p1, double *p2, double *p3)
+{
+  tris[i].id = id;
+  tris[i].type = itype;
+  tris[i].mask = 1;
+  tris[i].isc = tris[i].isr = -1;
+  tris[i].p1[0] = p1[0];
+  tris[i].p1[1] = p1[1];
+  tris[i].p1[2] = p1[2];
+  tris[i].p2[0] = p2[0];
+  tris[i].p2[1] = p2[1];
+  tris[i].p2[2] = p2[2];
+  tris[i].p3[0] = p3[0];
+  tris[i].p3[1] = p3[1];
+  tris[i].p3[2] = p3[2];
+  tris[i].transparent = 0;
+}
+
+/* ----------------------------------------------------------------------
+   insure lines/tris list has room for N more owned surfs
+   caller then fills them via set_line() or set_tri() and bumps nlocal
+------------------------------------------------------------------------- */
+
+void Surf::reserve(int n)
+{
+  if ((bigint) nlocal + n <= nmax) return;
+  if ((bigint) nlocal + n + DELTA > MAXSMALLINT)
+    error->one(FLERR,"Surf reserve overflowed");
+  int old = nmax;
+  nmax = nlocal + n + DELTA;
+  grow(old);
+}
+
 /* ----------------------------------------------------------------------
    add a triangle to owned or ghost list, depending on ownflag
    called by Grid::unpack_one
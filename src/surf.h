@@ -170,10 +170,13 @@ class Surf : protected Pointers {
   void clear();
   void remove_ghosts();
   void add_line(surfint, int, double *, double *);
+  void set_line(int, surfint, int, double *, double *);
   void add_line_copy(int, Line *);
   void add_line_own(surfint, int, double *, double *);
   void add_line_temporary(surfint, int, double *, double *);
   void add_tri(surfint, int, double *, double *, double *);
+  void set_tri(int, surfint, int, double *, double *, double *);
+  void reserve(int);
   void add_tri_copy(int, Tri *);
   void add_tri_own(surfint, int, double *, double *, double *);
   void add_tri_own_clip(surfint, int, double *, double *, double *);
@@ -15,10 +15,17 @@
 #include "mpi.h"
 #include "ctype.h"
 #include "string.h"
+#include "math.h"
 #include "surf_collide.h"
+#include "random_knuth.h"
+#include "math_const.h"
+#include "memory.h"
 #include "error.h"
 
 using namespace SPARTA_NS;
+using namespace MathConst;
+
+#define NBLOCK 256              // must be even
 
 /* ---------------------------------------------------------------------- */
 
@@ -50,6 +57,11 @@ SurfCollide::SurfCollide(SPARTA *sparta, int, char **arg) :
   nsingle = ntotal = 0;
 
   kokkosable = copy = copymode = 0;
+
+  vrandom = NULL;
+  nblock = NBLOCK;
+  ihalf = igauss = nblock;
+  vhalf = vgauss = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -60,6 +72,8 @@ SurfCollide::~SurfCollide()
 
   delete [] id;
   delete [] style;
+  memory->destroy(vhalf);
+  memory->destroy(vgauss);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -93,3 +107,38 @@ double SurfCollide::compute_vector(int i)
 
   return all[i];
 }
+
+/* ----------------------------------------------------------------------
+   refill block of half-range variates for normal velocity of wall flux
+   draw all uniform RNs first, so transform loop has no dependencies
+------------------------------------------------------------------------- */
+
+void SurfCollide::refill_half()
+{
+  if (!vhalf) memory->create(vhalf,nblock,"surf_collide:vhalf");
+
+  for (int i = 0; i < nblock; i++) vhalf[i] = vrandom->uniform();
+  for (int i = 0; i < nblock; i++) vhalf[i] = sqrt(-log(vhalf[i]));
+
+  ihalf = 0;
+}
+
+/* ----------------------------------------------------------------------
+   refill block of Box-Muller pairs for tangential velocities
+   pair = sqrt(-ln U1) * (cos,sin)(2 PI U2), each value is N(0,1/2)
+------------------------------------------------------------------------- */
+
+void SurfCollide::refill_gauss()
+{
+  if (!vgauss) memory->create(vgauss,nblock,"surf_collide:vgauss");
+
+  for (int i = 0; i < nblock; i++) vgauss[i] = vrandom->uniform();
+  for (int i = 0; i < nblock; i += 2) {
+    double r = sqrt(-log(vgauss[i]));
+    double theta = MY_2PI * vgauss[i+1];
+    vgauss[i] = r * cos(theta);
+    vgauss[i+1] = r * sin(theta);
+  }
+
+  igauss = 0;
+}
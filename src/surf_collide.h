@@ -59,6 +59,32 @@ class SurfCollide : protected Pointers {
 
   int ntotal;
   double one[2],all[2];
+
+  // blocks of precomputed random variates for thermal wall models,
+  //   drawn from vrandom which is set by a derived class that uses them
+  // caller scales them by most probable speed vrm of hitting species
+
+  class RanKnuth *vrandom;
+  int nblock;               // # of variates in each block
+  int ihalf,igauss;         // index of next unused variate in each block
+  double *vhalf;            // sqrt(-ln U) = normal speed / vrm of
+                            //   a one-sided Maxwellian flux
+  double *vgauss;           // Box-Muller pairs, each N(0,1/2)
+                            //   = tangential velocity / vrm of a Maxwellian
+
+  double half_variate() {
+    if (ihalf == nblock) refill_half();
+    return vhalf[ihalf++];
+  }
+
+  void gauss_pair(double &g1, double &g2) {
+    if (igauss == nblock) refill_gauss();
+    g1 = vgauss[igauss++];
+    g2 = vgauss[igauss++];
+  }
+
+  void refill_half();
+  void refill_gauss();
 };
 
 }
@@ -142,6 +142,7 @@ SurfCollideCLL::SurfCollideCLL(SPARTA *sparta, int narg, char **arg) :
   random = new RanKnuth(update->ranmaster->uniform());
   double seed = update->ranmaster->uniform();
   random->reset(seed,comm->me,100);
+  vrandom = random;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -285,19 +286,23 @@ void SurfCollideCLL::cll(Particle::OnePart *p, double *norm)
   vrm = sqrt(2.0*update->boltz * twall / species[ispecies].mass);
 
   // CLL model normal velocity
+  // r cos(theta), r sin(theta) with r = sqrt(-acc ln U), theta = 2 PI U
+  //   are a precomputed Box-Muller pair scaled by sqrt(acc)
+  // so r^2 + d^2 + 2 r d cos(theta) = (r cos(theta) + d)^2 + (r sin(theta))^2
 
-  double r_1 = sqrt(-acc_n*log(random->uniform()));
-  double theta_1 = MY_2PI * random->uniform();
+  double g1,g2;
+  gauss_pair(g1,g2);
   double dot_norm = dot/vrm * sqrt(1-acc_n);
-  vperp = vrm * sqrt(r_1*r_1 + dot_norm*dot_norm + 2*r_1*dot_norm*cos(theta_1));
+  double a_1 = sqrt(acc_n)*g1 + dot_norm;
+  double b_1 = sqrt(acc_n)*g2;
+  vperp = vrm * sqrt(a_1*a_1 + b_1*b_1);
 
   // CLL model tangential velocities
 
-  double r_2 = sqrt(-acc_t*log(random->uniform()));
-  double theta_2 = MY_2PI * random->uniform();
+  gauss_pair(g1,g2);
   double vtangent = tan1/vrm * sqrt(1-acc_t);
-  vtan1 = vrm * (vtangent + r_2*cos(theta_2));
-  vtan2 = vrm * r_2 * sin(theta_2);
+  vtan1 = vrm * (vtangent + sqrt(acc_t)*g1);
+  vtan2 = vrm * sqrt(acc_t)*g2;
 
   // partial keyword
   // incomplete energy accommodation with partial/fully diffuse scattering
@@ -117,6 +117,7 @@ SurfCollideDiffuse::SurfCollideDiffuse(SPARTA *sparta, int narg, char **arg) :
   random = new RanKnuth(update->ranmaster->uniform());
   double seed = update->ranmaster->uniform();
   random->reset(seed,comm->me,100);
+  vrandom = random;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -248,10 +249,11 @@ void SurfCollideDiffuse::diffuse(Particle::OnePart *p, double *norm)
   // vrm = most probable speed of species, eqns (4.1) and (4.7)
   // vperp = velocity component perpendicular to surface along norm, eqn (12.3)
   // vtan12 = 2 velocity components tangential to surface
-  // tangent1 = component of particle v tangential to surface,
-  //   check if tangent1 = 0 (normal collision), set randomly
-  // tangent2 = norm x tangent1 = orthogonal tangential direction
-  // tangent12 are both unit vectors
+  // vperp and vtan12 are precomputed variates scaled by vrm
+  // tangent12 = any orthonormal tangential directions,
+  //   since vtan12 are isotropic in the tangent plane
+  // tangent1 = norm x coord axis least aligned with norm
+  // tangent2 = norm x tangent1
 
   } else {
     double tangent1[3],tangent2[3];
@@ -259,29 +261,23 @@ void SurfCollideDiffuse::diffuse(Particle::OnePart *p, double *norm)
     int ispecies = p->ispecies;
 
     double vrm = sqrt(2.0*update->boltz * twall / species[ispecies].mass);
-    double vperp = vrm * sqrt(-log(random->uniform()));
+    double vperp = vrm * half_variate();
 
-    double theta = MY_2PI * random->uniform();
-    double vtangent = vrm * sqrt(-log(random->uniform()));
-    double vtan1 = vtangent * sin(theta);
-    double vtan2 = vtangent * cos(theta);
+    double vtan1,vtan2;
+    gauss_pair(vtan1,vtan2);
+    vtan1 *= vrm;
+    vtan2 *= vrm;
 
     double *v = p->v;
-    double dot = MathExtra::dot3(v,norm);
-
     double beta_un,normalized_distbn_fn;
 
-    tangent1[0] = v[0] - dot*norm[0];
-    tangent1[1] = v[1] - dot*norm[1];
-    tangent1[2] = v[2] - dot*norm[2];
-
-    if (MathExtra::lensq3(tangent1) == 0.0) {
-      tangent2[0] = random->uniform();
-      tangent2[1] = random->uniform();
-      tangent2[2] = random->uniform();
-      MathExtra::cross3(norm,tangent2,tangent1);
-    }
+    double axis[3] = {0.0,0.0,0.0};
+    if (fabs(norm[0]) <= fabs(norm[1]) && fabs(norm[0]) <= fabs(norm[2]))
+      axis[0] = 1.0;
+    else if (fabs(norm[1]) <= fabs(norm[2])) axis[1] = 1.0;
+    else axis[2] = 1.0;
 
+    MathExtra::cross3(norm,axis,tangent1);
     MathExtra::norm3(tangent1);
     MathExtra::cross3(norm,tangent1,tangent2);
 
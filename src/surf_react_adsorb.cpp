@@ -154,6 +154,10 @@ SurfReactAdsorb::SurfReactAdsorb(SPARTA *sparta, int narg, char **arg) :
   rlist_gs = NULL;
   reactions_gs = NULL;
   indices_gs = NULL;
+  gs_cacheable = NULL;
+  gs_cumprob = NULL;
+  gs_stamp = NULL;
+  state_stamp = 0;
 
   nlist_ps = maxlist_ps = 0;
   rlist_ps = NULL;
@@ -252,6 +256,9 @@ SurfReactAdsorb::~SurfReactAdsorb()
     memory->destroy(rlist_gs);
     memory->destroy(reactions_gs);
     memory->destroy(indices_gs);
+    memory->destroy(gs_cacheable);
+    memory->destroy(gs_cumprob);
+    memory->destroy(gs_stamp);
   }
 
   // PS chemistry
@@ -502,6 +509,37 @@ void SurfReactAdsorb::init()
   if (gsflag) init_reactions_gs();
   if (psflag) init_reactions_ps();
 
+  // per-face or per-surf tables of cumulative GS reaction probabilities
+  // one row per face or surf, columns are aligned with indices_gs
+  // gs_stamp = state_stamp when row of a species is current
+  // species with a CI reaction using particle energy are not tabulated
+
+  if (gsflag) {
+    int nspecies = particle->nspecies;
+    int nrow = (mode == FACE) ? nface : surf->nlocal;
+    int ncol = 0;
+    for (int isp = 0; isp < nspecies; isp++) ncol += reactions_gs[isp].n;
+
+    memory->destroy(gs_cacheable);
+    memory->destroy(gs_cumprob);
+    memory->destroy(gs_stamp);
+    memory->create(gs_cacheable,nspecies,"react/adsorb:gs_cacheable");
+    memory->create(gs_cumprob,nrow,MAX(ncol,1),"react/adsorb:gs_cumprob");
+    memory->create(gs_stamp,nrow,nspecies,"react/adsorb:gs_stamp");
+
+    for (int isp = 0; isp < nspecies; isp++) {
+      gs_cacheable[isp] = 1;
+      for (int i = 0; i < reactions_gs[isp].n; i++) {
+        OneReaction_GS *r = &rlist_gs[reactions_gs[isp].list[i]];
+        if (r->type == CI && r->energy_flag) gs_cacheable[isp] = 0;
+      }
+    }
+
+    state_stamp++;
+    for (int i = 0; i < nrow; i++)
+      for (int isp = 0; isp < nspecies; isp++) gs_stamp[i][isp] = -1;
+  }
+
   // initialze tau only for PS models
 
   if (psflag) {
@@ -598,261 +636,54 @@ int SurfReactAdsorb::react(Particle::OnePart *&ip, int isurf, double *norm,
   int n = reactions_gs[ip->ispecies].n;
   if (n == 0) return 0;
 
-  double fnum = update->fnum;
-  long int maxstick = ceil(max_cover*area[isurf] / (fnum*weight[isurf]));
-  double factor = fnum * weight[isurf] / area[isurf];
-  double ms_inv = factor / max_cover;
-
-  // loop over possible reactions for this species
-
-  Particle::Species *species = particle->species;
-
-  OneReaction_GS *r;
-  double prob_value[n], sum_prob = 0.0;
-  double scatter_prob = 0.0, correction = 1.0;
-  //int check_ads = 0, ads_index = -1;
-
-  int coeff_val = 1;
-
-  for (int i = 0; i < n; i++) {
-    r = &rlist_gs[list[i]];
-
-    if (r->style == ARRHENIUS) coeff_val = 3;
-
-    switch (r->type) {
-    case DISSOCIATION:
-      {
-        //prob_value[i] = r->coeff[0];
-        prob_value[i] = r->k_react;
-        break;
-      }
-
-    case EXCHANGE:
-      {
-        //prob_value[i] = r->coeff[0];
-        prob_value[i] = r->k_react;
-        break;
-      }
-
-    case RECOMBINATION:
-      {
-        //prob_value[i] = r->coeff[0];
-        prob_value[i] = r->k_react;
-        break;
-      }
-
-    case AA:
-      {
-        //check_ads = 1;
-        //ads_index = i;
-        double surf_cover = total_state[isurf] * ms_inv;
-        double S_theta = 0.0;
-
-        if (r->kisliuk_flag)
-        {
-          double K_ads = r->kisliuk_coeff[0] * pow(twall,r->kisliuk_coeff[1]) *
-          exp(-r->kisliuk_coeff[2]/twall);
-          if (surf_cover < 1)
-            S_theta = pow((1 - surf_cover) /
-                          (1 - surf_cover +
-                           K_ads*surf_cover),r->coeff[coeff_val]);
-        }
-        else
-        {
-          S_theta = pow((1-surf_cover),r->coeff[coeff_val]);
-        }
-        //scatter_prob = 1 - r->k_react*S_theta;
-        //prob_value[i] = 1.0;
-        prob_value[i] = r->k_react*S_theta;
-        break;
-      }
-
-    case DA:
-      {
-        double surf_cover = total_state[isurf] * ms_inv;
-        double S_theta = 0.0;
-
-        if (r->kisliuk_flag) {
-          double K_ads = r->kisliuk_coeff[0] * pow(twall,r->kisliuk_coeff[1]) *
-            exp(-r->kisliuk_coeff[2]/twall);
-          if (surf_cover < 1)
-            S_theta = pow((1 - surf_cover) /
-                          (1 - surf_cover +
-                           K_ads*surf_cover),r->coeff[coeff_val]);
-        } else {
-          S_theta = pow((1-surf_cover),r->coeff[coeff_val]);
-        }
-
-        prob_value[i] = r->k_react*S_theta;
-
-        /*
-        if (r->state_products[1][0] == 's') {
-          double K_ads2 = r->coeff[6] * pow(twall,r->coeff[7]) *
-            exp(-r->coeff[8]/twall);
-          double S_ratio2 = (1 - surf_cover) /
-               (1 - surf_cover + K_ads*surf_cover);
-          prob_value[i] *= (S_ratio2);
-        }
-        */
-
-        break;
-      }
-
-    case LH1:
-      {
-        double surf_cover = total_state[isurf] * ms_inv;
-        double S_theta = 0.0;
-
-        if (r->kisliuk_flag) {
-          double K_ads = r->kisliuk_coeff[0] * pow(twall,r->kisliuk_coeff[1]) *
-            exp(-r->kisliuk_coeff[2]/twall);
-          if (surf_cover < 1)
-            S_theta = pow((1 - surf_cover) /
-                          (1 - surf_cover +
-                           K_ads*surf_cover),r->coeff[coeff_val]);
-        } else {
-          S_theta = pow((1-surf_cover),r->coeff[coeff_val]);
-        }
-
-        prob_value[i] = r->k_react*S_theta;
-        break;
-      }
-
-    case LH3:
-      {
-        double surf_cover = total_state[isurf] * ms_inv;
-        double S_theta = 0.0;
-
-        if (r->kisliuk_flag) {
-          double K_ads = r->kisliuk_coeff[0] * pow(twall,r->kisliuk_coeff[1]) *
-            exp(-r->kisliuk_coeff[2]/twall);
-          if (surf_cover < 1)
-            S_theta = pow((1 - surf_cover) /
-                          (1 - surf_cover +
-                           K_ads*surf_cover),r->coeff[coeff_val]);
-        } else {
-          S_theta = pow((1-surf_cover),r->coeff[coeff_val]);
-        }
-
-        prob_value[i] = r->k_react*S_theta;
-        break;
-      }
-
-    case CD:
-      {
-        double surf_cover = total_state[isurf] * ms_inv;
-        double S_theta = 0.0;
-
-        if (r->kisliuk_flag) {
-          double K_ads = r->kisliuk_coeff[0] * pow(twall,r->kisliuk_coeff[1]) *
-            exp(-r->kisliuk_coeff[2]/twall);
-          if (surf_cover < 1)
-            S_theta = pow((1 - surf_cover) /
-                          (1 - surf_cover +
-                           K_ads*surf_cover),r->coeff[coeff_val]);
-        } else {
-          S_theta = pow((1-surf_cover),r->coeff[coeff_val]);
-        }
-
-        prob_value[i] = r->k_react*S_theta;
-        break;
-      }
-
-    case ER:
-      {
-        double dot = MathExtra::dot3(ip->v,norm);
-        dot = 2.0;
-
-        if (r->nreactant == 1) {
-          prob_value[i] = 2.0 * r->k_react *
-            (maxstick - total_state[isurf]) * ms_inv / fabs(dot);
-        } else {
-          prob_value[i] = 2.0 * r->k_react / fabs(dot);
-        }
-        break;
+  // cumprob = cumulative probabilities of possible reactions
+  // use per-face/surf table if reactions of this species only depend
+  //   on surf state, rebuild it if state has changed since last sync
 
-      }
+  double prob_value[n];
+  double *cumprob;
 
-    case CI:
-      {
-        prob_value[i] = r->k_react;
-        if (r->energy_flag) {
-          double *v = ip->v;
-          double dot = MathExtra::dot3(v,norm);
-          double vmag_sq = MathExtra::lensq3(v);
-          double E_i = 0.5 * species[ip->ispecies].mass * vmag_sq;
-          double cos_theta = abs(dot) / sqrt(vmag_sq);
-          prob_value[i] *= pow(E_i,r->energy_coeff[0]) *
-          pow(cos_theta,r->energy_coeff[1]);
-        }
-        break;
-      }
-
-    /*
-    case CI2:
-      {
-        double *v = ip->v;
-        double dot = MathExtra::dot3(v,norm);
-        double vmag_sq = MathExtra::lensq3(v);
-        double E_i = 0.5 * species[ip->ispecies].mass * vmag_sq;
-        double cos_theta = dot/sqrt(vmag_sq);
-        prob_value[i] = r->k_react * pow(E_i,r->coeff[3]) *
-          pow(cos_theta,r->coeff[4]);
-        break;
-      }
-      */
-    }
-
-    for (int j = 1; j < r->nreactant; j++) {
-      if (r->state_reactants[j][0] == 's') {
-        if (r->part_reactants[j] == 0) {
-          prob_value[i] *=
-            stoich_pow(total_state[isurf],
-                       r->stoich_reactants[j]) *
-            pow(ms_inv,r->stoich_reactants[j]);
-        } else {
-          prob_value[i] *=
-            stoich_pow(species_state[isurf][r->reactants_ad_index[j]],
-                       r->stoich_reactants[j]) *
-            pow(ms_inv,r->stoich_reactants[j]);
-        }
-      }
+  if (gs_cacheable[ip->ispecies]) {
+    cumprob = &gs_cumprob[isurf][list-indices_gs];
+    if (gs_stamp[isurf][ip->ispecies] != state_stamp) {
+      gs_probs(ip->ispecies,isurf,NULL,NULL,cumprob);
+      gs_stamp[isurf][ip->ispecies] = state_stamp;
     }
-
-    sum_prob += prob_value[i];
+  } else {
+    gs_probs(ip->ispecies,isurf,ip,norm,prob_value);
+    cumprob = prob_value;
   }
 
-  // NOTE: scatter_prob is always zero?
-  /*
-  if (check_ads) {
-    if (sum_prob > (1-scatter_prob))
-      correction = (1-scatter_prob) / sum_prob;
-  } else if (sum_prob > 1.0) correction = 1.0/sum_prob;
-  */
+  double sum_prob = cumprob[n-1];
+  double scatter_prob = 0.0, correction = 1.0;
 
   if (sum_prob > 1.0) correction = 1.0/sum_prob;
   else scatter_prob = 1.0 - sum_prob;
 
-  //if (sum_prob > (1.0-scatter_prob))
-  //  correction = (1.0-scatter_prob) / sum_prob;
-
   // probablity to compare to reaction probability
 
-  double react_prob = scatter_prob;
   double random_prob = random->uniform();
 
-  if (react_prob > random_prob) return 0;
+  if (scatter_prob > random_prob) return 0;
   else {
     // NOTE: at this point is it guaranteed a reaction will take place?
 
     if (mode == SURF) mark[isurf] = 1;
 
-    // NOTE: why summing to previous react_prob?
+    // binary search for 1st reaction whose cumulative prob > random_prob
+
+    int lo = 0;
+    int hi = n;
+    while (lo < hi) {
+      int mid = (lo+hi) / 2;
+      if (scatter_prob + cumprob[mid]*correction > random_prob) hi = mid;
+      else lo = mid+1;
+    }
+
+    OneReaction_GS *r;
 
-    for (int i = 0; i < n; i++) {
+    for (int i = lo; i < n; i++) {
       r = &rlist_gs[list[i]];
-      react_prob += prob_value[i] * correction;
-      if (react_prob <= random_prob) continue;
 
       // perform the reaction and return
       // if dissociation or CI2 performs a realloc:
@@ -1093,6 +924,126 @@ int SurfReactAdsorb::react(Particle::OnePart *&ip, int isurf, double *norm,
   return 0;
 }
 
+/* ----------------------------------------------------------------------
+   compute cumulative probabilities of all GS reactions of species ISP
+     on face or surf element isurf, store them in cumprob
+   depend only on current surf state, except for CI reactions with
+     energy_flag set, which also use velocity of incident particle ip
+------------------------------------------------------------------------- */
+
+void SurfReactAdsorb::gs_probs(int isp, int isurf, Particle::OnePart *ip,
+                               double *norm, double *cumprob)
+{
+  int *list = reactions_gs[isp].list;
+  int n = reactions_gs[isp].n;
+
+  double fnum = update->fnum;
+  long int maxstick = ceil(max_cover*area[isurf] / (fnum*weight[isurf]));
+  double factor = fnum * weight[isurf] / area[isurf];
+  double ms_inv = factor / max_cover;
+
+  Particle::Species *species = particle->species;
+
+  OneReaction_GS *r;
+  double prob,sum_prob = 0.0;
+
+  int coeff_val = 1;
+
+  for (int i = 0; i < n; i++) {
+    r = &rlist_gs[list[i]];
+
+    if (r->style == ARRHENIUS) coeff_val = 3;
+
+    // reaction types not listed below have zero probability
+
+    prob = 0.0;
+
+    switch (r->type) {
+    case DISSOCIATION:
+    case EXCHANGE:
+    case RECOMBINATION:
+      {
+        prob = r->k_react;
+        break;
+      }
+
+    // adsorption mediated reactions are scaled by available surf sites
+    // K_ads for Kisliuk option was computed at twall by init_reactions_gs()
+
+    case AA:
+    case DA:
+    case LH1:
+    case LH3:
+    case CD:
+      {
+        double surf_cover = total_state[isurf] * ms_inv;
+        double S_theta = 0.0;
+
+        if (r->kisliuk_flag) {
+          double K_ads = r->kisliuk_K;
+          if (surf_cover < 1)
+            S_theta = pow((1 - surf_cover) /
+                          (1 - surf_cover +
+                           K_ads*surf_cover),r->coeff[coeff_val]);
+        } else {
+          S_theta = pow((1-surf_cover),r->coeff[coeff_val]);
+        }
+
+        prob = r->k_react*S_theta;
+        break;
+      }
+
+    case ER:
+      {
+        // NOTE: dot with particle velocity is not used
+        double dot = 2.0;
+
+        if (r->nreactant == 1) {
+          prob = 2.0 * r->k_react *
+            (maxstick - total_state[isurf]) * ms_inv / fabs(dot);
+        } else {
+          prob = 2.0 * r->k_react / fabs(dot);
+        }
+        break;
+      }
+
+    case CI:
+      {
+        prob = r->k_react;
+        if (r->energy_flag) {
+          double *v = ip->v;
+          double dot = MathExtra::dot3(v,norm);
+          double vmag_sq = MathExtra::lensq3(v);
+          double E_i = 0.5 * species[ip->ispecies].mass * vmag_sq;
+          double cos_theta = abs(dot) / sqrt(vmag_sq);
+          prob *= pow(E_i,r->energy_coeff[0]) *
+          pow(cos_theta,r->energy_coeff[1]);
+        }
+        break;
+      }
+    }
+
+    for (int j = 1; j < r->nreactant; j++) {
+      if (r->state_reactants[j][0] == 's') {
+        if (r->part_reactants[j] == 0) {
+          prob *=
+            stoich_pow(total_state[isurf],
+                       r->stoich_reactants[j]) *
+            pow(ms_inv,r->stoich_reactants[j]);
+        } else {
+          prob *=
+            stoich_pow(species_state[isurf][r->reactants_ad_index[j]],
+                       r->stoich_reactants[j]) *
+            pow(ms_inv,r->stoich_reactants[j]);
+        }
+      }
+    }
+
+    sum_prob += prob;
+    cumprob[i] = sum_prob;
+  }
+}
+
 /* ---------------------------------------------------------------------- */
 
 void SurfReactAdsorb::tally_update()
@@ -1177,6 +1128,11 @@ void SurfReactAdsorb::PS_chemistry()
     }
   }
 
+  // merge on-surface reaction tallies staged by PS_react()
+
+  for (int m = 0; m < ncompute_tally; m++)
+    clist_active[m]->post_surf_tally();
+
   // allpart = nall-length vector of particles all procs are adding
   // accumulate via Allgatherv
 
@@ -1238,6 +1194,10 @@ void SurfReactAdsorb::update_state_face()
 {
   int i,j;
 
+  // GS reaction probability tables are now out of date
+
+  state_stamp++;
+
   // sum perspecies deltas across all procs
 
   MPI_Allreduce(&species_delta[0][0],&face_sum_delta[0][0],
@@ -1265,6 +1225,10 @@ void SurfReactAdsorb::update_state_surf()
 {
   int i,j,m,isr;
 
+  // GS reaction probability tables are now out of date
+
+  state_stamp++;
+
   // incollate = array of deltas for surfs I marked
   // ntally = # of surfs I marked = # of rows in incollate
   // tally2surf = global surf index (1 to Nsurf) for each row of array
@@ -1402,6 +1366,15 @@ void SurfReactAdsorb::init_reactions_gs()
     }
   }
 
+  // Kisliuk K_ads only depends on twall
+
+  for (int m = 0; m < nlist_gs; m++) {
+    OneReaction_GS *r = &rlist_gs[m];
+    if (r->kisliuk_flag)
+      r->kisliuk_K = r->kisliuk_coeff[0] * pow(twall,r->kisliuk_coeff[1]) *
+        exp(-r->kisliuk_coeff[2]/twall);
+  }
+
   // count possible reactions for each species
 
   memory->destroy(reactions_gs);
@@ -123,6 +123,7 @@ class SurfReactAdsorb : public SurfReact {
     double k_react;
     int kisliuk_flag, energy_flag;
     double kisliuk_coeff[3], energy_coeff[2];
+    double kisliuk_K;              // Kisliuk K_ads at twall
     int cmodel_ip;                  // style for I's post-reaction surf collision
     int *cmodel_ip_flags;           // integer flags to pass to SC class
     double *cmodel_ip_coeffs;       // double coeffs to pass to SC class
@@ -143,6 +144,12 @@ class SurfReactAdsorb : public SurfReact {
   ReactionI_GS *reactions_gs;    // reactions for all species
   int *indices_gs;               // master list of indices
 
+  int *gs_cacheable;       // 1 if species reaction probs only depend on state
+  double **gs_cumprob;     // per-face/surf cumulative reaction probs,
+                           //   columns aligned with indices_gs
+  int **gs_stamp;          // state_stamp when per-species probs were computed
+  int state_stamp;         // incremented whenever face/surf state changes
+
  // PS (on-surf) reaction model
 
  struct OneReaction_PS {
@@ -216,6 +223,7 @@ class SurfReactAdsorb : public SurfReact {
 
   void init_reactions_gs();
   void readfile_gs(char *);
+  void gs_probs(int, int, Particle::OnePart *, double *, double *);
 
   // PS methods
 
@@ -48,6 +48,7 @@ SurfReactProb::SurfReactProb(SPARTA *sparta, int narg, char **arg) :
   rlist = NULL;
   reactions = NULL;
   indices = NULL;
+  cumprobs = NULL;
 
   // read reaction file
 
@@ -98,6 +99,7 @@ SurfReactProb::~SurfReactProb()
 
   memory->destroy(reactions);
   memory->destroy(indices);
+  memory->destroy(cumprobs);
 }
 
 /* ---------------------------------------------------------------------- */
@@ -121,53 +123,58 @@ int SurfReactProb::react(Particle::OnePart *&ip, int, double *,
   if (n == 0) return 0;
 
   int *list = reactions[ip->ispecies].list;
+  double *cumprob = reactions[ip->ispecies].cumprob;
 
-  // probablity to compare to reaction probability
+  // probablity to compare to cumulative reaction probabilities
+  // no reaction if it exceeds summed probability of all reactions
 
-  double react_prob = 0.0;
   double random_prob = random->uniform();
+  if (cumprob[n-1] <= random_prob) return 0;
 
-  // loop over possible reactions for this species
+  // binary search for 1st reaction whose cumulative prob > random_prob
   // if dissociation performs a realloc:
   //   make copy of x,v with new species
   //   rot/vib energies will be reset by SurfCollide
   //   repoint ip to new particles data struct if reallocated
 
-  OneReaction *r;
+  int lo = 0;
+  int hi = n-1;
+  while (lo < hi) {
+    int mid = (lo+hi) / 2;
+    if (cumprob[mid] > random_prob) hi = mid;
+    else lo = mid+1;
+  }
 
-  for (int i = 0; i < n; i++) {
-    r = &rlist[list[i]];
-    react_prob += r->coeff[0];
-
-    if (react_prob > random_prob) {
-      nsingle++;
-      tally_single[list[i]]++;
-      switch (r->type) {
-      case DISSOCIATION:
-        {
-          double x[3],v[3];
-          ip->ispecies = r->products[0];
-          int id = MAXSMALLINT*random->uniform();
-          memcpy(x,ip->x,3*sizeof(double));
-          memcpy(v,ip->v,3*sizeof(double));
-          Particle::OnePart *particles = particle->particles;
-          int reallocflag =
-            particle->add_particle(id,r->products[1],ip->icell,x,v,0.0,0.0);
-          if (reallocflag) ip = particle->particles + (ip - particles);
-          jp = &particle->particles[particle->nlocal-1];
-          return (list[i] + 1);
-        }
-      case EXCHANGE:
-        {
-          ip->ispecies = r->products[0];
-          return (list[i] + 1);
-        }
-      case RECOMBINATION:
-        {
-          ip = NULL;
-          return (list[i] + 1);
-        }
-      }
+  int m = list[lo];
+  OneReaction *r = &rlist[m];
+
+  nsingle++;
+  tally_single[m]++;
+
+  switch (r->type) {
+  case DISSOCIATION:
+    {
+      double x[3],v[3];
+      ip->ispecies = r->products[0];
+      int id = MAXSMALLINT*random->uniform();
+      memcpy(x,ip->x,3*sizeof(double));
+      memcpy(v,ip->v,3*sizeof(double));
+      Particle::OnePart *particles = particle->particles;
+      int reallocflag =
+        particle->add_particle(id,r->products[1],ip->icell,x,v,0.0,0.0);
+      if (reallocflag) ip = particle->particles + (ip - particles);
+      jp = &particle->particles[particle->nlocal-1];
+      return (m + 1);
+    }
+  case EXCHANGE:
+    {
+      ip->ispecies = r->products[0];
+      return (m + 1);
+    }
+  case RECOMBINATION:
+    {
+      ip = NULL;
+      return (m + 1);
     }
   }
 
@@ -269,13 +276,20 @@ void SurfReactProb::init_reactions()
     reactions[i].list[reactions[i].n++] = m;
   }
 
+  // reactions[i].cumprob = cumulative probabilities for each species
   // check that summed reaction probabilities for each species <= 1.0
 
+  memory->destroy(cumprobs);
+  memory->create(cumprobs,n,"surf_react:cumprobs");
+
   double sum;
   for (int i = 0; i < nspecies; i++) {
+    reactions[i].cumprob = &cumprobs[reactions[i].list - indices];
     sum = 0.0;
-    for (int j = 0; j < reactions[i].n; j++)
+    for (int j = 0; j < reactions[i].n; j++) {
       sum += rlist[reactions[i].list[j]].coeff[0];
+      reactions[i].cumprob[j] = sum;
+    }
     if (sum > 1.0)
       error->all(FLERR,"Surface reaction probability for a species > 1.0");
   }
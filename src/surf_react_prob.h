@@ -61,11 +61,14 @@ class SurfReactProb : public SurfReact {
 
   struct ReactionI {
     int *list;           // list of indices into rlist, ptr into indices
+    double *cumprob;     // cumulative probs of reactions in list,
+                         //   ptr into cumprobs
     int n;               // # of reactions in list
   };
 
   ReactionI *reactions;       // reactions for all species
   int *indices;               // master list of indices
+  double *cumprobs;           // master list of cumulative probabilities
 
   virtual void init_reactions();
   void readfile(char *);
@@ -0,0 +1,90 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#include "tally_stage.h"
+#include "memory.h"
+
+using namespace SPARTA_NS;
+
+/* ---------------------------------------------------------------------- */
+
+TallyStage::TallyStage(SPARTA *sparta, int ncol_caller) : Pointers(sparta)
+{
+  ncol = ncol_caller;
+  nslot = maxslot = 0;
+  values = NULL;
+}
+
+/* ---------------------------------------------------------------------- */
+
+TallyStage::~TallyStage()
+{
+  memory->destroy(values);
+}
+
+/* ----------------------------------------------------------------------
+   discard staged values, keep allocated slots for next move
+------------------------------------------------------------------------- */
+
+void TallyStage::reset()
+{
+  for (int i = 0; i < nslot; i++)
+    for (int m = 0; m < ncol; m++)
+      values[i][m] = 0.0;
+  nslot = 0;
+}
+
+/* ----------------------------------------------------------------------
+   add staged slots 0 to nslot-1 into rows of caller's array
+   array must have at least nslot rows of ncol values
+   slots are zeroed for next move
+------------------------------------------------------------------------- */
+
+void TallyStage::merge(double **array)
+{
+  double *vec,*svec;
+
+  for (int i = 0; i < nslot; i++) {
+    vec = array[i];
+    svec = values[i];
+    for (int m = 0; m < ncol; m++) {
+      vec[m] += svec[m];
+      svec[m] = 0.0;
+    }
+  }
+  nslot = 0;
+}
+
+/* ----------------------------------------------------------------------
+   grow slots to at least n, new slots are zeroed
+------------------------------------------------------------------------- */
+
+void TallyStage::grow(int n)
+{
+  int old = maxslot;
+  maxslot = MAX(n,2*maxslot);
+  memory->grow(values,maxslot,ncol,"tally/stage:values");
+  for (int i = old; i < maxslot; i++)
+    for (int m = 0; m < ncol; m++)
+      values[i][m] = 0.0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+bigint TallyStage::memory_usage()
+{
+  bigint bytes = 0;
+  bytes += (bigint) maxslot*ncol * sizeof(double);
+  return bytes;
+}
@@ -0,0 +1,56 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifndef SPARTA_TALLY_STAGE_H
+#define SPARTA_TALLY_STAGE_H
+
+#include "pointers.h"
+
+namespace SPARTA_NS {
+
+// staging buffer for surface and boundary tallies made during a move
+// one dense slot of ncol values per tally row of the caller
+//   (tally index of a surf, or a box face), hits accumulate in place
+// after the move the caller merges slots 0 to nslot-1 into its tally
+//   array in order, so merge cost scales with # of tallied rows, not hits
+
+class TallyStage : protected Pointers {
+ public:
+  int ncol;                  // # of values per slot
+  int nslot;                 // slots 0 to nslot-1 may hold values
+
+  TallyStage(class SPARTA *, int);
+  ~TallyStage();
+  void reset();
+  void merge(double **);
+  bigint memory_usage();
+
+  // return ptr to ncol values of slot I for caller to accumulate into
+
+  double *slot(int i) {
+    if (i >= maxslot) grow(i+1);
+    if (i >= nslot) nslot = i+1;
+    return values[i];
+  }
+
+ private:
+  int maxslot;               // # of slots allocated
+  double **values;           // ncol values for each slot
+
+  void grow(int);
+};
+
+}
+
+#endif
@@ -71,6 +71,7 @@ Update::Update(SPARTA *sparta) : Pointers(sparta)
   ntimestep = 0;
   firststep = laststep = 0;
   beginstep = endstep = 0;
+  haltflag = 0;
   runflag = 0;
 
   unit_style = NULL;
@@ -160,6 +161,8 @@ void Update::init()
       error->all(FLERR,"Cannot use optimized move with non-uniform grid");
     else if (surf->exist)
       error->all(FLERR,"Cannot use optimized move when surfaces are defined");
+    else if (grid->dtlevelflag)
+      error->all(FLERR,"Cannot use optimized move with local timesteps");
     else {
       for (int ifix = 0; ifix < modify->nfix; ifix++) {
         if (strstr(modify->fix[ifix]->style,"adapt") != NULL)
@@ -281,6 +284,8 @@ void Update::run(int nsteps)
   int cellweightflag = 0;
   if (grid->cellweightflag) cellweightflag = 1;
 
+  haltflag = 0;
+
   // loop over timesteps
 
   for (int i = 0; i < nsteps; i++) {
@@ -297,8 +302,9 @@ void Update::run(int nsteps)
     if (dynamic) dynamic_update();
 
     // start of step fixes
+    // skip steps before the next step any fix is scheduled on
 
-    if (n_start_of_step) {
+    if (n_start_of_step && ntimestep >= modify->next_start_of_step) {
       modify->start_of_step();
       timer->stamp(TIME_MODIFY);
     }
@@ -326,10 +332,14 @@ void Update::run(int nsteps)
     if (collide_react) collide_react_update();
 
     // diagnostic fixes
+    // skip steps before the next step any fix is scheduled on
+    // a fix may set haltflag to end the run on this step
+    //   if so, force stats output on this step as last step of run
 
-    if (n_end_of_step) {
+    if (n_end_of_step && ntimestep >= modify->next_end_of_step) {
       modify->end_of_step();
       timer->stamp(TIME_MODIFY);
+      if (haltflag) output->next_stats = output->next = ntimestep;
     }
 
     // all output
@@ -338,6 +348,12 @@ void Update::run(int nsteps)
       output->write(ntimestep);
       timer->stamp(TIME_OUTPUT);
     }
+
+    if (haltflag) {
+      this->nsteps = i+1;
+      laststep = ntimestep;
+      break;
+    }
   }
 }
 
@@ -411,6 +427,10 @@ template < int DIM, int SURF, int OPT > void Update::move()
   Surf::Line *lines = surf->lines;
   double dt = update->dt;
 
+  // ltsflag = 1 if cells use local timesteps = dt * 2^dtlevel
+
+  int ltsflag = grid->dtlevelflag;
+
   // external per particle field
   // fix calculates field acting on all owned particles
 
@@ -463,6 +483,7 @@ template < int DIM, int SURF, int OPT > void Update::move()
 
       if (pflag == PKEEP) {
         dtremain = dt;
+        if (ltsflag) dtremain *= grid->dtscale(particles[i].icell);
         xnew[0] = x[0] + dtremain*v[0];
         xnew[1] = x[1] + dtremain*v[1];
         if (DIM != 2) xnew[2] = x[2] + dtremain*v[2];
@@ -470,6 +491,7 @@ template < int DIM, int SURF, int OPT > void Update::move()
           (this->*moveperturb)(i,particles[i].icell,dtremain,xnew,v);
       } else if (pflag == PINSERT) {
         dtremain = particles[i].dtremain;
+        if (ltsflag) dtremain *= grid->dtscale(particles[i].icell);
         xnew[0] = x[0] + dtremain*v[0];
         xnew[1] = x[1] + dtremain*v[1];
         if (DIM != 2) xnew[2] = x[2] + dtremain*v[2];
@@ -1191,6 +1213,17 @@ template < int DIM, int SURF, int OPT > void Update::move()
           break;
         }
 
+        // if new cell has a different local timestep,
+        //   rescale remaining time by ratio of new to old timestep
+        //   and reset xnew along same trajectory
+
+        if (ltsflag && cells[icell].dtlevel != cells[icell_original].dtlevel) {
+          dtremain *= grid->dtscale(icell) / grid->dtscale(icell_original);
+          xnew[0] = x[0] + dtremain*v[0];
+          xnew[1] = x[1] + dtremain*v[1];
+          if (DIM != 2) xnew[2] = x[2] + dtremain*v[2];
+        }
+
         // if nsurf < 0, new cell is EMPTY ghost
         // exit with particle flag = PENTRY, so receiver can continue move
 
@@ -1278,6 +1311,14 @@ template < int DIM, int SURF, int OPT > void Update::move()
 
   particle->sorted = 0;
 
+  // merge surf and boundary tallies staged during the move
+
+  if (nsurf_tally)
+    for (m = 0; m < nsurf_tally; m++) slist_active[m]->post_surf_tally();
+  if (nboundary_tally)
+    for (m = 0; m < nboundary_tally; m++)
+      blist_active[m]->post_boundary_tally();
+
   // accumulate running totals
 
   niterate_running += niterate;
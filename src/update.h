@@ -25,6 +25,7 @@ class Update : protected Pointers {
   bigint ntimestep;               // current timestep
   int nsteps;                     // # of steps to run
   int runflag;                    // 0 for unset, 1 for run
+  int haltflag;                   // 1 if a fix requests the run end early
   bigint firststep,laststep;      // 1st & last step of this run
   bigint beginstep,endstep;       // 1st and last step of multiple runs
   int first_update;               // 0 before initial update, 1 after
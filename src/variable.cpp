@@ -115,6 +115,12 @@ Variable::Variable(SPARTA *sparta) : Pointers(sparta)
   maxvec_storage = 0;
   vec_storage = NULL;
   maxlen_storage = NULL;
+
+  // postfix form of grid-style formulas, built by compile_grid()
+
+  compileflag = 0;
+  npostfix = maxpostfix = 0;
+  postfix = NULL;
 }
 
 /* ---------------------------------------------------------------------- */
@@ -146,6 +152,7 @@ Variable::~Variable()
     memory->destroy(vec_storage[i]);
   memory->sfree(vec_storage);
   memory->sfree(maxlen_storage);
+  memory->sfree(postfix);
 }
 
 /* ----------------------------------------------------------------------
@@ -437,13 +444,29 @@ void Variable::set(int narg, char **arg)
       copy(1,&arg[2],data[nvar]);
     }
 
-  // SURF (not implemented yet)
+  // SURF
   // replace pre-existing var if also style SURF (allows it to be reset)
   // num = 1, which = 1st value
   // data = 1 value, string to eval
 
   } else if (strcmp(arg[1],"surf") == 0) {
-    error->all(FLERR,"Surf-style variables are not yet implemented");
+    if (narg != 3) error->all(FLERR,"Illegal variable command");
+    int ivar = find(arg[0]);
+    if (ivar >= 0) {
+      if (style[find(arg[0])] != SURF)
+        error->all(FLERR,"Cannot redefine variable as a different style");
+      delete [] data[ivar][0];
+      copy(1,&arg[2],data[ivar]);
+      replaceflag = 1;
+    } else {
+      if (nvar == maxvar) grow();
+      style[nvar] = SURF;
+      num[nvar] = 1;
+      which[nvar] = 0;
+      pad[nvar] = 0;
+      data[nvar] = new char*[num[nvar]];
+      copy(1,&arg[2],data[nvar]);
+    }
 
   // INTERNAL
   // replace pre-existing var if also style INTERNAL (allows it to be reset)
@@ -526,13 +549,13 @@ int Variable::next(int narg, char **arg)
       error->all(FLERR,"All variables in next command must be same style");
   }
 
-  // invalid styles: STRING, EQUAL, WORLD, PARTICLE, GRID, GETENV,
+  // invalid styles: STRING, EQUAL, WORLD, PARTICLE, GRID, SURF, GETENV,
   //                 FORMAT, INTERNAL
 
   int istyle = style[find(arg[0])];
   if (istyle == STRING || istyle == EQUAL || istyle == WORLD ||
       istyle == GETENV || istyle == PARTICLE || istyle == GRID ||
-      istyle == FORMAT || istyle == INTERNAL)
+      istyle == SURF || istyle == FORMAT || istyle == INTERNAL)
     error->all(FLERR,"Invalid variable style with next command");
 
   // if istyle = UNIVERSE or ULOOP, insure all such variables are incremented
@@ -643,7 +666,7 @@ int Variable::next(int narg, char **arg)
    if EQUAL var, evaluate variable and put result in str
    if FORMAT var, evaluate its variable and put formatted result in str
    if GETENV var, query environment and put result in str
-   if PARTICLE or GRID var, return NULL
+   if PARTICLE or GRID or SURF var, return NULL
    if INTERNAL, convert dvalue and put result in str
    return NULL if no variable with name or which value is bad,
      caller must respond
@@ -697,7 +720,8 @@ char *Variable::retrieve(char *name)
   } else if (style[ivar] == INTERNAL) {
     sprintf(data[ivar][0],"%.15g",dvalue[ivar]);
     str = data[ivar][0];
-  } else if (style[ivar] == PARTICLE || style[ivar] == GRID) return NULL;
+  } else if (style[ivar] == PARTICLE || style[ivar] == GRID ||
+             style[ivar] == SURF) return NULL;
 
   return str;
 }
@@ -815,6 +839,86 @@ void Variable::compute_grid(int ivar, double *result,
   eval_in_progress[ivar] = 0;
 }
 
+/* ----------------------------------------------------------------------
+   convert a grid-style variable formula into a flat postfix program
+   allows accelerator styles to evaluate the formula on their own data
+   per-grid computes referenced by the formula are NOT invoked,
+     caller must invoke them and gather their values for each operand
+   return # of ops in program, returned as ptr to internal storage
+   return -1 if formula uses an operation that postfix cannot represent,
+     caller should then fall back to compute_grid()
+------------------------------------------------------------------------- */
+
+int Variable::compile_grid(int ivar, PostfixOp *&ops)
+{
+  Tree *tree;
+
+  if (eval_in_progress[ivar])
+    error->all(FLERR,"Variable has circular dependency");
+  eval_in_progress[ivar] = 1;
+
+  compileflag = 1;
+  nvec_storage = 0;
+  treestyle = GRID;
+  evaluate(data[ivar][0],&tree);
+  collapse_tree(tree);
+  compileflag = 0;
+
+  npostfix = 0;
+  int flag = postfix_tree(tree);
+
+  free_tree(tree);
+
+  eval_in_progress[ivar] = 0;
+
+  ops = postfix;
+  if (!flag) return -1;
+  return npostfix;
+}
+
+/* ----------------------------------------------------------------------
+   compute result of surf-style variable evaluation
+   evaluated for the nown explicit surf elements this proc owns
+   answers are placed every stride locations into result
+   if sumflag, add variable values to existing result
+------------------------------------------------------------------------- */
+
+void Variable::compute_surf(int ivar, double *result,
+                            int stride, int sumflag)
+{
+  Tree *tree;
+
+  if (eval_in_progress[ivar])
+    error->all(FLERR,"Variable has circular dependency");
+  eval_in_progress[ivar] = 1;
+
+  nvec_storage = 0;
+  treestyle = SURF;
+  evaluate(data[ivar][0],&tree);
+  collapse_tree(tree);
+
+  int nown = surf->nown;
+
+  if (sumflag == 0) {
+    int m = 0;
+    for (int i = 0; i < nown; i++) {
+      result[m] = eval_tree(tree,i);
+      m += stride;
+    }
+
+  } else {
+    int m = 0;
+    for (int i = 0; i < nown; i++) {
+      result[m] += eval_tree(tree,i);
+      m += stride;
+    }
+  }
+
+  free_tree(tree);
+
+  eval_in_progress[ivar] = 0;
+}
+
 /* ----------------------------------------------------------------------
    set value stored by INTERNAL style ivar
 ------------------------------------------------------------------------- */
@@ -1124,7 +1228,9 @@ double Variable::evaluate(char *str, Tree **tree)
               error->all(FLERR,"Compute used in variable between runs "
                          "is not current");
           } else if (!(compute->invoked_flag & INVOKED_SCALAR)) {
+            modify->invoke_begin(compute);
             compute->compute_scalar();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_SCALAR;
           }
 
@@ -1149,7 +1255,9 @@ double Variable::evaluate(char *str, Tree **tree)
               error->all(FLERR,"Compute used in variable between runs "
                          "is not current");
           } else if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+            modify->invoke_begin(compute);
             compute->compute_vector();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_VECTOR;
           }
 
@@ -1177,7 +1285,9 @@ double Variable::evaluate(char *str, Tree **tree)
               error->all(FLERR,"Compute used in variable between runs "
                          "is not current");
           } else if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+            modify->invoke_begin(compute);
             compute->compute_array();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_ARRAY;
           }
 
@@ -1203,7 +1313,9 @@ double Variable::evaluate(char *str, Tree **tree)
               error->all(FLERR,"Compute used in variable between runs "
                          "is not current");
           } else if (!(compute->invoked_flag & INVOKED_PER_PARTICLE)) {
+            modify->invoke_begin(compute);
             compute->compute_per_particle();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_PER_PARTICLE;
           }
 
@@ -1231,7 +1343,9 @@ double Variable::evaluate(char *str, Tree **tree)
               error->all(FLERR,"Compute used in variable between runs "
                          "is not current");
           } else if (!(compute->invoked_flag & INVOKED_PER_PARTICLE)) {
+            modify->invoke_begin(compute);
             compute->compute_per_particle();
+            modify->invoke_end();
             compute->invoked_flag |= INVOKED_PER_PARTICLE;
           }
 
@@ -1251,25 +1365,36 @@ double Variable::evaluate(char *str, Tree **tree)
           if (tree == NULL || treestyle != GRID)
             error->all(FLERR,"Per-grid compute in "
                        "non grid-style variable formula");
-          if (update->runflag == 0) {
-            if (compute->invoked_per_grid != update->ntimestep)
-              error->all(FLERR,"Compute used in variable between runs "
-                         "is not current");
-          } else if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
-            compute->compute_per_grid();
-            compute->invoked_flag |= INVOKED_PER_GRID;
-          }
 
-          if (compute->post_process_grid_flag)
-            compute->post_process_grid(0,1,NULL,NULL,NULL,1);
-          else if (compute->post_process_isurf_grid_flag)
-            compute->post_process_isurf_grid();
+          // compile_grid() only records the compute,
+          //   caller is responsible for invoking it
+
+          if (!compileflag) {
+            if (update->runflag == 0) {
+              if (compute->invoked_per_grid != update->ntimestep)
+                error->all(FLERR,"Compute used in variable between runs "
+                           "is not current");
+            } else if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+              modify->invoke_begin(compute);
+              compute->compute_per_grid();
+              modify->invoke_end();
+              compute->invoked_flag |= INVOKED_PER_GRID;
+            }
+
+            if (compute->post_process_grid_flag)
+              compute->post_process_grid(0,1,NULL,NULL,NULL,1);
+            else if (compute->post_process_isurf_grid_flag)
+              compute->post_process_isurf_grid();
+          }
 
           Tree *newtree = new Tree();
           newtree->type = ARRAY;
           newtree->array = compute->vector_grid;
           newtree->nstride = 1;
           newtree->selfalloc = 0;
+          newtree->srcwhich = PF_COMPUTE;
+          newtree->srcindex = icompute;
+          newtree->srccol = 0;
           newtree->left = newtree->middle = newtree->right = NULL;
           treestack[ntreestack++] = newtree;
 
@@ -1289,23 +1414,30 @@ double Variable::evaluate(char *str, Tree **tree)
           if (index1 > compute->size_per_grid_cols)
             error->all(FLERR,"Variable formula compute array "
                        "is accessed out-of-range");
-          if (update->runflag == 0) {
-            if (compute->invoked_per_grid != update->ntimestep)
-              error->all(FLERR,"Compute used in variable between runs "
-                         "is not current");
-          } else if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
-            compute->compute_per_grid();
-            compute->invoked_flag |= INVOKED_PER_GRID;
+          if (!compileflag) {
+            if (update->runflag == 0) {
+              if (compute->invoked_per_grid != update->ntimestep)
+                error->all(FLERR,"Compute used in variable between runs "
+                           "is not current");
+            } else if (!(compute->invoked_flag & INVOKED_PER_GRID)) {
+              modify->invoke_begin(compute);
+              compute->compute_per_grid();
+              modify->invoke_end();
+              compute->invoked_flag |= INVOKED_PER_GRID;
+            }
+
+            if (compute->post_process_grid_flag)
+              compute->post_process_grid(index1,1,NULL,NULL,NULL,1);
+            else if (compute->post_process_isurf_grid_flag)
+              compute->post_process_isurf_grid();
           }
 
-          if (compute->post_process_grid_flag)
-            compute->post_process_grid(index1,1,NULL,NULL,NULL,1);
-          else if (compute->post_process_isurf_grid_flag)
-            compute->post_process_isurf_grid();
-
           Tree *newtree = new Tree();
           newtree->type = ARRAY;
-          if (compute->post_process_grid_flag) {
+          if (compileflag) {
+            newtree->array = NULL;
+            newtree->nstride = 1;
+          } else if (compute->post_process_grid_flag) {
             newtree->array = add_storage(compute->vector_grid);
             newtree->nstride = 1;
           } else {
@@ -1313,6 +1445,72 @@ double Variable::evaluate(char *str, Tree **tree)
             newtree->nstride = compute->size_per_grid_cols;
           }
           newtree->selfalloc = 0;
+          newtree->srcwhich = PF_COMPUTE;
+          newtree->srcindex = icompute;
+          newtree->srccol = index1;
+          newtree->left = newtree->middle = newtree->right = NULL;
+          treestack[ntreestack++] = newtree;
+
+        // c_ID = vector from per-surf vector
+
+        } else if (nbracket == 0 && compute->per_surf_flag &&
+                   compute->size_per_surf_cols == 0) {
+
+          if (tree == NULL || treestyle != SURF)
+            error->all(FLERR,"Per-surf compute in "
+                       "non surf-style variable formula");
+          if (update->runflag == 0) {
+            if (compute->invoked_per_surf != update->ntimestep)
+              error->all(FLERR,"Compute used in variable between runs "
+                         "is not current");
+          } else if (!(compute->invoked_flag & INVOKED_PER_SURF)) {
+            modify->invoke_begin(compute);
+            compute->compute_per_surf();
+            modify->invoke_end();
+            compute->invoked_flag |= INVOKED_PER_SURF;
+          }
+
+          compute->post_process_surf();
+
+          Tree *newtree = new Tree();
+          newtree->type = ARRAY;
+          newtree->array = compute->vector_surf;
+          newtree->nstride = 1;
+          newtree->selfalloc = 0;
+          newtree->left = newtree->middle = newtree->right = NULL;
+          treestack[ntreestack++] = newtree;
+
+        // c_ID[i] = vector from per-surf array
+        // post_process_surf() sums tallies for all columns at once,
+        //   so compute's array_surf can be accessed directly
+
+        } else if (nbracket == 1 && compute->per_surf_flag &&
+                   compute->size_per_surf_cols > 0) {
+
+          if (tree == NULL || treestyle != SURF)
+            error->all(FLERR,"Per-surf compute in "
+                       "non surf-style variable formula");
+          if (index1 > compute->size_per_surf_cols)
+            error->all(FLERR,"Variable formula compute array "
+                       "is accessed out-of-range");
+          if (update->runflag == 0) {
+            if (compute->invoked_per_surf != update->ntimestep)
+              error->all(FLERR,"Compute used in variable between runs "
+                         "is not current");
+          } else if (!(compute->invoked_flag & INVOKED_PER_SURF)) {
+            modify->invoke_begin(compute);
+            compute->compute_per_surf();
+            modify->invoke_end();
+            compute->invoked_flag |= INVOKED_PER_SURF;
+          }
+
+          compute->post_process_surf();
+
+          Tree *newtree = new Tree();
+          newtree->type = ARRAY;
+          newtree->array = &compute->array_surf[0][index1-1];
+          newtree->nstride = compute->size_per_surf_cols;
+          newtree->selfalloc = 0;
           newtree->left = newtree->middle = newtree->right = NULL;
           treestack[ntreestack++] = newtree;
 
@@ -1471,6 +1669,9 @@ double Variable::evaluate(char *str, Tree **tree)
           newtree->array = fix->vector_grid;
           newtree->nstride = 1;
           newtree->selfalloc = 0;
+          newtree->srcwhich = PF_FIX;
+          newtree->srcindex = ifix;
+          newtree->srccol = 0;
           newtree->left = newtree->middle = newtree->right = NULL;
           treestack[ntreestack++] = newtree;
 
@@ -1494,6 +1695,52 @@ double Variable::evaluate(char *str, Tree **tree)
           newtree->array = &fix->array_grid[0][index1-1];
           newtree->nstride = fix->size_per_grid_cols;
           newtree->selfalloc = 0;
+          newtree->srcwhich = PF_FIX;
+          newtree->srcindex = ifix;
+          newtree->srccol = index1;
+          newtree->left = newtree->middle = newtree->right = NULL;
+          treestack[ntreestack++] = newtree;
+
+        // f_ID = vector from per-surf vector
+
+        } else if (nbracket == 0 && fix->per_surf_flag &&
+                   fix->size_per_surf_cols == 0) {
+
+          if (tree == NULL || treestyle != SURF)
+            error->all(FLERR,"Per-surf fix in "
+                       "non surf-style variable formula");
+          if (update->runflag > 0 &&
+              update->ntimestep % fix->per_surf_freq)
+            error->all(FLERR,"Fix in variable not computed at compatible time");
+
+          Tree *newtree = new Tree();
+          newtree->type = ARRAY;
+          newtree->array = fix->vector_surf;
+          newtree->nstride = 1;
+          newtree->selfalloc = 0;
+          newtree->left = newtree->middle = newtree->right = NULL;
+          treestack[ntreestack++] = newtree;
+
+        // f_ID[i] = vector from per-surf array
+
+        } else if (nbracket == 1 && fix->per_surf_flag &&
+                   fix->size_per_surf_cols > 0) {
+
+          if (tree == NULL || treestyle != SURF)
+            error->all(FLERR,"Per-surf fix in "
+                       "non surf-style variable formula");
+          if (index1 > fix->size_per_surf_cols)
+            error->all(FLERR,
+                       "Variable formula fix array is accessed out-of-range");
+          if (update->runflag > 0 &&
+              update->ntimestep % fix->per_surf_freq)
+            error->all(FLERR,"Fix in variable not computed at compatible time");
+
+          Tree *newtree = new Tree();
+          newtree->type = ARRAY;
+          newtree->array = &fix->array_surf[0][index1-1];
+          newtree->nstride = fix->size_per_surf_cols;
+          newtree->selfalloc = 0;
           newtree->left = newtree->middle = newtree->right = NULL;
           treestack[ntreestack++] = newtree;
 
@@ -1654,11 +1901,11 @@ double Variable::evaluate(char *str, Tree **tree)
             treestack[ntreestack++] = newtree;
           } else argstack[nargstack++] = value1;
 
-        // v_name = scalar from non particle/grid variable
+        // v_name = scalar from non particle/grid/surf variable
         // access value via retrieve()
 
         } else if (nbracket == 0 && style[ivar] != PARTICLE &&
-                   style[ivar] != GRID) {
+                   style[ivar] != GRID && style[ivar] != SURF) {
 
           char *var = retrieve(id);
           if (var == NULL)
@@ -1695,6 +1942,18 @@ double Variable::evaluate(char *str, Tree **tree)
           evaluate(data[ivar][0],&newtree);
           treestack[ntreestack++] = newtree;
 
+        // v_name = per-surf vector from surf-style variable
+        // evaluate the surf-style variable as newtree
+
+        } else if (nbracket == 0 && style[ivar] == SURF) {
+
+          if (tree == NULL || treestyle != SURF)
+            error->all(FLERR,"Per-surf variable in "
+                       "non surf-style variable formula");
+          Tree *newtree;
+          evaluate(data[ivar][0],&newtree);
+          treestack[ntreestack++] = newtree;
+
         } else error->all(FLERR,"Mismatched variable in variable formula");
 
         delete [] id;
@@ -2388,6 +2647,84 @@ double Variable::collapse_tree(Tree *tree)
   return 0.0;
 }
 
+/* ----------------------------------------------------------------------
+   append postfix ops for a collapsed grid-style variable parse tree
+   operands precede their operation, left operand before right operand
+   return 1 if successful, 0 if tree uses an operation postfix cannot hold
+------------------------------------------------------------------------- */
+
+int Variable::postfix_tree(Tree *tree)
+{
+  int type;
+
+  switch (tree->type) {
+  case VALUE: type = PF_VALUE; break;
+  case ARRAY:
+    if (tree->srcwhich != PF_COMPUTE && tree->srcwhich != PF_FIX) return 0;
+    type = tree->srcwhich;
+    break;
+  case PARTARRAYDOUBLE: type = PF_CELL; break;
+  case ADD: type = PF_ADD; break;
+  case SUBTRACT: type = PF_SUBTRACT; break;
+  case MULTIPLY: type = PF_MULTIPLY; break;
+  case DIVIDE: type = PF_DIVIDE; break;
+  case CARAT: type = PF_CARAT; break;
+  case MODULO: type = PF_MODULO; break;
+  case UNARY: type = PF_UNARY; break;
+  case NOT: type = PF_NOT; break;
+  case EQ: type = PF_EQ; break;
+  case NE: type = PF_NE; break;
+  case LT: type = PF_LT; break;
+  case LE: type = PF_LE; break;
+  case GT: type = PF_GT; break;
+  case GE: type = PF_GE; break;
+  case AND: type = PF_AND; break;
+  case OR: type = PF_OR; break;
+  case SQRT: type = PF_SQRT; break;
+  case EXP: type = PF_EXP; break;
+  case LN: type = PF_LN; break;
+  case LOG: type = PF_LOG; break;
+  case ABS: type = PF_ABS; break;
+  case SIN: type = PF_SIN; break;
+  case COS: type = PF_COS; break;
+  case TAN: type = PF_TAN; break;
+  case ASIN: type = PF_ASIN; break;
+  case ACOS: type = PF_ACOS; break;
+  case ATAN: type = PF_ATAN; break;
+  case ATAN2: type = PF_ATAN2; break;
+  case ERF: type = PF_ERF; break;
+  case CEIL: type = PF_CEIL; break;
+  case FLOOR: type = PF_FLOOR; break;
+  case ROUND: type = PF_ROUND; break;
+  default: return 0;
+  }
+
+  if (tree->middle) return 0;
+  if (tree->left && !postfix_tree(tree->left)) return 0;
+  if (tree->right && !postfix_tree(tree->right)) return 0;
+
+  if (npostfix == maxpostfix) {
+    maxpostfix += VARDELTA;
+    postfix = (PostfixOp *)
+      memory->srealloc(postfix,maxpostfix*sizeof(PostfixOp),
+                       "variable:postfix");
+  }
+
+  PostfixOp *op = &postfix[npostfix++];
+  op->type = type;
+  op->value = tree->value;
+  op->index = 0;
+  op->column = 0;
+
+  if (type == PF_COMPUTE || type == PF_FIX) {
+    op->index = tree->srcindex;
+    op->column = tree->srccol;
+  } else if (type == PF_CELL)
+    op->index = tree->carray - (char *) grid->cells;
+
+  return 1;
+}
+
 /* ----------------------------------------------------------------------
    evaluate a particle-style variable parse tree for particle I
      or a grid-style variable parse tree for grid cell I
@@ -3199,7 +3536,9 @@ int Variable::special_function(char *word, char *contents, Tree **tree,
             error->all(FLERR,
                        "Compute used in variable between runs is not current");
         } else if (!(compute->invoked_flag & INVOKED_VECTOR)) {
+          modify->invoke_begin(compute);
           compute->compute_vector();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_VECTOR;
         }
         nvec = compute->size_vector;
@@ -3213,7 +3552,9 @@ int Variable::special_function(char *word, char *contents, Tree **tree,
             error->all(FLERR,
                        "Compute used in variable between runs is not current");
         } else if (!(compute->invoked_flag & INVOKED_ARRAY)) {
+          modify->invoke_begin(compute);
           compute->compute_array();
+          modify->invoke_end();
           compute->invoked_flag |= INVOKED_ARRAY;
         }
         nvec = compute->size_array_rows;
@@ -40,7 +40,26 @@ class Variable : protected Pointers {
   double compute_equal(char *);
   void compute_particle(int, double *, int, int);
   void compute_grid(int, double *, int, int);
-  void compute_surf(int, double *, int, int) {}  // not yet supported
+  void compute_surf(int, double *, int, int);
+
+  // flattened postfix form of a grid-style variable formula
+  // lets accelerator styles evaluate the formula on their own copy of data
+
+  enum{PF_VALUE,PF_COMPUTE,PF_FIX,PF_CELL,
+       PF_ADD,PF_SUBTRACT,PF_MULTIPLY,PF_DIVIDE,PF_CARAT,PF_MODULO,PF_UNARY,
+       PF_NOT,PF_EQ,PF_NE,PF_LT,PF_LE,PF_GT,PF_GE,PF_AND,PF_OR,
+       PF_SQRT,PF_EXP,PF_LN,PF_LOG,PF_ABS,PF_SIN,PF_COS,PF_TAN,
+       PF_ASIN,PF_ACOS,PF_ATAN,PF_ATAN2,PF_ERF,PF_CEIL,PF_FLOOR,PF_ROUND};
+
+  struct PostfixOp {
+    int type;              // one of PF_* values
+    double value;          // constant for PF_VALUE
+    int index;             // compute or fix index for PF_COMPUTE, PF_FIX
+                           // byte offset into Grid::ChildCell for PF_CELL
+    int column;            // 0 = per-grid vector, else column of per-grid array
+  };
+
+  int compile_grid(int, PostfixOp *&);
   void internal_set(int, double);
 
   int int_between_brackets(char *&, int);
@@ -75,6 +94,10 @@ class Variable : protected Pointers {
   double **vec_storage;    // list of vector copies
   int *maxlen_storage;     // allocated length of each vector
 
+  int compileflag;          // 1 if evaluate() is building a postfix program
+  int npostfix,maxpostfix;  // # of ops in postfix, allocated length
+  PostfixOp *postfix;       // postfix program from compile_grid()
+
   struct Tree {            // parse tree for particle-style variables
     double value;          // single scalar
     double *array;         // per-atom or per-type list of doubles
@@ -83,6 +106,8 @@ class Variable : protected Pointers {
     int nstride;           // stride between atoms if array is a 2d array
     int selfalloc;         // 1 if array is allocated here, else 0
     int ivalue1,ivalue2;   // extra values for needed for gmask,rmask,grmask
+    int srcwhich;          // PF_COMPUTE or PF_FIX if array is per-grid data
+    int srcindex,srccol;   // compute/fix index and column of per-grid data
     Tree *left,*middle,*right;    // ptrs further down tree
   };
 
@@ -92,6 +117,7 @@ class Variable : protected Pointers {
   double evaluate(char *, Tree **);
   double collapse_tree(Tree *);
   double eval_tree(Tree *, int);
+  int postfix_tree(Tree *);
   void free_tree(Tree *);
   int find_matching_paren(char *, int, char *&);
   int math_function(char *, char *, Tree **, Tree **, int &, double *, int &);
@@ -158,10 +184,6 @@ E: Grid-style variables are not yet implemented
 
 Self-explanatory.
 
-E: Surf-style variables are not yet implemented
-
-Self-explanatory.
-
 E: Variable name must be alphanumeric or underscore characters
 
 Self-explanatory.
@@ -221,6 +243,10 @@ E: Per-particle compute in equal-style variable formula
 
 Equal-style variables cannot use per-particle quantities.
 
+E: Per-surf compute in non surf-style variable formula
+
+Only surf-style variables can use per-surf compute quantities.
+
 E: Mismatched compute in variable formula
 
 A compute is referenced incorrectly or a compute that produces per-atom
@@ -247,6 +273,10 @@ E: Per-particle fix in equal-style variable formula
 
 Equal-style variables cannot use per-particle quantities.
 
+E: Per-surf fix in non surf-style variable formula
+
+Only surf-style variables can use per-surf fix quantities.
+
 E: Mismatched fix in variable formula
 
 A fix is referenced incorrectly or a fix that produces per-atom
@@ -264,6 +294,10 @@ E: Particle-style variable in equal-style variable formula
 
 Equal-style variables cannot use per-particle quantities.
 
+E: Per-surf variable in non surf-style variable formula
+
+Only surf-style variables can reference other surf-style variables.
+
 E: Mismatched variable in variable formula
 
 A variable is referenced incorrectly or an atom-style variable that
@@ -14,12 +14,14 @@
 
 #include "mpi.h"
 #include "spatype.h"
+#include "stdlib.h"
 #include "string.h"
 #include "write_grid.h"
 #include "grid.h"
 #include "domain.h"
 #include "comm.h"
 #include "hash3.h"
+#include "write_text.h"
 #include "memory.h"
 #include "error.h"
 
@@ -42,32 +44,31 @@ void WriteGrid::command(int narg, char **arg)
   if (!grid->exist)
     error->all(FLERR,"Cannot write grid when grid is not defined");
 
-  if (narg != 1) error->all(FLERR,"Illegal write_grid command");
+  if (narg < 1) error->all(FLERR,"Illegal write_grid command");
 
-  MPI_Barrier(world);
-  double time1 = MPI_Wtime();
+  // optional args
 
-  // open file on proc 0
+  nwriter = 1;
 
-  int me = comm->me;
-  if (me == 0) {
-    if (screen && !silent) fprintf(screen,"Writing grid file ...\n");
-    fp = fopen(arg[0],"w");
-    if (!fp) {
-      char str[128];
-      sprintf(str,"Cannot open file %s",arg[0]);
-      error->one(FLERR,str);
-    }
+  int iarg = 1;
+  while (iarg < narg) {
+    if (strcmp(arg[iarg],"nwriter") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal write_grid command");
+      nwriter = atoi(arg[iarg+1]);
+      if (nwriter <= 0) error->all(FLERR,"Illegal write_grid command");
+      iarg += 2;
+    } else error->all(FLERR,"Illegal write_grid command");
   }
 
-  // write file
+  MPI_Barrier(world);
+  double time1 = MPI_Wtime();
 
-  if (me == 0) header();
-  write();
+  int me = comm->me;
+  if (me == 0 && screen && !silent) fprintf(screen,"Writing grid file ...\n");
 
-  // close file
+  // write file
 
-  if (me == 0) fclose(fp);
+  write(arg[0]);
 
   // stats
 
@@ -94,78 +95,41 @@ void WriteGrid::command(int narg, char **arg)
    only called by proc 0
 ------------------------------------------------------------------------- */
 
-void WriteGrid::header()
+void WriteGrid::header(WriteText *text)
 {
   Grid::ParentLevel *plevels = grid->plevels;
 
-  fprintf(fp,"# Grid file of cell IDs written by SPARTA\n\n");
-  fprintf(fp,BIGINT_FORMAT " cells\n",grid->ncell);
-  fprintf(fp,"%d levels\n",grid->maxlevel);
+  text->format(0,"# Grid file of cell IDs written by SPARTA\n\n");
+  text->format(0,BIGINT_FORMAT " cells\n",grid->ncell);
+  text->format(0,"%d levels\n",grid->maxlevel);
   for (int ilevel = 0; ilevel < grid->maxlevel; ilevel++)
-    fprintf(fp,"%d %d %d level-%d\n",
-            plevels[ilevel].nx,plevels[ilevel].ny,plevels[ilevel].nz,ilevel+1);
+    text->format(0,"%d %d %d level-%d\n",plevels[ilevel].nx,
+                 plevels[ilevel].ny,plevels[ilevel].nz,ilevel+1);
 }
 
 /* ----------------------------------------------------------------------
-   write Cells section of grid file
-   proc 0 pings other procs for info and writes entire file
+   write grid file
+   each proc formats IDs of its cells, skipping sub cells
+   nwriter procs write the text of all procs to file
 ------------------------------------------------------------------------- */
 
-void WriteGrid::write()
+void WriteGrid::write(char *file)
 {
-  int i,tmp,nlines;
-  MPI_Status status;
-  MPI_Request request;
-
-  int me = comm->me;
-  int nprocs = comm->nprocs;
+  WriteText *text = new WriteText(sparta,1,nwriter);
 
-  // nme = # of cells this proc will contribute
-
-  int nme = grid->nunsplitlocal + grid->nsplitlocal;
-
-  // allocate memory for max of nme
-
-  int nmax;
-  MPI_Allreduce(&nme,&nmax,1,MPI_INT,MPI_MAX,world);
-
-  bigint *buf;
-  memory->create(buf,nmax,"write_grid:buf");
-
-  // pack ID each cell into buf, skipping sub cells
+  if (comm->me == 0) {
+    header(text);
+    text->format(0,"\nCells\n\n");
+  }
 
   Grid::ChildCell *cells = grid->cells;
   int nglocal = grid->nlocal;
 
-  int m = 0;
-  for (i = 0; i < nglocal; i++) {
+  for (int i = 0; i < nglocal; i++) {
     if (cells[i].nsplit <= 0) continue;
-    buf[m++] = cells[i].id;
+    text->format(0,BIGINT_FORMAT "\n",(bigint) cells[i].id);
   }
 
-  // write out cell IDs from all procs
-
-  if (me == 0) {
-    fprintf(fp,"\nCells\n\n");
-    for (int iproc = 0; iproc < nprocs; iproc++) {
-      if (iproc) {
-        MPI_Irecv(buf,nmax,MPI_SPARTA_BIGINT,iproc,0,world,&request);
-        MPI_Send(&tmp,0,MPI_INT,iproc,0,world);
-        MPI_Wait(&request,&status);
-        MPI_Get_count(&status,MPI_DOUBLE,&nlines);
-      } else nlines = nme;
-
-      for (i = 0; i < nlines; i++) {
-        fprintf(fp,BIGINT_FORMAT "\n",buf[i]);
-      }
-    }
-
-  } else {
-    MPI_Recv(&tmp,0,MPI_INT,0,0,world,&status);
-    MPI_Rsend(buf,nme,MPI_SPARTA_BIGINT,0,0,world);
-  }
-
-  // clean up
-
-  memory->destroy(buf);
+  text->write(file);
+  delete text;
 }
@@ -34,10 +34,10 @@ class WriteGrid : protected Pointers {
   void command(int, char **);
 
  private:
-  FILE *fp;
+  int nwriter;
 
-  void header();
-  void write();
+  void header(class WriteText *);
+  void write(char *);
 };
 
 }
@@ -21,6 +21,7 @@
 #include "update.h"
 #include "comm.h"
 #include "domain.h"
+#include "write_text.h"
 #include "memory.h"
 #include "error.h"
 
@@ -70,6 +71,7 @@ void WriteSurf::command(int narg, char **arg)
   // optional args
 
   pointflag = 1;
+  nwriter = 1;
 
   if (multiproc) {
     nclusterprocs = 1;
@@ -133,6 +135,15 @@ void WriteSurf::command(int narg, char **arg)
       else filewriter = 0;
       iarg += 2;
 
+    } else if (strcmp(arg[iarg],"nwriter") == 0) {
+      if (iarg+2 > narg) error->all(FLERR,"Illegal write_surf command");
+      if (multiproc)
+        error->all(FLERR,"Cannot use write_surf nwriter "
+                   "with % in surface file name");
+      nwriter = atoi(arg[iarg+1]);
+      if (nwriter <= 0) error->all(FLERR,"Illegal write_surf command");
+      iarg += 2;
+
     } else error->all(FLERR,"Illegal write_surf command");
   }
 
@@ -171,6 +182,11 @@ void WriteSurf::command(int narg, char **arg)
 
 void WriteSurf::write_file(char *file)
 {
+  if (!multiproc) {
+    write_file_single(file);
+    return;
+  }
+
   if (surf->distributed) {
     if (pointflag) write_file_distributed_points(file);
     else write_file_distributed_nopoints(file);
@@ -181,7 +197,137 @@ void WriteSurf::write_file(char *file)
 }
 
 /* ----------------------------------------------------------------------
-   write surf file to single or multiple files with Points section
+   write single surf file with or without Points section
+   each proc formats its surfs, nwriter procs write text of all procs
+   if each proc has copy of all surfs, each formats 1/P fraction of them
+   else each proc formats its explicit or implicit distributed surfs
+------------------------------------------------------------------------- */
+
+void WriteSurf::write_file_single(char *file)
+{
+  // nmine = # of surfs I contribute, starting at lines_mine/tris_mine
+
+  int nmine;
+  Surf::Line *lines_mine = NULL;
+  Surf::Tri *tris_mine = NULL;
+
+  if (!surf->distributed) {
+    int first = static_cast<int> (1.0*me/nprocs * surf->nlocal);
+    int next = static_cast<int> (1.0*(me+1)/nprocs * surf->nlocal);
+    nmine = next - first;
+    if (dim == 2) lines_mine = &surf->lines[first];
+    else tris_mine = &surf->tris[first];
+  } else if (surf->implicit) {
+    nmine = surf->nlocal;
+    lines_mine = surf->lines;
+    tris_mine = surf->tris;
+  } else {
+    nmine = surf->nown;
+    lines_mine = surf->mylines;
+    tris_mine = surf->mytris;
+  }
+
+  // index = # of points contributed by procs before me
+
+  bigint bnmine = nmine;
+  bigint index;
+  MPI_Scan(&bnmine,&index,1,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  index = (index-bnmine) * dim;
+
+  // proc 0 formats header info and section titles
+  // section 0 = Points (if included), section 1 = Lines or Triangles
+
+  int ipoint = 0;
+  int isurf = 0;
+  if (pointflag) isurf = 1;
+
+  WriteText *text = new WriteText(sparta,isurf+1,nwriter);
+
+  if (me == 0) {
+    text->format(0,"# Surface element file written by SPARTA\n\n");
+    if (dim == 2) {
+      if (pointflag)
+        text->format(0,BIGINT_FORMAT " points\n",(bigint) 2*surf->nsurf);
+      text->format(0,BIGINT_FORMAT " lines\n",surf->nsurf);
+    } else if (dim == 3) {
+      if (pointflag)
+        text->format(0,BIGINT_FORMAT " points\n",(bigint) 3*surf->nsurf);
+      text->format(0,BIGINT_FORMAT " triangles\n",surf->nsurf);
+    }
+    if (pointflag) text->format(ipoint,"\nPoints\n\n");
+    if (dim == 2) text->format(isurf,"\nLines\n\n");
+    else text->format(isurf,"\nTriangles\n\n");
+  }
+
+  // points
+
+  if (pointflag) {
+    if (dim == 2) {
+      Surf::Line *lines = lines_mine;
+      bigint m = index;
+      for (int i = 0; i < nmine; i++) {
+        text->format(ipoint,BIGINT_FORMAT " %20.15g %20.15g\n",
+                     m+1,lines[i].p1[0],lines[i].p1[1]);
+        text->format(ipoint,BIGINT_FORMAT " %20.15g %20.15g\n",
+                     m+2,lines[i].p2[0],lines[i].p2[1]);
+        m += 2;
+      }
+    } else {
+      Surf::Tri *tris = tris_mine;
+      bigint m = index;
+      for (int i = 0; i < nmine; i++) {
+        text->format(ipoint,BIGINT_FORMAT " %20.15g %20.15g %20.15g\n",
+                     m+1,tris[i].p1[0],tris[i].p1[1],tris[i].p1[2]);
+        text->format(ipoint,BIGINT_FORMAT " %20.15g %20.15g %20.15g\n",
+                     m+2,tris[i].p2[0],tris[i].p2[1],tris[i].p2[2]);
+        text->format(ipoint,BIGINT_FORMAT " %20.15g %20.15g %20.15g\n",
+                     m+3,tris[i].p3[0],tris[i].p3[1],tris[i].p3[2]);
+        m += 3;
+      }
+    }
+  }
+
+  // lines or triangles, with point indices or coords
+
+  if (dim == 2) {
+    Surf::Line *lines = lines_mine;
+    bigint m = index;
+    for (int i = 0; i < nmine; i++) {
+      if (pointflag)
+        text->format(isurf,SURFINT_FORMAT " %d " BIGINT_FORMAT " "
+                     BIGINT_FORMAT "\n",lines[i].id,lines[i].type,m+1,m+2);
+      else
+        text->format(isurf,SURFINT_FORMAT " %d %20.15g %20.15g "
+                     "%20.15g %20.15g\n",lines[i].id,lines[i].type,
+                     lines[i].p1[0],lines[i].p1[1],
+                     lines[i].p2[0],lines[i].p2[1]);
+      m += 2;
+    }
+  } else {
+    Surf::Tri *tris = tris_mine;
+    bigint m = index;
+    for (int i = 0; i < nmine; i++) {
+      if (pointflag)
+        text->format(isurf,SURFINT_FORMAT " %d " BIGINT_FORMAT " "
+                     BIGINT_FORMAT " " BIGINT_FORMAT "\n",
+                     tris[i].id,tris[i].type,m+1,m+2,m+3);
+      else
+        text->format(isurf,SURFINT_FORMAT " %d %20.15g %20.15g %20.15g "
+                     "%20.15g %20.15g %20.15g %20.15g %20.15g %20.15g\n",
+                     tris[i].id,tris[i].type,
+                     tris[i].p1[0],tris[i].p1[1],tris[i].p1[2],
+                     tris[i].p2[0],tris[i].p2[1],tris[i].p2[2],
+                     tris[i].p3[0],tris[i].p3[1],tris[i].p3[2]);
+      m += 3;
+    }
+  }
+
+  text->write(file);
+  delete text;
+}
+
+/* ----------------------------------------------------------------------
+   write surf file to multiple files with Points section
    each proc has copy of all surfs
 ------------------------------------------------------------------------- */
 
@@ -272,7 +418,7 @@ void WriteSurf::write_file_all_points(char *file)
 }
 
 /* ----------------------------------------------------------------------
-   write surf file to single or multiple files with no Points section
+   write surf file to multiple files with no Points section
    each proc has copy of all surfs
 ------------------------------------------------------------------------- */
 
@@ -335,7 +481,7 @@ void WriteSurf::write_file_all_nopoints(char *file)
 }
 
 /* ----------------------------------------------------------------------
-   write surf file to single or multiple files with Points section
+   write surf file to multiple files with Points section
    surfs are distributed across procs (explicit or implicit)
 ------------------------------------------------------------------------- */
 
@@ -554,7 +700,7 @@ void WriteSurf::write_file_distributed_points(char *file)
 }
 
 /* ----------------------------------------------------------------------
-   write surf file to single or multiple files with no Points section
+   write surf file to multiple files with no Points section
    surfs are distributed across procs (explicit or implicit)
 ------------------------------------------------------------------------- */
 
@@ -39,8 +39,8 @@ class WriteSurf : protected Pointers {
   FILE *fp;
 
   int pointflag;             // 1/0 to include/exclude Points section in file
-  int multiproc;             // 0 = proc 0 writes for all
-                             // else # of procs writing files
+  int multiproc;             // 0 = single file, else # of files written
+  int nwriter;               // # of procs writing single file
   int filewriter;            // 1 if this proc writes to file, else 0
   int icluster;              // which cluster I am in
   int nclusterprocs;         // # of procs in my cluster that write to one file
@@ -52,6 +52,7 @@ class WriteSurf : protected Pointers {
   };
 
   void write_file(char *);
+  void write_file_single(char *);
   void write_file_all_points(char *);
   void write_file_all_nopoints(char *);
   void write_file_distributed_points(char *);
@@ -0,0 +1,191 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#include "mpi.h"
+#include "stdarg.h"
+#include "string.h"
+#include "write_text.h"
+#include "comm.h"
+#include "memory.h"
+#include "error.h"
+
+using namespace SPARTA_NS;
+
+#define DELTA 65536
+
+/* ----------------------------------------------------------------------
+   write a single text file whose contents are formatted by all procs
+   file has Nsection sections, each proc formats its text of every section
+   file contains text of section 1 from all procs in rank order,
+     then section 2, etc
+   Nwriter procs write to the file, each for a contiguous cluster of procs
+------------------------------------------------------------------------- */
+
+WriteText::WriteText(SPARTA *sparta, int nsection_caller, int nwriter_caller) :
+  Pointers(sparta)
+{
+  me = comm->me;
+  nprocs = comm->nprocs;
+
+  nsection = nsection_caller;
+  bufs = new char*[nsection];
+  nbytes = new bigint[nsection];
+  maxbytes = new bigint[nsection];
+  for (int i = 0; i < nsection; i++) {
+    bufs[i] = NULL;
+    nbytes[i] = maxbytes[i] = 0;
+  }
+
+  // assign clusters of procs to writers, same as write_surf nfile option
+
+  nwriter = MIN(nwriter_caller,nprocs);
+  int icluster = static_cast<int> ((bigint) me * nwriter/nprocs);
+  fileproc = static_cast<int> ((bigint) icluster * nprocs/nwriter);
+  int fcluster = static_cast<int> ((bigint) fileproc * nwriter/nprocs);
+  if (fcluster < icluster) fileproc++;
+  int fileprocnext =
+    static_cast<int> ((bigint) (icluster+1) * nprocs/nwriter);
+  fcluster = static_cast<int> ((bigint) fileprocnext * nwriter/nprocs);
+  if (fcluster < icluster+1) fileprocnext++;
+  nclusterprocs = fileprocnext - fileproc;
+  if (me == fileproc) filewriter = 1;
+  else filewriter = 0;
+}
+
+/* ---------------------------------------------------------------------- */
+
+WriteText::~WriteText()
+{
+  for (int i = 0; i < nsection; i++) memory->sfree(bufs[i]);
+  delete [] bufs;
+  delete [] nbytes;
+  delete [] maxbytes;
+}
+
+/* ----------------------------------------------------------------------
+   append printf-style formatted text to my text of section isection
+------------------------------------------------------------------------- */
+
+void WriteText::format(int isection, const char *fmt, ...)
+{
+  va_list args;
+
+  while (1) {
+    bigint nroom = maxbytes[isection] - nbytes[isection];
+    va_start(args,fmt);
+    int n = vsnprintf(&bufs[isection][nbytes[isection]],nroom,fmt,args);
+    va_end(args);
+
+    if (n < nroom) {
+      nbytes[isection] += n;
+      return;
+    }
+
+    maxbytes[isection] += MAX(DELTA,n+1);
+    bufs[isection] = (char *)
+      memory->srealloc(bufs[isection],maxbytes[isection],"write_text:buf");
+  }
+}
+
+/* ----------------------------------------------------------------------
+   write file, called by all procs
+   offset of each proc's text in file is computed via prefix sums
+   each writer seeks to offset of its cluster in each section
+     and writes its own text followed by text of other procs in cluster
+------------------------------------------------------------------------- */
+
+void WriteText::write(const char *file)
+{
+  int i,iproc,recv_size,tmp;
+  MPI_Request request;
+  MPI_Status status;
+
+  // offset = where my text of each section starts in file
+  // maxsize = largest text of any proc in each section
+
+  bigint *offset = new bigint[nsection];
+  bigint *total = new bigint[nsection];
+  bigint *maxsize = new bigint[nsection];
+
+  MPI_Scan(nbytes,offset,nsection,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  MPI_Allreduce(nbytes,total,nsection,MPI_SPARTA_BIGINT,MPI_SUM,world);
+  MPI_Allreduce(nbytes,maxsize,nsection,MPI_SPARTA_BIGINT,MPI_MAX,world);
+
+  bigint base = 0;
+  for (i = 0; i < nsection; i++) {
+    offset[i] += base - nbytes[i];
+    base += total[i];
+    if (maxsize[i] > MAXSMALLINT)
+      error->one(FLERR,"Too much text to write per processor");
+  }
+
+  // proc 0 creates file, then other writers open it
+
+  FILE *fp = NULL;
+  if (me == 0) {
+    fp = fopen(file,"w");
+    if (fp == NULL) {
+      char str[128];
+      sprintf(str,"Cannot open file %s",file);
+      error->one(FLERR,str);
+    }
+  }
+
+  if (nwriter > 1) {
+    MPI_Barrier(world);
+    if (filewriter && me) {
+      fp = fopen(file,"r+");
+      if (fp == NULL) {
+        char str[128];
+        sprintf(str,"Cannot open file %s",file);
+        error->one(FLERR,str);
+      }
+    }
+  }
+
+  // filewriter = 1 = this proc writes to file
+  // ping each proc in my cluster, receive its text, write text to file
+  // else wait for ping from fileproc, send my text to fileproc
+
+  char *rbuf = NULL;
+  if (filewriter && nclusterprocs > 1) {
+    bigint maxall = 0;
+    for (i = 0; i < nsection; i++) maxall = MAX(maxall,maxsize[i]);
+    rbuf = (char *) memory->smalloc(maxall,"write_text:rbuf");
+  }
+
+  for (i = 0; i < nsection; i++) {
+    if (filewriter) {
+      fseek(fp,offset[i],SEEK_SET);
+      fwrite(bufs[i],1,nbytes[i],fp);
+      for (iproc = 1; iproc < nclusterprocs; iproc++) {
+        MPI_Irecv(rbuf,maxsize[i],MPI_CHAR,me+iproc,0,world,&request);
+        MPI_Send(&tmp,0,MPI_INT,me+iproc,0,world);
+        MPI_Wait(&request,&status);
+        MPI_Get_count(&status,MPI_CHAR,&recv_size);
+        fwrite(rbuf,1,recv_size,fp);
+      }
+    } else {
+      MPI_Recv(&tmp,0,MPI_INT,fileproc,0,world,&status);
+      MPI_Rsend(bufs[i],nbytes[i],MPI_CHAR,fileproc,0,world);
+    }
+  }
+
+  if (filewriter) fclose(fp);
+
+  memory->sfree(rbuf);
+  delete [] offset;
+  delete [] total;
+  delete [] maxsize;
+}
@@ -0,0 +1,59 @@
+/* ----------------------------------------------------------------------
+   SPARTA - Stochastic PArallel Rarefied-gas Time-accurate Analyzer
+   http://sparta.sandia.gov
+   Steve Plimpton, sjplimp@gmail.com, Michael Gallis, magalli@sandia.gov
+   Sandia National Laboratories
+
+   Copyright (2014) Sandia Corporation.  Under the terms of Contract
+   DE-AC04-94AL85000 with Sandia Corporation, the U.S. Government retains
+   certain rights in this software.  This software is distributed under
+   the GNU General Public License.
+
+   See the README file in the top-level SPARTA directory.
+------------------------------------------------------------------------- */
+
+#ifndef SPARTA_WRITE_TEXT_H
+#define SPARTA_WRITE_TEXT_H
+
+#include "stdio.h"
+#include "pointers.h"
+
+namespace SPARTA_NS {
+
+class WriteText : protected Pointers {
+ public:
+  WriteText(class SPARTA *, int, int);
+  ~WriteText();
+  void format(int, const char *, ...);
+  void write(const char *);
+
+ private:
+  int me,nprocs;
+  int nsection;              // # of sections in file
+  int nwriter;               // # of procs which write to file
+  int filewriter;            // 1 if this proc writes to file
+  int fileproc;              // proc which writes my text
+  int nclusterprocs;         // # of procs whose text fileproc writes
+
+  char **bufs;               // my text for each section
+  bigint *nbytes;            // length of my text in each section
+  bigint *maxbytes;          // allocated length of each buf
+};
+
+}
+
+#endif
+
+/* ERROR/WARNING messages:
+
+E: Cannot open file %s
+
+The specified file cannot be opened.  Check that the path and name are
+correct.
+
+E: Too much text to write per processor
+
+The text one processor contributes to a section of an output file
+exceeds the size of a single MPI message.
+
+*/